@@ -25,6 +25,7 @@
 
 #include "callgraph.h"
 
+#include "asyncprocess.h"
 #include "fileutils.h"
 #include "macromanager.h"
 #include "uicallgraphpanel.h"
@@ -38,6 +39,7 @@
 #include <wx/msgdlg.h>
 #include <wx/mstream.h>
 #include <wx/wfstream.h>
+#include <vector>
 #include <wx/xrc/xmlres.h>
 
 /*!
@@ -97,6 +99,13 @@ CallGraph::CallGraph(IManager* manager)
 
     m_mgr->GetTheApp()->Connect(XRCID("cg_show_callgraph"), wxEVT_COMMAND_TOOL_CLICKED,
                                 wxCommandEventHandler(CallGraph::OnShowCallGraph), NULL, this);
+    m_mgr->GetTheApp()->Connect(XRCID("cg_cancel_callgraph"), wxEVT_COMMAND_MENU_SELECTED,
+                                wxCommandEventHandler(CallGraph::OnCancelCallGraph), NULL, this);
+    m_mgr->GetTheApp()->Connect(XRCID("cg_cancel_callgraph"), wxEVT_UPDATE_UI,
+                                wxUpdateUIEventHandler(CallGraph::OnCancelCallGraphUI), NULL, this);
+
+    Bind(wxEVT_ASYNC_PROCESS_OUTPUT, &CallGraph::OnGprofOutput, this);
+    Bind(wxEVT_ASYNC_PROCESS_TERMINATED, &CallGraph::OnGprofTerminated, this);
 }
 
 //---- DTOR -------------------------------------------------------------------
@@ -110,6 +119,13 @@ CallGraph::~CallGraph()
 
     m_mgr->GetTheApp()->Disconnect(XRCID("cg_show_callgraph"), wxEVT_COMMAND_TOOL_CLICKED,
                                    wxCommandEventHandler(CallGraph::OnShowCallGraph), NULL, this);
+    m_mgr->GetTheApp()->Disconnect(XRCID("cg_cancel_callgraph"), wxEVT_COMMAND_MENU_SELECTED,
+                                   wxCommandEventHandler(CallGraph::OnCancelCallGraph), NULL, this);
+    m_mgr->GetTheApp()->Disconnect(XRCID("cg_cancel_callgraph"), wxEVT_UPDATE_UI,
+                                   wxUpdateUIEventHandler(CallGraph::OnCancelCallGraphUI), NULL, this);
+
+    Unbind(wxEVT_ASYNC_PROCESS_OUTPUT, &CallGraph::OnGprofOutput, this);
+    Unbind(wxEVT_ASYNC_PROCESS_TERMINATED, &CallGraph::OnGprofTerminated, this);
 }
 
 //-----------------------------------------------------------------------------
@@ -125,6 +141,9 @@ void CallGraph::CreatePluginMenu(wxMenu* pluginsMenu)
     item = new wxMenuItem(menu, XRCID("cg_show_callgraph"), _("Show call graph"),
                           _("Show call graph for selected/active project"), wxITEM_NORMAL);
     menu->Append(item);
+    item = new wxMenuItem(menu, XRCID("cg_cancel_callgraph"), _("Cancel call graph"),
+                          _("Stop creating the call graph"), wxITEM_NORMAL);
+    menu->Append(item);
     menu->AppendSeparator();
     item = new wxMenuItem(menu, XRCID("cg_settings"), _("Settings..."), wxEmptyString, wxITEM_NORMAL);
     menu->Append(item);
@@ -173,10 +192,7 @@ void CallGraph::HookPopupMenu(wxMenu* menu, MenuType type)
 
 //-----------------------------------------------------------------------------
 
-void CallGraph::UnPlug()
-{
-    // TODO:: perform the unplug action for this plugin
-}
+void CallGraph::UnPlug() { CancelCallGraph(); }
 
 //---- About ------------------------------------------------------------------
 
@@ -328,103 +344,139 @@ void CallGraph::OnShowCallGraph(wxCommandEvent& event)
         gmon_cfn.Assign(gmonfn, wxPATH_NATIVE);
     }
 
-    wxString bin, arg1, arg2;
-
-    bin = GetGprofPath();
-    arg1 = bin_fpath;
-    arg2 = gmonfn;
-
-    wxString cmdgprof = wxString::Format("%s %s %s", bin, arg1, arg2);
+    // build output dir
+    cfn.Assign(base_path, "");
+    cfn.AppendDir(CALLGRAPH_DIR);
+    cfn.Normalize();
 
-    wxProcess* proc = new wxProcess(wxPROCESS_REDIRECT);
+    if(!cfn.DirExists()) cfn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
-    // wxStopWatch	sw;
+    // a new request replaces the one in progress
+    CancelCallGraph();
+
+    // the gprof output is parsed while gprof is still writing it, the functions and the calls below the configured
+    // thresholds are dropped right away
+    m_gprofParser.reset(new GprofParser());
+    m_gprofParser->SetThresholds(confData.GetTresholdNode(), confData.GetTresholdEdge());
+
+    std::vector<wxString> cmdgprof = { GetGprofPath(), bin_fpath, gmonfn };
+    // no pty: on Unix it would merge the gprof diagnostics into the output. Only stdout is parsed, stderr is reported
+    // through wxEVT_ASYNC_PROCESS_STDERR which is not handled
+    m_gprofProcess = ::CreateAsyncProcess(
+        this, cmdgprof, IProcessCreateWithHiddenConsole | IProcessNoPty | IProcessStderrEvent | IProcessRawOutput);
+    if(!m_gprofProcess) {
+        m_gprofParser.reset();
+        return MessageBox(_("Failed to launch gprof, aborting"), wxICON_ERROR);
+    }
 
-    const int err = ::wxExecute(cmdgprof, wxEXEC_SYNC, proc);
-    wxUnusedVar(err);
-    // on sync returns 0 (success), -1 (failure / "couldn't be started")
+    m_basePath = base_path;
+    cfn.SetFullName(DOT_FILENAME_TXT);
+    m_dotFile = cfn.GetFullPath();
+    cfn.SetFullName(DOT_FILENAME_PNG);
+    m_pngFile = cfn.GetFullPath();
 
-    wxInputStream* process_is = proc->GetInputStream();
-    if(!process_is || !process_is->CanRead())
-        return MessageBox(_("wxProcess::GetInputStream() can't be opened, aborting"), wxICON_ERROR);
+    m_mgr->SetStatusMessage(_("Creating call graph..."));
+}
 
-    // start parsing and writing to dot language file
-    GprofParser pgp;
+void CallGraph::OnGprofOutput(clProcessEvent& event)
+{
+    if(event.GetProcess() != m_gprofProcess || !m_gprofParser) return;
 
-    pgp.GprofParserStream(process_is);
+    const std::string& output = event.GetOutputRaw();
+    m_gprofParser->Parse(output.data(), output.length());
+}
 
-    delete proc;
+void CallGraph::OnGprofTerminated(clProcessEvent& event)
+{
+    if(event.GetProcess() != m_gprofProcess || !m_gprofParser) {
+        // a cancelled request
+        return;
+    }
+    wxDELETE(m_gprofProcess);
 
-    ConfCallGraph conf;
+    m_gprofParser->Finish();
+    if(!m_gprofParser->IsCallGraphFound()) {
+        CancelCallGraph();
+        return MessageBox(_("gprof output does not contain a call graph, aborting"), wxICON_ERROR);
+    }
 
-    config_tool->ReadObject(wxT("CallGraph"), &conf);
+    m_mgr->GetConfigTool()->ReadObject(wxT("CallGraph"), &confData);
 
     DotWriter dotWriter;
 
     // DotWriter
-    dotWriter.SetLineParser(&(pgp.lines));
+    dotWriter.SetCallGraph(&m_gprofParser->GetGraph());
 
-    int suggestedThreshold = pgp.GetSuggestedNodeThreshold();
+    m_suggestedThreshold = m_gprofParser->GetSuggestedNodeThreshold();
 
-    if(suggestedThreshold <= conf.GetTresholdNode()) {
-        suggestedThreshold = conf.GetTresholdNode();
+    wxString suggest_msg;
+    if(m_suggestedThreshold <= confData.GetTresholdNode()) {
+        m_suggestedThreshold = confData.GetTresholdNode();
 
         dotWriter.SetDotWriterFromDialogSettings(m_mgr);
 
     } else {
-        dotWriter.SetDotWriterFromDetails(conf.GetColorsNode(), conf.GetColorsEdge(), suggestedThreshold,
-                                          conf.GetTresholdEdge(), conf.GetHideParams(), conf.GetStripParams(),
-                                          conf.GetHideNamespaces());
+        dotWriter.SetDotWriterFromDetails(confData.GetColorsNode(), confData.GetColorsEdge(), m_suggestedThreshold,
+                                          confData.GetTresholdEdge(), confData.GetHideParams(),
+                                          confData.GetStripParams(), confData.GetHideNamespaces());
 
-        wxString suggest_msg = wxString::Format(_("The CallGraph plugin has suggested node threshold %d to speed-up "
-                                                  "the call graph creation. You can alter it on the call graph panel."),
-                                                suggestedThreshold);
-
-        MessageBox(suggest_msg, wxICON_INFORMATION);
+        suggest_msg = wxString::Format(_("The CallGraph plugin has suggested node threshold %d to speed-up "
+                                         "the call graph creation. You can alter it on the call graph panel."),
+                                       m_suggestedThreshold);
     }
 
+    // only the nodes and the edges passing the thresholds are written
     dotWriter.WriteToDotLanguage();
+    dotWriter.SendToDotAppOutputDirectory(m_dotFile);
 
-    // build output dir
-    cfn.Assign(base_path, "");
-    cfn.AppendDir(CALLGRAPH_DIR);
-    cfn.Normalize();
-
-    if(!cfn.DirExists()) cfn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
-
-    cfn.SetFullName(DOT_FILENAME_TXT);
-    wxString dot_fn = cfn.GetFullPath();
-
-    dotWriter.SendToDotAppOutputDirectory(dot_fn);
-
-    cfn.SetFullName(DOT_FILENAME_PNG);
-    wxString output_png_fn = cfn.GetFullPath();
-
-    // delete any existing PNG
-    if(wxFileExists(output_png_fn)) clRemoveFile(output_png_fn);
-
-    wxString cmddot_ln;
-
-    cmddot_ln << GetDotPath() << " -Tpng -o" << output_png_fn << " " << dot_fn;
+    if(!m_dotRenderer.Start(GetDotPath(), m_dotFile, m_pngFile, [this](bool ok) { OnCallGraphRendered(ok); })) {
+        CancelCallGraph();
+        return MessageBox(_("Failed to launch dot, aborting"), wxICON_ERROR);
+    }
 
-    wxExecute(cmddot_ln, wxEXEC_SYNC | wxEXEC_HIDE_CONSOLE);
+    // the graph is rendered while the message is shown
+    if(!suggest_msg.IsEmpty()) MessageBox(suggest_msg, wxICON_INFORMATION);
+}
 
-    if(!wxFileExists(output_png_fn))
+void CallGraph::OnCallGraphRendered(bool ok)
+{
+    if(!ok || !m_gprofParser) {
+        CancelCallGraph();
         return MessageBox(_("Failed to open file CallGraph.png. Please check the project settings, rebuild the project "
                             "and try again."),
                           wxICON_INFORMATION);
+    }
 
     // show image and create table in the editor tab page
-    uicallgraphpanel* panel = new uicallgraphpanel(m_mgr->GetEditorPaneNotebook(), m_mgr, output_png_fn, base_path,
-                                                   suggestedThreshold, &(pgp.lines));
+    uicallgraphpanel* panel = new uicallgraphpanel(m_mgr->GetEditorPaneNotebook(), m_mgr, m_pngFile, m_basePath,
+                                                   m_suggestedThreshold, m_gprofParser->GetGraph());
 
     wxString tstamp = wxDateTime::Now().Format(wxT(" %Y-%m-%d %H:%M:%S"));
 
-    wxString title = wxT("Call graph for \"") + output_png_fn + wxT("\" " + tstamp);
+    wxString title = wxT("Call graph for \"") + m_pngFile + wxT("\" " + tstamp);
 
     m_mgr->AddEditorPage(panel, title);
+
+    m_gprofParser.reset();
+}
+
+void CallGraph::CancelCallGraph()
+{
+    // deleting the process kills it
+    wxDELETE(m_gprofProcess);
+    m_dotRenderer.Cancel();
+    m_gprofParser.reset();
+}
+
+void CallGraph::OnCancelCallGraph(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    CancelCallGraph();
+    m_mgr->SetStatusMessage(_("Call graph cancelled"), 3);
 }
 
+void CallGraph::OnCancelCallGraphUI(wxUpdateUIEvent& event) { event.Enable(IsCallGraphRunning()); }
+
 //---- Show Settings Dialog ---------------------------------------------------
 
 void CallGraph::OnSettings(wxCommandEvent& event)
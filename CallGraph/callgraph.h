@@ -44,8 +44,13 @@
 #include "confcallgraph.h"
 #include "gprofparser.h"
 #include "dotwriter.h"
+#include "dotrenderer.h"
 #include "static.h"
 
+#include <memory>
+
+class IProcess;
+
 /**
  * @class CallGraph
  * @brief Class define structure for plugin interface.
@@ -114,6 +119,30 @@ protected:
      * @param event Reference to event class
      */
     void OnSettings(wxCommandEvent& event);
+    /**
+     * @brief Stop creating the call graph.
+     * @param event Reference to event class
+     */
+    void OnCancelCallGraph(wxCommandEvent& event);
+    void OnCancelCallGraphUI(wxUpdateUIEvent& event);
+
+    /**
+     * @brief The gprof output is parsed as it arrives.
+     */
+    void OnGprofOutput(clProcessEvent& event);
+    /**
+     * @brief gprof exited, write the call graph to the DOT language and render it in the background.
+     */
+    void OnGprofTerminated(clProcessEvent& event);
+    /**
+     * @brief The call graph image is ready, show it with the table of functions in a new tab page.
+     */
+    void OnCallGraphRendered(bool ok);
+    /**
+     * @brief Kill gprof or dot and drop the parsed data.
+     */
+    void CancelCallGraph();
+    bool IsCallGraphRunning() const { return m_gprofProcess || m_dotRenderer.IsRunning(); }
 
     /**
      * @brief Create custom plugin's popup menu.
@@ -128,6 +157,15 @@ protected:
      * @brief Object confData type ConfCallGraph with stored configuration data.
      */
     ConfCallGraph confData; // object confData type ConfCallGraph with stored configuration data
+
+    // the call graph being created
+    IProcess* m_gprofProcess = nullptr;
+    std::unique_ptr<GprofParser> m_gprofParser;
+    DotRenderer m_dotRenderer;
+    wxString m_basePath;
+    wxString m_dotFile;
+    wxString m_pngFile;
+    int m_suggestedThreshold = -1;
 };
 
 #endif // CallGraph
@@ -0,0 +1,33 @@
+#include "callgraphdata.h"
+
+#include <algorithm>
+
+void CallGraphData::Clear()
+{
+    m_nodes.clear();
+    m_edges.clear();
+    m_nodeByIndex.clear();
+    m_maxTime = -2;
+}
+
+void CallGraphData::AddNode(const CallGraphNode& node)
+{
+    m_nodeByIndex[node.index] = m_nodes.size();
+    m_nodes.push_back(node);
+}
+
+void CallGraphData::RemoveDanglingEdges()
+{
+    auto iter = std::remove_if(m_edges.begin(), m_edges.end(),
+                               [this](const CallGraphEdge& edge) { return FindNode(edge.to) == nullptr; });
+    m_edges.erase(iter, m_edges.end());
+}
+
+const CallGraphNode* CallGraphData::FindNode(int index) const
+{
+    auto iter = m_nodeByIndex.find(index);
+    if(iter == m_nodeByIndex.end()) {
+        return nullptr;
+    }
+    return &m_nodes[iter->second];
+}
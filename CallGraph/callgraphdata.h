@@ -0,0 +1,82 @@
+#ifndef CALLGRAPHDATA_H
+#define CALLGRAPHDATA_H
+
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief a function of the profiled binary (a primary line of the gprof call graph)
+ */
+struct CallGraphNode {
+    int index = -1;   ///< gprof index of the function
+    float time = 0;   ///< percentage of the total time spent in the function and its children
+    float self = 0;   ///< seconds spent in the function itself
+    float children = 0;
+    int called0 = -1; ///< number of calls, -1 if gprof did not report it
+    int called1 = -1; ///< number of recursive calls, -1 if the function is not recursive
+    wxString name;
+};
+
+/**
+ * @brief a call from a function to another one (a child line of the gprof call graph)
+ */
+struct CallGraphEdge {
+    int from = -1; ///< gprof index of the caller
+    int to = -1;   ///< gprof index of the callee
+    int calls = 0;
+};
+
+/**
+ * @class CallGraphData
+ * @brief Compact call graph built by the gprof parser.
+ *
+ * Only the nodes and the edges passing the thresholds the graph was parsed with are stored, higher thresholds are
+ * applied when the graph is written to the DOT language.
+ */
+class CallGraphData
+{
+public:
+    void Clear();
+
+    void AddNode(const CallGraphNode& node);
+    void AddEdge(const CallGraphEdge& edge) { m_edges.push_back(edge); }
+    /**
+     * @brief remove the edges leading to functions that were not stored
+     */
+    void RemoveDanglingEdges();
+    /**
+     * @brief return the node with the given gprof index or NULL if the function was not stored
+     */
+    const CallGraphNode* FindNode(int index) const;
+
+    const std::vector<CallGraphNode>& GetNodes() const { return m_nodes; }
+    const std::vector<CallGraphEdge>& GetEdges() const { return m_edges; }
+
+    /**
+     * @brief the thresholds the graph was parsed with, nodes and edges below them are not available
+     */
+    void SetThresholds(int nodeThreshold, int edgeThreshold)
+    {
+        m_nodeThreshold = nodeThreshold;
+        m_edgeThreshold = edgeThreshold;
+    }
+    int GetNodeThreshold() const { return m_nodeThreshold; }
+    int GetEdgeThreshold() const { return m_edgeThreshold; }
+
+    /**
+     * @brief the highest time of all the functions found in the gprof output, including those not stored
+     */
+    void SetMaxTime(float maxTime) { m_maxTime = maxTime; }
+    float GetMaxTime() const { return m_maxTime; }
+
+private:
+    std::vector<CallGraphNode> m_nodes;
+    std::vector<CallGraphEdge> m_edges;
+    std::unordered_map<int, size_t> m_nodeByIndex;
+    int m_nodeThreshold = 0;
+    int m_edgeThreshold = 0;
+    float m_maxTime = -2;
+};
+
+#endif // CALLGRAPHDATA_H
@@ -0,0 +1,52 @@
+#include "dotrenderer.h"
+
+#include "asyncprocess.h"
+#include "fileutils.h"
+
+#include <vector>
+#include <wx/filefn.h>
+
+DotRenderer::DotRenderer() { Bind(wxEVT_ASYNC_PROCESS_TERMINATED, &DotRenderer::OnProcessTerminated, this); }
+
+DotRenderer::~DotRenderer()
+{
+    Cancel();
+    Unbind(wxEVT_ASYNC_PROCESS_TERMINATED, &DotRenderer::OnProcessTerminated, this);
+}
+
+bool DotRenderer::Start(const wxString& dotPath, const wxString& dotFile, const wxString& pngFile,
+                        const Callback_t& callback)
+{
+    Cancel();
+
+    // delete any existing PNG so an image of the previous graph is not taken for the result
+    if(wxFileExists(pngFile)) clRemoveFile(pngFile);
+
+    std::vector<wxString> args = { dotPath, "-Tpng", "-o" + pngFile, dotFile };
+    m_process = ::CreateAsyncProcess(this, args, IProcessCreateWithHiddenConsole);
+    if(!m_process) return false;
+
+    m_pngFile = pngFile;
+    m_callback = callback;
+    return true;
+}
+
+void DotRenderer::Cancel()
+{
+    // deleting the process kills it
+    wxDELETE(m_process);
+    m_callback = nullptr;
+}
+
+void DotRenderer::OnProcessTerminated(clProcessEvent& event)
+{
+    if(event.GetProcess() != m_process) {
+        // a cancelled job
+        return;
+    }
+    wxDELETE(m_process);
+
+    Callback_t callback;
+    callback.swap(m_callback);
+    if(callback) callback(wxFileExists(m_pngFile));
+}
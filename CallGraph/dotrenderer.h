@@ -0,0 +1,48 @@
+#ifndef DOTRENDERER_H
+#define DOTRENDERER_H
+
+#include "cl_command_event.h"
+
+#include <functional>
+#include <wx/event.h>
+#include <wx/string.h>
+
+class IProcess;
+
+/**
+ * @class DotRenderer
+ * @brief Render a file in the DOT language to a PNG image with the 'dot' tool, in the background.
+ *
+ * The callback is called once 'dot' exits; a job that was cancelled (or replaced by a newer one) never calls it.
+ */
+class DotRenderer : public wxEvtHandler
+{
+public:
+    /**
+     * @brief called with true if the image was created
+     */
+    typedef std::function<void(bool)> Callback_t;
+
+    DotRenderer();
+    virtual ~DotRenderer();
+
+    /**
+     * @brief start rendering, the job in progress (if any) is cancelled
+     * @return false if 'dot' could not be started
+     */
+    bool Start(const wxString& dotPath, const wxString& dotFile, const wxString& pngFile, const Callback_t& callback);
+    /**
+     * @brief kill the job in progress
+     */
+    void Cancel();
+    bool IsRunning() const { return m_process != nullptr; }
+
+protected:
+    void OnProcessTerminated(clProcessEvent& event);
+
+    IProcess* m_process = nullptr;
+    wxString m_pngFile;
+    Callback_t m_callback;
+};
+
+#endif // DOTRENDERER_H
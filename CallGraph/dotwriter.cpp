@@ -30,6 +30,7 @@
 #include <wx/math.h>
 #include <wx/regex.h>
 #include <math.h>
+#include <unordered_set>
 
 DotWriter::DotWriter()
 {
@@ -46,7 +47,7 @@ DotWriter::DotWriter()
     dlabel = wxT("");
     graph = wxT("");
     // m_OutputString = wxT("");
-    mlines = NULL;
+    mgraph = NULL;
     dwcn = 0;
     dwce = 0;
     dwtn = 0;
@@ -59,10 +60,7 @@ DotWriter::DotWriter()
 
 DotWriter::~DotWriter() {}
 
-void DotWriter::SetLineParser(LineParserList* pLines) //, int numOfLines)
-{
-    mlines = pLines;
-}
+void DotWriter::SetCallGraph(const CallGraphData* pGraph) { mgraph = pGraph; }
 
 void DotWriter::SetDotWriterFromDialogSettings(IManager* mgr)
 {
@@ -95,12 +93,10 @@ void DotWriter::SetDotWriterFromDetails(int colnode,
 
 void DotWriter::WriteToDotLanguage()
 {
-    int pl_index = 0;
-    float pl_time = 0;
     bool is_node = false;
-    wxArrayInt index_pl_nodes;
+    std::unordered_set<int> index_pl_nodes;
 
-    if(mlines == NULL) return;
+    if(mgraph == NULL) return;
 
     graph = wxT("graph [ranksep=\"0.25\", fontname=") + fontname + wxT(", nodesep=\"0.125\"];");
 
@@ -113,88 +109,62 @@ void DotWriter::WriteToDotLanguage()
 
     m_OutputString += begin_graph + wxT("\n") + graph + wxT("\n") + hnode + wxT("\n") + hedge + wxT("\n");
 
-    LineParserList::compatibility_iterator it = mlines->GetFirst();
-
-    while(it) {
-        LineParser* line = it->GetData();
-
-        if(line->pline && wxRound(line->time) >= dwtn) {
-            is_node = true;
-            index_pl_nodes.Add(line->index);
-            dlabel = wxString::Format(wxT("%i"), line->index);
-            dlabel += wxT(" [label=\"");
-            dlabel += OptionsShortNameAndParameters(line->name);
-            dlabel += wxT("\\n");
-            dlabel += wxString::Format(wxT("%.2f"), line->time);
-            dlabel += wxT("% \\n");
-            dlabel += wxT("(");
-            // self or children if have function childern line
-            // if(line->self >= line->childern)
-            //	dlabel += wxString::Format(wxT("%.2f"), line->self);
-            // else
-            dlabel += wxString::Format(wxT("%.2f"), line->self + line->children);
-            dlabel += wxT("s)");
-            dlabel += wxT("\\n");
-            if(line->called0 != -1) dlabel += wxString::Format(wxT("%i"), line->called0) + wxT("x");
-            // if(line->recursive)
-            //	dlabel += wxT(" (") + wxString::Format(wxT("%i"),line->called0 + line->called1) + wxT("x)");
-            dlabel += wxT("\",fontcolor=\"");
-            dlabel += DefineColorForLabel(ReturnIndexForColor(line->time, dwcn));
-            dlabel += wxT("\", color=\"");
-            dlabel += DefineColorForNodeEdge(ReturnIndexForColor(line->time, dwcn));
-            //
-            dlabel += wxT("\"];"); //, fontsize=\"10.00\"
-            //
-            m_OutputString += dlabel + wxT("\n");
-            //
-            dlabel.Clear();
-        }
-        it = it->GetNext();
+    for(const CallGraphNode& node : mgraph->GetNodes()) {
+        if(wxRound(node.time) < dwtn) continue;
+
+        is_node = true;
+        index_pl_nodes.insert(node.index);
+        dlabel = wxString::Format(wxT("%i"), node.index);
+        dlabel += wxT(" [label=\"");
+        dlabel += OptionsShortNameAndParameters(node.name);
+        dlabel += wxT("\\n");
+        dlabel += wxString::Format(wxT("%.2f"), node.time);
+        dlabel += wxT("% \\n");
+        dlabel += wxT("(");
+        dlabel += wxString::Format(wxT("%.2f"), node.self + node.children);
+        dlabel += wxT("s)");
+        dlabel += wxT("\\n");
+        if(node.called0 != -1) dlabel += wxString::Format(wxT("%i"), node.called0) + wxT("x");
+        dlabel += wxT("\",fontcolor=\"");
+        dlabel += DefineColorForLabel(ReturnIndexForColor(node.time, dwcn));
+        dlabel += wxT("\", color=\"");
+        dlabel += DefineColorForNodeEdge(ReturnIndexForColor(node.time, dwcn));
+        //
+        dlabel += wxT("\"];"); //, fontsize=\"10.00\"
+        //
+        m_OutputString += dlabel + wxT("\n");
+        //
+        dlabel.Clear();
     }
 
-    it = mlines->GetFirst();
-
-    float max_time = -2;
-
-    while(it) {
-        LineParser* line = it->GetData();
-
-        if(max_time < line->time) max_time = line->time;
-
-        if(line->pline) {
-            pl_index = line->index; // index for primary node
-            pl_time = line->time;   // time for primary node
-        }
-
-        if(line->child && IsInArray(line->nameid, index_pl_nodes) && IsInArray(pl_index, index_pl_nodes) &&
-           (wxRound(pl_time) >= dwte)) {
-            dedge = wxString::Format(wxT("%i"), pl_index);
-            dedge += wxT(" -> ");
-            dedge += wxString::Format(wxT("%i"), line->nameid);
-            dedge += wxT(" [color=\"");
-            dedge += DefineColorForNodeEdge(ReturnIndexForColor(pl_time, dwce)); // color by primary node
-            dedge += wxT("\", label=\"");
-            // if(line->self != -1)
-            // dedge += wxString::Format(wxT("%.2f"),line->self) + wxT("%");
-            // dedge += wxT("\\n");
-            dedge += wxString::Format(wxT("%i"), line->called0);
-            dedge += wxT("x");
-            dedge += wxT("\" ,arrowsize=\"0.50\", fontsize=\"9.00\", fontcolor=\"");
-            dedge += cblack;
-            dedge += wxT("\", penwidth=\"2.00\"];"); // labeldistance=\"4.00\",
-            //
-            m_OutputString += dedge + wxT("\n");
-            //
-            dedge.Clear();
-        }
-        it = it->GetNext();
+    for(const CallGraphEdge& edge : mgraph->GetEdges()) {
+        const CallGraphNode* pl_node = mgraph->FindNode(edge.from); // primary node
+        if(!pl_node || wxRound(pl_node->time) < dwte || !index_pl_nodes.count(edge.from) ||
+           !index_pl_nodes.count(edge.to))
+            continue;
+
+        dedge = wxString::Format(wxT("%i"), edge.from);
+        dedge += wxT(" -> ");
+        dedge += wxString::Format(wxT("%i"), edge.to);
+        dedge += wxT(" [color=\"");
+        dedge += DefineColorForNodeEdge(ReturnIndexForColor(pl_node->time, dwce)); // color by primary node
+        dedge += wxT("\", label=\"");
+        dedge += wxString::Format(wxT("%i"), edge.calls);
+        dedge += wxT("x");
+        dedge += wxT("\" ,arrowsize=\"0.50\", fontsize=\"9.00\", fontcolor=\"");
+        dedge += cblack;
+        dedge += wxT("\", penwidth=\"2.00\"];"); // labeldistance=\"4.00\",
+        //
+        m_OutputString += dedge + wxT("\n");
+        //
+        dedge.Clear();
     }
     m_OutputString += end_graph;
 
     if(!is_node) { // if the call graph is empty create new graph with label node
         m_OutputString = wxT("digraph e {0 [label=");
-        m_OutputString +=
-            wxString::Format(_("\"The call-graph is empty; the node threshold ceiling is %d !\""), wxRound(max_time));
+        m_OutputString += wxString::Format(_("\"The call-graph is empty; the node threshold ceiling is %d !\""),
+                                           wxRound(mgraph->GetMaxTime()));
         m_OutputString += wxT(", shape=none, height=2, width=2, fontname=Arial, fontsize=14.00];}");
     }
 }
@@ -327,14 +297,6 @@ wxString DotWriter::DefineColorForNodeEdge(int index)
     return colors[index];
 }
 
-bool DotWriter::IsInArray(int index, const wxArrayInt& arr)
-{
-    for(unsigned int i = 0; i < arr.GetCount(); i++) {
-        if(arr.Item(i) == index) return true;
-    }
-    return false;
-}
-
 wxString DotWriter::DefineColorForLabel(int index)
 {
     if((index < 3) || (index > 6)) {
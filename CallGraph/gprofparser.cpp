@@ -24,276 +24,315 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "gprofparser.h"
-#include <wx/intl.h>
-#include <wx/regex.h>
+
+#include <climits>
+#include <cstring>
+#include <wx/math.h>
 #include <wx/strconv.h>
 
-int cmpint(int* a, int* b) { return *b - *a; }
+namespace
+{
+// the numeric columns of a line: '%time self children called' at most
+constexpr size_t MAX_COLUMNS = 4;
+
+struct LineFields {
+    int index = -1; ///< [index] of a primary line, -1 for the callers and the callees
+    const char* columns[MAX_COLUMNS];
+    const char* columnsEnd[MAX_COLUMNS];
+    size_t columnCount = 0;
+    const char* name = nullptr;
+    const char* nameEnd = nullptr;
+    int nameId = -1;
+};
+
+inline bool IsSpace(char ch) { return ch == ' ' || ch == '\t' || ch == '\r'; }
+inline bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+const char* SkipSpaces(const char* p, const char* end)
+{
+    while(p < end && IsSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* TrimRight(const char* begin, const char* end)
+{
+    while(end > begin && IsSpace(end[-1])) {
+        --end;
+    }
+    return end;
+}
+
+int ParseInt(const char*& p, const char* end)
+{
+    int value = 0;
+    for(; p < end && IsDigit(*p); ++p) {
+        value = value * 10 + (*p - '0');
+    }
+    return value;
+}
+
+/**
+ * @brief parse a decimal number, gprof always prints '.' whatever the locale is
+ */
+float ParseFloat(const char* p, const char* end)
+{
+    double value = ParseInt(p, end);
+    if(p < end && *p == '.') {
+        double scale = 0.1;
+        for(++p; p < end && IsDigit(*p); ++p, scale /= 10) {
+            value += (*p - '0') * scale;
+        }
+    }
+    return (float)value;
+}
+
+/**
+ * @brief parse the 'called' column: 'calls', 'calls+recursive calls' or 'calls/total calls'
+ */
+void ParseCalled(const char* p, const char* end, int& called0, int& called1)
+{
+    called0 = ParseInt(p, end);
+    if(p < end && *p == '+') {
+        ++p;
+        called1 = ParseInt(p, end);
+    }
+}
+
+/**
+ * @brief split a line of the call graph into its fields:
+ *  [index] %time self children [called] name [id]  - primary line
+ *          [self children] called[/total] name [id] - caller or callee
+ */
+bool SplitLine(const char* p, const char* end, LineFields& fields)
+{
+    p = SkipSpaces(p, end);
+    if(p < end && *p == '[') {
+        ++p;
+        fields.index = ParseInt(p, end);
+        if(p == end || *p != ']') {
+            return false;
+        }
+        ++p;
+    }
+
+    // the numeric columns, a function name never starts with a digit
+    for(p = SkipSpaces(p, end); p < end && (IsDigit(*p) || *p == '.'); p = SkipSpaces(p, end)) {
+        const char* columnEnd = p;
+        while(columnEnd < end && !IsSpace(*columnEnd)) {
+            ++columnEnd;
+        }
+        if(fields.columnCount == MAX_COLUMNS) {
+            return false;
+        }
+        fields.columns[fields.columnCount] = p;
+        fields.columnsEnd[fields.columnCount] = columnEnd;
+        ++fields.columnCount;
+        p = columnEnd;
+    }
+
+    // the name is followed by the [id] of the function ('<spontaneous>' has none)
+    const char* nameEnd = TrimRight(p, end);
+    if(nameEnd == p || nameEnd[-1] != ']') {
+        return false;
+    }
+    const char* idStart = nameEnd - 1;
+    while(idStart > p && *idStart != '[') {
+        --idStart;
+    }
+    if(*idStart != '[') {
+        return false;
+    }
+    const char* id = idStart + 1;
+    fields.nameId = ParseInt(id, nameEnd);
+    nameEnd = TrimRight(p, idStart);
+
+    // strip the '<cycle N>' tag of the cycle members, '<cycle N as a whole>' is the name of the cycle itself
+    if(nameEnd > p && nameEnd[-1] == '>') {
+        const char* tag = nameEnd - 1;
+        while(tag > p && *tag != '<') {
+            --tag;
+        }
+        if(tag > p && IsSpace(tag[-1]) && strncmp(tag, "<cycle ", 7) == 0) {
+            nameEnd = TrimRight(p, tag);
+        }
+    }
+
+    fields.name = p;
+    fields.nameEnd = nameEnd;
+    return nameEnd > p;
+}
+
+wxString MakeName(const char* name, const char* nameEnd)
+{
+    wxString str = wxString::FromUTF8(name, nameEnd - name);
+    if(str.IsEmpty()) {
+        // not a valid UTF-8
+        str = wxString(name, wxConvISO8859_1, nameEnd - name);
+    }
+    return str;
+}
+} // namespace
 
 GprofParser::GprofParser()
+    : m_inCallGraph(false)
+    , m_done(false)
+    , m_inEntry(false)
+    , m_entryIndex(-1)
+    , m_nodeThreshold(0)
+    , m_edgeThreshold(0)
 {
-	lineheader = false;
-	primaryline = false;
-	nameLen = 0;
-	nameandid = NULL;
-	isdot = false;
-	iscycle = false;
-	islom = false;
-	isplus = false;
-	isspontaneous = false;
-	lines.DeleteContents(true);
-	lines.Clear();
-};
+}
 
-GprofParser::~GprofParser()
+GprofParser::~GprofParser() {}
+
+void GprofParser::SetThresholds(int nodeThreshold, int edgeThreshold)
 {
-	lines.DeleteContents(true);
-	lines.Clear();
-};
+    m_nodeThreshold = nodeThreshold;
+    m_edgeThreshold = edgeThreshold;
+    m_graph.SetThresholds(nodeThreshold, edgeThreshold);
+}
+
+void GprofParser::Parse(const char* data, size_t length)
+{
+    if(m_done) {
+        return;
+    }
+
+    // complete the line left over from the previous chunk
+    const char* end = data + length;
+    if(!m_buffer.empty()) {
+        const char* eol = (const char*)memchr(data, '\n', length);
+        if(!eol) {
+            m_buffer.append(data, length);
+            return;
+        }
+        m_buffer.append(data, eol);
+        ParseLine(m_buffer.data(), m_buffer.data() + m_buffer.length());
+        m_buffer.clear();
+        data = eol + 1;
+    }
+
+    while(data < end && !m_done) {
+        const char* eol = (const char*)memchr(data, '\n', end - data);
+        if(!eol) {
+            m_buffer.assign(data, end);
+            break;
+        }
+        ParseLine(data, eol);
+        data = eol + 1;
+    }
+}
+
+void GprofParser::Finish()
+{
+    if(!m_buffer.empty() && !m_done) {
+        ParseLine(m_buffer.data(), m_buffer.data() + m_buffer.length());
+    }
+    m_buffer.clear();
+    m_done = true;
+    m_graph.RemoveDanglingEdges();
+}
 
-void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
+void GprofParser::ParseLine(const char* line, const char* end)
 {
-	wxRegEx re;
-	readlinetext = wxT("");
-	readlinetexttemp = wxT("");
-	wxCSConv conv( wxT("ISO-8859-1") );
-	wxTextInputStream text(*gprof_output);//, wxT(" \t"), conv);
-	//wxFileOutputStream out( wxT("DEBUG.TXT") );
-	//wxTextOutputStream tout( out );
-
-	isspontaneous = false;
-	calls.clear();
-
-	while(!gprof_output->Eof()) {
-		readlinetext = text.ReadLine();
-		//tout.WriteString( readlinetext + wxT("\n") );
-		nameLen = readlinetext.Len();
-
-		if(readlinetext != wxT("")) {
-			if(readlinetext == wxT("index % time    self  children    called     name")) {
-				lineheader = true;
-			} else if (readlinetext[0] == wxT('-')) {
-				primaryline = false;
-				continue;
-			} else if (readlinetext.Contains(wxT("<spontaneous>"))) {
-				isspontaneous = true;
-				continue;
-			} else if (lineheader) {
-				delete [] nameandid;
-				nameandid = new char[nameLen + 1]; // dynam array for pointer nameandid
-				memset(nameandid, 0, nameLen + 1);
-
-				LineParser *line = new LineParser();
-
-				//inicializace struktury
-				line->called0 = -1;
-				line->called1 = -1;
-				line->child = false;
-				line->children = -1;
-				line->cycle = false;
-				line->cycleid = -1;
-				line->index = -1;
-				line->name = wxT("<undefined>");
-				line->nameid = -1;
-				line->parents = false;
-				line->pline = false;
-				line->recursive = false;
-				line->self = -1;
-				line->time = -1;
-
-				if(re.Compile(wxT("[ ]{2,}")) && re.Matches( readlinetext )) {
-					re.Replace(&readlinetext, wxT(" "));
-				}
-
-				if (readlinetext.Contains(wxT("."))) isdot = true;
-				else isdot = false;
-
-				if (readlinetext.Contains(wxT("cycle"))) iscycle = true;
-				else iscycle = false;
-
-				//if (readlinetext.Contains(wxT("/"))) islom = true;
-				if(re.Compile( wxT("[0-9]+/[0-9]+"), wxRE_ADVANCED) && re.Matches( readlinetext)) islom = true;
-				else islom = false;
-
-				//if (readlinetext.Contains(wxT("+"))) isplus = true;
-				if(re.Compile( wxT("([0-9]+)\\+([0-9]+)"), wxRE_ADVANCED) && re.Matches( readlinetext)) { 
-					isplus = true;
-					//readlinetext.Replace( wxT("+"), wxT(" ") );
-					re.Replace(&readlinetext, wxT("\\1 \\2"));
-				}
-				else isplus = false;
-
-				wxString dot = wxLocale::GetInfo(wxLOCALE_DECIMAL_POINT, wxLOCALE_CAT_NUMBER);
-				readlinetext.Replace( wxT("."), dot );
-
-				if ((readlinetext[0] == '[') && (readlinetext[(readlinetext.length()) - 1] == ']')) {
-					primaryline = true;
-					//
-					if(iscycle && isplus) { // [3]     91.71    1.77        0.00    1+5    <cycle 1 as a whole> [3]
-						//warning
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %d <cycle %d as a whole> [%d]",&line->index,&line->time,&line->self,&line->children,&line->called0,&line->called1,&line->cycleid,&line->nameid);
-						line->name = wxT("whole");
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = true;
-						line->recursive = true;
-					} else if(iscycle) { //  [5]     38.86    0.75        0    1      a <cycle 1> [5]
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %[^\n]s",&line->index,&line->time,&line->self,&line->children,&line->called0,nameandid);
-
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('<'));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('<')).BeforeFirst(wxT('>')),wxT("cycle %d"), &line->cycleid);
-						//line->cycleid = readlinesubtext.AfterFirst('<').BeforeFirst('>');
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = true;
-						line->recursive = false;
-					} else if(isplus) { //[4]      3.7    0.00    0.01       1+6       quicksort(int*, int, int) [4]
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %d %[^\n]s",&line->index,&line->time,&line->self,&line->children,&line->called0,&line->called1,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv);
-						//
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						//
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = false;
-						line->recursive = true;
-					} else if (isspontaneous) { // || !readlinetext.Contains(wxT('('))) // [3]    100.0    0.00    0.03       %d - neni        main [3]
-						//special case (probably appears after 'spontaneous'
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %[^\n]s",&line->index,&line->time,&line->self,&line->children,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						//
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = false;
-						line->recursive = false;
-
-						isspontaneous = false;
-					} else { //[2]    100.00    0.16     1.77    1      main [2]
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %[^\n]s",&line->index,&line->time,&line->self,&line->children,&line->called0,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						//
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = false;
-						line->recursive = false;
-
-					}
-				} else { //parents and childern
-					if(iscycle && !islom) { //3          a <cycle 1> [5]
-						// warning
-						sscanf((const char*)readlinetext.mb_str(conv),"%d %[^\n]s",&line->called0,nameandid);
-						wxString readlinesubtext(nameandid, conv);
-						line->name = readlinesubtext.BeforeFirst(wxT('<'));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('<')).BeforeFirst(wxT('>')),wxT("cycle %d"), &line->cycleid);
-						//line->cycleid = readlinesubtext.AfterFirst('<').BeforeFirst('>');
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-
-						line->cycle = true;
-						line->recursive = false;
-
-					} else if(!iscycle && islom) { // 0        0    6/6        c [6]
-						sscanf((const char*)readlinetext.mb_str(conv),"%f %f %d/%d %[^\n]s",&line->self,&line->children,&line->called0,&line->called1,nameandid);
-						wxString readlinesubtext(nameandid, conv);
-						line->name = (wxString)readlinesubtext.BeforeFirst(wxT('['));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-
-						line->cycle = false;
-						line->recursive = false;
-						//
-					} else if(iscycle && islom) { //1.77        0    1/1        a <cycle 1> [5]
-						sscanf((const char*)readlinetext.mb_str(conv),"%f %f %d/%d %[^\n]s",&line->self,&line->children,&line->called0,&line->called1,nameandid);
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('<'));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('<')).BeforeFirst(wxT('>')),wxT("cycle %d"), &line->cycleid);
-						//line->cycleid = readlinesubtext.AfterFirst('<').BeforeFirst('>');
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-
-						line->cycle = true;
-						line->recursive = false;
-
-					} else if(!iscycle && !islom && !isdot) { //15             faktorial(int) [8]
-						sscanf((const char*)readlinetext.mb_str(conv),"%d %[^\n]s",&line->called0,nameandid);
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-
-						line->cycle = false;
-						line->recursive = true;
-
-					}
-					/*else if(!iscycle && !islom)
-					{
-						sscanf((const char*)readlinetext.mb_str(conv),"%f %f %d %[^\n]s",&line->self,&line->childern,&line->called0,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst('[');
-						//
-						wxSscanf(readlinesubtext.AfterFirst('[').BeforeFirst(']'),"%d",&line->nameid);
-
-						line->cycle = false;
-						line->recursive = false;
-						//
-					}*/
-
-					if (primaryline) {
-						line->parents = false;
-						line->pline = false;
-						line->child = true;
-					} else {
-						line->parents = true;
-						line->pline = false;
-						line->child = false;
-					}
-				}
-				
-				lines.Append( line );
-				calls[ wxRound(line->time) ] = calls[ wxRound(line->time) ] + 1;
-			}
-		} else if (lineheader) {
-			break;
-		}
-	}
-
-	delete [] nameandid;
+    end = TrimRight(line, end);
+
+    if(!m_inCallGraph) {
+        static const char header[] = "index % time";
+        const char* p = SkipSpaces(line, end);
+        m_inCallGraph = (size_t)(end - p) >= sizeof(header) - 1 && memcmp(p, header, sizeof(header) - 1) == 0;
+        return;
+    }
+
+    if(line == end) {
+        // the call graph ends with an empty line
+        m_done = true;
+        return;
+    }
+
+    if(*line == '-') {
+        // entries separator
+        m_inEntry = false;
+        m_entryIndex = -1;
+        return;
+    }
+
+    LineFields fields;
+    if(!SplitLine(line, end, fields)) {
+        return;
+    }
+
+    if(fields.index != -1) {
+        if(fields.columnCount < 3) {
+            return;
+        }
+        CallGraphNode node;
+        node.index = fields.index;
+        node.time = ParseFloat(fields.columns[0], fields.columnsEnd[0]);
+
+        int time = wxRound(node.time);
+        ++m_timeHistogram[time];
+        if(node.time > m_graph.GetMaxTime()) {
+            m_graph.SetMaxTime(node.time);
+        }
+
+        m_inEntry = true;
+        m_entryIndex = -1;
+        if(time < m_nodeThreshold) {
+            return;
+        }
+
+        node.self = ParseFloat(fields.columns[1], fields.columnsEnd[1]);
+        node.children = ParseFloat(fields.columns[2], fields.columnsEnd[2]);
+        if(fields.columnCount > 3) {
+            ParseCalled(fields.columns[3], fields.columnsEnd[3], node.called0, node.called1);
+        }
+        node.name = MakeName(fields.name, fields.nameEnd);
+        m_graph.AddNode(node);
+
+        if(time >= m_edgeThreshold) {
+            m_entryIndex = node.index;
+        }
+
+    } else if(m_inEntry && m_entryIndex != -1 && fields.columnCount > 0) {
+        // a callee of the primary function (the lines above the primary line are its callers)
+        // whether the callee itself is stored is known once all the primary lines are parsed
+        CallGraphEdge edge;
+        edge.from = m_entryIndex;
+        edge.to = fields.nameId;
+        int unused = -1;
+        size_t called = fields.columnCount - 1;
+        ParseCalled(fields.columns[called], fields.columnsEnd[called], edge.calls, unused);
+        m_graph.AddEdge(edge);
+    }
 }
 
-int GprofParser::GetSuggestedNodeThreshold()
+int GprofParser::GetSuggestedNodeThreshold() const
 {
-	sortedCalls.Clear();
-	
-	for( OccurrenceMap::iterator it = calls.begin(); it != calls.end(); ++it )
-		sortedCalls.Add( it->first );
-		
-	sortedCalls.Sort(cmpint);
-	int totalCount = 0;
-	int minCallTime = INT_MAX;
-	
-	for( size_t i = 0; i < sortedCalls.GetCount() && totalCount < 100; ++i )
-	{
-		totalCount += calls[ sortedCalls[i] ];
-		if( totalCount < 100 && sortedCalls[i] < minCallTime  ) minCallTime = sortedCalls[i];
-	}
-	
-	if( minCallTime < 0 ) minCallTime = 0;
-	else if( minCallTime > 100 ) minCallTime = 100;
-	
-	if( sortedCalls.GetCount() > 1 && totalCount >= 100 ) return minCallTime;
-	else
-		return -1;
+    // the histogram is sorted by the time, highest first
+    int totalCount = 0;
+    int minCallTime = INT_MAX;
+
+    for(const auto& bucket : m_timeHistogram) {
+        if(totalCount >= 100) {
+            break;
+        }
+        totalCount += bucket.second;
+        if(totalCount < 100 && bucket.first < minCallTime) {
+            minCallTime = bucket.first;
+        }
+    }
+
+    if(minCallTime < 0) {
+        minCallTime = 0;
+    } else if(minCallTime > 100) {
+        minCallTime = 100;
+    }
+
+    if(m_timeHistogram.size() > 1 && totalCount >= 100) {
+        return minCallTime;
+    }
+    return -1;
 }
@@ -33,58 +33,71 @@
  * Notes:
  **************************************************************/
 
-#include <wx/wx.h>
-#include <wx/string.h> 
-#include <wx/stream.h>
-#include <wx/txtstrm.h>
-#include <wx/hashmap.h>
+#ifndef GPROFPARSER_H
+#define GPROFPARSER_H
 
-#include "lineparser.h"
+#include "callgraphdata.h"
 
-WX_DECLARE_HASH_MAP(int, int, wxIntegerHash, wxIntegerEqual, OccurrenceMap);
+#include <functional>
+#include <map>
+#include <string>
 
 /**
  * @class GprofParser
- * @brief Class define structure for parser to read stream of data from gprof tool.
+ * @brief Streaming parser of the call graph printed by the gprof tool.
+ *
+ * The output is passed in chunks of any size as gprof writes it, an incomplete last line is kept until the next chunk
+ * arrives. The lines are split by hand (no regular expressions, no intermediate strings) straight into a compact
+ * CallGraphData; the functions and the calls below the thresholds are dropped while parsing.
  */
 class GprofParser
 {
-private:
-	wxString readlinetext;
-	wxString readlinetexttemp;
-	bool lineheader;
-	bool primaryline;
-	int nameLen;
-	char *nameandid;
-	bool isdot;
-	bool iscycle;
-	bool islom;
-	bool isplus;	
-	bool isspontaneous;	
-	
-	OccurrenceMap calls;
-	wxArrayInt sortedCalls;
-	
 public:
-	/**
-	 * @brief Default constructor.
-	 */
-	GprofParser();
-	/**
-	 * @brief Default destructor.
-	 */
-	~GprofParser();
-	/**
-	 * @brief  List lines type LineParserList.
-	 */
-	LineParserList lines;
-	/**
-	 * @brief Function is reading the input stream from gprof application and scan the rows to save to collection of objects lines. 
-	 * @param m_pInputStream pointer of type wxInputStream. 
-	 */
-	void GprofParserStream(wxInputStream *m_pInputStream);
-	/**
-	 * @brief Suggest call diagram's node threshold so no more than 100 items should be displayed at once.
-	 */
-	int GetSuggestedNodeThreshold();
+    /**
+     * @brief Default constructor.
+     */
+    GprofParser();
+    /**
+     * @brief Default destructor.
+     */
+    ~GprofParser();
+    /**
+     * @brief Set the node and edge thresholds (in percents of the total time) applied while parsing.
+     */
+    void SetThresholds(int nodeThreshold, int edgeThreshold);
+    /**
+     * @brief Parse next chunk of the gprof output.
+     */
+    void Parse(const char* data, size_t length);
+    /**
+     * @brief Parse the rest of the output and finalize the call graph.
+     */
+    void Finish();
+    /**
+     * @brief Return true if the call graph section was found in the gprof output.
+     */
+    bool IsCallGraphFound() const { return m_inCallGraph; }
+    /**
+     * @brief Return the parsed call graph.
+     */
+    const CallGraphData& GetGraph() const { return m_graph; }
+    /**
+     * @brief Suggest call diagram's node threshold so no more than 100 items should be displayed at once.
+     */
+    int GetSuggestedNodeThreshold() const;
+
+protected:
+    void ParseLine(const char* line, const char* end);
+
+    std::string m_buffer; ///< output which was not processed yet (incomplete line)
+    bool m_inCallGraph;   ///< the header of the call graph was found
+    bool m_done;          ///< the end of the call graph was reached, the rest of the output is ignored
+    bool m_inEntry;       ///< the primary line of the current entry was parsed, the next lines are its callees
+    int m_entryIndex;     ///< index of the current primary node if its calls are stored, -1 otherwise
+    int m_nodeThreshold;
+    int m_edgeThreshold;
+    std::map<int, int, std::greater<int>> m_timeHistogram; ///< number of functions per rounded time
+    CallGraphData m_graph;
 };
+
+#endif // GPROFPARSER_H
@@ -24,7 +24,6 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "callgraph.h"
-#include "fileutils.h"
 #include "uicallgraphpanel.h"
 #include "workspace.h"
 #include <wx/bitmap.h>
@@ -34,8 +33,9 @@
 #include <wx/xrc/xmlres.h>
 
 uicallgraphpanel::uicallgraphpanel(wxWindow* parent, IManager* mgr, const wxString& imagepath,
-                                   const wxString& projectpath, int suggestedThreshold, LineParserList* pLines)
+                                   const wxString& projectpath, int suggestedThreshold, const CallGraphData& graph)
     : uicallgraph(parent)
+    , m_graph(graph)
 {
     m_mgr = mgr;
     m_pathimage = imagepath;
@@ -45,11 +45,6 @@ uicallgraphpanel::uicallgraphpanel(wxWindow* parent, IManager* mgr, const wxStri
     m_scrolledWindow->SetBackgroundColour(wxColour(255, 255, 255));
     m_scrolledWindow->SetBackgroundStyle(wxBG_STYLE_PAINT);
 
-    // copy lines to local storage
-    m_lines.DeleteContents(true);
-    for(LineParserList::iterator it = pLines->begin(); it != pLines->end(); ++it)
-        m_lines.Append((*it)->Clone());
-
     if(m_bmpOrig.LoadFile(m_pathimage, wxBITMAP_TYPE_PNG)) UpdateImage();
 
     m_mgr->GetConfigTool()->ReadObject(wxT("CallGraph"), &confData);
@@ -57,6 +52,9 @@ uicallgraphpanel::uicallgraphpanel(wxWindow* parent, IManager* mgr, const wxStri
 
     CreateAndInserDataToTable(suggestedThreshold);
 
+    // the nodes and the edges below the thresholds the graph was parsed with are not available
+    m_spinNT->SetRange(m_graph.GetNodeThreshold(), 100);
+    m_spinET->SetRange(m_graph.GetEdgeThreshold(), 100);
     m_spinNT->SetValue(suggestedThreshold);
     m_spinET->SetValue(confData.GetTresholdEdge());
     m_checkBoxHP->SetValue(confData.GetHideParams());
@@ -64,7 +62,7 @@ uicallgraphpanel::uicallgraphpanel(wxWindow* parent, IManager* mgr, const wxStri
     m_grid->Update();
 }
 
-uicallgraphpanel::~uicallgraphpanel() { m_lines.Clear(); }
+uicallgraphpanel::~uicallgraphpanel() { m_renderer.Cancel(); }
 
 void uicallgraphpanel::OnPaint(wxPaintEvent& event)
 {
@@ -99,45 +97,45 @@ void uicallgraphpanel::OnClosePanel(wxCommandEvent& event)
 
 int uicallgraphpanel::CreateAndInserDataToTable(int node_thr)
 {
-    LineParserList::compatibility_iterator it = m_lines.GetFirst();
-    int nr = 0;
-    float max_time = -2;
-
-    while(it) {
-        LineParser* line = it->GetData();
-
-        if(max_time < line->time) max_time = line->time;
-
-        if(line->pline && wxRound(line->time) >= node_thr) {
-            m_grid->AppendRows(1, true);
-            // name   time %   self  children    called
-            m_grid->SetCellValue(nr, 0, line->name);
-            m_grid->SetCellValue(nr, 1, wxString::Format(wxT("%.2f"), line->time));
-            m_grid->SetCellValue(nr, 2, wxString::Format(wxT("%.2f"), line->self + line->children));
+    int rows = 0;
+    for(const CallGraphNode& node : m_graph.GetNodes()) {
+        if(wxRound(node.time) >= node_thr) rows++;
+    }
 
-            int callsum;
-            if(line->called0 != -1) {
-                callsum = line->called0;
-                if(line->called1 != -1) callsum += line->called1;
-            } else
-                callsum = 1;
+    m_grid->BeginBatch();
+    m_grid->AppendRows(rows, true);
 
-            m_grid->SetCellValue(nr, 3, wxString::Format(wxT("%i"), callsum));
-            nr++;
-        }
-        it = it->GetNext();
+    int nr = 0;
+    for(const CallGraphNode& node : m_graph.GetNodes()) {
+        if(wxRound(node.time) < node_thr) continue;
+
+        // name   time %   self  children    called
+        m_grid->SetCellValue(nr, 0, node.name);
+        m_grid->SetCellValue(nr, 1, wxString::Format(wxT("%.2f"), node.time));
+        m_grid->SetCellValue(nr, 2, wxString::Format(wxT("%.2f"), node.self + node.children));
+
+        int callsum;
+        if(node.called0 != -1) {
+            callsum = node.called0;
+            if(node.called1 != -1) callsum += node.called1;
+        } else
+            callsum = 1;
+
+        m_grid->SetCellValue(nr, 3, wxString::Format(wxT("%i"), callsum));
+        nr++;
     }
+    m_grid->EndBatch();
 
-    return wxRound(max_time);
+    return wxRound(m_graph.GetMaxTime());
 }
 
 void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
 {
-    if(m_grid->GetNumberRows()) m_grid->DeleteRows(0, (m_grid->GetNumberRows() - 1));
+    if(m_grid->GetNumberRows()) m_grid->DeleteRows(0, m_grid->GetNumberRows());
 
     // write to output png file
     DotWriter dw;
-    dw.SetLineParser(&m_lines);
+    dw.SetCallGraph(&m_graph);
     dw.SetDotWriterFromDetails(confData.GetColorsNode(), confData.GetColorsEdge(), m_spinNT->GetValue(),
                                m_spinET->GetValue(), m_checkBoxHP->GetValue(), confData.GetStripParams(),
                                m_checkBoxHN->GetValue());
@@ -151,16 +149,9 @@ void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
     wxString dot_fn = cfn.GetFullPath();
 
     bool ok = dw.SendToDotAppOutputDirectory(dot_fn);
-    if(ok) { // delete any existing PNG
-        if(wxFileExists(m_pathimage)) { clRemoveFile(m_pathimage); }
-
-        wxString cmddot_ln;
-
-        cmddot_ln << confData.GetDotPath() << " -Tpng -o" << m_pathimage << " " << dot_fn;
-
-        wxExecute(cmddot_ln, wxEXEC_SYNC | wxEXEC_HIDE_CONSOLE);
-
-        if(m_bmpOrig.LoadFile(m_pathimage, wxBITMAP_TYPE_PNG)) UpdateImage();
+    if(ok) { // render in the background, a previous request still in progress is cancelled
+        m_renderer.Start(confData.GetDotPath(), dot_fn, m_pathimage,
+                         [this](bool rendered) { OnImageRendered(rendered); });
 
     } else
         wxMessageBox(_("CallGraph failed to save file with DOT language, please build the project again."),
@@ -170,6 +161,11 @@ void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
     CreateAndInserDataToTable(m_spinNT->GetValue());
 }
 
+void uicallgraphpanel::OnImageRendered(bool ok)
+{
+    if(ok && m_bmpOrig.LoadFile(m_pathimage, wxBITMAP_TYPE_PNG)) UpdateImage();
+}
+
 void uicallgraphpanel::UpdateImage()
 {
     wxBusyCursor busy;
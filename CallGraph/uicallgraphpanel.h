@@ -36,8 +36,9 @@
 #ifndef UICALLGRAPHPANEL_H
 #define UICALLGRAPHPANEL_H
 
-#include "lineparser.h"
+#include "callgraphdata.h"
 #include "confcallgraph.h"
+#include "dotrenderer.h"
 #include "plugin.h"
 #include "uicallgraph.h" // Base class: uicallgraph
 
@@ -46,7 +47,7 @@ class uicallgraphpanel : public uicallgraph
 {
 
 public:
-	uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxString& imagepath, const wxString& projectpath, int suggestedThreshold, LineParserList *pLines);
+	uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxString& imagepath, const wxString& projectpath, int suggestedThreshold, const CallGraphData& graph);
 	virtual ~uicallgraphpanel();
 
 protected:
@@ -65,13 +66,15 @@ protected:
 
 	int CreateAndInserDataToTable(int nodethr);	// returns min_threshold
 	void UpdateImage();
+	void OnImageRendered(bool ok);
 
 	wxBitmap m_bmpOrig;
 	wxBitmap m_bmpScaled;
 	IManager *m_mgr;
 	wxString m_pathimage;
 	wxString m_pathproject;
-	LineParserList m_lines;
+	CallGraphData m_graph;
+	DotRenderer m_renderer; // renders the graph again when the thresholds are changed
 	ConfCallGraph confData; // stored configuration data
 	wxPoint m_viewPortOrigin;
 	wxPoint m_startigPoint;
@@ -104,9 +104,10 @@ bool GenericFormatter::SyncFormat(const wxString& cmd, const wxString& wd, bool
 }
 
 /**
- * @brief format source file using background thread, when the formatting is done, fire an event to the sink object
+ * @brief format source file using background thread, when the formatting is done, fire an event to the sink object.
+ * Return false if the formatter process could not be started, in which case no event is fired
  */
-void GenericFormatter::AsyncFormat(const wxString& cmd, const wxString& wd, const wxString& filepath,
+bool GenericFormatter::AsyncFormat(const wxString& cmd, const wxString& wd, const wxString& filepath,
                                    bool inplace_formatter, wxEvtHandler* sink)
 {
     clDirChanger cd{ wd };
@@ -116,9 +117,12 @@ void GenericFormatter::AsyncFormat(const wxString& cmd, const wxString& wd, cons
     EnvSetter setter{ envlist.get() };
 
     long pid = wxNOT_FOUND;
-    if (ProcUtils::ShellExecAsync(cmd, &pid, this)) {
-        m_pid_commands.insert({ pid, CommandMetadata{ cmd, filepath, sink } });
+    if (!ProcUtils::ShellExecAsync(cmd, &pid, this)) {
+        clWARNING() << "Failed to launch formatter:" << cmd << endl;
+        return false;
     }
+    m_pid_commands.insert({ pid, CommandMetadata{ cmd, filepath, sink } });
+    return true;
 }
 
 bool GenericFormatter::DoFormatFile(const wxString& filepath, wxEvtHandler* sink, wxString* output)
@@ -132,8 +136,7 @@ bool GenericFormatter::DoFormatFile(const wxString& filepath, wxEvtHandler* sink
     wxBusyCursor bc;
     if (sink) {
         clDEBUG() << "Formatting file (async):" << filepath << "Working dir:" << wd << "Calling:" << cmd << endl;
-        AsyncFormat(cmd, wd, filepath, IsInplaceFormatter(), sink);
-        return true;
+        return AsyncFormat(cmd, wd, filepath, IsInplaceFormatter(), sink);
     } else {
         clDEBUG() << "Formatting file (sync):" << filepath << "Working dir:" << wd << "Calling:" << cmd << endl;
         return SyncFormat(cmd, wd, IsInplaceFormatter(), output);
@@ -251,6 +254,13 @@ void GenericFormatter::OnAsyncShellProcessTerminated(clShellProcessEvent& event)
         wxString errmsg;
         errmsg << wxT("\u26A0") << _(" format error. Process exit code: ") << event.GetExitCode();
         clGetManager()->SetStatusMessage(errmsg, 3);
+
+        // let the sink know that this file is done
+        if (command_data.m_sink) {
+            clSourceFormatEvent format_failed_event{ wxEVT_FORMAT_FAILED };
+            format_failed_event.SetFileName(command_data.m_filepath);
+            command_data.m_sink->QueueEvent(format_failed_event.Clone());
+        }
         return;
     }
 
@@ -34,6 +34,7 @@ enum class FormatterFlags {
 
 wxDECLARE_EVENT(wxEVT_FORMAT_COMPELTED, clSourceFormatEvent);
 wxDECLARE_EVENT(wxEVT_FORMAT_INPLACE_COMPELTED, clSourceFormatEvent);
+wxDECLARE_EVENT(wxEVT_FORMAT_FAILED, clSourceFormatEvent);
 
 class SourceFormatterBase : public wxEvtHandler
 {
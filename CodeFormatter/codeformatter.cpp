@@ -43,6 +43,7 @@
 #include "macros.h"
 #include "workspace.h"
 
+#include <algorithm>
 #include <thread>
 #include <wx/app.h> //wxInitialize/wxUnInitialize
 #include <wx/ffile.h>
@@ -142,6 +143,9 @@ CodeFormatter::CodeFormatter(IManager* manager)
 
     Bind(wxEVT_FORMAT_INPLACE_COMPELTED, &CodeFormatter::OnInplaceFormatCompleted, this);
     Bind(wxEVT_FORMAT_COMPELTED, &CodeFormatter::OnFormatCompleted, this);
+    Bind(wxEVT_FORMAT_FAILED, &CodeFormatter::OnFormatFailed, this);
+    m_mgr->GetInfoBar()->Bind(wxEVT_BUTTON, &CodeFormatter::OnCancelBatchFormat, this,
+                              XRCID("formatter-cancel-batch"));
 
     clKeyboardManager::Get()->AddAccelerator(
         _("Source Code Formatter"),
@@ -344,6 +348,9 @@ void CodeFormatter::UnPlug()
 
     Unbind(wxEVT_FORMAT_INPLACE_COMPELTED, &CodeFormatter::OnInplaceFormatCompleted, this);
     Unbind(wxEVT_FORMAT_COMPELTED, &CodeFormatter::OnFormatCompleted, this);
+    Unbind(wxEVT_FORMAT_FAILED, &CodeFormatter::OnFormatFailed, this);
+    m_mgr->GetInfoBar()->Unbind(wxEVT_BUTTON, &CodeFormatter::OnCancelBatchFormat, this,
+                                XRCID("formatter-cancel-batch"));
 }
 
 IManager* CodeFormatter::GetManager() { return m_mgr; }
@@ -432,23 +439,150 @@ void CodeFormatter::BatchFormat(const std::vector<wxString>& files, bool silent)
         }
     }
 
-    for (size_t i = 0; i < files.size(); ++i) {
-        wxString msg;
-        msg << "Formatting file: " << (i + 1) << "/" << files.size() << " " << files[i];
-        if (!silent) {
-            clGetManager()->SetStatusMessage(msg, 1);
-            wxSafeYield();
+    m_batchSilent = silent;
+    if (!silent) {
+        clGetManager()->SetStatusMessage(_("Code Formatter: checking for modified files..."));
+    }
+
+    // Reading the files to compare their checksums takes a while for a large project, do it in the background
+    std::thread thr(
+        [](const std::vector<wxString>& files,
+           const std::unordered_map<wxString, size_t>& checksums,
+           CodeFormatter* formatter) {
+            std::vector<wxString> modified;
+            modified.reserve(files.size());
+            for (const wxString& file : files) {
+                size_t checksum = 0;
+                auto iter = checksums.find(file);
+                if (iter != checksums.end() && FileUtils::GetChecksum(file, &checksum) && checksum == iter->second) {
+                    // not modified since we formatted it
+                    continue;
+                }
+                modified.push_back(file);
+            }
+            formatter->CallAfter(&CodeFormatter::OnBatchChecksumsReady, modified, files.size() - modified.size());
+        },
+        files,
+        m_formattedChecksums,
+        this);
+    thr.detach();
+}
+
+void CodeFormatter::OnBatchChecksumsReady(const std::vector<wxString>& files, size_t unchanged)
+{
+    bool wasIdle = m_batchQueue.empty() && m_batchInFlight.empty();
+    if (wasIdle) {
+        m_batchCancelled = false;
+    }
+
+    m_batchTotal += files.size() + unchanged;
+    m_batchDone += unchanged;
+    m_batchUnchanged += unchanged;
+    m_batchQueue.insert(m_batchQueue.end(), files.begin(), files.end());
+
+    if (wasIdle && !m_batchSilent && !m_batchQueue.empty()) {
+        m_mgr->DisplayMessage(_("Source Code Formatter: formatting files in the background"),
+                              wxICON_INFORMATION,
+                              { { XRCID("formatter-cancel-batch"), _("Cancel") } });
+    }
+
+    DoBatchFormatNext();
+    if (m_batchQueue.empty() && m_batchInFlight.empty()) {
+        DoBatchFormatFinished();
+    }
+}
+
+void CodeFormatter::DoBatchFormatNext()
+{
+    // Every file is formatted by its own process, keep one process per core running
+    const size_t maxProcesses = std::max<size_t>(1, std::thread::hardware_concurrency());
+    while (!m_batchQueue.empty() && m_batchInFlight.size() < maxProcesses) {
+        wxString filepath = m_batchQueue.front();
+        m_batchQueue.pop_front();
+
+        if (m_batchInFlight.count(filepath)) {
+            // the same file was queued twice
+            ++m_batchDone;
+            continue;
+        }
+
+        // the formatter notifies us when done: OnFormatCompleted, OnInplaceFormatCompleted or OnFormatFailed
+        m_batchInFlight.insert(filepath);
+        if (!DoFormatFile(filepath, false)) {
+            m_batchInFlight.erase(filepath);
+            ++m_batchDone;
+            ++m_batchFailed;
         }
-        DoFormatFile(files[i], false);
     }
+}
 
-    if (!silent) {
-        clGetManager()->SetStatusMessage(wxString() << _("Successfully formatted ") << files.size() << _(" files"), 3);
-        wxSafeYield();
+void CodeFormatter::DoBatchFileDone(const wxString& filepath, bool success)
+{
+    if (m_batchInFlight.erase(filepath) == 0) {
+        // not part of a batch
+        return;
+    }
+
+    ++m_batchDone;
+    size_t checksum = 0;
+    if (success && FileUtils::GetChecksum(filepath, &checksum)) {
+        m_formattedChecksums[filepath] = checksum;
+    } else if (!success) {
+        ++m_batchFailed;
+    }
+
+    if (!m_batchSilent) {
+        wxString msg;
+        msg << _("Code Formatter: ") << m_batchDone << "/" << m_batchTotal << _(" files");
+        clGetManager()->SetStatusMessage(msg);
+    }
+
+    DoBatchFormatNext();
+    if (m_batchQueue.empty() && m_batchInFlight.empty()) {
+        DoBatchFormatFinished();
+    }
+}
+
+void CodeFormatter::DoBatchFormatFinished()
+{
+    if (!m_batchSilent) {
+        if (m_mgr->GetInfoBar()->IsShown()) {
+            m_mgr->GetInfoBar()->Dismiss();
+        }
+
+        wxString msg;
+        msg << (m_batchCancelled ? _("Code Formatter: cancelled. Formatted ") : _("Successfully formatted "))
+            << (m_batchDone - m_batchUnchanged - m_batchFailed) << _(" files");
+        if (m_batchUnchanged) {
+            msg << ", " << m_batchUnchanged << _(" unchanged since the last format");
+        }
+        if (m_batchFailed) {
+            msg << ", " << m_batchFailed << _(" failed");
+        }
+        clGetManager()->SetStatusMessage(msg, 3);
     }
+
+    m_batchTotal = 0;
+    m_batchDone = 0;
+    m_batchFailed = 0;
+    m_batchUnchanged = 0;
     EventNotifier::Get()->PostReloadExternallyModifiedEvent(false);
 }
 
+void CodeFormatter::OnCancelBatchFormat(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    m_mgr->GetInfoBar()->Dismiss();
+    EventNotifier::Get()->TopFrame()->SendSizeEvent(wxSEND_EVENT_POST);
+
+    // the files that are being formatted right now are left to complete
+    m_batchCancelled = true;
+    m_batchQueue.clear();
+    if (m_batchInFlight.empty()) {
+        DoBatchFormatFinished();
+    }
+}
+
 void CodeFormatter::OnScanFilesCompleted(const std::vector<wxString>& files) { BatchFormat(files, false); }
 
 void CodeFormatter::OnWorkspaceLoaded(clWorkspaceEvent& e)
@@ -561,6 +695,7 @@ void CodeFormatter::OnFormatCompleted(clSourceFormatEvent& event)
             FileUtils::WriteFileContent(filepath, event.GetFormattedString());
         }
     }
+    DoBatchFileDone(filepath, true);
 }
 
 void CodeFormatter::OnInplaceFormatCompleted(clSourceFormatEvent& event)
@@ -581,6 +716,13 @@ void CodeFormatter::OnInplaceFormatCompleted(clSourceFormatEvent& event)
     event_modified.SetFileName(filepath);
     event_modified.SetIsRemoteFile(!wxFileName::FileExists(filepath));
     EventNotifier::Get()->AddPendingEvent(event_modified);
+    DoBatchFileDone(filepath, true);
+}
+
+void CodeFormatter::OnFormatFailed(clSourceFormatEvent& event)
+{
+    event.Skip();
+    DoBatchFileDone(event.GetFileName(), false);
 }
 
 void CodeFormatter::OnInitDone(wxCommandEvent& e)
@@ -31,13 +31,27 @@
 #include "fileextmanager.h"
 #include "plugin.h"
 
+#include <deque>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 class CodeFormatter : public IPlugin
 {
     CodeFormatterManager m_manager;
     std::shared_ptr<CodeLiteRemoteHelper> m_remoteHelper;
 
+    // batch formatting
+    std::deque<wxString> m_batchQueue;                         ///< files waiting for a formatter process
+    std::unordered_set<wxString> m_batchInFlight;              ///< files being formatted right now
+    std::unordered_map<wxString, size_t> m_formattedChecksums; ///< file checksums, as left by the last format
+    size_t m_batchTotal = 0;
+    size_t m_batchDone = 0;
+    size_t m_batchFailed = 0;
+    size_t m_batchUnchanged = 0;
+    bool m_batchSilent = true;
+    bool m_batchCancelled = false;
+
 protected:
     wxString m_selectedFolder;
 
@@ -48,17 +62,27 @@ private:
     bool DoFormatString(const wxString& content, const wxString& fileName, wxString* output);
     bool DoFormatEditor(IEditor* editor);
     void OnScanFilesCompleted(const std::vector<wxString>& files);
+    void OnBatchChecksumsReady(const std::vector<wxString>& files, size_t unchanged);
+    /**
+     * @brief start formatting queued files, as long as there is a free slot in the process pool
+     */
+    void DoBatchFormatNext();
+    void DoBatchFileDone(const wxString& filepath, bool success);
+    void DoBatchFormatFinished();
+    void OnCancelBatchFormat(wxCommandEvent& event);
     void OnWorkspaceLoaded(clWorkspaceEvent& e);
     void OnWorkspaceClosed(clWorkspaceEvent& e);
     void OnFileSaved(clCommandEvent& e);
 
     void OnFormatCompleted(clSourceFormatEvent& event);
     void OnInplaceFormatCompleted(clSourceFormatEvent& event);
+    void OnFormatFailed(clSourceFormatEvent& event);
     void OnInitDone(wxCommandEvent& e);
 
 public:
     /**
-     * @brief format list of files
+     * @brief format list of files. The files are formatted in the background by a pool of formatter processes,
+     * files that were not modified since we last formatted them are skipped
      */
     void BatchFormat(const std::vector<wxString>& files, bool silent = true);
     void OnContextMenu(clContextMenuEvent& event);
@@ -12,6 +12,11 @@
 #include "fileutils.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stopwatch.h>
@@ -23,6 +28,9 @@ wxDEFINE_EVENT(wxPHP_PARSE_PROGRESS, clParseEvent);
 
 static wxString PHP_SCHEMA_VERSION = "9.3.0.1";
 
+// Number of files stored in a single transaction by RecreateSymbolsDatabase()
+static const size_t PHP_FILES_PER_TRANSACTION = 250;
+
 //------------------------------------------------
 // Metadata table
 //------------------------------------------------
@@ -163,6 +171,7 @@ const static wxString CREATE_FILES_TABLE_SQL_IDX1 =
 
 PHPLookupTable::PHPLookupTable()
     : m_sizeLimit(50)
+    , m_parserThreads(0)
 {
 }
 
@@ -1312,18 +1321,26 @@ void PHPLookupTable::DoFixVarsDocComment(PHPEntityBase::List_t& matches, wxLongL
 
 void PHPLookupTable::UpdateClassCache(const wxString& classname)
 {
+    std::lock_guard<std::mutex> lock(m_allClassesMutex);
     if(m_allClasses.count(classname) == 0) {
         m_allClasses.insert(classname);
     }
 }
 
-bool PHPLookupTable::ClassExists(const wxString& classname) const { return m_allClasses.count(classname) != 0; }
+bool PHPLookupTable::ClassExists(const wxString& classname) const
+{
+    std::lock_guard<std::mutex> lock(m_allClassesMutex);
+    return m_allClasses.count(classname) != 0;
+}
 
 void PHPLookupTable::RebuildClassCache()
 {
     // locate the scope
     clDEBUG() << "Rebuilding PHP class cache..." << clEndl;
-    m_allClasses.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_allClassesMutex);
+        m_allClasses.clear();
+    }
     size_t count = 0;
     try {
         wxString sql;
@@ -1365,3 +1382,110 @@ size_t PHPLookupTable::FindFunctionsByFile(const wxFileName& filename, PHPEntity
     }
     return functions.size();
 }
+
+void PHPLookupTable::DoParseAndStoreFiles(const std::vector<wxFileName>& files, bool parseFuncBodies,
+                                          const std::function<bool()>& goingDown,
+                                          const std::function<void(const wxFileName&)>& onFileStored)
+{
+    if(files.empty()) {
+        return;
+    }
+
+    size_t threadCount = m_parserThreads ? m_parserThreads : std::thread::hardware_concurrency();
+    threadCount = std::max<size_t>(1, std::min(threadCount, files.size()));
+    // Don't let the parser threads get too far ahead of the writer, a parsed file is kept in memory until it is stored
+    const size_t maxPending = threadCount * 4;
+
+    std::mutex mutex;
+    std::condition_variable resultReady;
+    std::condition_variable slotFree;
+    std::deque<std::unique_ptr<PHPSourceFile>> parsedFiles;
+    size_t runningThreads = threadCount;
+    bool stop = false;
+    std::atomic_size_t nextFile(0);
+
+    auto parser = [&]() {
+        while(true) {
+            size_t index = nextFile++;
+            if(index >= files.size()) {
+                break;
+            }
+
+            // For performance reasons, load the file into memory and then parse it
+            const wxFileName& fnSourceFile = files[index];
+            wxString content;
+            if(!FileUtils::ReadFileContent(fnSourceFile, content, wxConvISO8859_1)) {
+                clWARNING() << "PHP: Failed to read file:" << fnSourceFile << "for parsing" << clEndl;
+                continue;
+            }
+            std::unique_ptr<PHPSourceFile> sourceFile(new PHPSourceFile(content, this));
+            sourceFile->SetFilename(fnSourceFile);
+            sourceFile->SetParseFunctionBody(parseFuncBodies);
+            sourceFile->Parse();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            slotFree.wait(lock, [&]() { return stop || parsedFiles.size() < maxPending; });
+            if(stop) {
+                break;
+            }
+            parsedFiles.push_back(std::move(sourceFile));
+            resultReady.notify_one();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        --runningThreads;
+        resultReady.notify_one();
+    };
+
+    auto stopParsers = [&](std::vector<std::thread>& threads) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        slotFree.notify_all();
+        for(auto& thr : threads) {
+            thr.join();
+        }
+        threads.clear();
+    };
+
+    clDEBUG() << "PHP: parsing" << files.size() << "files using" << threadCount << "threads" << clEndl;
+
+    std::vector<std::thread> threads;
+    try {
+        for(size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(parser);
+        }
+
+        // The calling thread is the only one writing to the database
+        size_t storedFiles = 0;
+        while(!goingDown()) {
+            std::unique_ptr<PHPSourceFile> sourceFile;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                resultReady.wait(lock, [&]() { return !parsedFiles.empty() || runningThreads == 0; });
+                if(parsedFiles.empty()) {
+                    // all the files were parsed
+                    break;
+                }
+                sourceFile = std::move(parsedFiles.front());
+                parsedFiles.pop_front();
+            }
+            slotFree.notify_one();
+
+            onFileStored(sourceFile->GetFilename());
+            UpdateSourceFile(*sourceFile, false);
+
+            // Commit in batches: the changes become visible while parsing large workspaces and the transaction (and
+            // its journal) is kept small
+            if(++storedFiles % PHP_FILES_PER_TRANSACTION == 0) {
+                m_db.Commit();
+                m_db.Begin();
+            }
+        }
+    } catch(...) {
+        stopParsers(threads);
+        throw;
+    }
+    stopParsers(threads);
+}
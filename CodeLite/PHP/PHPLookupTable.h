@@ -36,6 +36,8 @@
 #include "fileutils.h"
 #include "wxStringHash.h"
 
+#include <functional>
+#include <mutex>
 #include <set>
 #include <unordered_set>
 #include <vector>
@@ -65,6 +67,8 @@ class WXDLLIMPEXP_CL PHPLookupTable
     wxFileName m_filename;
     size_t m_sizeLimit;
     std::unordered_set<wxString> m_allClasses;
+    mutable std::mutex m_allClassesMutex; // the parser threads look up classes while the writer adds them
+    size_t m_parserThreads;
 
 public:
     enum eLookupFlags {
@@ -156,6 +160,15 @@ private:
      */
     bool CheckDiskImage(wxSQLite3Database& db, const wxFileName& filename);
 
+    /**
+     * @brief parse `files` on a pool of worker threads and store them into the database. The database is accessed only
+     * by the calling thread, which commits the parsed files in batches
+     * @param onFileStored called (on the calling thread) for every file about to be stored
+     */
+    void DoParseAndStoreFiles(const std::vector<wxFileName>& files, bool parseFuncBodies,
+                              const std::function<bool()>& goingDown,
+                              const std::function<void(const wxFileName&)>& onFileStored);
+
 public:
     PHPLookupTable();
     virtual ~PHPLookupTable();
@@ -178,6 +191,12 @@ public:
 
     void SetSizeLimit(size_t sizeLimit) { this->m_sizeLimit = sizeLimit; }
 
+    /**
+     * @brief set the number of threads used by RecreateSymbolsDatabase() to parse the files. 0 (the default) means one
+     * thread per CPU core
+     */
+    void SetParserThreads(size_t parserThreads) { this->m_parserThreads = parserThreads; }
+
     /**
      * @brief return list of functions from a given file
      */
@@ -269,7 +288,7 @@ public:
     void UpdateSourceFile(PHPSourceFile& source, bool autoCommit = true);
 
     /**
-     * @brief update list of source files
+     * @brief update list of source files. The files are parsed in parallel (see SetParserThreads())
      */
     template <typename GoindDownFunc>
     void RecreateSymbolsDatabase(const wxArrayString& files, eUpdateMode updateMode, GoindDownFunc pFuncGoingDown,
@@ -310,19 +329,19 @@ void PHPLookupTable::RecreateSymbolsDatabase(const wxArrayString& files, eUpdate
         wxStopWatch sw;
         sw.Start();
 
-        m_allClasses.clear(); // clear the cache
-        m_db.Begin();
+        {
+            std::lock_guard<std::mutex> lock(m_allClassesMutex);
+            m_allClasses.clear(); // clear the cache
+        }
+
+        // Collect the files that need to be parsed. This is done here and not by the parser threads since it requires
+        // the database
+        std::vector<wxFileName> filesToParse;
+        filesToParse.reserve(files.GetCount());
         for(size_t i = 0; i < files.GetCount(); ++i) {
             if(pFuncGoingDown()) {
                 break;
             }
-            {
-                clParseEvent event(wxPHP_PARSE_PROGRESS);
-                event.SetTotalFiles(files.GetCount());
-                event.SetCurfileIndex(i);
-                event.SetFileName(files.Item(i));
-                EventNotifier::Get()->AddPendingEvent(event);
-            }
 
             wxFileName fnFile(files.Item(i));
             bool reParseNeeded(true);
@@ -353,20 +372,22 @@ void PHPLookupTable::RecreateSymbolsDatabase(const wxArrayString& files, eUpdate
             }
 
             if(reParseNeeded) {
-                // For performance reaons, load the file into memory and then parse it
-                wxFileName fnSourceFile(files.Item(i));
-                wxString content;
-                if(!FileUtils::ReadFileContent(fnSourceFile, content, wxConvISO8859_1)) {
-                    clWARNING() << "PHP: Failed to read file:" << fnSourceFile << "for parsing" << clEndl;
-                    continue;
-                }
-                PHPSourceFile sourceFile(content, this);
-                sourceFile.SetFilename(fnSourceFile);
-                sourceFile.SetParseFunctionBody(parseFuncBodies);
-                sourceFile.Parse();
-                UpdateSourceFile(sourceFile, false);
+                filesToParse.push_back(fnFile);
             }
         }
+
+        // The files that don't need to be parsed are reported as done
+        size_t curfileIndex = files.GetCount() - filesToParse.size();
+        m_db.Begin();
+        DoParseAndStoreFiles(
+            filesToParse, parseFuncBodies, [&]() { return pFuncGoingDown(); },
+            [&](const wxFileName& filename) {
+                clParseEvent event(wxPHP_PARSE_PROGRESS);
+                event.SetTotalFiles(files.GetCount());
+                event.SetCurfileIndex(curfileIndex++);
+                event.SetFileName(filename.GetFullPath());
+                EventNotifier::Get()->AddPendingEvent(event);
+            });
         m_db.Commit();
         long elapsedMs = sw.Time();
 
@@ -106,6 +106,7 @@ private:
     std::string m_string;
     int m_commentStartLine;
     int m_commentEndLine;
+    int m_bracketCount;
     bool m_insidePhp;
     FILE* m_fp;
 
@@ -117,6 +118,7 @@ public:
         }
         m_fp = NULL;
         m_insidePhp = false;
+        m_bracketCount = 0;
         ClearComment();
         m_rawStringLabel.clear();
         m_string.clear();
@@ -126,6 +128,7 @@ public:
         : m_flags(options)
         , m_commentStartLine(wxNOT_FOUND)
         , m_commentEndLine(wxNOT_FOUND)
+        , m_bracketCount(0)
         , m_insidePhp(false)
         , m_fp(NULL)
     {
@@ -155,6 +158,12 @@ public:
 
     void SetRawStringLabel(const std::string& rawStringLabel) { this->m_rawStringLabel = rawStringLabel; }
     const std::string& GetRawStringLabel() const { return m_rawStringLabel; }
+
+    /**
+     * @brief nesting level of the '[' brackets inside a PHP 8 attribute "#[...]"
+     */
+    void SetBracketCount(int bracketCount) { this->m_bracketCount = bracketCount; }
+    int GetBracketCount() const { return m_bracketCount; }
     //==--------------------
     // Comment management
     //==--------------------
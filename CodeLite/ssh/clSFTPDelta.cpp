@@ -0,0 +1,260 @@
+#include "clSFTPDelta.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <wx/tokenzr.h>
+
+namespace
+{
+constexpr uint32_t ADLER_MOD = 65521;
+constexpr char DELTA_MAGIC[] = "CLDELTA1";
+
+// Print the weak and strong checksums of every complete block of a file
+const char* CHECKSUMS_SCRIPT = R"(import sys,zlib
+n=int(sys.argv[2])
+with open(sys.argv[1],"rb") as f:
+    while True:
+        d=f.read(n)
+        if len(d)<n:
+            break
+        print(zlib.adler32(d)&0xffffffff,zlib.crc32(d)&0xffffffff)
+)";
+
+// Rebuild a file from the copy ("C") and literal ("D") instructions of a delta file. The original file is replaced
+// only if the result has the expected size and crc32
+const char* PATCH_SCRIPT = R"(import sys,os,zlib,struct
+src,dlt=sys.argv[1],sys.argv[2]
+tmp=src+".codelitedelta"
+try:
+    d=open(dlt,"rb")
+    if d.read(8)!=b"CLDELTA1":
+        sys.exit(1)
+    crc,size=struct.unpack("<IQ",d.read(12))
+    o=open(src,"rb")
+    c=0
+    with open(tmp,"wb") as out:
+        while True:
+            k=d.read(1)
+            if not k:
+                break
+            if k==b"C":
+                off,n=struct.unpack("<QQ",d.read(16))
+                o.seek(off)
+                x=o.read(n)
+            else:
+                n=struct.unpack("<Q",d.read(8))[0]
+                x=d.read(n)
+            if len(x)!=n:
+                sys.exit(1)
+            c=zlib.crc32(x,c)
+            out.write(x)
+    if (c&0xffffffff)!=crc or os.path.getsize(tmp)!=size:
+        sys.exit(1)
+    os.chmod(tmp,os.stat(src).st_mode&0o7777)
+    os.replace(tmp,src)
+    print("CLDELTA_OK")
+finally:
+    os.path.exists(tmp) and os.remove(tmp)
+    os.remove(dlt)
+)";
+
+wxString ShellQuote(const wxString& str)
+{
+    wxString quoted = str;
+    quoted.Replace("'", "'\\''");
+    return "'" + quoted + "'";
+}
+
+void AppendUInt(wxMemoryBuffer& buffer, uint64_t value, size_t bytes)
+{
+    // little endian
+    for (size_t i = 0; i < bytes; ++i) {
+        buffer.AppendByte((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void AppendCopy(wxMemoryBuffer& buffer, uint64_t offset, uint64_t len)
+{
+    buffer.AppendByte('C');
+    AppendUInt(buffer, offset, 8);
+    AppendUInt(buffer, len, 8);
+}
+
+void AppendLiteral(wxMemoryBuffer& buffer, const char* data, uint64_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    buffer.AppendByte('D');
+    AppendUInt(buffer, len, 8);
+    buffer.AppendData(data, len);
+}
+} // namespace
+
+size_t clSFTPDelta::GetBlockSize(size_t file_size)
+{
+    // like rsync: roughly the square root of the file size, a multiple of 8 and within sane limits
+    size_t block_size = (size_t)std::sqrt((double)file_size) & ~(size_t)7;
+    return std::min<size_t>(std::max<size_t>(block_size, 2048), 128 * 1024);
+}
+
+uint32_t clSFTPDelta::Adler32(const char* data, size_t len)
+{
+    uint32_t a = 1;
+    uint32_t b = 0;
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; ++i) {
+        a = (a + p[i]) % ADLER_MOD;
+        b = (b + a) % ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t clSFTPDelta::Crc32(const char* data, size_t len, uint32_t crc)
+{
+    // function-local static: initialised once, thread-safe (transfers run on several threads)
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    const unsigned char* p = (const unsigned char*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+wxString clSFTPDelta::GetChecksumsCommand(const wxString& remote_path, size_t block_size)
+{
+    wxString command;
+    command << "python3 -c " << ShellQuote(CHECKSUMS_SCRIPT) << " " << ShellQuote(remote_path) << " " << block_size;
+    return command;
+}
+
+wxString clSFTPDelta::GetPatchCommand(const wxString& remote_path, const wxString& delta_path)
+{
+    wxString command;
+    command << "python3 -c " << ShellQuote(PATCH_SCRIPT) << " " << ShellQuote(remote_path) << " "
+            << ShellQuote(delta_path);
+    return command;
+}
+
+bool clSFTPDelta::SetRemoteChecksums(const wxString& output, size_t block_size)
+{
+    m_blockSize = block_size;
+    m_blocks.clear();
+    m_weakToBlocks.clear();
+
+    wxArrayString lines = ::wxStringTokenize(output, "\r\n", wxTOKEN_STRTOK);
+    m_blocks.reserve(lines.size());
+    for (const wxString& line : lines) {
+        wxString weak_str = line.BeforeFirst(' ');
+        wxString strong_str = line.AfterFirst(' ');
+        unsigned long weak = 0;
+        unsigned long strong = 0;
+        if (!weak_str.ToCULong(&weak) || !strong_str.ToCULong(&strong)) {
+            // not our output (e.g. python3 is missing on the remote machine)
+            m_blocks.clear();
+            m_weakToBlocks.clear();
+            return false;
+        }
+        m_weakToBlocks[(uint32_t)weak].push_back(m_blocks.size());
+        m_blocks.push_back({ (uint32_t)weak, (uint32_t)strong });
+    }
+    return true;
+}
+
+size_t clSFTPDelta::Encode(const char* data, size_t len, wxMemoryBuffer& delta) const
+{
+    delta.Clear();
+    delta.AppendData(DELTA_MAGIC, sizeof(DELTA_MAGIC) - 1);
+    AppendUInt(delta, Crc32(data, len), 4);
+    AppendUInt(delta, len, 8);
+
+    const size_t n = m_blockSize;
+    size_t matched = 0;
+    size_t literal_start = 0;
+    size_t pos = 0;
+
+    // pending copy instruction, consecutive blocks are merged into a single instruction
+    uint64_t copy_offset = 0;
+    uint64_t copy_len = 0;
+
+    auto flush_literal = [&](size_t end) {
+        if (end > literal_start) {
+            if (copy_len) {
+                AppendCopy(delta, copy_offset, copy_len);
+                copy_len = 0;
+            }
+            AppendLiteral(delta, data + literal_start, end - literal_start);
+        }
+    };
+
+    uint32_t a = 0;
+    uint32_t b = 0;
+    bool window_valid = false;
+    while (n > 0 && !m_blocks.empty() && pos + n <= len) {
+        if (!window_valid) {
+            uint32_t adler = Adler32(data + pos, n);
+            a = adler & 0xFFFF;
+            b = adler >> 16;
+            window_valid = true;
+        }
+
+        size_t block_index = wxString::npos;
+        auto iter = m_weakToBlocks.find((b << 16) | a);
+        if (iter != m_weakToBlocks.end()) {
+            uint32_t strong = Crc32(data + pos, n);
+            for (size_t index : iter->second) {
+                if (m_blocks[index].strong == strong) {
+                    block_index = index;
+                    break;
+                }
+            }
+        }
+
+        if (block_index != wxString::npos) {
+            flush_literal(pos);
+            uint64_t offset = (uint64_t)block_index * n;
+            if (copy_len && copy_offset + copy_len == offset) {
+                copy_len += n;
+            } else {
+                if (copy_len) {
+                    AppendCopy(delta, copy_offset, copy_len);
+                }
+                copy_offset = offset;
+                copy_len = n;
+            }
+            matched += n;
+            pos += n;
+            literal_start = pos;
+            window_valid = false;
+            continue;
+        }
+
+        // roll the window by one byte
+        if (pos + n < len) {
+            uint32_t out = (unsigned char)data[pos];
+            uint32_t in = (unsigned char)data[pos + n];
+            a = (a + ADLER_MOD - out + in) % ADLER_MOD;
+            b = (uint32_t)((b + (uint64_t)ADLER_MOD * n - (uint64_t)n * out + a + ADLER_MOD - 1) % ADLER_MOD);
+        }
+        ++pos;
+    }
+
+    flush_literal(len);
+    if (copy_len) {
+        AppendCopy(delta, copy_offset, copy_len);
+    }
+    return matched;
+}
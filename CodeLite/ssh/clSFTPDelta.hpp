@@ -0,0 +1,77 @@
+#ifndef CLSFTPDELTA_HPP
+#define CLSFTPDELTA_HPP
+
+#include "codelite_exports.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <wx/buffer.h>
+#include <wx/string.h>
+
+/**
+ * @brief rsync style delta encoding used to upload only the changed parts of a remote file.
+ *
+ * The remote side splits its copy of the file into fixed size blocks and reports a weak (adler32) and a strong (crc32)
+ * checksum per block. Locally, a rolling adler32 is used to find these blocks at any offset of the new content, and the
+ * new content is encoded as a list of "copy from the remote file" and "literal data" instructions. The remote side
+ * rebuilds the file from the instructions and verifies the crc32 of the result before replacing the original file.
+ */
+class WXDLLIMPEXP_CL clSFTPDelta
+{
+public:
+    struct BlockChecksum {
+        uint32_t weak = 0;
+        uint32_t strong = 0;
+    };
+
+private:
+    size_t m_blockSize = 0;
+    std::vector<BlockChecksum> m_blocks;
+    std::unordered_map<uint32_t, std::vector<size_t>> m_weakToBlocks;
+
+public:
+    clSFTPDelta() = default;
+    ~clSFTPDelta() = default;
+
+    /**
+     * @brief return the block size to use for a file of a given size
+     */
+    static size_t GetBlockSize(size_t file_size);
+
+    static uint32_t Adler32(const char* data, size_t len);
+    static uint32_t Crc32(const char* data, size_t len, uint32_t crc = 0);
+
+    /**
+     * @brief return the shell command that prints the block checksums of `remote_path`, one "<weak> <strong>" line
+     * per block
+     */
+    static wxString GetChecksumsCommand(const wxString& remote_path, size_t block_size);
+
+    /**
+     * @brief return the shell command that rebuilds `remote_path` from the instructions in `delta_path`. The result is
+     * written into a temporary file which replaces `remote_path` only if its checksum is correct. On success, the
+     * command prints GetPatchSuccessMarker()
+     */
+    static wxString GetPatchCommand(const wxString& remote_path, const wxString& delta_path);
+    static wxString GetPatchSuccessMarker() { return "CLDELTA_OK"; }
+
+    /**
+     * @brief load the output of the command returned by GetChecksumsCommand()
+     */
+    bool SetRemoteChecksums(const wxString& output, size_t block_size);
+
+    /**
+     * @brief return the number of remote blocks loaded by SetRemoteChecksums()
+     */
+    size_t GetBlockCount() const { return m_blocks.size(); }
+
+    /**
+     * @brief encode `data` against the remote blocks
+     * @param delta [output] the encoded instructions
+     * @return the number of bytes of `data` that were found in the remote file
+     */
+    size_t Encode(const char* data, size_t len, wxMemoryBuffer& delta) const;
+};
+
+#endif // CLSFTPDELTA_HPP
@@ -26,10 +26,13 @@
 #if USE_SFTP
 #include "cl_sftp.h"
 
+#include "clSFTPDelta.hpp"
 #include "cl_standard_paths.h"
 #include "file_logger.h"
 
+#include <algorithm>
 #include <atomic>
+#include <deque>
 #include <libssh/sftp.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -49,6 +52,179 @@ public:
     ~SFTPDirCloser() { sftp_closedir(m_dir); }
 };
 
+namespace
+{
+// Number of read / write requests kept in flight during a transfer. Waiting for each chunk before
+// requesting the next one makes the transfer rate bound to the link latency, not its bandwidth
+constexpr size_t SFTP_REQUESTS_IN_FLIGHT = 16;
+// The largest chunk size every SFTP server is required to accept
+constexpr size_t SFTP_CHUNK_SIZE = 32768;
+// Files smaller than this are always uploaded in full
+constexpr size_t SFTP_DELTA_UPLOAD_MIN_SIZE = 256 * 1024;
+
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0, 11, 0)
+/// return the read / write chunk sizes to use for this session, as advertised by the server
+void clSFTPGetChunkSizes(SFTPSession_t sftp, size_t* read_chunk, size_t* write_chunk)
+{
+    *read_chunk = SFTP_CHUNK_SIZE;
+    *write_chunk = SFTP_CHUNK_SIZE;
+    sftp_limits_t limits = sftp_limits(sftp);
+    if (limits) {
+        *read_chunk = std::max(SFTP_CHUNK_SIZE, (size_t)std::min<uint64_t>(limits->max_read_length, 256 * 1024));
+        *write_chunk = std::max(SFTP_CHUNK_SIZE, (size_t)std::min<uint64_t>(limits->max_write_length, 256 * 1024));
+        sftp_limits_free(limits);
+    }
+}
+#endif
+
+/**
+ * @brief read exactly `size` bytes from `file` into `data` while keeping up to SFTP_REQUESTS_IN_FLIGHT read
+ * requests outstanding
+ * @return false on error (including a short read)
+ */
+bool clSFTPPipelinedRead(SFTPSession_t sftp, sftp_file file, char* data, size_t size)
+{
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0, 11, 0)
+    size_t chunk_size, write_chunk_size;
+    clSFTPGetChunkSizes(sftp, &chunk_size, &write_chunk_size);
+
+    std::deque<std::pair<sftp_aio, size_t>> pending;
+    size_t requested = 0;
+    size_t bytes_read = 0;
+    bool ok = true;
+    while (ok && (requested < size || !pending.empty())) {
+        // keep the window full
+        while (pending.size() < SFTP_REQUESTS_IN_FLIGHT && requested < size) {
+            size_t len = std::min(chunk_size, size - requested);
+            sftp_aio aio = nullptr;
+            if (sftp_aio_begin_read(file, len, &aio) < 0) {
+                ok = false;
+                break;
+            }
+            pending.push_back({ aio, len });
+            requested += len;
+        }
+
+        if (!ok || pending.empty()) {
+            break;
+        }
+
+        // replies arrive in the order the requests were sent
+        auto req = pending.front();
+        pending.pop_front();
+        ssize_t nbytes = sftp_aio_wait_read(&req.first, data + bytes_read, req.second);
+        if (nbytes != (ssize_t)req.second) {
+            ok = false;
+            break;
+        }
+        bytes_read += nbytes;
+    }
+
+    for (auto& req : pending) {
+        sftp_aio_free(req.first);
+    }
+    return ok && bytes_read == size;
+#else
+    wxUnusedVar(sftp);
+    std::deque<std::pair<uint32_t, size_t>> pending;
+    size_t requested = 0;
+    size_t bytes_read = 0;
+    bool ok = true;
+    while (ok && (requested < size || !pending.empty())) {
+        // keep the window full
+        while (pending.size() < SFTP_REQUESTS_IN_FLIGHT && requested < size) {
+            size_t len = std::min(SFTP_CHUNK_SIZE, size - requested);
+            int id = sftp_async_read_begin(file, len);
+            if (id < 0) {
+                ok = false;
+                break;
+            }
+            pending.push_back({ (uint32_t)id, len });
+            requested += len;
+        }
+
+        if (!ok || pending.empty()) {
+            break;
+        }
+
+        // replies arrive in the order the requests were sent
+        auto req = pending.front();
+        pending.pop_front();
+        int nbytes = sftp_async_read(file, data + bytes_read, req.second, req.first);
+        if (nbytes != (int)req.second) {
+            ok = false;
+            break;
+        }
+        bytes_read += nbytes;
+    }
+    // any reply still pending is discarded by sftp_close()
+    return ok && bytes_read == size;
+#endif
+}
+
+/**
+ * @brief write `size` bytes from `data` into `file`. With libssh 0.11 and later, up to
+ * SFTP_REQUESTS_IN_FLIGHT write requests are kept outstanding, older versions write one chunk at a time
+ * @return false on error
+ */
+bool clSFTPPipelinedWrite(SFTPSession_t sftp, sftp_file file, const char* data, size_t size)
+{
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0, 11, 0)
+    size_t read_chunk_size, chunk_size;
+    clSFTPGetChunkSizes(sftp, &read_chunk_size, &chunk_size);
+
+    std::deque<std::pair<sftp_aio, size_t>> pending;
+    size_t requested = 0;
+    size_t bytes_written = 0;
+    bool ok = true;
+    while (ok && (requested < size || !pending.empty())) {
+        while (pending.size() < SFTP_REQUESTS_IN_FLIGHT && requested < size) {
+            size_t len = std::min(chunk_size, size - requested);
+            sftp_aio aio = nullptr;
+            if (sftp_aio_begin_write(file, data + requested, len, &aio) < 0) {
+                ok = false;
+                break;
+            }
+            pending.push_back({ aio, len });
+            requested += len;
+        }
+
+        if (!ok || pending.empty()) {
+            break;
+        }
+
+        auto req = pending.front();
+        pending.pop_front();
+        ssize_t nbytes = sftp_aio_wait_write(&req.first);
+        if (nbytes != (ssize_t)req.second) {
+            ok = false;
+            break;
+        }
+        bytes_written += nbytes;
+    }
+
+    for (auto& req : pending) {
+        sftp_aio_free(req.first);
+    }
+    return ok && bytes_written == size;
+#else
+    wxUnusedVar(sftp);
+    // this version of libssh has no asynchronous write API
+    size_t bytes_left = size;
+    while (bytes_left > 0) {
+        size_t chunk_size = std::min(SFTP_CHUNK_SIZE * 2, bytes_left);
+        ssize_t bytes_written = sftp_write(file, data, chunk_size);
+        if (bytes_written < 0) {
+            return false;
+        }
+        bytes_left -= bytes_written;
+        data += bytes_written;
+    }
+    return true;
+#endif
+}
+} // namespace
+
 clSFTP::clSFTP(clSSH::Ptr_t ssh)
     : m_ssh(ssh)
     , m_sftp(NULL)
@@ -154,6 +330,12 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
         throw clException("SFTP is not initialized");
     }
 
+    // large files: try to send only what changed
+    if (m_deltaUploadSupported && fileContent.GetDataLen() >= SFTP_DELTA_UPLOAD_MIN_SIZE &&
+        DoWriteDelta(fileContent, remotePath)) {
+        return;
+    }
+
     static size_t counter = 0;
     int access_type = O_WRONLY | O_CREAT | O_TRUNC;
     sftp_file file;
@@ -168,21 +350,12 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
                           sftp_get_error(m_sftp));
     }
 
-    char* p = (char*)fileContent.GetData();
-    const int maxChunkSize = 65536;
-    wxInt64 bytesLeft = fileContent.GetDataLen();
-
-    while (bytesLeft > 0) {
-        wxInt64 chunkSize = bytesLeft > maxChunkSize ? maxChunkSize : bytesLeft;
-        wxInt64 bytesWritten = sftp_write(file, p, chunkSize);
-        if (bytesWritten < 0) {
-            sftp_close(file);
-            throw clException(wxString() << _("Can't write data to file: ") << tmpRemoteFile << ". "
-                                         << ssh_get_error(m_ssh->GetSession()),
-                              sftp_get_error(m_sftp));
-        }
-        bytesLeft -= bytesWritten;
-        p += bytesWritten;
+    const char* p = (const char*)fileContent.GetData();
+    if (!clSFTPPipelinedWrite(m_sftp, file, p, fileContent.GetDataLen())) {
+        sftp_close(file);
+        throw clException(wxString() << _("Can't write data to file: ") << tmpRemoteFile << ". "
+                                     << ssh_get_error(m_ssh->GetSession()),
+                          sftp_get_error(m_sftp));
     }
     sftp_close(file);
 
@@ -208,6 +381,83 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
     }
 }
 
+bool clSFTP::DoWriteDelta(const wxMemoryBuffer& fileContent, const wxString& remotePath)
+{
+    auto char_buffer_remote = remotePath.mb_str(wxConvUTF8);
+    sftp_attributes attr = sftp_stat(m_sftp, char_buffer_remote.data());
+    if (!attr) {
+        // a new file
+        return false;
+    }
+    uint64_t remoteSize = attr->size;
+    bool isRegularFile = attr->type == SSH_FILEXFER_TYPE_REGULAR;
+    sftp_attributes_free(attr);
+    if (!isRegularFile || remoteSize < SFTP_DELTA_UPLOAD_MIN_SIZE) {
+        return false;
+    }
+
+    // fetch the checksums of the remote blocks
+    size_t blockSize = clSFTPDelta::GetBlockSize(remoteSize);
+    clSFTPDelta delta;
+    try {
+        wxString output = ExecuteCommand(clSFTPDelta::GetChecksumsCommand(remotePath, blockSize));
+        if (output.empty()) {
+            // the remote machine can not compute the checksums, don't try again on this connection
+            clDEBUG() << "SFTP: delta upload is not supported by the remote host, uploading full files" << endl;
+            m_deltaUploadSupported = false;
+            return false;
+        }
+
+        if (!delta.SetRemoteChecksums(output, blockSize) || delta.GetBlockCount() != remoteSize / blockSize) {
+            return false;
+        }
+    } catch (const clException& e) {
+        clDEBUG() << "SFTP: failed to read remote checksums of" << remotePath << "." << e.What() << endl;
+        return false;
+    }
+
+    // a delta that is not much smaller than the file is not worth the extra work on the remote side
+    const char* data = (const char*)fileContent.GetData();
+    wxMemoryBuffer encoded;
+    delta.Encode(data, fileContent.GetDataLen(), encoded);
+    if (encoded.GetDataLen() > fileContent.GetDataLen() / 2) {
+        return false;
+    }
+
+    // upload the instructions
+    static size_t counter = 0;
+    wxString deltaFile = remotePath;
+    deltaFile << ".codelitedelta" << (++counter);
+    auto char_buffer_delta = deltaFile.mb_str(wxConvUTF8);
+    sftp_file file = sftp_open(m_sftp, char_buffer_delta.data(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (file == NULL) {
+        return false;
+    }
+    bool written = clSFTPPipelinedWrite(m_sftp, file, (const char*)encoded.GetData(), encoded.GetDataLen());
+    sftp_close(file);
+    if (!written) {
+        sftp_unlink(m_sftp, char_buffer_delta.data());
+        return false;
+    }
+
+    // rebuild the file on the remote side. The original file is replaced atomically, and only if the result is
+    // correct. The delta file is deleted by the command
+    try {
+        wxString output = ExecuteCommand(clSFTPDelta::GetPatchCommand(remotePath, deltaFile));
+        if (!output.Contains(clSFTPDelta::GetPatchSuccessMarker())) {
+            clDEBUG() << "SFTP: delta upload of" << remotePath << "failed, uploading the full file" << endl;
+            return false;
+        }
+    } catch (const clException& e) {
+        clDEBUG() << "SFTP: delta upload of" << remotePath << "failed." << e.What() << endl;
+        return false;
+    }
+
+    clDEBUG() << "SFTP: delta upload of" << remotePath << "sent" << encoded.GetDataLen() << "bytes instead of"
+              << fileContent.GetDataLen() << endl;
+    return true;
+}
+
 SFTPAttribute::List_t clSFTP::List(const wxString& folder, size_t flags, const wxString& filter)
 {
     sftp_dir dir;
@@ -289,26 +539,17 @@ SFTPAttribute::Ptr_t clSFTP::Read(const wxString& remotePath, wxMemoryBuffer& bu
                           sftp_get_error(m_sftp));
     }
     wxInt64 fileSize = fileAttr->GetSize();
-    if (fileSize == 0)
+    if (fileSize == 0) {
+        sftp_close(file);
         return fileAttr;
-
-    // Allocate buffer for the file content
-    char pBuffer[65536]; // buffer
-
-    // Read the entire file content
-    wxInt64 bytesLeft = fileSize;
-    wxInt64 bytesRead = 0;
-    while (bytesLeft > 0) {
-        wxInt64 nbytes = sftp_read(file, pBuffer, sizeof(pBuffer));
-        if (nbytes <= 0) {
-            break; // we will throw later
-        }
-        bytesRead += nbytes;
-        bytesLeft -= nbytes;
-        buffer.AppendData(pBuffer, nbytes);
     }
 
-    if (bytesRead != fileSize) {
+    // Read the entire file content directly into the output buffer
+    char* pBuffer = (char*)buffer.GetAppendBuf(fileSize);
+    bool ok = clSFTPPipelinedRead(m_sftp, file, pBuffer, fileSize);
+    buffer.UngetAppendBuf(ok ? fileSize : 0);
+
+    if (!ok) {
         sftp_close(file);
         buffer.Clear();
         throw clException(wxString() << _("Could not read file:") << remotePath << ". "
@@ -48,6 +48,7 @@ class WXDLLIMPEXP_CL clSFTP
     bool m_connected;
     wxString m_currentFolder;
     wxString m_account;
+    bool m_deltaUploadSupported = true;
 
 public:
     typedef std::shared_ptr<clSFTP> Ptr_t;
@@ -60,6 +61,12 @@ protected:
     wxString GetErrorString() const;
     wxString ExecuteCommand(const wxString& command);
 
+    /**
+     * @brief update an existing remote file by sending only the parts of `fileContent` that differ from it
+     * @return false if the delta upload is not possible or not worth it, in which case the remote file is untouched
+     */
+    bool DoWriteDelta(const wxMemoryBuffer& fileContent, const wxString& remotePath);
+
 public:
     clSFTP(clSSH::Ptr_t ssh);
     virtual ~clSFTP();
@@ -54,6 +54,16 @@ void BuildProcess::Stop()
         m_process = NULL;
     }
     m_fileName.Clear();
+    m_output.Clear();
+}
+
+void BuildProcess::Cancel()
+{
+    if(m_process) {
+        m_process->Detach();
+        m_process->Terminate();
+    }
+    Stop();
 }
 
 bool BuildProcess::IsBusy() { return m_process != NULL; }
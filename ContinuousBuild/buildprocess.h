@@ -33,6 +33,7 @@ class BuildProcess
     IProcess* m_process = nullptr;
     wxEvtHandler* m_evtHandler = nullptr;
     wxString m_fileName;
+    wxString m_output;
 
 public:
     BuildProcess();
@@ -41,8 +42,20 @@ public:
     bool Execute(const wxString& cmd, const wxString& fileName, const wxString& workingDirectory,
                  wxEvtHandler* evtHandler);
     void Stop();
+    /**
+     * @brief kill the process without reporting its output or termination
+     */
+    void Cancel();
     bool IsBusy();
 
+    IProcess* GetProcess() const { return m_process; }
+
+    /**
+     * @brief the compiler output is kept until the process ends so the output of concurrent builds is not mixed
+     */
+    void AppendOutput(const wxString& output) { m_output << output; }
+    const wxString& GetOutput() const { return m_output; }
+
     void SetFileName(const wxString& fileName) { this->m_fileName = fileName; }
     const wxString& GetFileName() const { return m_fileName; }
 
@@ -24,9 +24,12 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "continousbuildconf.h"
+
+#include <wx/thread.h>
+
 ContinousBuildConf::ContinousBuildConf()
 		: m_enabled(false)
-		, m_parallelProcesses(1)
+		, m_parallelProcesses(wxMax(wxThread::GetCPUCount(), 1))
 {
 }
 
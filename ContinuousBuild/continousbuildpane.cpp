@@ -29,6 +29,7 @@
 #include "drawingutils.h"
 #include "imanager.h"
 #include <wx/msgdlg.h>
+#include <wx/stattext.h>
 
 ContinousBuildPane::ContinousBuildPane(wxWindow* parent, IManager* manager, ContinuousBuild* plugin)
     : ContinousBuildBasePane(parent)
@@ -39,6 +40,16 @@ ContinousBuildPane::ContinousBuildPane(wxWindow* parent, IManager* manager, Cont
     m_mgr->GetConfigTool()->ReadObject(wxT("ContinousBuildConf"), &conf);
     m_checkBox1->SetValue(conf.GetEnabled());
 
+    // the number of files compiled concurrently
+    wxSizer* sizer = m_checkBox1->GetContainingSizer();
+    m_spinCtrlJobs = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS,
+                                    1, 64, conf.GetParallelProcesses());
+    sizer->Insert(1, new wxStaticText(this, wxID_ANY, _("Parallel jobs:")), 0, wxLEFT | wxALIGN_CENTER_VERTICAL,
+                  FromDIP(5));
+    sizer->Insert(2, m_spinCtrlJobs, 0, wxALL | wxALIGN_CENTER_VERTICAL, FromDIP(5));
+    m_spinCtrlJobs->Bind(wxEVT_SPINCTRL, &ContinousBuildPane::OnJobsChanged, this);
+    Layout();
+
     m_listBoxQueue->SetForegroundColour(DrawingUtils::GetOutputPaneFgColour());
     m_listBoxQueue->SetBackgroundColour(DrawingUtils::GetOutputPaneBgColour());
 }
@@ -91,6 +102,15 @@ void ContinousBuildPane::OnEnableContBuildUI(wxUpdateUIEvent& event)
 void ContinousBuildPane::OnEnableCB(wxCommandEvent& event)
 {
     ContinousBuildConf conf;
+    m_mgr->GetConfigTool()->ReadObject(wxT("ContinousBuildConf"), &conf);
     conf.SetEnabled(event.IsChecked());
     m_mgr->GetConfigTool()->WriteObject(wxT("ContinousBuildConf"), &conf);
 }
+
+void ContinousBuildPane::OnJobsChanged(wxSpinEvent& event)
+{
+    ContinousBuildConf conf;
+    m_mgr->GetConfigTool()->ReadObject(wxT("ContinousBuildConf"), &conf);
+    conf.SetParallelProcesses(event.GetPosition());
+    m_mgr->GetConfigTool()->WriteObject(wxT("ContinousBuildConf"), &conf);
+}
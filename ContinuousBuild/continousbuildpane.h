@@ -32,6 +32,9 @@ Subclass of ContinousBuildBasePane, which is generated by wxFormBuilder.
 */
 
 #include "continousbuildbasepane.h"
+
+#include <wx/spinctrl.h>
+
 class IManager;
 class ContinuousBuild;
 
@@ -40,6 +43,7 @@ class ContinousBuildPane : public ContinousBuildBasePane
 {
     IManager* m_mgr;
     ContinuousBuild* m_plugin;
+    wxSpinCtrl* m_spinCtrlJobs = nullptr;
 
 protected:
     // Handlers for ContinousBuildBasePane events.
@@ -56,6 +60,7 @@ protected:
      * @param event
      */
     virtual void OnEnableContBuildUI(wxUpdateUIEvent& event);
+    void OnJobsChanged(wxSpinEvent& event);
 
 public:
     /** Constructor */
@@ -41,6 +41,7 @@
 #include "globals.h"
 #include "workspace.h"
 
+#include <algorithm>
 #include <wx/app.h>
 #include <wx/imaglist.h>
 #include <wx/log.h>
@@ -198,7 +199,16 @@ void ContinuousBuild::DoBuild(const wxString& fileName)
     wxString cmd =
         builder->GetSingleFileCmd(projectName, bldConf->GetName(), bldConf->GetBuildSystemArguments(), fileName);
 
-    if(m_buildProcess.IsBusy()) {
+    // the file was saved again while it is being compiled: the running compilation is outdated, restart it
+    auto iter = std::find_if(m_jobs.begin(), m_jobs.end(),
+                             [&fileName](const auto& job) { return job->GetFileName() == fileName; });
+    if(iter != m_jobs.end()) {
+        clDEBUG() << "Continuous build: cancelling outdated compilation of" << fileName << endl;
+        (*iter)->Cancel();
+        m_jobs.erase(iter);
+    }
+
+    if(m_jobs.size() >= GetMaxJobs()) {
         // add the build to the queue
         if(m_files.Index(fileName) == wxNOT_FOUND) {
             m_files.Add(fileName);
@@ -210,18 +220,27 @@ void ContinuousBuild::DoBuild(const wxString& fileName)
     }
 
     // Fire it up
-    clBuildEvent event(wxEVT_BUILD_PROCESS_STARTED);
-    event.SetProjectName(projectName);
-    event.SetConfigurationName(bldConf->GetName());
-    event.SetFlag(clBuildEvent::kCustomProject, bldConf->IsCustomBuild());
-    event.SetFlag(clBuildEvent::kClean, false);
-    event.SetToolchain(bldConf->GetCompilerType());
-    EventNotifier::Get()->AddPendingEvent(event);
-
     EnvSetter env(NULL, NULL, projectName, bldConf->GetName());
     clDEBUG() << "Continuous build:" << cmd << endl;
-    if(!m_buildProcess.Execute(cmd, fileName, project->GetFileName().GetPath(), this))
+    auto job = std::make_unique<BuildProcess>();
+    if(!job->Execute(cmd, fileName, project->GetFileName().GetPath(), this)) {
+        m_view->RemoveFile(fileName);
         return;
+    }
+    m_jobs.push_back(std::move(job));
+
+    // The build tab is notified once for all the compilations running concurrently. The process output is
+    // delivered by events as well, so the build tab gets this event first
+    if(!m_buildStarted) {
+        clBuildEvent event(wxEVT_BUILD_PROCESS_STARTED);
+        event.SetProjectName(projectName);
+        event.SetConfigurationName(bldConf->GetName());
+        event.SetFlag(clBuildEvent::kCustomProject, bldConf->IsCustomBuild());
+        event.SetFlag(clBuildEvent::kClean, false);
+        event.SetToolchain(bldConf->GetCompilerType());
+        EventNotifier::Get()->AddPendingEvent(event);
+        m_buildStarted = true;
+    }
 
     // Set some messages
     m_mgr->SetStatusMessage(
@@ -233,45 +252,100 @@ void ContinuousBuild::DoBuild(const wxString& fileName)
 
 void ContinuousBuild::OnBuildProcessEnded(clProcessEvent& e)
 {
-    // remove the file from the UI
-    int pid = m_buildProcess.GetPid();
-    m_view->RemoveFile(m_buildProcess.GetFileName());
+    auto iter = std::find_if(m_jobs.begin(), m_jobs.end(),
+                             [&e](const auto& job) { return job->GetProcess() == e.GetProcess(); });
+    if(iter == m_jobs.end()) {
+        // a cancelled compilation
+        return;
+    }
 
-    clBuildEvent event(wxEVT_BUILD_PROCESS_ENDED);
-    EventNotifier::Get()->AddPendingEvent(event);
+    BuildProcess* job = iter->get();
+
+    // remove the file from the UI
+    int pid = job->GetPid();
+    m_view->RemoveFile(job->GetFileName());
 
     int exitCode(-1);
     if(IProcess::GetProcessExitCode(pid, exitCode) && exitCode != 0) {
-        m_view->AddFailedFile(m_buildProcess.GetFileName());
+        m_view->AddFailedFile(job->GetFileName());
+    }
+
+    // merge the diagnostics of this file into the build tab
+    wxString output = job->GetOutput();
+    if(!output.empty()) {
+        if(!output.EndsWith("\n")) {
+            output << "\n";
+        }
+        clBuildEvent event(wxEVT_BUILD_PROCESS_ADDLINE);
+        event.SetString(output);
+        EventNotifier::Get()->AddPendingEvent(event);
     }
 
     // Release the resources allocated for this build
-    m_buildProcess.Stop();
+    m_jobs.erase(iter);
 
     // if the queue is not empty, start another build
-    if(m_files.IsEmpty() == false) {
+    StartQueuedJobs();
 
+    if(m_jobs.empty() && m_buildStarted) {
+        clBuildEvent event(wxEVT_BUILD_PROCESS_ENDED);
+        EventNotifier::Get()->AddPendingEvent(event);
+        m_buildStarted = false;
+    }
+}
+
+void ContinuousBuild::StartQueuedJobs()
+{
+    while(!m_files.IsEmpty() && m_jobs.size() < GetMaxJobs()) {
         wxString fileName = m_files.Item(0);
         m_files.RemoveAt(0);
         DoBuild(fileName);
     }
 }
 
-void ContinuousBuild::StopAll()
+size_t ContinuousBuild::GetMaxJobs() const
+{
+    ContinousBuildConf conf;
+    m_mgr->GetConfigTool()->ReadObject(wxT("ContinousBuildConf"), &conf);
+    return wxMax(conf.GetParallelProcesses(), 1);
+}
+
+BuildProcess* ContinuousBuild::FindJob(IProcess* process) const
+{
+    for(const auto& job : m_jobs) {
+        if(job->GetProcess() == process) {
+            return job.get();
+        }
+    }
+    return nullptr;
+}
+
+void ContinuousBuild::CancelAll(bool notify)
 {
     // empty the queue
     m_files.Clear();
-    m_buildProcess.Stop();
+    for(auto& job : m_jobs) {
+        job->Cancel();
+    }
+    m_jobs.clear();
+
+    if(notify && m_buildStarted) {
+        clBuildEvent event(wxEVT_BUILD_PROCESS_ENDED);
+        EventNotifier::Get()->AddPendingEvent(event);
+    }
+    m_buildStarted = false;
 }
 
+void ContinuousBuild::StopAll() { CancelAll(true); }
+
 void ContinuousBuild::OnIgnoreFileSaved(wxCommandEvent& e)
 {
     e.Skip();
 
     m_buildInProgress = true;
 
-    // Clear the queue
-    m_files.Clear();
+    // Clear the queue. The main build reports to the build tab from now on, so do not send the "ended" event
+    CancelAll(false);
 
     // Clear the view
     m_view->ClearAll();
@@ -285,7 +359,8 @@ void ContinuousBuild::OnStopIgnoreFileSaved(wxCommandEvent& e)
 
 void ContinuousBuild::OnBuildProcessOutput(clProcessEvent& e)
 {
-    clBuildEvent event(wxEVT_BUILD_PROCESS_ADDLINE);
-    event.SetString(e.GetOutput());
-    EventNotifier::Get()->AddPendingEvent(event);
+    BuildProcess* job = FindJob(e.GetProcess());
+    if(job) {
+        job->AppendOutput(e.GetOutput());
+    }
 }
@@ -32,6 +32,9 @@
 #include "cl_command_event.h"
 #include "clTabTogglerHelper.h"
 
+#include <memory>
+#include <vector>
+
 class wxEvtHandler;
 class ContinousBuildPane;
 class ShellCommand;
@@ -40,11 +43,25 @@ class ContinuousBuild : public IPlugin
 {
     ContinousBuildPane* m_view;
     wxEvtHandler* m_topWin;
-    BuildProcess m_buildProcess;
-    wxArrayString m_files;
+    std::vector<std::unique_ptr<BuildProcess>> m_jobs; // the compilations in progress
+    wxArrayString m_files;                             // files waiting for a free job
     bool m_buildInProgress;
+    bool m_buildStarted = false; // wxEVT_BUILD_PROCESS_STARTED was sent, wxEVT_BUILD_PROCESS_ENDED was not
     clTabTogglerHelper::Ptr_t m_tabHelper;
-    
+
+protected:
+    size_t GetMaxJobs() const;
+    BuildProcess* FindJob(IProcess* process) const;
+    /**
+     * @brief start compiling queued files while there are free job slots
+     */
+    void StartQueuedJobs();
+    /**
+     * @brief kill all the compilations and empty the queue
+     * @param notify send wxEVT_BUILD_PROCESS_ENDED if a build was reported as started
+     */
+    void CancelAll(bool notify);
+
 public:
     void DoBuild(const wxString& fileName);
 
@@ -99,8 +99,8 @@ _SqlCommandPanel::_SqlCommandPanel(wxWindow* parent, wxWindowID id, const wxPoin
     wxBoxSizer* bSizer24 = new wxBoxSizer(wxVERTICAL);
     m_panel14->SetSizer(bSizer24);
 
-    m_table = new clTableWithPagination(m_panel14, wxID_ANY, wxDefaultPosition, wxDLG_UNIT(m_panel14, wxSize(-1, -1)),
-                                        wxTAB_TRAVERSAL);
+    m_table = new SqlResultGrid(m_panel14, wxID_ANY, wxDefaultPosition, wxDLG_UNIT(m_panel14, wxSize(-1, -1)),
+                                wxTAB_TRAVERSAL);
 
     bSizer24->Add(m_table, 1, wxEXPAND, WXC_FROM_DIP(5));
 
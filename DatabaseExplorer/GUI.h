@@ -16,7 +16,7 @@
 #include <wx/sizer.h>
 #include <wx/splitter.h>
 #include <wx/stc/stc.h>
-#include "clTableWithPagination.h"
+#include "SqlResultGrid.h"
 #include <wx/treectrl.h>
 #include "clThemedTreeCtrl.h"
 #include <wx/dialog.h>
@@ -58,13 +58,13 @@ protected:
     wxPanel* m_panel13;
     wxStyledTextCtrl* m_scintillaSQL;
     wxPanel* m_panel14;
-    clTableWithPagination* m_table;
+    SqlResultGrid* m_table;
 
 protected:
 public:
     wxStyledTextCtrl* GetScintillaSQL() { return m_scintillaSQL; }
     wxPanel* GetPanel13() { return m_panel13; }
-    clTableWithPagination* GetTable() { return m_table; }
+    SqlResultGrid* GetTable() { return m_table; }
     wxPanel* GetPanel14() { return m_panel14; }
     wxSplitterWindow* GetSplitter1() { return m_splitter1; }
     _SqlCommandPanel(wxWindow* parent, wxWindowID id = wxID_ANY, const wxPoint& pos = wxDefaultPosition,
@@ -27,6 +27,7 @@
 
 #include "DbViewerPanel.h"
 #include "Keyboard/clKeyboardManager.h"
+#include "SqlQueryRunner.h"
 #include "bitmap_loader.h"
 #include "clStatusBarMessage.h"
 #include "cl_aui_tool_stickness.h"
@@ -103,15 +104,23 @@ SQLCommandPanel::SQLCommandPanel(wxWindow* parent, IDbAdapter* dbAdapter, const
     auto images = m_toolbar->GetBitmapsCreateIfNeeded();
     m_toolbar->AddTool(wxID_OPEN, _("Load SQL Script"), images->Add("file_open"));
     m_toolbar->AddTool(wxID_EXECUTE, _("Execute SQL"), images->Add("execute"));
+    m_toolbar->AddTool(wxID_STOP, _("Stop fetching rows"), images->Add("stop"));
     m_toolbar->Realize();
     GetSizer()->Insert(0, m_toolbar, 0, wxEXPAND);
 
     // Bind events
     m_toolbar->Bind(wxEVT_TOOL, &SQLCommandPanel::OnExecuteClick, this, wxID_EXECUTE);
     m_toolbar->Bind(wxEVT_TOOL, &SQLCommandPanel::OnLoadClick, this, wxID_OPEN);
+    m_toolbar->Bind(wxEVT_TOOL, &SQLCommandPanel::OnStopClick, this, wxID_STOP);
+    m_toolbar->Bind(wxEVT_UPDATE_UI, &SQLCommandPanel::OnStopUI, this, wxID_STOP);
+    m_table->SetFetchMoreCallback([this]() { OnFetchMoreRows(); });
 }
 
-SQLCommandPanel::~SQLCommandPanel() { wxDELETE(m_pDbAdapter); }
+SQLCommandPanel::~SQLCommandPanel()
+{
+    StopQuery();
+    wxDELETE(m_pDbAdapter);
+}
 
 void SQLCommandPanel::OnExecuteClick(wxCommandEvent& event) { ExecuteSql(); }
 
@@ -125,157 +134,106 @@ void SQLCommandPanel::OnScintilaKeyDown(wxKeyEvent& event)
 
 void SQLCommandPanel::ExecuteSql()
 {
-    clStatusBarMessage message(_("Executing SQL..."));
-
-    clWindowUpdateLocker locker(this);
-    std::set<int> textCols;
-    std::set<int> blobCols;
-    DatabaseLayerPtr m_pDbLayer = m_pDbAdapter->GetDatabaseLayer(m_dbName);
-    if(m_pDbLayer->IsOpen()) {
-        // build string of SQL statements with comments removed
-        wxArrayString sqls = ParseSql();
-        wxString sqlStmt = "";
-        for(size_t i = 0; i < sqls.GetCount(); i++) {
-            sqlStmt += sqls[i];
-        }
+    StopQuery();
 
-        // save the history
-        SaveSqlHistory(sqls);
-
-        if(!sqls.IsEmpty()) {
-            try {
-                m_colsMetaData.clear();
-                if(!m_pDbAdapter->GetUseDb(m_dbName).IsEmpty())
-                    m_pDbLayer->RunQuery(m_pDbAdapter->GetUseDb(m_dbName));
-                // run query
-                DatabaseResultSet* pResultSet = m_pDbLayer->RunQueryWithResults(sqlStmt);
-
-                m_table->ClearAll();
-                if(!pResultSet) {
-                    wxMessageBox(_("Unknown SQL error."), _("DB Error"), wxOK | wxICON_ERROR);
-                    return;
-                }
-
-                int cols = pResultSet->GetMetaData()->GetColumnCount();
-                m_colsMetaData.resize(cols);
-
-                // create table header
-                wxArrayString columns;
-                for(int i = 1; i <= pResultSet->GetMetaData()->GetColumnCount(); i++) {
-                    columns.Add(pResultSet->GetMetaData()->GetColumnName(i));
-                    m_colsMetaData.at(i - 1) = ColumnInfo(pResultSet->GetMetaData()->GetColumnType(i),
-                                                          pResultSet->GetMetaData()->GetColumnName(i));
-                }
-                m_table->SetColumns(columns);
-
-                // fill table data
-                std::vector<wxArrayString> data;
-                while(pResultSet->Next()) {
-                    data.push_back(wxArrayString());
-                    wxArrayString& row = data.back();
-                    wxString value;
-                    for(int i = 1; i <= pResultSet->GetMetaData()->GetColumnCount(); i++) {
-
-                        switch(pResultSet->GetMetaData()->GetColumnType(i)) {
-                        case ResultSetMetaData::COLUMN_INTEGER:
-                            if(m_pDbAdapter->GetAdapterType() == IDbAdapter::atSQLITE) {
-                                value = pResultSet->GetResultString(i);
-
-                            } else {
-                                value = wxString::Format(wxT("%i"), pResultSet->GetResultInt(i));
-                            }
-                            break;
-
-                        case ResultSetMetaData::COLUMN_STRING:
-                            value = pResultSet->GetResultString(i);
-                            break;
-
-                        case ResultSetMetaData::COLUMN_UNKNOWN:
-                            value = pResultSet->GetResultString(i);
-                            break;
-
-                        case ResultSetMetaData::COLUMN_BLOB: {
-                            if(textCols.find(i) != textCols.end()) {
-                                // this column should be displayed as TEXT rather than BLOB
-                                value = pResultSet->GetResultString(i);
-
-                            } else if(blobCols.find(i) != blobCols.end()) {
-                                // this column should be displayed as BLOB
-                                wxMemoryBuffer buffer;
-                                pResultSet->GetResultBlob(i, buffer);
-                                value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
-
-                            } else {
-                                // first time
-                                wxString strCol = pResultSet->GetResultString(i);
-                                if(IsBlobColumn(strCol)) {
-                                    blobCols.insert(i);
-                                    wxMemoryBuffer buffer;
-                                    pResultSet->GetResultBlob(i, buffer);
-                                    value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
-
-                                } else {
-                                    textCols.insert(i);
-                                    value = strCol;
-                                }
-                            }
-                            break;
-                        }
-                        case ResultSetMetaData::COLUMN_BOOL:
-                            value = wxString::Format(wxT("%b"), pResultSet->GetResultBool(i));
-                            break;
-
-                        case ResultSetMetaData::COLUMN_DATE: {
-                            wxDateTime dt = pResultSet->GetResultDate(i);
-                            if(dt.IsValid()) {
-                                value = dt.Format();
-                            } else {
-                                value.Clear();
-                            }
-                        } break;
-
-                        case ResultSetMetaData::COLUMN_DOUBLE:
-                            value = wxString::Format(wxT("%f"), pResultSet->GetResultDouble(i));
-                            break;
-
-                        case ResultSetMetaData::COLUMN_NULL:
-                            value = wxT("NULL");
-                            break;
-
-                        default:
-                            value = pResultSet->GetResultString(i);
-                            break;
-                        }
-                        row.Add(value);
-                    }
-                }
-                m_pDbLayer->CloseResultSet(pResultSet);
-
-                // Popuplate the data
-                m_table->SetData(data);
-                GetSizer()->Layout();
-                Layout();
-
-            } catch (const DatabaseLayerException& e) {
-                // for some reason an exception is thrown even if the error code is 0...
-                if(e.GetErrorCode() != 0) {
-                    wxString errorMessage =
-                        wxString::Format(_("Error (%d): %s"), e.GetErrorCode(), e.GetErrorMessage().c_str());
-                    wxMessageDialog dlg(this, errorMessage, _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
-                    dlg.ShowModal();
-                }
-
-            } catch (...) {
-                wxMessageDialog dlg(this, _("Unknown error."), _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
-                dlg.ShowModal();
-            }
-        }
+    DatabaseLayerPtr pDbLayer = m_pDbAdapter->GetDatabaseLayer(m_dbName);
+    if(!pDbLayer || !pDbLayer->IsOpen()) {
+        wxMessageBox(_("Cant connect!"));
+        return;
+    }
+
+    // build string of SQL statements with comments removed
+    wxArrayString sqls = ParseSql();
+    wxString sqlStmt = "";
+    for(size_t i = 0; i < sqls.GetCount(); i++) {
+        sqlStmt += sqls[i];
+    }
+
+    // save the history
+    SaveSqlHistory(sqls);
+    if(sqls.IsEmpty()) {
+        return;
+    }
+
+    // A single SELECT statement is run through a server side cursor, so the rows are kept on the server until they
+    // are displayed
+    bool useCursor = m_pDbAdapter->GetAdapterType() == IDbAdapter::atPOSTGRES && sqls.GetCount() == 1 &&
+                     SqlQueryRunner::IsCursorStatement(sqls.Item(0));
+
+    m_colsMetaData.clear();
+    m_table->ClearAll();
+    m_table->SetStatusText(_("Executing SQL..."));
+
+    // the query runs on a worker thread, the rows are fetched in pages as the user scrolls the result
+    m_fetchPending = true;
+    wxString sql = useCursor ? sqls.Item(0) : sqlStmt;
+    m_queryRunner = std::make_shared<SqlQueryRunner>(this, ++m_queryId, pDbLayer, m_pDbAdapter->GetAdapterType(),
+                                                     m_pDbAdapter->GetUseDb(m_dbName), sql, useCursor);
+    m_queryRunner->Start();
+}
 
+void SQLCommandPanel::StopQuery()
+{
+    if(!m_queryRunner) {
+        return;
+    }
+    // does not wait for the statement being executed, its late pages are dropped by their query id
+    m_queryRunner->Cancel();
+    m_queryRunner.reset();
+    m_fetchPending = false;
+}
+
+void SQLCommandPanel::OnQueryResult(std::shared_ptr<SqlResultPage> page)
+{
+    if(!m_queryRunner || page->queryId != m_queryId) {
+        // a page of a query that was cancelled
+        return;
+    }
+
+    m_fetchPending = false;
+    if(!page->columns.empty()) {
+        m_colsMetaData = page->columns;
+        m_table->SetColumns(m_colsMetaData);
+        GetSizer()->Layout();
+        Layout();
+    }
+    m_table->AppendRows(page->rows);
+
+    if(page->complete) {
+        StopQuery();
+        m_table->SetStatusText(wxString() << _("Total of: ") << m_table->GetRowCount() << _(" entries"));
     } else {
-        wxMessageBox(_("Cant connect!"));
+        m_table->SetStatusText(wxString() << _("Showing the first ") << m_table->GetRowCount()
+                                          << _(" entries, scroll down to fetch more"));
+    }
+
+    if(!page->errorMessage.IsEmpty()) {
+        wxMessageDialog dlg(this, page->errorMessage, _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
+        dlg.ShowModal();
+    }
+}
+
+void SQLCommandPanel::OnFetchMoreRows()
+{
+    // one page at a time
+    if(m_queryRunner && !m_fetchPending) {
+        m_fetchPending = true;
+        m_queryRunner->FetchMore();
     }
 }
 
+void SQLCommandPanel::OnStopClick(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    if(m_queryRunner) {
+        StopQuery();
+        m_table->SetStatusText(wxString() << _("Query cancelled. Showing ") << m_table->GetRowCount()
+                                          << _(" entries"));
+    }
+}
+
+void SQLCommandPanel::OnStopUI(wxUpdateUIEvent& event) { event.Enable(m_queryRunner != nullptr); }
+
 void SQLCommandPanel::OnLoadClick(wxCommandEvent& event)
 {
     wxFileDialog dlg(this, _("Choose a file"), wxT(""), wxT(""), wxT("Sql files(*.sql)|*.sql"),
@@ -369,16 +327,6 @@ void SQLCommandPanel::OnCopyCellValue(wxCommandEvent& e)
     }
 }
 
-bool SQLCommandPanel::IsBlobColumn(const wxString& str)
-{
-    for(size_t i = 0; i < str.Len(); i++) {
-        if(!wxIsprint(str.GetChar(i))) {
-            return true;
-        }
-    }
-    return false;
-}
-
 void SQLCommandPanel::SetDefaultSelect()
 {
     m_scintillaSQL->ClearAll();
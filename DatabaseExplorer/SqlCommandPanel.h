@@ -28,44 +28,19 @@
 
 #include "GUI.h" // Base class: _SqlCommandPanel
 #include "IDbAdapter.h"
+#include "SqlQueryResult.h"
 #include "clEditorEditEventsHandler.h"
 #include "clToolBar.h"
 
 #include <map>
+#include <memory>
 #include <wx/aui/auibar.h>
 #include <wx/dblayer/include/DatabaseErrorCodes.h>
 #include <wx/dblayer/include/DatabaseLayer.h>
 #include <wx/dblayer/include/DatabaseLayerException.h>
 #include <wx/wx.h>
 
-// ----------------------------------------------------------------
-class ColumnInfo
-{
-    int m_type;
-    wxString m_name;
-
-public:
-    typedef std::vector<ColumnInfo> Vector_t;
-
-public:
-    ColumnInfo()
-        : m_type(0)
-    {
-    }
-
-    ColumnInfo(int type, const wxString& name)
-        : m_type(type)
-        , m_name(name)
-    {
-    }
-
-    virtual ~ColumnInfo() {}
-
-    void SetName(const wxString& name) { this->m_name = name; }
-    void SetType(int type) { this->m_type = type; }
-    const wxString& GetName() const { return m_name; }
-    int GetType() const { return m_type; }
-};
+class SqlQueryRunner;
 
 // ----------------------------------------------------------------
 class SQLCommandPanel : public _SqlCommandPanel
@@ -84,12 +59,22 @@ protected:
     ColumnInfo::Vector_t m_colsMetaData;
     clEditEventsHandler::Ptr_t m_editHelper;
     clToolBarGeneric* m_toolbar;
+    std::shared_ptr<SqlQueryRunner> m_queryRunner;
+    size_t m_queryId = 0;
+    bool m_fetchPending = false;
 
 protected:
-    bool IsBlobColumn(const wxString& str);
     wxArrayString ParseSql() const;
     void SaveSqlHistory(wxArrayString sqls);
 
+    /**
+     * @brief cancel the running query (if any). The rows fetched so far are kept
+     */
+    void StopQuery();
+    void OnFetchMoreRows();
+    void OnStopClick(wxCommandEvent& event);
+    void OnStopUI(wxUpdateUIEvent& event);
+
 public:
     SQLCommandPanel(wxWindow* parent, IDbAdapter* dbAdapter, const wxString& dbName, const wxString& dbTable);
     virtual ~SQLCommandPanel();
@@ -106,6 +91,11 @@ public:
     void OnCopyCellValue(wxCommandEvent& e);
     DECLARE_EVENT_TABLE()
     void OnExecuteSQL(wxCommandEvent& e);
+
+    /**
+     * @brief a page of rows was fetched by the query thread
+     */
+    void OnQueryResult(std::shared_ptr<SqlResultPage> page);
 };
 
 #endif // SQLCOMMANDPANEL_H
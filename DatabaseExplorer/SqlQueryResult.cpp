@@ -0,0 +1,72 @@
+#include "SqlQueryResult.h"
+
+SqlResultValue SqlResultValue::Integer(long long value)
+{
+    SqlResultValue v;
+    v.m_kind = kInteger;
+    v.m_integer = value;
+    return v;
+}
+
+SqlResultValue SqlResultValue::Double(double value)
+{
+    SqlResultValue v;
+    v.m_kind = kDouble;
+    v.m_double = value;
+    return v;
+}
+
+SqlResultValue SqlResultValue::Bool(bool value)
+{
+    SqlResultValue v;
+    v.m_kind = kBool;
+    v.m_bool = value;
+    return v;
+}
+
+SqlResultValue SqlResultValue::Date(const wxDateTime& value)
+{
+    SqlResultValue v;
+    v.m_kind = kDate;
+    v.m_integer = value.GetValue().GetValue();
+    return v;
+}
+
+SqlResultValue SqlResultValue::Blob(size_t size)
+{
+    SqlResultValue v;
+    v.m_kind = kBlob;
+    v.m_integer = size;
+    return v;
+}
+
+SqlResultValue SqlResultValue::Text(const wxString& value)
+{
+    SqlResultValue v;
+    v.m_kind = kText;
+    v.m_text = value;
+    return v;
+}
+
+wxString SqlResultValue::ToString() const
+{
+    switch(m_kind) {
+    case kNull:
+        return wxT("NULL");
+    case kInteger:
+        return wxString::Format(wxT("%lld"), m_integer);
+    case kDouble:
+        return wxString::Format(wxT("%f"), m_double);
+    case kBool:
+        return m_bool ? wxT("true") : wxT("false");
+    case kDate: {
+        wxDateTime dt(wxLongLong(m_integer));
+        return dt.IsValid() ? dt.Format() : wxString();
+    }
+    case kBlob:
+        return wxString::Format(wxT("BLOB (Size:%llu)"), (unsigned long long)m_integer);
+    case kText:
+    default:
+        return m_text;
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef SQLQUERYRESULT_H
+#define SQLQUERYRESULT_H
+
+#include <vector>
+#include <wx/datetime.h>
+#include <wx/string.h>
+
+// ----------------------------------------------------------------
+class ColumnInfo
+{
+    int m_type;
+    wxString m_name;
+
+public:
+    typedef std::vector<ColumnInfo> Vector_t;
+
+public:
+    ColumnInfo()
+        : m_type(0)
+    {
+    }
+
+    ColumnInfo(int type, const wxString& name)
+        : m_type(type)
+        , m_name(name)
+    {
+    }
+
+    virtual ~ColumnInfo() {}
+
+    void SetName(const wxString& name) { this->m_name = name; }
+    void SetType(int type) { this->m_type = type; }
+    const wxString& GetName() const { return m_name; }
+    int GetType() const { return m_type; }
+};
+
+// ----------------------------------------------------------------
+/**
+ * @class SqlResultValue
+ * @brief a single cell of a result set. The value is kept in its native type and is converted into a string only when
+ * it is displayed
+ */
+class SqlResultValue
+{
+public:
+    enum eKind {
+        kNull = 0,
+        kInteger,
+        kDouble,
+        kBool,
+        kDate,
+        kBlob,
+        kText,
+    };
+    typedef std::vector<SqlResultValue> Row_t;
+
+private:
+    eKind m_kind = kNull;
+    union {
+        long long m_integer = 0; // also holds the date ticks and the blob size
+        double m_double;
+        bool m_bool;
+    };
+    wxString m_text;
+
+public:
+    SqlResultValue() {}
+    ~SqlResultValue() {}
+
+    static SqlResultValue Null() { return SqlResultValue(); }
+    static SqlResultValue Integer(long long value);
+    static SqlResultValue Double(double value);
+    static SqlResultValue Bool(bool value);
+    static SqlResultValue Date(const wxDateTime& value);
+    static SqlResultValue Blob(size_t size);
+    static SqlResultValue Text(const wxString& value);
+
+    eKind GetKind() const { return m_kind; }
+    bool IsNumeric() const { return m_kind == kInteger || m_kind == kDouble; }
+
+    /**
+     * @brief format the value for display
+     */
+    wxString ToString() const;
+};
+
+// ----------------------------------------------------------------
+/**
+ * @brief a page of rows sent by the query thread to the SQL panel
+ */
+struct SqlResultPage {
+    size_t queryId = 0;
+    ColumnInfo::Vector_t columns; // set in the first page only
+    std::vector<SqlResultValue::Row_t> rows;
+    bool complete = false; // this is the last page of the query
+    wxString errorMessage; // set if the query failed
+};
+
+#endif // SQLQUERYRESULT_H
@@ -0,0 +1,269 @@
+#include "SqlQueryRunner.h"
+
+#include "SqlCommandPanel.h"
+#include "file_logger.h"
+
+#include <wx/dblayer/include/DatabaseLayerException.h>
+#include <wx/dblayer/include/DatabaseResultSet.h>
+#include <wx/dblayer/include/ResultSetMetaData.h>
+
+namespace
+{
+const wxString CURSOR_NAME = "codelite_result_cursor";
+
+bool IsBlobColumn(const wxString& str)
+{
+    for(size_t i = 0; i < str.Len(); i++) {
+        if(!wxIsprint(str.GetChar(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+SqlQueryRunner::SqlQueryRunner(SQLCommandPanel* owner, size_t queryId, DatabaseLayerPtr db,
+                               IDbAdapter::TYPE adapterType, const wxString& useDb, const wxString& sql,
+                               bool useCursor)
+    : m_owner(owner)
+    , m_queryId(queryId)
+    , m_db(db)
+    , m_adapterType(adapterType)
+    , m_useDb(useDb)
+    , m_sql(sql)
+    , m_useCursor(useCursor)
+    , m_cancelled(false)
+{
+    if(m_useCursor) {
+        // DECLARE does not accept the statement terminator
+        m_sql.Trim().Trim(false);
+        while(m_sql.EndsWith(";")) {
+            m_sql.RemoveLast();
+            m_sql.Trim();
+        }
+    }
+}
+
+bool SqlQueryRunner::IsCursorStatement(const wxString& sql)
+{
+    wxString statement = sql;
+    statement.Trim().Trim(false);
+    while(statement.EndsWith(";")) {
+        statement.RemoveLast();
+        statement.Trim();
+    }
+    if(statement.Contains(";")) {
+        // more than one statement
+        return false;
+    }
+    wxString keyword = statement.BeforeFirst(' ').BeforeFirst('\n').BeforeFirst('\t').Upper();
+    return keyword == "SELECT" || keyword == "VALUES";
+}
+
+void SqlQueryRunner::Start()
+{
+    if(m_started) {
+        return;
+    }
+    m_started = true;
+    m_requestedRows = GetPageSize();
+    // the thread keeps the runner alive until the statement being executed returns
+    std::shared_ptr<SqlQueryRunner> self = shared_from_this();
+    std::thread([self]() { self->Run(); }).detach();
+}
+
+void SqlQueryRunner::FetchMore()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requestedRows += GetPageSize();
+    }
+    m_cv.notify_one();
+}
+
+void SqlQueryRunner::Cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled = true;
+    }
+    m_cv.notify_one();
+}
+
+bool SqlQueryRunner::WaitForRequest(size_t& rows)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_cancelled || m_requestedRows > m_fetchedRows; });
+    if(m_cancelled) {
+        return false;
+    }
+    rows = m_requestedRows - m_fetchedRows;
+    m_fetchedRows = m_requestedRows;
+    return true;
+}
+
+bool SqlQueryRunner::Post(std::shared_ptr<SqlResultPage> page)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_cancelled) {
+        return false;
+    }
+    m_owner->CallAfter(&SQLCommandPanel::OnQueryResult, page);
+    return true;
+}
+
+void SqlQueryRunner::Run()
+{
+    DatabaseResultSet* resultSet = nullptr;
+    bool firstPage = true;
+    try {
+        if(!m_useDb.IsEmpty()) {
+            m_db->RunQuery(m_useDb);
+        }
+        if(m_useCursor) {
+            // a cursor lives inside a transaction
+            m_db->BeginTransaction();
+            m_db->RunQuery(wxString() << "DECLARE " << CURSOR_NAME << " NO SCROLL CURSOR FOR " << m_sql);
+        }
+
+        size_t count = 0;
+        while(WaitForRequest(count)) {
+            if(m_useCursor) {
+                wxString fetch;
+                fetch << "FETCH FORWARD " << count << " FROM " << CURSOR_NAME;
+                resultSet = m_db->RunQueryWithResults(fetch);
+            } else if(!resultSet) {
+                resultSet = m_db->RunQueryWithResults(m_sql);
+            }
+
+            auto page = std::make_shared<SqlResultPage>();
+            page->queryId = m_queryId;
+            if(!resultSet) {
+                page->complete = true;
+                page->errorMessage = _("Unknown SQL error.");
+                Post(page);
+                break;
+            }
+
+            if(firstPage) {
+                firstPage = false;
+                ResultSetMetaData* metaData = resultSet->GetMetaData();
+                for(int i = 1; i <= metaData->GetColumnCount(); i++) {
+                    page->columns.push_back(ColumnInfo(metaData->GetColumnType(i), metaData->GetColumnName(i)));
+                    m_columnTypes.push_back(metaData->GetColumnType(i));
+                }
+            }
+
+            bool hasMore = ReadRows(resultSet, count, page->rows);
+            if(m_useCursor) {
+                // each FETCH returns a new result set
+                m_db->CloseResultSet(resultSet);
+                resultSet = nullptr;
+            }
+            page->complete = !hasMore;
+            if(!Post(page) || page->complete) {
+                break;
+            }
+        }
+
+    } catch(const DatabaseLayerException& e) {
+        auto page = std::make_shared<SqlResultPage>();
+        page->queryId = m_queryId;
+        page->complete = true;
+        // for some reason an exception is thrown even if the error code is 0...
+        if(e.GetErrorCode() != 0) {
+            page->errorMessage = wxString::Format(_("Error (%d): %s"), e.GetErrorCode(), e.GetErrorMessage().c_str());
+        }
+        Post(page);
+
+    } catch(...) {
+        auto page = std::make_shared<SqlResultPage>();
+        page->queryId = m_queryId;
+        page->complete = true;
+        page->errorMessage = _("Unknown error.");
+        Post(page);
+    }
+
+    try {
+        if(resultSet) {
+            m_db->CloseResultSet(resultSet);
+        }
+        if(m_useCursor) {
+            // nothing was modified, rolling back closes the cursor (and ends a transaction aborted by an error)
+            m_db->RollBack();
+        }
+    } catch(...) {
+        clWARNING() << "DatabaseExplorer: failed to close the query result set" << clEndl;
+    }
+}
+
+bool SqlQueryRunner::ReadRows(DatabaseResultSet* resultSet, size_t count, std::vector<SqlResultValue::Row_t>& rows)
+{
+    rows.reserve(count);
+    while(rows.size() < count) {
+        if(m_cancelled || !resultSet->Next()) {
+            return false;
+        }
+        rows.push_back(SqlResultValue::Row_t());
+        SqlResultValue::Row_t& row = rows.back();
+        row.reserve(m_columnTypes.size());
+        for(size_t i = 0; i < m_columnTypes.size(); i++) {
+            row.push_back(ReadValue(resultSet, i + 1, m_columnTypes[i]));
+        }
+    }
+    // the page is full, there might be more rows
+    return true;
+}
+
+SqlResultValue SqlQueryRunner::ReadValue(DatabaseResultSet* resultSet, int col, int type)
+{
+    switch(type) {
+    case ResultSetMetaData::COLUMN_INTEGER:
+        if(m_adapterType == IDbAdapter::atSQLITE) {
+            // SQLite does not enforce the column type
+            return SqlResultValue::Text(resultSet->GetResultString(col));
+        }
+        return SqlResultValue::Integer(resultSet->GetResultLong(col));
+
+    case ResultSetMetaData::COLUMN_BLOB: {
+        if(m_textCols.count(col)) {
+            // this column should be displayed as TEXT rather than BLOB
+            return SqlResultValue::Text(resultSet->GetResultString(col));
+
+        } else if(m_blobCols.count(col)) {
+            // this column should be displayed as BLOB
+            wxMemoryBuffer buffer;
+            resultSet->GetResultBlob(col, buffer);
+            return SqlResultValue::Blob(buffer.GetDataLen());
+        }
+
+        // first time
+        wxString strCol = resultSet->GetResultString(col);
+        if(IsBlobColumn(strCol)) {
+            m_blobCols.insert(col);
+            wxMemoryBuffer buffer;
+            resultSet->GetResultBlob(col, buffer);
+            return SqlResultValue::Blob(buffer.GetDataLen());
+        }
+        m_textCols.insert(col);
+        return SqlResultValue::Text(strCol);
+    }
+
+    case ResultSetMetaData::COLUMN_BOOL:
+        return SqlResultValue::Bool(resultSet->GetResultBool(col));
+
+    case ResultSetMetaData::COLUMN_DATE:
+        return SqlResultValue::Date(resultSet->GetResultDate(col));
+
+    case ResultSetMetaData::COLUMN_DOUBLE:
+        return SqlResultValue::Double(resultSet->GetResultDouble(col));
+
+    case ResultSetMetaData::COLUMN_NULL:
+        return SqlResultValue::Null();
+
+    case ResultSetMetaData::COLUMN_STRING:
+    case ResultSetMetaData::COLUMN_UNKNOWN:
+    default:
+        return SqlResultValue::Text(resultSet->GetResultString(col));
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SQLQUERYRUNNER_H
+#define SQLQUERYRUNNER_H
+
+#include "IDbAdapter.h"
+#include "SqlQueryResult.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+class DatabaseResultSet;
+class SQLCommandPanel;
+
+/**
+ * @class SqlQueryRunner
+ * @brief run a query on a worker thread and fetch its rows in pages.
+ *
+ * The first page is fetched as soon as the query runs, the next pages only when they are requested with FetchMore()
+ * (i.e. when the user scrolls to the end of the rows fetched so far). The pages are sent to the SQL panel with
+ * SQLCommandPanel::OnQueryResult(). When a cursor is used (PostgreSQL, see IsCursorStatement()) the query is declared
+ * as a server side cursor and every page is a FETCH from it, so the rows that were not fetched stay on the server.
+ * The worker thread is detached and holds a reference to the runner: a statement that is being executed cannot be
+ * interrupted, so cancelling does not wait for it, the runner is deleted when the worker exits
+ */
+class SqlQueryRunner : public std::enable_shared_from_this<SqlQueryRunner>
+{
+    SQLCommandPanel* m_owner;
+    size_t m_queryId;
+    DatabaseLayerPtr m_db;
+    IDbAdapter::TYPE m_adapterType;
+    wxString m_useDb;
+    wxString m_sql;
+    bool m_useCursor;
+    bool m_started = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    size_t m_requestedRows = 0;
+    size_t m_fetchedRows = 0;
+    std::atomic_bool m_cancelled;
+
+    std::vector<int> m_columnTypes;
+    // BLOB columns that were found to hold text (or binary data)
+    std::set<int> m_textCols;
+    std::set<int> m_blobCols;
+
+protected:
+    void Run();
+
+    /**
+     * @brief wait until more rows are requested
+     * @param rows [output] the number of rows to fetch
+     * @return false if the query was cancelled
+     */
+    bool WaitForRequest(size_t& rows);
+    bool ReadRows(DatabaseResultSet* resultSet, size_t count, std::vector<SqlResultValue::Row_t>& rows);
+    SqlResultValue ReadValue(DatabaseResultSet* resultSet, int col, int type);
+    bool Post(std::shared_ptr<SqlResultPage> page);
+
+public:
+    SqlQueryRunner(SQLCommandPanel* owner, size_t queryId, DatabaseLayerPtr db, IDbAdapter::TYPE adapterType,
+                   const wxString& useDb, const wxString& sql, bool useCursor);
+    ~SqlQueryRunner() = default;
+
+    /**
+     * @brief the number of rows in a page
+     */
+    static size_t GetPageSize() { return 500; }
+
+    /**
+     * @brief can `sql` be run through a server side cursor? (a single SELECT statement)
+     */
+    static bool IsCursorStatement(const wxString& sql);
+
+    /**
+     * @brief start the worker thread, it runs the query and fetches the first page. The runner must be owned by a
+     * std::shared_ptr
+     */
+    void Start();
+
+    /**
+     * @brief request the next page
+     */
+    void FetchMore();
+
+    /**
+     * @brief stop fetching rows. This function does not wait for the worker thread, but once it returns no more pages
+     * are sent to the owner
+     */
+    void Cancel();
+};
+
+#endif // SQLQUERYRUNNER_H
@@ -0,0 +1,134 @@
+#include "SqlResultGrid.h"
+
+#include "clTableLineEditorDlg.h"
+#include "globals.h"
+
+#include <algorithm>
+#include <iterator>
+#include <wx/sizer.h>
+
+namespace
+{
+// ask for the next page when the displayed rows are this close to the end of the list
+constexpr long FETCH_AHEAD_ROWS = 200;
+
+class SqlResultListCtrl : public wxListCtrl
+{
+    SqlResultGrid* m_grid;
+    std::function<void()>& m_fetchMore;
+
+public:
+    SqlResultListCtrl(SqlResultGrid* grid, std::function<void()>& fetchMore)
+        : wxListCtrl(grid, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                     wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL | wxLC_HRULES | wxLC_VRULES)
+        , m_grid(grid)
+        , m_fetchMore(fetchMore)
+    {
+    }
+
+protected:
+    wxString OnGetItemText(long item, long column) const override
+    {
+        if(m_fetchMore && item + FETCH_AHEAD_ROWS >= GetItemCount()) {
+            m_fetchMore();
+        }
+        return m_grid->GetCellText(item, column);
+    }
+};
+} // namespace
+
+SqlResultGrid::SqlResultGrid(wxWindow* parent, wxWindowID winid, const wxPoint& pos, const wxSize& size, long style,
+                             const wxString& name)
+    : wxPanel(parent, winid, pos, size, style, name)
+{
+    SetSizer(new wxBoxSizer(wxVERTICAL));
+    m_list = new SqlResultListCtrl(this, m_fetchMore);
+    GetSizer()->Add(m_list, 1, wxEXPAND | wxALL, 5);
+    m_staticText = new wxStaticText(this, wxID_ANY, "");
+    GetSizer()->Add(m_staticText, 0, wxEXPAND | wxALL, 5);
+
+    m_list->Bind(wxEVT_LIST_ITEM_ACTIVATED, &SqlResultGrid::OnItemActivated, this);
+    GetSizer()->Fit(this);
+}
+
+SqlResultGrid::~SqlResultGrid() {}
+
+void SqlResultGrid::SetColumns(const ColumnInfo::Vector_t& columns)
+{
+    ClearAll();
+    m_columns = columns;
+    for(const auto& column : m_columns) {
+        m_list->AppendColumn(column.GetName(), wxLIST_FORMAT_LEFT, 150);
+    }
+}
+
+void SqlResultGrid::AppendRows(std::vector<SqlResultValue::Row_t>& rows)
+{
+    if(m_rows.empty()) {
+        m_rows.swap(rows);
+    } else {
+        m_rows.reserve(m_rows.size() + rows.size());
+        std::move(rows.begin(), rows.end(), std::back_inserter(m_rows));
+        rows.clear();
+    }
+    m_list->SetItemCount(m_rows.size());
+    m_list->Refresh();
+}
+
+void SqlResultGrid::ClearAll()
+{
+    m_rows.clear();
+    m_columns.clear();
+    m_list->ClearAll(); // deletes the columns as well
+    m_staticText->SetLabel(wxEmptyString);
+}
+
+void SqlResultGrid::SetStatusText(const wxString& text) { m_staticText->SetLabel(text); }
+
+wxString SqlResultGrid::GetCellText(long row, long col) const
+{
+    if(row < 0 || (size_t)row >= m_rows.size()) {
+        return wxEmptyString;
+    }
+    const SqlResultValue::Row_t& values = m_rows[row];
+    if(col < 0 || (size_t)col >= values.size()) {
+        return wxEmptyString;
+    }
+    return MakeDisplayString(values[col].ToString());
+}
+
+wxString SqlResultGrid::MakeDisplayString(const wxString& str) const
+{
+    // truncate the string to a reasonable string
+    wxString truncatedString = str;
+    if(truncatedString.Length() > 100) {
+        truncatedString = truncatedString.Mid(0, 100);
+        truncatedString.Append(wxT("..."));
+    }
+
+    // Convert all whitespace chars into visible ones
+    truncatedString.Replace(wxT("\n"), wxT("\\n"));
+    truncatedString.Replace(wxT("\r"), wxT("\\r"));
+    truncatedString.Replace(wxT("\t"), wxT("\\t"));
+    return truncatedString;
+}
+
+void SqlResultGrid::OnItemActivated(wxListEvent& event)
+{
+    long row = event.GetIndex();
+    if(row < 0 || (size_t)row >= m_rows.size()) {
+        return;
+    }
+
+    wxArrayString columns;
+    for(const auto& column : m_columns) {
+        columns.Add(column.GetName());
+    }
+    wxArrayString data;
+    for(const auto& value : m_rows[row]) {
+        data.Add(value.ToString());
+    }
+
+    clTableLineEditorDlg* dlg = new clTableLineEditorDlg(::wxGetTopLevelParent(this), columns, data);
+    dlg->Show();
+}
@@ -0,0 +1,62 @@
+#ifndef SQLRESULTGRID_H
+#define SQLRESULTGRID_H
+
+#include "SqlQueryResult.h"
+
+#include <functional>
+#include <vector>
+#include <wx/listctrl.h>
+#include <wx/panel.h>
+#include <wx/stattext.h>
+
+/**
+ * @class SqlResultGrid
+ * @brief displays the rows of a query in a virtual list. The rows are kept in their native types and only the visible
+ * cells are converted into strings. When the rows near the end of the list are displayed, the "fetch more" callback
+ * is called so the owner can fetch the next page of the query
+ */
+class SqlResultGrid : public wxPanel
+{
+    wxListCtrl* m_list = nullptr;
+    wxStaticText* m_staticText = nullptr;
+    ColumnInfo::Vector_t m_columns;
+    std::vector<SqlResultValue::Row_t> m_rows;
+    std::function<void()> m_fetchMore;
+
+protected:
+    wxString MakeDisplayString(const wxString& str) const;
+    void OnItemActivated(wxListEvent& event);
+
+public:
+    SqlResultGrid(wxWindow* parent, wxWindowID winid = wxID_ANY, const wxPoint& pos = wxDefaultPosition,
+                  const wxSize& size = wxDefaultSize, long style = wxTAB_TRAVERSAL | wxNO_BORDER,
+                  const wxString& name = wxPanelNameStr);
+    virtual ~SqlResultGrid();
+
+    /**
+     * @brief define the columns for this table
+     * Calling this functions clears all the rows from the table!
+     */
+    void SetColumns(const ColumnInfo::Vector_t& columns);
+
+    /**
+     * @brief append rows to the table. `rows` is moved into the table
+     */
+    void AppendRows(std::vector<SqlResultValue::Row_t>& rows);
+
+    /**
+     * @brief clear all rows and columns from the table
+     */
+    void ClearAll();
+
+    size_t GetRowCount() const { return m_rows.size(); }
+    void SetStatusText(const wxString& text);
+    void SetFetchMoreCallback(std::function<void()> cb) { m_fetchMore = std::move(cb); }
+
+    /**
+     * @brief return the text to display for a given cell. Called by the virtual list
+     */
+    wxString GetCellText(long row, long col) const;
+};
+
+#endif // SQLRESULTGRID_H
@@ -57,10 +57,12 @@
 #include "sessionmanager.h"
 #include "workspacetab.h"
 
+#include <algorithm>
 #include <memory>
 #include <wx/dir.h>
 #include <wx/filename.h>
 #include <wx/log.h>
+#include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 #include <wx/toolbook.h>
 #include <wx/xrc/xmlres.h>
@@ -107,6 +109,114 @@ void PluginManager::UnLoad()
     }
     m_plugins.clear();
     m_dl.clear();
+
+    // plugins that were never constructed
+    for (auto& deferred : m_deferredPlugins) {
+        wxDELETE(deferred.dl);
+    }
+    m_deferredPlugins.clear();
+}
+
+IPlugin* PluginManager::DoCreatePlugin(GET_PLUGIN_CREATE_FUNC create_func, clDynamicLibrary* dl, long* init_ms)
+{
+    wxStopWatch sw;
+    IPlugin* plugin = create_func((IManager*)this);
+    clDEBUG() << "Loaded plugin:" << plugin->GetLongName() << endl;
+    m_plugins[plugin->GetShortName()] = plugin;
+
+    // Load the toolbar
+    plugin->CreateToolBar(clMainFrame::Get()->GetPluginsToolBar());
+
+    // Keep the dynamic load library
+    m_dl.push_back(dl);
+    *init_ms = sw.Time();
+    return plugin;
+}
+
+bool PluginManager::DoLoadDeferredPlugin(const wxString& pluginName)
+{
+    auto iter = std::find_if(m_deferredPlugins.begin(), m_deferredPlugins.end(),
+                             [&](const DeferredPlugin& deferred) { return deferred.name == pluginName; });
+    if (iter == m_deferredPlugins.end()) {
+        return false;
+    }
+
+    // remove it from the list before constructing it: the plugin constructor may call GetPlugin()
+    DeferredPlugin deferred = *iter;
+    m_deferredPlugins.erase(iter);
+
+    PluginLoadProfile profile;
+    profile.name = deferred.name;
+    profile.load_ms = deferred.load_ms;
+    profile.deferred = true;
+    IPlugin* plugin = DoCreatePlugin(deferred.create_func, deferred.dl, &profile.init_ms);
+
+    // The 'Plugins' menu and the toolbars were already built, add this plugin to them
+    wxStopWatch sw;
+    wxMenu* pluginsMenu = NULL;
+    wxMenuItem* menuitem = clMainFrame::Get()->GetMainMenuBar()->FindItem(XRCID("manage_plugins"), &pluginsMenu);
+    if (pluginsMenu && menuitem) {
+        plugin->SetPluginsMenu(pluginsMenu);
+        plugin->CreatePluginMenu(pluginsMenu);
+    }
+    clMainFrame::Get()->GetPluginsToolBar()->Realize();
+    clMainFrame::Get()->GetDockingManager().Update();
+    profile.init_ms += sw.Time();
+
+    m_loadProfile.push_back(profile);
+    return true;
+}
+
+void PluginManager::DoLoadNextDeferredPlugin()
+{
+    if (m_deferredPlugins.empty()) {
+        return;
+    }
+
+    DoLoadDeferredPlugin(m_deferredPlugins.front().name);
+    if (m_deferredPlugins.empty()) {
+        DoLogLoadProfile();
+    } else {
+        clMainFrame::Get()->CallAfter([this]() { DoLoadNextDeferredPlugin(); });
+    }
+}
+
+void PluginManager::LoadDeferredPlugins()
+{
+    while (!m_deferredPlugins.empty()) {
+        DoLoadDeferredPlugin(m_deferredPlugins.front().name);
+    }
+    DoLogLoadProfile();
+}
+
+const PluginManager::PluginLoadProfile* PluginManager::GetLoadProfile(const wxString& pluginName) const
+{
+    for (const auto& profile : m_loadProfile) {
+        if (profile.name == pluginName) {
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
+void PluginManager::DoLogLoadProfile() const
+{
+    // Print the slowest plugins first
+    PluginLoadProfile::Vec_t profile = m_loadProfile;
+    std::sort(profile.begin(), profile.end(), [](const PluginLoadProfile& a, const PluginLoadProfile& b) {
+        return (a.load_ms + a.init_ms) > (b.load_ms + b.init_ms);
+    });
+
+    long total_ms = 0;
+    clSYSTEM() << "Plugins load profile (load ms / init ms):" << endl;
+    for (const auto& p : profile) {
+        clSYSTEM() << "  " << p.name << ":" << p.load_ms << "/" << p.init_ms << (p.deferred ? "(deferred)" : "")
+                   << endl;
+        if (!p.deferred) {
+            total_ms += p.load_ms + p.init_ms;
+        }
+    }
+    clSYSTEM() << "Total time spent loading plugins before the main frame was shown:" << total_ms << "ms" << endl;
 }
 
 PluginManager::~PluginManager() {}
@@ -177,6 +287,7 @@ void PluginManager::Load()
             }
 #endif
 
+            wxStopWatch sw;
             clDynamicLibrary* dl = new clDynamicLibrary();
             if (!dl->Load(fileName)) {
                 clERROR() << "Failed to load plugin's dll" << fileName << endl;
@@ -258,16 +369,25 @@ void PluginManager::Load()
                 continue;
             }
 
-            // Construct the plugin
-            IPlugin* plugin = pfn((IManager*)this);
-            clDEBUG() << "Loaded plugin:" << plugin->GetLongName() << endl;
-            m_plugins[plugin->GetShortName()] = plugin;
-
-            // Load the toolbar
-            plugin->CreateToolBar(clMainFrame::Get()->GetPluginsToolBar());
+            long load_ms = sw.Time();
+            if (pluginInfo->HasFlag(PluginInfo::kLoadDeferred)) {
+                // Construct it once the IDE is up, or when it is first requested
+                clDEBUG() << "Plugin:" << pluginInfo->GetName() << "loading is deferred" << endl;
+                DeferredPlugin deferred;
+                deferred.name = pluginInfo->GetName();
+                deferred.dl = dl;
+                deferred.create_func = pfn;
+                deferred.load_ms = load_ms;
+                m_deferredPlugins.push_back(deferred);
+                continue;
+            }
 
-            // Keep the dynamic load library
-            m_dl.push_back(dl);
+            // Construct the plugin
+            PluginLoadProfile profile;
+            profile.name = pluginInfo->GetName();
+            profile.load_ms = load_ms;
+            DoCreatePlugin(pfn, dl, &profile.init_ms);
+            m_loadProfile.push_back(profile);
         }
         clMainFrame::Get()->GetDockingManager().Update();
 
@@ -285,6 +405,13 @@ void PluginManager::Load()
 
         // save the plugins data
         conf.WriteItem(&m_pluginsData);
+
+        // Construct the deferred plugins one by one, letting the event loop run between them
+        if (!m_deferredPlugins.empty()) {
+            clMainFrame::Get()->CallAfter([this]() { DoLoadNextDeferredPlugin(); });
+        } else {
+            DoLogLoadProfile();
+        }
     }
 
     // Now that all the plugins are loaded, load from the configuration file
@@ -462,6 +589,14 @@ IPlugin* PluginManager::GetPlugin(const wxString& pluginName)
     if (iter != m_plugins.end()) {
         return iter->second;
     }
+
+    // First use of a deferred plugin, construct it now
+    if (DoLoadDeferredPlugin(pluginName)) {
+        iter = m_plugins.find(pluginName);
+        if (iter != m_plugins.end()) {
+            return iter->second;
+        }
+    }
     return NULL;
 }
 
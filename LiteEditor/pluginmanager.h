@@ -52,7 +52,28 @@ class clInfoBar;
 
 class PluginManager : public IManager
 {
+public:
+    /// Time spent loading a single plugin
+    struct PluginLoadProfile {
+        wxString name;
+        long load_ms = 0; // loading the shared object and resolving its symbols
+        long init_ms = 0; // constructing the plugin, its toolbar and menu
+        bool deferred = false;
+        typedef std::vector<PluginLoadProfile> Vec_t;
+    };
+
+private:
+    /// A plugin whose library is loaded but its construction was postponed
+    struct DeferredPlugin {
+        wxString name;
+        clDynamicLibrary* dl = nullptr;
+        GET_PLUGIN_CREATE_FUNC create_func = nullptr;
+        long load_ms = 0;
+    };
+
     std::map<wxString, IPlugin*> m_plugins;
+    std::vector<DeferredPlugin> m_deferredPlugins;
+    PluginLoadProfile::Vec_t m_loadProfile;
     std::list<clDynamicLibrary*> m_dl;
     PluginInfoArray m_pluginsData;
     BitmapLoader* m_bmpLoader;
@@ -65,6 +86,11 @@ private:
     PluginManager();
     virtual ~PluginManager();
 
+    IPlugin* DoCreatePlugin(GET_PLUGIN_CREATE_FUNC create_func, clDynamicLibrary* dl, long* init_ms);
+    bool DoLoadDeferredPlugin(const wxString& pluginName);
+    void DoLoadNextDeferredPlugin();
+    void DoLogLoadProfile() const;
+
 public:
     static PluginManager* Get();
 
@@ -72,6 +98,17 @@ public:
     virtual void UnLoad();
     virtual void EnableToolbars();
 
+    /**
+     * @brief construct all the plugins whose loading was deferred
+     */
+    void LoadDeferredPlugins();
+
+    /**
+     * @brief return the time spent loading each plugin (the loading order is preserved)
+     */
+    const PluginLoadProfile::Vec_t& GetLoadProfile() const { return m_loadProfile; }
+    const PluginLoadProfile* GetLoadProfile(const wxString& pluginName) const;
+
     void SetInstalledPlugins(const PluginInfo::PluginMap_t& installedPlugins)
     {
         this->m_installedPlugins = installedPlugins;
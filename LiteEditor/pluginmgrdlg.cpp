@@ -126,6 +126,18 @@ void PluginMgrDlg::CreateInfoPage(unsigned int index)
 
         WritePropertyLine(_("Is Loaded?"), plugins.CanLoad(info) ? _("Yes") : _("No"));
         m_richTextCtrl->Newline();
+
+        const PluginManager::PluginLoadProfile* profile = PluginManager::Get()->GetLoadProfile(info.GetName());
+        if(profile) {
+            wxString loadTime;
+            loadTime << profile->load_ms + profile->init_ms << "ms (" << _("load: ") << profile->load_ms << "ms, "
+                     << _("init: ") << profile->init_ms << "ms)";
+            if(profile->deferred) {
+                loadTime << " " << _("deferred");
+            }
+            WritePropertyLine(_("Load Time"), loadTime);
+            m_richTextCtrl->Newline();
+        }
         m_richTextCtrl->Newline();
 
         m_richTextCtrl->BeginBold();
@@ -64,6 +64,7 @@ protected:
     MemCheckSettings* m_settings;
     wxString m_outputLogFileName;
     ErrorList m_errorList;
+    MemCheckFrameTable m_frameTable; ///< owns the locations of all errors in m_errorList
 
 public:
     /**
@@ -93,6 +94,22 @@ public:
      * @brief Processes data from external tool (log file) to ErrorList.
      */
     virtual bool Process(const wxString& outputLogFileName = wxEmptyString) = 0;
+
+    /**
+     * @brief Processes the data the external tool has written to the log file since the last call. It is called while
+     * the tool is running, new errors are appended to ErrorList.
+     * @return number of new errors
+     */
+    virtual size_t ProcessNewOutput() { return 0; }
+
+    /**
+     * @brief Removes all errors, e.g. before new test starts.
+     */
+    virtual void Reset()
+    {
+        m_errorList.clear();
+        m_frameTable.Clear();
+    }
 };
 
 #endif //_IMEMCHECKPROCESSOR_H_
@@ -52,6 +52,8 @@ MemCheckPlugin::MemCheckPlugin(IManager* manager)
 {
     m_terminal.Bind(wxEVT_TERMINAL_COMMAND_EXIT, &MemCheckPlugin::OnProcessTerminated, this);
     m_terminal.Bind(wxEVT_TERMINAL_COMMAND_OUTPUT, &MemCheckPlugin::OnProcessOutput, this);
+    m_logTimer = new wxTimer(this);
+    Bind(wxEVT_TIMER, &MemCheckPlugin::OnLogTimer, this, m_logTimer->GetId());
 
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckPlugin constructor"));
     m_longName = _("Detects memory management problems. Uses Valgrind - memcheck skin.");
@@ -109,6 +111,7 @@ MemCheckPlugin::MemCheckPlugin(IManager* manager)
 MemCheckPlugin::~MemCheckPlugin()
 {
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckPlugin destroyed"));
+    wxDELETE(m_logTimer);
     wxDELETE(m_memcheckProcessor);
     wxDELETE(m_settings);
 }
@@ -180,6 +183,8 @@ void MemCheckPlugin::UnPlug()
     m_tabHelper.reset(NULL);
     m_terminal.Unbind(wxEVT_TERMINAL_COMMAND_EXIT, &MemCheckPlugin::OnProcessTerminated, this);
     m_terminal.Unbind(wxEVT_TERMINAL_COMMAND_OUTPUT, &MemCheckPlugin::OnProcessOutput, this);
+    m_logTimer->Stop();
+    Unbind(wxEVT_TIMER, &MemCheckPlugin::OnLogTimer, this, m_logTimer->GetId());
 
     m_mgr->GetTheApp()->Disconnect(XRCID("memcheck_check_active_project"), wxEVT_COMMAND_MENU_SELECTED,
                                    wxCommandEventHandler(MemCheckPlugin::OnCheckAtiveProject), NULL,
@@ -312,7 +317,16 @@ void MemCheckPlugin::CheckProject(const wxString& projectName)
     m_memcheckProcessor->GetExecutionCommand(command, cmd, cmdArgs);
     m_mgr->AppendOutputTabText(kOutputTab_Output, wxString()
                                                       << _("MemCheck command: ") << command << " " << cmdArgs << "\n");
-    m_terminal.ExecuteConsole(cmd, true, cmdArgs, "", wxString::Format("MemCheck: %s", projectName));
+
+    // errors are shown as valgrind writes them, make sure the log of the previous run is not read
+    m_memcheckProcessor->Reset();
+    if(wxFileExists(m_memcheckProcessor->GetOutputLogFileName()))
+        wxRemoveFile(m_memcheckProcessor->GetOutputLogFileName());
+
+    if(m_terminal.ExecuteConsole(cmd, true, cmdArgs, "", wxString::Format("MemCheck: %s", projectName))) {
+        SwitchToMyPage();
+        m_logTimer->Start(500);
+    }
 }
 
 void MemCheckPlugin::OnImportLog(wxCommandEvent& event)
@@ -363,14 +377,23 @@ void MemCheckPlugin::OnProcessOutput(clCommandEvent& event)
 void MemCheckPlugin::OnProcessTerminated(clCommandEvent& event)
 {
     m_mgr->AppendOutputTabText(kOutputTab_Output, _("\n-- MemCheck process completed\n"));
+    m_logTimer->Stop();
     wxBusyInfo wait(BUSY_MESSAGE);
     m_mgr->GetTheApp()->Yield();
 
+    // most of the log was already parsed while the process was running, this parses only the rest
     m_memcheckProcessor->Process();
     m_outputView->LoadErrors();
     SwitchToMyPage();
 }
 
+void MemCheckPlugin::OnLogTimer(wxTimerEvent& event)
+{
+    if(m_memcheckProcessor->ProcessNewOutput() > 0) {
+        m_outputView->AppendErrors();
+    }
+}
+
 void MemCheckPlugin::OnStopProcess(wxCommandEvent& event)
 {
     wxUnusedVar(event);
@@ -40,6 +40,7 @@
 #include "plugin.h"
 
 #include <wx/process.h>
+#include <wx/timer.h>
 
 class MemCheckOutputView;
 
@@ -89,6 +90,7 @@ protected:
     MemCheckSettings* m_settings;
     TerminalEmulator m_terminal;
     MemCheckOutputView* m_outputView; ///< Main plugin UI pane.
+    wxTimer* m_logTimer;              ///< While test is running, new errors are read from the log periodically
     clTabTogglerHelper::Ptr_t m_tabHelper;
 
 protected:
@@ -141,6 +143,12 @@ protected:
     void OnProcessOutput(clCommandEvent& event);
     void OnProcessTerminated(clCommandEvent& event);
 
+    /**
+     * @brief Parses the part of the log written since the last tick and shows the new errors.
+     * @param event
+     */
+    void OnLogTimer(wxTimerEvent& event);
+
     /**
      * @brief Analyse can be made independent of CodeLite and log can be load from file.
      * @param event
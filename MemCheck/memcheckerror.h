@@ -30,7 +30,8 @@
  * @copyright GNU General Public License v2
  *
  * ErrorList implements of list of parsed errors. Basically Error have label and trace log - list of Locations.
- * LocationList represents stack trace.
+ * LocationList represents stack trace. Locations are owned by MemCheckFrameTable, where each distinct frame is stored
+ * only once, stack traces hold pointers to them.
  */
 
 #ifndef _MEMCHECKERROR_H_
@@ -39,15 +40,18 @@
 #include <wx/wx.h>
 #include <wx/tokenzr.h>
 
-#include <list>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 #include "memcheckdefs.h"
 
 class MemCheckErrorLocation;
 class MemCheckError;
 
-typedef std::list<MemCheckErrorLocation> LocationList;
-typedef std::list<MemCheckError> ErrorList;
+typedef std::vector<MemCheckErrorLocation*> LocationList;
+// std::deque keeps references valid when errors are appended while valgrind is running (see MemCheckErrorReferrer)
+typedef std::deque<MemCheckError> ErrorList;
 typedef MemCheckError* MemCheckErrorPtr;
 
 
@@ -189,6 +193,28 @@ public:
 };
 
 
+/**
+ * @class MemCheckFrameTable
+ * @brief Storage of all stack frames of an error list.
+ *
+ * Most errors share the outer part of their stack trace (main, the event loop, ...), so every distinct frame is stored
+ * only once and the errors hold pointers to it. Stored frames are never moved, so the pointers stay valid until Clear()
+ */
+class MemCheckFrameTable
+{
+    std::deque<MemCheckErrorLocation> m_frames;
+    std::unordered_map<wxString, MemCheckErrorLocation*> m_index;
+
+public:
+    /**
+     * @brief returns the stored frame equal to location, the frame is added if it is not in the table yet
+     */
+    MemCheckErrorLocation* Add(const MemCheckErrorLocation& location);
+    void Clear();
+    size_t GetCount() const { return m_frames.size(); }
+};
+
+
 /**
  * @brief flags to use with MemCheckIterTools
  */
@@ -248,6 +274,7 @@ public:
         IterTool m_iterTool;
     public:
         ErrorListIterator(ErrorList & l, const IterTool & iterTool);
+        ErrorListIterator(ErrorList & l, ErrorList::iterator start, const IterTool & iterTool);
         ~ErrorListIterator();
         ErrorList::iterator& operator++();
         ErrorList::iterator operator++(int);
@@ -265,6 +292,7 @@ protected:
     MemCheckIterTools(const wxString & workspacePath, unsigned int flags);
 
     ErrorListIterator GetIterator(ErrorList & l);
+    ErrorListIterator GetIterator(ErrorList & l, ErrorList::iterator start);
     LocationListIterator GetIterator(LocationList & l);
 
 public:
@@ -278,6 +306,14 @@ public:
      * This method calls MemCheckIterTools constructor and then GetIterator method.
      */
     static ErrorListIterator Factory(ErrorList & l, const wxString & workspacePath, unsigned int flags);
+
+    /**
+     * @brief Same as above but the iteration starts at "start" (which must not be omitted by the flags).
+     *
+     * It is used to continue the iteration when new errors were appended to the list.
+     */
+    static ErrorListIterator Factory(ErrorList & l, ErrorList::iterator start, const wxString & workspacePath,
+                                     unsigned int flags);
     
     /**
      * @brief Creates iterator with holds settings and does iteration.
@@ -96,11 +96,19 @@ void MemCheckOutputView::ResetItemsView()
         flags |= MC_IT_OMIT_SUPPRESSED;
 
     m_totalErrorsView = 0;
-    for(MemCheckIterTools::ErrorListIterator it = MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
-        it != errorList.end(); ++it) {
+    m_lastErrorView = 0;
+    MemCheckIterTools::ErrorListIterator it = MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
+    while(it != errorList.end()) {
+        m_lastErrorView = it++ - errorList.begin();
         ++m_totalErrorsView;
     }
 
+    UpdatePageMax();
+    itemsInvalidView = false;
+}
+
+void MemCheckOutputView::UpdatePageMax()
+{
     if(m_totalErrorsView)
         m_pageMax = (m_totalErrorsView - 1) / m_plugin->GetSettings()->GetResultPageSize() + 1;
     else
@@ -112,7 +120,58 @@ void MemCheckOutputView::ResetItemsView()
     pageValidator.SetRange(1, m_pageMax);
     m_textCtrlPageNumber->SetValidator(pageValidator);
     pageValidator.SetWindow(m_textCtrlPageNumber);
-    itemsInvalidView = false;
+}
+
+void MemCheckOutputView::AppendErrors()
+{
+    ErrorList& errorList = m_plugin->GetProcessor()->GetErrors();
+    if(errorList.empty())
+        return;
+
+    if(m_totalErrorsView == 0) {
+        // first errors of this test
+        if(m_mgr->IsWorkspaceOpen())
+            m_workspacePath =
+                m_mgr->GetWorkspace()->GetWorkspaceFileName().GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
+        else
+            m_workspacePath = wxEmptyString;
+    }
+
+    unsigned int flags = 0;
+    if(m_plugin->GetSettings()->GetOmitNonWorkspace())
+        flags |= MC_IT_OMIT_NONWORKSPACE;
+    if(m_plugin->GetSettings()->GetOmitDuplications())
+        flags |= MC_IT_OMIT_DUPLICATIONS;
+    if(m_plugin->GetSettings()->GetOmitSuppressed())
+        flags |= MC_IT_OMIT_SUPPRESSED;
+
+    // continue from the last counted error, so duplications are compared with it
+    MemCheckIterTools::ErrorListIterator it =
+        m_totalErrorsView == 0
+            ? MemCheckIterTools::Factory(errorList, m_workspacePath, flags)
+            : MemCheckIterTools::Factory(errorList, errorList.begin() + m_lastErrorView, m_workspacePath, flags);
+    if(m_totalErrorsView > 0)
+        ++it;
+
+    size_t pageSize = m_plugin->GetSettings()->GetResultPageSize();
+    size_t totalErrorsBefore = m_totalErrorsView;
+    while(it != errorList.end()) {
+        ErrorList::iterator error = it++;
+        m_lastErrorView = error - errorList.begin();
+        ++m_totalErrorsView;
+        if(m_totalErrorsView <= pageSize)
+            AddTree(wxDataViewItem(0), *error);
+    }
+
+    if(m_totalErrorsView == totalErrorsBefore)
+        return;
+
+    if(totalErrorsBefore == 0) {
+        m_currentPage = 1;
+        m_currentPageIsEmptyView = false;
+    }
+    UpdatePageMax();
+    pageValidator.TransferToWindow();
 }
 
 void MemCheckOutputView::ResetItemsSupp()
@@ -1009,6 +1068,14 @@ void MemCheckOutputView::Clear()
 {
     m_dataViewCtrlErrorsModel->Clear();
     m_listCtrlErrors->DeleteAllItems();
+
+    m_totalErrorsView = 0;
+    m_lastErrorView = 0;
+    m_currentPage = 0;
+    m_currentPageIsEmptyView = true;
+    m_currentItem = wxDataViewItem(0);
+    UpdatePageMax();
+    m_textCtrlPageNumber->Clear();
 }
 void MemCheckOutputView::OnStop(wxCommandEvent& event) { m_plugin->StopProcess(); }
 void MemCheckOutputView::OnStopUI(wxUpdateUIEvent& event) { event.Enable(m_plugin->IsRunning()); }
@@ -122,8 +122,10 @@ protected:
     wxDataViewItem m_currentItem;
     bool m_onValueChangedLocked; ///< if user (un)checks an item, all items in its tree must be (un)checked. This action is trigered by OnValueChanged callback. Problem is that if an item is checked is also invoked that callback. So this lock brakes the infinite loop.
     size_t m_totalErrorsView;
+    size_t m_lastErrorView; ///< index of the last error counted in "m_totalErrorsView", used by AppendErrors()
     size_t m_currentPage;
     size_t m_pageMax;
+    void UpdatePageMax(); ///< recompute "m_pageMax" from "m_totalErrorsView"
 
     wxDataViewItem GetTopParent(wxDataViewItem item); ///< get top level item for an item
     wxDataViewItem GetLeaf(const wxDataViewItem &item, bool first); ///< get deepes item for an item(error), first == true means firts from top, first==false means last.
@@ -171,6 +173,13 @@ public:
      * MemCheck plugin calls this method after test ends and after processor parses logfile into ErrorList.
      */
     void LoadErrors();
+    /**
+     * @brief Add errors appended to ErrorList since the last call (or since Clear()) to the tree view page.
+     *
+     * MemCheck plugin calls this method while the test is running. Errors are added to the first page until it is full,
+     * the rest is only counted. LoadErrors() must be called after the test ends to refresh both pages.
+     */
+    void AppendErrors();
     /**
      * @brief clear the content
      */
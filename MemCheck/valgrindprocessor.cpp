@@ -12,11 +12,25 @@
 #include "memchecksettings.h"
 #include "workspace.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <wx/ffile.h>
 #include <wx/stdpaths.h>
 #include <wx/textfile.h>
 
+namespace
+{
+// the log is read in chunks of this size
+const size_t READ_CHUNK_SIZE = 64 * 1024;
+// while valgrind is running, at most this much of the log is parsed on every update
+const size_t MAX_BYTES_PER_UPDATE = 4 * 1024 * 1024;
+} // namespace
+
 ValgrindMemcheckProcessor::ValgrindMemcheckProcessor(MemCheckSettings* const settings)
     : IMemCheckProcessor(settings)
+    , m_parser(m_errorList, m_frameTable)
+    , m_logOffset(0)
 {
 }
 
@@ -64,139 +78,66 @@ bool ValgrindMemcheckProcessor::Process(const wxString& outputLogFileName)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::Process()"));
 
-    if(!outputLogFileName.IsEmpty())
+    if(!outputLogFileName.IsEmpty()) {
+        // a log file is imported, start over
         m_outputLogFileName = outputLogFileName;
+        Reset();
+    }
 
-    wxXmlDocument doc;
-    if(!doc.Load(m_outputLogFileName) || doc.GetRoot()->GetName() != wxT("valgrindoutput")) {
+    if(!wxFileExists(m_outputLogFileName)) {
         return false;
     }
-    m_errorList.clear();
 
-    int i = 0;
-    wxXmlNode* errorNode = doc.GetRoot()->GetChildren();
-    while(errorNode) {
-        if(errorNode->GetName() == wxT("error")) {
-            m_errorList.push_back(ProcessError(doc, errorNode));
-        }
-        errorNode = errorNode->GetNext();
+    ReadLog(std::numeric_limits<size_t>::max(), true);
+    return m_parser.GetState() == ValgrindXmlParser::kParsing;
+}
 
-        if(i < 1000)
-            i++;
-        else {
-            i = 0;
-            // ATTN  m_mgr->GetTheApp()
-            wxTheApp->Yield();
-        }
-    }
-    return true;
+size_t ValgrindMemcheckProcessor::ProcessNewOutput() { return ReadLog(MAX_BYTES_PER_UPDATE, false); }
+
+void ValgrindMemcheckProcessor::Reset()
+{
+    IMemCheckProcessor::Reset();
+    m_parser.Reset();
+    m_logOffset = 0;
 }
 
-MemCheckError ValgrindMemcheckProcessor::ProcessError(wxXmlDocument& doc, wxXmlNode* errorNode)
+size_t ValgrindMemcheckProcessor::ReadLog(size_t maxBytes, bool yield)
 {
-    // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessError()"));
-
-    bool auxiliary = false;
-    MemCheckError result;
-    result.type = MemCheckError::TYPE_ERROR;
-    MemCheckError auxiliaryResult;
-
-    wxXmlNode* suberrorNode = errorNode->GetChildren();
-    while(suberrorNode) {
-
-        // retrieving error label
-        if(suberrorNode->GetName() == wxT("what")) {
-            result.label = suberrorNode->GetNodeContent();
-        } else if(suberrorNode->GetName() == wxT("xwhat")) {
-            wxXmlNode* child = suberrorNode->GetChildren();
-            while(child) {
-                if(child->GetName() == wxT("text")) {
-                    result.label = child->GetNodeContent();
-                    break;
-                }
-                child = child->GetNext();
-            }
-        } else if(suberrorNode->GetName() == wxT("auxwhat")) {
-            auxiliaryResult.label = suberrorNode->GetNodeContent();
-            auxiliaryResult.type = MemCheckError::TYPE_AUXILIARY;
-            auxiliary = true;
-        } else if(suberrorNode->GetName() == wxT("stack")) {
-            wxXmlNode* locationNode = suberrorNode->GetChildren();
-            while(locationNode) {
-                if(locationNode->GetName() == wxT("frame")) {
-                    if(auxiliary) {
-                        auxiliaryResult.locations.push_back(ProcessLocation(doc, locationNode));
-                    } else {
-                        result.locations.push_back(ProcessLocation(doc, locationNode));
-                    }
-                }
-                locationNode = locationNode->GetNext();
-            }
-        } else if(suberrorNode->GetName() == wxT("suppression")) {
-            wxXmlNode* child = suberrorNode->GetChildren();
-            while(child) {
-                if(child->GetName() == wxT("rawtext")) {
-                    result.suppression = child->GetNodeContent();
-                    break;
-                }
-                child = child->GetNext();
-            }
-        }
-        suberrorNode = suberrorNode->GetNext();
+    if(m_outputLogFileName.IsEmpty() || !wxFileExists(m_outputLogFileName)) {
+        return 0;
     }
 
-    if(!result.suppression)
-        result.suppression = wxT("#Suppresion pattern not present in output log.\n#This plugin requires Valgrind to be "
-                                 "run with '--gen-suppressions=all' option");
-
-    if(auxiliary)
-        result.nestedErrors.push_back(auxiliaryResult);
-
-    // TODO ? add checout ?
-    // add check for empty locationArrays
-    //  CL_DEBUG1(PLUGIN_PREFIX("\t equal #0 and #1 = %s", (errorArray.Item(0) == errorArray.Item(1)?"true":"false") ));
-    //  CL_DEBUG1(PLUGIN_PREFIX("\t equal #1 and #2 = %s", (*(errorArray.Item(2)) ==
-    //  *(errorArray.Item(1))?"true":"false") )); CL_DEBUG1(PLUGIN_PREFIX("\t equal #2 and #3 = %s", (errorArray.Item(2)
-    //  == errorArray.Item(3)?"true":"false") ));
+    wxFFile fp(m_outputLogFileName, "rb");
+    if(!fp.IsOpened()) {
+        return 0;
+    }
 
-    // check if required fields was found
-    //  CL_ERROR1(PLUGIN_PREFIX("Broken input, tag <what> or <xwhat> not found, can't continue!"));
-    //  CL_ERROR1(PLUGIN_PREFIX("Broken input, tag <stack> not found, can't continue!"));
-    return result;
-}
+    if(fp.Length() < m_logOffset) {
+        // the log was truncated (a new run has started), parse it from the beginning
+        Reset();
+    }
+    if(fp.Length() == m_logOffset || !fp.Seek(m_logOffset)) {
+        return 0;
+    }
 
-MemCheckErrorLocation ValgrindMemcheckProcessor::ProcessLocation(wxXmlDocument& doc, wxXmlNode* locationNode)
-{
-    // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessLocation()"));
-
-    MemCheckErrorLocation result;
-    result.line = -1;
-    wxString file;
-    wxString dir;
-
-    wxXmlNode* subframeNode = locationNode->GetChildren();
-    while(subframeNode) {
-
-        if(subframeNode->GetName() == wxT("ip")) {
-            // ignoring
-        } else if(subframeNode->GetName() == wxT("obj")) {
-            result.obj = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("fn")) {
-            result.func = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("dir")) {
-            dir = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("file")) {
-            file = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("line")) {
-            result.line = wxAtoi(subframeNode->GetNodeContent());
+    size_t errorsAdded = 0;
+    size_t bytesRead = 0;
+    std::vector<char> buffer(READ_CHUNK_SIZE);
+    while(bytesRead < maxBytes) {
+        size_t count = fp.Read(buffer.data(), std::min(buffer.size(), maxBytes - bytesRead));
+        if(count == 0) {
+            break;
+        }
+        bytesRead += count;
+        m_logOffset += count;
+        errorsAdded += m_parser.Parse(buffer.data(), count);
+        if(m_parser.GetState() == ValgrindXmlParser::kInvalid) {
+            break;
+        }
+        if(yield) {
+            // ATTN  m_mgr->GetTheApp()
+            wxTheApp->Yield();
         }
-        subframeNode = subframeNode->GetNext();
     }
-
-    if(!dir.IsEmpty() && !dir.EndsWith(wxT("/")))
-        dir.Append(wxT("/"));
-    result.file = dir + file;
-
-    // TODO ? add checkout ?
-    return result;
+    return errorsAdded;
 }
@@ -34,7 +34,9 @@
 #define _VALGRINDPROCESSOR_H_
 
 #include "imemcheckprocessor.h"
-#include <wx/xml/xml.h>
+#include "valgrindxmlparser.h"
+
+#include <wx/filefn.h>
 
 /**
  * @class ValgrindMemcheckProcessor
@@ -74,29 +76,33 @@ public:
      * @param outputLogFileName
      * @return
      *
-     * Loads Valgrind's xml log to wxXmlDocument, and goes trought nodes
+     * Streams Valgrind's xml log through ValgrindXmlParser, the whole document is never held in memory. If
+     * outputLogFileName is empty, parsing continues where ProcessNewOutput() stopped.
      */
     virtual bool Process(const wxString& outputLogFileName = wxEmptyString);
 
-protected:
     /**
-     * @brief creates one MemCheckError object
-     * @param doc whole log document
-     * @param errorNode reference to current processed node in that doc file
-     * @return MemCheckError object
+     * @brief interface implementation
+     * @return number of new errors
      *
-     * Auxiliary section is not in subnode. First part of the node describes particular error, second part describes
-     * auxiliary info. For auxiliary is created sub MemCheckError object.
+     * Parses the part of the log Valgrind has written since the last call, at most a few MB at once so
+     * the UI stays responsive, the rest is parsed on the next call.
      */
-    MemCheckError ProcessError(wxXmlDocument& doc, wxXmlNode* errorNode);
+    virtual size_t ProcessNewOutput();
 
+    virtual void Reset();
+
+protected:
     /**
-     * @brief creates one MemCheckErrorLocation object
-     * @param doc whole log document
-     * @param locationNode reference to current processed node in that doc file
-     * @return MemCheckErrorLocation object
+     * @brief parses the log from m_logOffset
+     * @param maxBytes stop after this many bytes were read
+     * @param yield if true, wxTheApp->Yield() is called between chunks
+     * @return number of new errors
      */
-    MemCheckErrorLocation ProcessLocation(wxXmlDocument& doc, wxXmlNode* locationNode);
+    size_t ReadLog(size_t maxBytes, bool yield);
+
+    ValgrindXmlParser m_parser;
+    wxFileOffset m_logOffset; ///< how much of the log was parsed
 };
 
 #endif // _VALGRINDPROCESSOR_H_
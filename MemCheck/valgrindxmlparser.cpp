@@ -0,0 +1,266 @@
+#include "valgrindxmlparser.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+/**
+ * @brief replace xml entities and character references with the characters they stand for
+ */
+std::string DecodeEntities(const std::string& text)
+{
+    if(text.find('&') == std::string::npos) {
+        return text;
+    }
+
+    std::string result;
+    result.reserve(text.length());
+    for(size_t i = 0; i < text.length(); ++i) {
+        if(text[i] != '&') {
+            result += text[i];
+            continue;
+        }
+        size_t end = text.find(';', i);
+        if(end == std::string::npos) {
+            result += text[i];
+            continue;
+        }
+        std::string entity = text.substr(i + 1, end - i - 1);
+        if(entity == "lt") {
+            result += '<';
+        } else if(entity == "gt") {
+            result += '>';
+        } else if(entity == "amp") {
+            result += '&';
+        } else if(entity == "quot") {
+            result += '"';
+        } else if(entity == "apos") {
+            result += '\'';
+        } else if(entity.length() > 1 && entity[0] == '#') {
+            unsigned long code = (entity[1] == 'x' || entity[1] == 'X') ? strtoul(entity.c_str() + 2, NULL, 16)
+                                                                         : strtoul(entity.c_str() + 1, NULL, 10);
+            // encode the code point as UTF-8
+            if(code < 0x80) {
+                result += (char)code;
+            } else if(code < 0x800) {
+                result += (char)(0xC0 | (code >> 6));
+                result += (char)(0x80 | (code & 0x3F));
+            } else if(code < 0x10000) {
+                result += (char)(0xE0 | (code >> 12));
+                result += (char)(0x80 | ((code >> 6) & 0x3F));
+                result += (char)(0x80 | (code & 0x3F));
+            } else {
+                result += (char)(0xF0 | (code >> 18));
+                result += (char)(0x80 | ((code >> 12) & 0x3F));
+                result += (char)(0x80 | ((code >> 6) & 0x3F));
+                result += (char)(0x80 | (code & 0x3F));
+            }
+        } else {
+            // unknown entity, keep it as it is
+            result.append(text, i, end - i + 1);
+        }
+        i = end;
+    }
+    return result;
+}
+} // namespace
+
+ValgrindXmlParser::ValgrindXmlParser(ErrorList& errors, MemCheckFrameTable& frames)
+    : m_errors(errors)
+    , m_frames(frames)
+    , m_state(kWaitingForRoot)
+    , m_errorsAdded(0)
+    , m_auxiliary(false)
+{
+}
+
+void ValgrindXmlParser::Reset()
+{
+    m_state = kWaitingForRoot;
+    m_buffer.clear();
+    m_text.clear();
+    m_elements.clear();
+    m_error = MemCheckError();
+    m_auxiliaryError = MemCheckError();
+    m_auxiliary = false;
+}
+
+size_t ValgrindXmlParser::Parse(const char* data, size_t length)
+{
+    m_errorsAdded = 0;
+    if(m_state == kInvalid) {
+        return 0;
+    }
+    m_buffer.append(data, length);
+
+    size_t pos = 0;
+    while(pos < m_buffer.length() && m_state != kInvalid) {
+        size_t tagStart = m_buffer.find('<', pos);
+        if(tagStart == std::string::npos) {
+            // text only, the element continues in the next chunk
+            m_text.append(m_buffer, pos, std::string::npos);
+            pos = m_buffer.length();
+            break;
+        }
+        m_text.append(m_buffer, pos, tagStart - pos);
+        pos = tagStart;
+
+        if(m_buffer.compare(tagStart, 4, "<!--") == 0) {
+            size_t end = m_buffer.find("-->", tagStart + 4);
+            if(end == std::string::npos) {
+                break;
+            }
+            pos = end + 3;
+
+        } else if(m_buffer.compare(tagStart, 9, "<![CDATA[") == 0) {
+            size_t end = m_buffer.find("]]>", tagStart + 9);
+            if(end == std::string::npos) {
+                break;
+            }
+            // CDATA content is not decoded, escape it so it survives GetText()
+            std::string cdata = m_buffer.substr(tagStart + 9, end - tagStart - 9);
+            for(size_t i = 0; i < cdata.length(); ++i) {
+                if(cdata[i] == '&') {
+                    m_text += "&amp;";
+                } else {
+                    m_text += cdata[i];
+                }
+            }
+            pos = end + 3;
+
+        } else {
+            size_t tagEnd = m_buffer.find('>', tagStart);
+            if(tagEnd == std::string::npos) {
+                break;
+            }
+            pos = tagEnd + 1;
+
+            const char first = m_buffer[tagStart + 1];
+            if(first == '?' || first == '!') {
+                // processing instruction or doctype
+                continue;
+            }
+
+            bool closing = first == '/';
+            bool empty = !closing && m_buffer[tagEnd - 1] == '/';
+            size_t nameStart = tagStart + (closing ? 2 : 1);
+            size_t nameEnd = m_buffer.find_first_of(" \t\r\n/>", nameStart);
+            std::string name = m_buffer.substr(nameStart, nameEnd - nameStart);
+
+            if(closing) {
+                OnEndElement(name);
+            } else {
+                OnStartElement(name);
+                if(empty) {
+                    OnEndElement(name);
+                }
+            }
+        }
+    }
+    m_buffer.erase(0, pos);
+    return m_errorsAdded;
+}
+
+bool ValgrindXmlParser::IsInside(const char* parent, const char* grandParent) const
+{
+    // the current element is the last one in m_elements
+    size_t count = m_elements.size();
+    if(count < 2 || m_elements[count - 2] != parent) {
+        return false;
+    }
+    return !grandParent || (count >= 3 && m_elements[count - 3] == grandParent);
+}
+
+wxString ValgrindXmlParser::GetText() const { return wxString::FromUTF8(DecodeEntities(m_text)); }
+
+void ValgrindXmlParser::OnStartElement(const std::string& name)
+{
+    m_text.clear();
+    if(m_state == kWaitingForRoot) {
+        m_state = (name == "valgrindoutput") ? kParsing : kInvalid;
+    }
+    m_elements.push_back(name);
+
+    if(name == "error" && IsInside("valgrindoutput")) {
+        m_error = MemCheckError();
+        m_error.type = MemCheckError::TYPE_ERROR;
+        m_auxiliaryError = MemCheckError();
+        m_auxiliary = false;
+
+    } else if(name == "frame" && IsInside("stack", "error")) {
+        m_location = MemCheckErrorLocation();
+        m_location.line = -1;
+        m_dir.clear();
+        m_file.clear();
+    }
+}
+
+void ValgrindXmlParser::OnEndElement(const std::string& name)
+{
+    if(m_elements.empty() || m_elements.back() != name) {
+        // not well-formed, ignore the tag
+        m_text.clear();
+        return;
+    }
+
+    if(IsInside("error")) {
+        if(name == "what") {
+            m_error.label = GetText();
+        } else if(name == "auxwhat") {
+            m_auxiliaryError.label = GetText();
+            m_auxiliaryError.type = MemCheckError::TYPE_AUXILIARY;
+            m_auxiliary = true;
+        }
+
+    } else if(IsInside("xwhat", "error")) {
+        if(name == "text") {
+            m_error.label = GetText();
+        }
+
+    } else if(IsInside("suppression", "error")) {
+        if(name == "rawtext") {
+            m_error.suppression = GetText();
+        }
+
+    } else if(IsInside("frame", "stack")) {
+        if(name == "obj") {
+            m_location.obj = GetText();
+        } else if(name == "fn") {
+            m_location.func = GetText();
+        } else if(name == "dir") {
+            m_dir = GetText();
+        } else if(name == "file") {
+            m_file = GetText();
+        } else if(name == "line") {
+            m_location.line = wxAtoi(GetText());
+        }
+
+    } else if(name == "frame" && IsInside("stack", "error")) {
+        if(!m_dir.IsEmpty() && !m_dir.EndsWith(wxT("/")))
+            m_dir.Append(wxT("/"));
+        m_location.file = m_dir + m_file;
+
+        MemCheckErrorLocation* frame = m_frames.Add(m_location);
+        if(m_auxiliary) {
+            m_auxiliaryError.locations.push_back(frame);
+        } else {
+            m_error.locations.push_back(frame);
+        }
+
+    } else if(name == "error" && IsInside("valgrindoutput")) {
+        if(!m_error.suppression)
+            m_error.suppression =
+                wxT("#Suppresion pattern not present in output log.\n#This plugin requires Valgrind to be "
+                    "run with '--gen-suppressions=all' option");
+
+        if(m_auxiliary)
+            m_error.nestedErrors.push_back(m_auxiliaryError);
+
+        m_errors.push_back(m_error);
+        ++m_errorsAdded;
+    }
+
+    m_elements.pop_back();
+    m_text.clear();
+}
@@ -0,0 +1,65 @@
+#ifndef _VALGRINDXMLPARSER_H_
+#define _VALGRINDXMLPARSER_H_
+
+#include "memcheckerror.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @class ValgrindXmlParser
+ * @brief SAX style parser of Valgrind's xml log.
+ *
+ * The log is passed in chunks of any size (e.g. as it is written by Valgrind), incomplete tags are kept until the next
+ * chunk arrives. Every time an <error> element is closed, the error is appended to the error list, its stack frames
+ * are stored in the frame table. Only the parts of the xml that Valgrind writes are supported (elements, text,
+ * comments, processing instructions and CDATA), attributes are ignored.
+ */
+class ValgrindXmlParser
+{
+public:
+    enum State {
+        kWaitingForRoot, ///< no element was found yet
+        kParsing,        ///< root element is <valgrindoutput>
+        kInvalid,        ///< root element is not <valgrindoutput>, the rest of the input is ignored
+    };
+
+    ValgrindXmlParser(ErrorList& errors, MemCheckFrameTable& frames);
+
+    /**
+     * @brief forget the partially parsed input, next chunk is parsed as a start of a new log
+     */
+    void Reset();
+
+    /**
+     * @brief parse next chunk of the log
+     * @return number of errors appended to the error list
+     */
+    size_t Parse(const char* data, size_t length);
+
+    State GetState() const { return m_state; }
+
+protected:
+    void OnStartElement(const std::string& name);
+    void OnEndElement(const std::string& name);
+    bool IsInside(const char* parent, const char* grandParent = NULL) const;
+    wxString GetText() const;
+
+    ErrorList& m_errors;
+    MemCheckFrameTable& m_frames;
+    State m_state;
+    std::string m_buffer; ///< input which was not processed yet (incomplete tag)
+    std::string m_text;   ///< text content of the current element
+    std::vector<std::string> m_elements;
+    size_t m_errorsAdded;
+
+    // the error being parsed
+    MemCheckError m_error;
+    MemCheckError m_auxiliaryError;
+    bool m_auxiliary;
+    MemCheckErrorLocation m_location;
+    wxString m_dir;
+    wxString m_file;
+};
+
+#endif // _VALGRINDXMLPARSER_H_
@@ -14,7 +14,11 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 #include <wx/dir.h>
+#include <wx/filefn.h>
 #include <wx/wupdlock.h>
 
 static int nCallCounter = 0;
@@ -34,6 +38,9 @@ DiffFoldersFrame::DiffFoldersFrame(wxWindow* parent)
     m_toolbar->AddTool(XRCID("diff-intersection"), _("Show similar files only"), images->Add("intersection"), "",
                        wxITEM_CHECK);
     m_toolbar->AddSeparator();
+    m_toolbar->AddTool(XRCID("diff-recursive"), _("Compare sub folders"), images->Add("folder-yellow"), "",
+                       wxITEM_CHECK);
+    m_toolbar->AddSeparator();
     m_toolbar->AddTool(XRCID("diff-up-folder"), _("Parent folder"), images->Add("up"));
     m_toolbar->AssignBitmaps(images);
     m_toolbar->Realize();
@@ -44,6 +51,8 @@ DiffFoldersFrame::DiffFoldersFrame(wxWindow* parent)
     m_toolbar->Bind(wxEVT_UPDATE_UI, &DiffFoldersFrame::OnShowSimilarFilesUI, this, XRCID("diff-intersection"));
     m_toolbar->Bind(wxEVT_TOOL, &DiffFoldersFrame::OnRefresh, this, wxID_REFRESH);
     m_toolbar->Bind(wxEVT_UPDATE_UI, &DiffFoldersFrame::OnRefreshUI, this, wxID_REFRESH);
+    m_toolbar->Bind(wxEVT_TOOL, &DiffFoldersFrame::OnRecursive, this, XRCID("diff-recursive"));
+    m_toolbar->Bind(wxEVT_UPDATE_UI, &DiffFoldersFrame::OnRecursiveUI, this, XRCID("diff-recursive"));
     m_toolbar->Bind(wxEVT_TOOL, &DiffFoldersFrame::OnUpFolder, this, XRCID("diff-up-folder"));
     m_toolbar->Bind(wxEVT_UPDATE_UI, &DiffFoldersFrame::OnUpFolderUI, this, XRCID("diff-up-folder"));
 
@@ -51,11 +60,13 @@ DiffFoldersFrame::DiffFoldersFrame(wxWindow* parent)
 
     // Load persistent items
     m_showSimilarItems = clConfig::Get().Read("DiffFolders/ShowSimilarItems", false);
+    m_recursive = clConfig::Get().Read("DiffFolders/Recursive", false);
 }
 
 DiffFoldersFrame::~DiffFoldersFrame()
 {
     clConfig::Get().Write("DiffFolders/ShowSimilarItems", m_showSimilarItems);
+    clConfig::Get().Write("DiffFolders/Recursive", m_recursive);
     StopChecksumThread();
 }
 
@@ -80,66 +91,235 @@ void DiffFoldersFrame::OnNewCmparison(wxCommandEvent& event)
     }
 }
 
-#define CLOSE_FP(fp)      \
-    {                     \
-        if(fp) {          \
-            fclose(fp);   \
-            fp = nullptr; \
-        }                 \
-    }
-
-static bool CompareFilesCheckSum(const wxString& fn1, const wxString& fn2)
+namespace
 {
-    // The sizes are the same
-    unsigned char checksum1 = 0;
-    unsigned char checksum2 = 0;
-
-    FILE* fp1 = fopen(fn1.mb_str(), "rb");
-    FILE* fp2 = fopen(fn2.mb_str(), "rb");
+// size of the blocks read from the compared files
+constexpr size_t COMPARE_BLOCK_SIZE = 256 * 1024;
+// the number of modified rows to collect before they are sent to the view
+constexpr size_t RESULTS_BATCH_SIZE = 64;
+
+struct CompareItem {
+    size_t row = 0;
+    wxString left;
+    wxString right;
+    bool isFolder = false;
+};
+
+struct ComparePair {
+    size_t row = 0;
+    wxString left;
+    wxString right;
+};
+
+bool StatFile(const wxString& path, wxStructStat& st) { return wxStat(path, &st) == 0; }
+
+/**
+ * @brief compare the content of two files of the same size, block by block. Stops on the first difference
+ */
+bool CompareFileContent(const wxString& fn1, const wxString& fn2)
+{
+    FILE* fp1 = wxFopen(fn1, "rb");
+    FILE* fp2 = wxFopen(fn2, "rb");
     if(!fp1 || !fp2) {
-        CLOSE_FP(fp1);
-        CLOSE_FP(fp2);
+        if(fp1) {
+            fclose(fp1);
+        }
+        if(fp2) {
+            fclose(fp2);
+        }
         return false;
     }
 
-    while(!feof(fp1) && !ferror(fp1) && !feof(fp2) && !ferror(fp2)) {
-        checksum1 ^= fgetc(fp1);
-        checksum2 ^= fgetc(fp2);
-        if(checksum1 != checksum2) {
+    thread_local std::vector<char> buffer1(COMPARE_BLOCK_SIZE);
+    thread_local std::vector<char> buffer2(COMPARE_BLOCK_SIZE);
+    bool isSame = true;
+    while(isSame && !checksumThreadStop.load()) {
+        size_t len1 = fread(buffer1.data(), 1, buffer1.size(), fp1);
+        size_t len2 = fread(buffer2.data(), 1, buffer2.size(), fp2);
+        if(len1 != len2 || memcmp(buffer1.data(), buffer2.data(), len1) != 0) {
+            isSame = false;
+        } else if(len1 < buffer1.size()) {
+            // both files reached their end (or failed to read)
+            isSame = !ferror(fp1) && !ferror(fp2);
             break;
         }
     }
-    CLOSE_FP(fp1);
-    CLOSE_FP(fp2);
-    return (checksum1 == checksum2);
+    fclose(fp1);
+    fclose(fp2);
+    return isSame;
 }
 
-static void HelperThreadCalculateChecksum(int callId, const wxArrayString& items, const wxString& left,
-                                          const wxString& right, DiffFoldersFrame* sink)
+/**
+ * @brief return true if the two files have the same content. Files with different sizes are different, files with
+ * the same size and the same modification time are considered as equal without reading them
+ */
+bool IsSameFile(const wxString& fn1, const wxString& fn2)
 {
-    wxArrayString results;
-    for(size_t i = 0; i < items.size(); ++i) {
+    wxStructStat st1;
+    wxStructStat st2;
+    if(!StatFile(fn1, st1) || !StatFile(fn2, st2)) {
+        return false;
+    }
+    if(st1.st_size != st2.st_size) {
+        return false;
+    }
+    if(st1.st_mtime == st2.st_mtime) {
+        return true;
+    }
+    return CompareFileContent(fn1, fn2);
+}
+
+/**
+ * @brief collect the pairs of files found under both folders (recursively)
+ * @return false if the folders do not have the same files and sub folders
+ */
+bool CollectFolderPairs(size_t row, const wxString& left, const wxString& right, std::vector<ComparePair>& pairs)
+{
+    clFilesScanner::EntryData::Vec_t leftEntries;
+    clFilesScanner::EntryData::Vec_t rightEntries;
+    clFilesScanner scanner;
+    scanner.ScanNoRecurse(left, leftEntries);
+    scanner.ScanNoRecurse(right, rightEntries);
+    if(leftEntries.size() != rightEntries.size()) {
+        return false;
+    }
+
+    std::unordered_map<wxString, const clFilesScanner::EntryData*> rightTable;
+    for(const auto& entry : rightEntries) {
+        rightTable.insert({ wxFileName(entry.fullpath).GetFullName(), &entry });
+    }
+
+    for(const auto& leftEntry : leftEntries) {
         if(checksumThreadStop.load()) {
-            break;
+            return true;
+        }
+        auto iter = rightTable.find(wxFileName(leftEntry.fullpath).GetFullName());
+        if(iter == rightTable.end()) {
+            return false;
         }
-        wxFileName fnLeft(left, items.Item(i));
-        wxFileName fnRight(right, items.Item(i));
-        if(fnLeft.IsOk() && fnLeft.FileExists() && fnRight.IsOk() && fnRight.FileExists()) {
-            if(fnLeft.GetSize() != fnRight.GetSize()) {
-                // If the size is different, no need to go further
-                results.Add("different");
-            } else {
-                bool isSame = CompareFilesCheckSum(fnLeft.GetFullPath(), fnRight.GetFullPath());
-                results.Add(isSame ? "same" : "different");
+        const clFilesScanner::EntryData& rightEntry = *iter->second;
+        bool leftIsFolder = leftEntry.flags & clFilesScanner::kIsFolder;
+        bool rightIsFolder = rightEntry.flags & clFilesScanner::kIsFolder;
+        if(leftIsFolder != rightIsFolder) {
+            return false;
+        }
+
+        if(!leftIsFolder) {
+            pairs.push_back({ row, leftEntry.fullpath, rightEntry.fullpath });
+        } else if(!(leftEntry.flags & clFilesScanner::kIsSymlink) && !(rightEntry.flags & clFilesScanner::kIsSymlink)) {
+            // don't follow symlinks to folders, they may point to one of their parents
+            if(!CollectFolderPairs(row, leftEntry.fullpath, rightEntry.fullpath, pairs)) {
+                return false;
             }
-        } else {
-            results.Add("n/a"); // Dont know
         }
     }
-    if(!checksumThreadStop.load()) {
-        sink->CallAfter(&DiffFoldersFrame::OnChecksum, callId, results);
+    return true;
+}
+
+/**
+ * @brief collects the modified rows and passes them to the view in batches
+ */
+class ModifiedRowsSink
+{
+    int m_callId;
+    DiffFoldersFrame* m_frame;
+    std::vector<std::atomic_bool> m_reported;
+    std::mutex m_mutex;
+    std::vector<size_t> m_rows;
+
+public:
+    ModifiedRowsSink(int callId, size_t rowCount, DiffFoldersFrame* frame)
+        : m_callId(callId)
+        , m_frame(frame)
+        , m_reported(rowCount)
+    {
+    }
+
+    bool IsReported(size_t row) const { return m_reported[row].load(); }
+
+    void Add(size_t row)
+    {
+        if(m_reported[row].exchange(true)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        m_rows.push_back(row);
+        if(m_rows.size() >= RESULTS_BATCH_SIZE) {
+            DoFlush();
+        }
+    }
+
+    void Flush()
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        DoFlush();
+    }
+
+private:
+    void DoFlush()
+    {
+        if(m_rows.empty() || checksumThreadStop.load()) {
+            return;
+        }
+        std::vector<size_t> rows;
+        rows.swap(m_rows);
+        m_frame->CallAfter(&DiffFoldersFrame::OnChecksum, m_callId, rows);
+    }
+};
+
+void HelperThreadCompareFolders(int callId, const std::vector<CompareItem>& items, size_t rowCount, bool recursive,
+                                DiffFoldersFrame* frame)
+{
+    ModifiedRowsSink sink(callId, rowCount, frame);
+
+    // compare the files of the current folder first, before scanning the sub folders
+    std::vector<ComparePair> pairs;
+    for(const CompareItem& item : items) {
+        if(!item.isFolder) {
+            pairs.push_back({ item.row, item.left, item.right });
+        }
+    }
+
+    size_t threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), 8));
+    auto compare_pairs = [&](const std::vector<ComparePair>& todo) {
+        std::atomic_size_t next(0);
+        auto worker = [&]() {
+            for(size_t i = next++; i < todo.size() && !checksumThreadStop.load(); i = next++) {
+                const ComparePair& pair = todo[i];
+                // a row that holds a folder is modified once any of its files is different
+                if(!sink.IsReported(pair.row) && !IsSameFile(pair.left, pair.right)) {
+                    sink.Add(pair.row);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for(size_t i = 1; i < std::min(threadCount, todo.size()); ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(auto& thr : threads) {
+            thr.join();
+        }
+        sink.Flush();
+    };
+    compare_pairs(pairs);
+
+    if(recursive) {
+        pairs.clear();
+        for(const CompareItem& item : items) {
+            if(checksumThreadStop.load()) {
+                return;
+            }
+            if(item.isFolder && !CollectFolderPairs(item.row, item.left, item.right, pairs)) {
+                sink.Add(item.row);
+            }
+        }
+        sink.Flush();
+        compare_pairs(pairs);
     }
 }
+} // namespace
 
 void DiffFoldersFrame::BuildTrees(const wxString& left, const wxString& right)
 {
@@ -193,7 +373,8 @@ void DiffFoldersFrame::BuildTrees(const wxString& left, const wxString& right)
 
     // Sort the merged list
     m_entries = viewList.ToSortedVector();
-    wxArrayString displayedItems;
+    std::vector<CompareItem> compareItems;
+    size_t row = 0;
     for(size_t i = 0; i < m_entries.size(); ++i) {
         cols.clear();
         const DiffViewEntry& entry = m_entries[i];
@@ -203,8 +384,20 @@ void DiffFoldersFrame::BuildTrees(const wxString& left, const wxString& right)
             continue;
         }
 
-        // This will be passed to the checksum thread
-        displayedItems.Add(entry.GetFullName());
+        // Items that exist on both sides are passed to the checksum thread
+        if(entry.IsExistsInBoth()) {
+            bool leftIsFolder = entry.GetLeft().flags & clFilesScanner::kIsFolder;
+            bool rightIsFolder = entry.GetRight().flags & clFilesScanner::kIsFolder;
+            if(leftIsFolder == rightIsFolder) {
+                CompareItem item;
+                item.row = row;
+                item.left = entry.GetLeft().fullpath;
+                item.right = entry.GetRight().fullpath;
+                item.isFolder = leftIsFolder;
+                compareItems.push_back(item);
+            }
+        }
+        ++row;
 
         if(entry.IsExistsInLeft()) {
             cols.push_back(::MakeBitmapIndexText(entry.GetLeft().fullpath, entry.GetImageId(true)));
@@ -220,8 +413,8 @@ void DiffFoldersFrame::BuildTrees(const wxString& left, const wxString& right)
         m_dvListCtrl->AppendItem(cols, (wxUIntPtr)&entry);
     }
 
-    m_checksumThread = new std::thread(&HelperThreadCalculateChecksum, (++nCallCounter), displayedItems, m_leftFolder,
-                                       m_rightFolder, this);
+    m_checksumThread =
+        new std::thread(&HelperThreadCompareFolders, (++nCallCounter), compareItems, row, m_recursive, this);
 }
 
 void DiffFoldersFrame::OnItemActivated(wxDataViewEvent& event)
@@ -340,21 +533,18 @@ void DiffFoldersFrame::OnCopyToLeft(wxCommandEvent& event)
     }
 }
 
-void DiffFoldersFrame::OnChecksum(int callId, const wxArrayString& checksumArray)
+void DiffFoldersFrame::OnChecksum(int callId, const std::vector<size_t>& modifiedRows)
 {
     if(callId != nCallCounter) {
         return;
     }
     bool isDark = DrawingUtils::IsDark(m_dvListCtrl->GetColours().GetBgColour());
     wxColour modifiedColour = isDark ? wxColour("rgb(255, 128, 64)") : *wxRED;
-    for(size_t i = 0; i < checksumArray.size(); ++i) {
-        const wxString& answer = checksumArray.Item(i);
-        if(answer == "different") {
-            wxDataViewItem item = m_dvListCtrl->RowToItem(i);
-            if(item.IsOk()) {
-                m_dvListCtrl->SetItemTextColour(item, modifiedColour, 0);
-                m_dvListCtrl->SetItemTextColour(item, modifiedColour, 1);
-            }
+    for(size_t row : modifiedRows) {
+        wxDataViewItem item = m_dvListCtrl->RowToItem(row);
+        if(item.IsOk()) {
+            m_dvListCtrl->SetItemTextColour(item, modifiedColour, 0);
+            m_dvListCtrl->SetItemTextColour(item, modifiedColour, 1);
         }
     }
 }
@@ -372,7 +562,7 @@ void DiffFoldersFrame::OnRefreshUI(wxUpdateUIEvent& event)
 
 void DiffFoldersFrame::StopChecksumThread()
 {
-    checksumThreadStop.store(false);
+    checksumThreadStop.store(true);
     if(m_checksumThread) {
         m_checksumThread->join();
     }
@@ -380,6 +570,19 @@ void DiffFoldersFrame::StopChecksumThread()
     wxDELETE(m_checksumThread);
 }
 
+void DiffFoldersFrame::OnRecursive(wxCommandEvent& event)
+{
+    event.Skip();
+    m_recursive = event.IsChecked();
+    BuildTrees(m_leftFolder, m_rightFolder);
+}
+
+void DiffFoldersFrame::OnRecursiveUI(wxUpdateUIEvent& event)
+{
+    event.Enable(!m_leftFolder.IsEmpty() && !m_rightFolder.IsEmpty());
+    event.Check(m_recursive);
+}
+
 void DiffFoldersFrame::OnUpFolder(wxCommandEvent& event)
 {
     if(!CanUp()) {
@@ -9,6 +9,7 @@
 #include "imanager.h"
 
 #include <thread>
+#include <vector>
 
 struct WXDLLIMPEXP_SDK DiffViewEntry {
 protected:
@@ -106,13 +107,17 @@ class WXDLLIMPEXP_SDK DiffFoldersFrame : public DiffFoldersBaseDlg
     wxString m_rightFolder;
     size_t m_depth = 0;
     bool m_showSimilarItems = false;
+    bool m_recursive = false;
     std::thread* m_checksumThread = nullptr;
     DiffViewEntry::Vect_t m_entries;
 
 public:
     DiffFoldersFrame(wxWindow* parent);
     virtual ~DiffFoldersFrame();
-    void OnChecksum(int callId, const wxArrayString& checksumArray);
+    /**
+     * @brief called from the checksum thread with the rows whose files (or folders content) are different
+     */
+    void OnChecksum(int callId, const std::vector<size_t>& modifiedRows);
 
 protected:
     void BuildTrees(const wxString& left, const wxString& right);
@@ -133,6 +138,8 @@ protected:
     void OnShowSimilarFilesUI(wxUpdateUIEvent& event);
     void OnRefresh(wxCommandEvent& event);
     void OnRefreshUI(wxUpdateUIEvent& event);
+    void OnRecursive(wxCommandEvent& event);
+    void OnRecursiveUI(wxUpdateUIEvent& event);
     void OnUpFolder(wxCommandEvent& event);
     void OnUpFolderUI(wxUpdateUIEvent& event);
 };
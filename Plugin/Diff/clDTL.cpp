@@ -25,13 +25,378 @@
 
 #include "clDTL.h"
 
-#include "dtl/dtl.hpp"
 #include "fileutils.h"
+#include "wxStringHash.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
 #include <wx/ffile.h>
-#include <wx/tokenzr.h>
 #include <wx/utils.h>
 
+namespace
+{
+enum EditType {
+    kEditCommon,
+    kEditAdd,
+    kEditDelete,
+};
+
+struct Edit {
+    EditType type;
+    size_t index; ///< index of the line in the left (common, delete) or the right (add) sequence
+};
+
+/**
+ * @brief split the text into lines, each line keeps its terminating "\n"
+ */
+std::vector<wxString> SplitLines(const wxString& text)
+{
+    std::vector<wxString> lines;
+    size_t start = 0;
+    while(start < text.length()) {
+        size_t end = text.find('\n', start);
+        if(end == wxString::npos) {
+            lines.push_back(text.Mid(start));
+            break;
+        }
+        lines.push_back(text.Mid(start, end - start + 1));
+        start = end + 1;
+    }
+    return lines;
+}
+
+/**
+ * @brief a line based diff working on lines hashed into integers (equal lines have equal ids).
+ *
+ * The common prefix and suffix are stripped first, then the remaining ranges are split recursively on their longest
+ * common run of low-occurrence lines (histogram diff). Small ranges and ranges that have common lines but no
+ * low-occurrence one are handed to the linear-space (divide and conquer) variant of Myers' O(ND) algorithm, which
+ * gives a minimal edit script for them. Both use O(N+M) memory.
+ */
+class LineDiff
+{
+    // lines that occur more often than this in a range are not used as split points by the histogram diff
+    static constexpr unsigned MAX_OCCURRENCES = 64;
+    // the minimal number of edits after which Myers' algorithm gives up looking for an optimal split of a range
+    static constexpr long MIN_MAX_COST = 256;
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    struct Range {
+        size_t a0, a1; ///< [a0, a1) in the left sequence
+        size_t b0, b1; ///< [b0, b1) in the right sequence
+    };
+
+    const std::vector<unsigned>& m_a;
+    const std::vector<unsigned>& m_b;
+    std::vector<size_t> m_matches; ///< for each left line, the index of the matching right line or NPOS
+    std::vector<Range> m_histogramQueue;
+    std::vector<Range> m_myersQueue;
+
+    // histogram diff tables, indexed by line id
+    std::vector<unsigned> m_counts;
+    std::vector<size_t> m_heads;
+    std::vector<size_t> m_next; ///< next occurrence of the same line in the left range, indexed by left line
+
+    // Myers' diagonals
+    std::vector<long> m_forward;
+    std::vector<long> m_backward;
+
+public:
+    LineDiff(const std::vector<unsigned>& a, const std::vector<unsigned>& b, size_t idCount)
+        : m_a(a)
+        , m_b(b)
+        , m_matches(a.size(), NPOS)
+        , m_counts(idCount, 0)
+        , m_heads(idCount, NPOS)
+        , m_next(a.size(), NPOS)
+    {
+    }
+
+    void Run()
+    {
+        m_histogramQueue.push_back({ 0, m_a.size(), 0, m_b.size() });
+        while(!m_histogramQueue.empty()) {
+            Range r = m_histogramQueue.back();
+            m_histogramQueue.pop_back();
+            Histogram(r);
+        }
+        while(!m_myersQueue.empty()) {
+            Range r = m_myersQueue.back();
+            m_myersQueue.pop_back();
+            Myers(r);
+        }
+    }
+
+    /**
+     * @brief build the edit script: for each change, the deleted lines come before the added ones
+     */
+    std::vector<Edit> GetEditScript() const
+    {
+        std::vector<Edit> script;
+        script.reserve(std::max(m_a.size(), m_b.size()));
+        size_t j = 0;
+        for(size_t i = 0; i < m_a.size(); ++i) {
+            if(m_matches[i] == NPOS) {
+                script.push_back({ kEditDelete, i });
+                continue;
+            }
+            for(; j < m_matches[i]; ++j) {
+                script.push_back({ kEditAdd, j });
+            }
+            script.push_back({ kEditCommon, i });
+            ++j;
+        }
+        for(; j < m_b.size(); ++j) {
+            script.push_back({ kEditAdd, j });
+        }
+        return script;
+    }
+
+private:
+    void Match(size_t a, size_t b, size_t count)
+    {
+        for(size_t i = 0; i < count; ++i) {
+            m_matches[a + i] = b + i;
+        }
+    }
+
+    /**
+     * @brief match the common prefix and suffix of the range and shrink it accordingly
+     */
+    void StripCommon(Range& r)
+    {
+        size_t a0 = r.a0;
+        size_t b0 = r.b0;
+        while(r.a0 < r.a1 && r.b0 < r.b1 && m_a[r.a0] == m_b[r.b0]) {
+            ++r.a0;
+            ++r.b0;
+        }
+        Match(a0, b0, r.a0 - a0);
+
+        size_t a1 = r.a1;
+        while(r.a0 < r.a1 && r.b0 < r.b1 && m_a[r.a1 - 1] == m_b[r.b1 - 1]) {
+            --r.a1;
+            --r.b1;
+        }
+        Match(r.a1, r.b1, a1 - r.a1);
+    }
+
+    void Histogram(Range r)
+    {
+        StripCommon(r);
+        if(r.a0 == r.a1 || r.b0 == r.b1) {
+            return;
+        }
+
+        if((r.a1 - r.a0) + (r.b1 - r.b0) <= (size_t)MIN_MAX_COST) {
+            // Myers' algorithm never gives up on a range this small, so its edit script is minimal
+            m_myersQueue.push_back(r);
+            return;
+        }
+
+        // index the left range, the occurrences chains are in ascending order
+        for(size_t i = r.a1; i-- > r.a0;) {
+            unsigned id = m_a[i];
+            ++m_counts[id];
+            m_next[i] = m_heads[id];
+            m_heads[id] = i;
+        }
+
+        // find the longest common run with the least occurring lines
+        bool hasCommon = false;
+        unsigned bestCount = MAX_OCCURRENCES + 1;
+        size_t bestA = 0, bestB = 0, bestLen = 0;
+        for(size_t bi = r.b0; bi < r.b1;) {
+            size_t bNext = bi + 1;
+            unsigned id = m_b[bi];
+            unsigned count = m_counts[id];
+            if(count) {
+                hasCommon = true;
+            }
+            if(count == 0 || count > bestCount) {
+                bi = bNext;
+                continue;
+            }
+
+            for(size_t ai = m_heads[id]; ai != NPOS;) {
+                size_t sa = ai, sb = bi, ea = ai + 1, eb = bi + 1;
+                unsigned runCount = count;
+                while(sa > r.a0 && sb > r.b0 && m_a[sa - 1] == m_b[sb - 1]) {
+                    --sa;
+                    --sb;
+                    runCount = std::min(runCount, m_counts[m_a[sa]]);
+                }
+                while(ea < r.a1 && eb < r.b1 && m_a[ea] == m_b[eb]) {
+                    runCount = std::min(runCount, m_counts[m_a[ea]]);
+                    ++ea;
+                    ++eb;
+                }
+                bNext = std::max(bNext, eb);
+                if(runCount < bestCount || (runCount == bestCount && ea - sa > bestLen)) {
+                    bestCount = runCount;
+                    bestA = sa;
+                    bestB = sb;
+                    bestLen = ea - sa;
+                }
+                // skip the occurrences that are part of this run
+                while(ai != NPOS && ai < ea) {
+                    ai = m_next[ai];
+                }
+            }
+            bi = bNext;
+        }
+
+        // reset the tables for the next range
+        for(size_t i = r.a0; i < r.a1; ++i) {
+            m_counts[m_a[i]] = 0;
+            m_heads[m_a[i]] = NPOS;
+        }
+
+        if(bestLen == 0) {
+            if(hasCommon) {
+                // all the common lines are too frequent
+                m_myersQueue.push_back(r);
+            }
+            return;
+        }
+
+        Match(bestA, bestB, bestLen);
+        m_histogramQueue.push_back({ r.a0, bestA, r.b0, bestB });
+        m_histogramQueue.push_back({ bestA + bestLen, r.a1, bestB + bestLen, r.b1 });
+    }
+
+    /**
+     * @brief find the middle snake of the range: the sub range [x0, x1) x [y0, y1) of common lines that lays in the
+     * middle of an optimal edit script. Coordinates are relative to the range start. When the ranges are too different
+     * the search stops early and returns the furthest point reached from the start instead, so the result is not
+     * minimal but the running time remains bounded
+     */
+    void MiddleSnake(const Range& r, long& x0, long& y0, long& x1, long& y1)
+    {
+        const long n = r.a1 - r.a0;
+        const long m = r.b1 - r.b0;
+        const long delta = n - m;
+        const bool odd = delta & 1;
+        const long maxD = (n + m + 1) / 2;
+        const long offset = maxD + 1;
+        const long maxCost = std::max(MIN_MAX_COST, (long)std::sqrt((double)(n + m)));
+
+        // forward diagonals hold the furthest x reached from the start, the backward ones the furthest x reached
+        // from the end of the range
+        m_forward.assign(2 * offset + 1, 0);
+        m_backward.assign(2 * offset + 1, 0);
+        for(long d = 0; d <= maxD; ++d) {
+            for(long k = -d; k <= d; k += 2) {
+                long x = (k == -d || (k != d && m_forward[offset + k - 1] < m_forward[offset + k + 1]))
+                             ? m_forward[offset + k + 1]
+                             : m_forward[offset + k - 1] + 1;
+                long y = x - k;
+                long sx = x, sy = y;
+                while(x < n && y < m && m_a[r.a0 + x] == m_b[r.b0 + y]) {
+                    ++x;
+                    ++y;
+                }
+                m_forward[offset + k] = x;
+                long kb = delta - k;
+                if(odd && kb >= -(d - 1) && kb <= d - 1 && x + m_backward[offset + kb] >= n) {
+                    x0 = sx;
+                    y0 = sy;
+                    x1 = x;
+                    y1 = y;
+                    return;
+                }
+            }
+            if(d >= maxCost && FurthestPoint(d, n, m, offset, x0, y0)) {
+                x1 = x0;
+                y1 = y0;
+                return;
+            }
+            for(long k = -d; k <= d; k += 2) {
+                long x = (k == -d || (k != d && m_backward[offset + k - 1] < m_backward[offset + k + 1]))
+                             ? m_backward[offset + k + 1]
+                             : m_backward[offset + k - 1] + 1;
+                long y = x - k;
+                long sx = x, sy = y;
+                while(x < n && y < m && m_a[r.a1 - 1 - x] == m_b[r.b1 - 1 - y]) {
+                    ++x;
+                    ++y;
+                }
+                m_backward[offset + k] = x;
+                long kf = delta - k;
+                if(!odd && kf >= -d && kf <= d && x + m_forward[offset + kf] >= n) {
+                    x0 = n - x;
+                    y0 = m - y;
+                    x1 = n - sx;
+                    y1 = m - sy;
+                    return;
+                }
+            }
+        }
+        // not reached: the forward and backward paths always meet
+        x0 = x1 = n;
+        y0 = y1 = m;
+    }
+
+    /**
+     * @brief return the point on the forward diagonals that is the furthest from the range start. The point must lay
+     * strictly inside the range so both sides of the split are smaller than the range
+     */
+    bool FurthestPoint(long d, long n, long m, long offset, long& x, long& y) const
+    {
+        long best = 0;
+        for(long k = -d; k <= d; k += 2) {
+            long fx = m_forward[offset + k];
+            long fy = fx - k;
+            if(fx <= n && fy >= 0 && fy <= m && fx + fy > best && fx + fy < n + m) {
+                best = fx + fy;
+                x = fx;
+                y = fy;
+            }
+        }
+        return best > 0;
+    }
+
+    void Myers(Range r)
+    {
+        StripCommon(r);
+        if(r.a0 == r.a1 || r.b0 == r.b1) {
+            return;
+        }
+
+        long x0, y0, x1, y1;
+        MiddleSnake(r, x0, y0, x1, y1);
+        Match(r.a0 + x0, r.b0 + y0, x1 - x0);
+        m_myersQueue.push_back({ r.a0, r.a0 + x0, r.b0, r.b0 + y0 });
+        m_myersQueue.push_back({ r.a0 + x1, r.a1, r.b0 + y1, r.b1 });
+    }
+};
+
+/**
+ * @brief diff the lines of `before` and `after`
+ */
+std::vector<Edit> DiffLines(const std::vector<wxString>& before, const std::vector<wxString>& after)
+{
+    // hash the lines into integers
+    std::unordered_map<wxString, unsigned> ids;
+    ids.reserve(before.size() + after.size());
+    auto to_ids = [&ids](const std::vector<wxString>& lines) {
+        std::vector<unsigned> result;
+        result.reserve(lines.size());
+        for(const wxString& line : lines) {
+            result.push_back(ids.insert({ line, (unsigned)ids.size() }).first->second);
+        }
+        return result;
+    };
+    std::vector<unsigned> a = to_ids(before);
+    std::vector<unsigned> b = to_ids(after);
+
+    LineDiff diff(a, b, ids.size());
+    diff.Run();
+    return diff.GetEditScript();
+}
+} // namespace
+
 clDTL::clDTL() {}
 
 clDTL::~clDTL() {}
@@ -50,22 +415,14 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
     m_resultRight.clear();
     m_sequences.clear();
 
-    typedef wxString elem;
-    typedef std::pair<elem, dtl::elemInfo> sesElem;
-
-    wxArrayString leftLines = wxStringTokenize(before, "\n", wxTOKEN_RET_DELIMS);
-    wxArrayString rightLines = wxStringTokenize(after, "\n", wxTOKEN_RET_DELIMS);
-
-    std::vector<elem> leftLinesVec;
-    std::vector<elem> rightLinesVec;
-    leftLinesVec.insert(leftLinesVec.end(), leftLines.begin(), leftLines.end());
-    rightLinesVec.insert(rightLinesVec.end(), rightLines.begin(), rightLines.end());
+    std::vector<wxString> leftLines = SplitLines(before);
+    std::vector<wxString> rightLines = SplitLines(after);
+    std::vector<Edit> seq = DiffLines(leftLines, rightLines);
+    auto edit_line = [&](const Edit& edit) -> const wxString& {
+        return edit.type == kEditAdd ? rightLines[edit.index] : leftLines[edit.index];
+    };
 
-    dtl::Diff<elem, std::vector<elem>> diff(leftLinesVec, rightLinesVec);
-    diff.onHuge();
-    diff.compose();
-
-    if(0 == diff.getEditDistance()) {
+    if(std::all_of(seq.begin(), seq.end(), [](const Edit& edit) { return edit.type == kEditCommon; })) {
         // nothing to be done - files are identical
         return;
     }
@@ -79,7 +436,6 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
         ///////////////////////////////////////////////////////////////////
 
         // Loop over the diff and check if it is a whitespace only diff
-        std::vector<sesElem> seq = diff.getSes().getSequence();
         m_resultLeft.reserve(seq.size());
         m_resultRight.reserve(seq.size());
 
@@ -94,8 +450,8 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
         LineInfoVec_t tmpSeqRight;
 
         for(size_t i = 0; i < seq.size(); ++i) {
-            switch(seq.at(i).second.type) {
-            case dtl::SES_COMMON: {
+            switch(seq[i].type) {
+            case kEditCommon: {
                 if(state == STATE_IN_SEQ) {
 
                     // set the sequence size
@@ -116,13 +472,13 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
                     tmpSeqRight.clear();
                     seqSize = 0;
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_COMMON);
+                clDTL::LineInfo line(edit_line(seq[i]), LINE_COMMON);
                 m_resultLeft.push_back(line);
                 m_resultRight.push_back(line);
                 break;
             }
-            case dtl::SES_ADD: {
-                clDTL::LineInfo lineRight(seq.at(i).first, LINE_ADDED);
+            case kEditAdd: {
+                clDTL::LineInfo lineRight(edit_line(seq[i]), LINE_ADDED);
                 tmpSeqRight.push_back(lineRight);
 
                 if(state == STATE_NONE) {
@@ -131,8 +487,8 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
                 }
                 break;
             }
-            case dtl::SES_DELETE: {
-                clDTL::LineInfo lineLeft(seq.at(i).first, LINE_REMOVED);
+            case kEditDelete: {
+                clDTL::LineInfo lineLeft(edit_line(seq[i]), LINE_REMOVED);
                 tmpSeqLeft.push_back(lineLeft);
 
                 if(state == STATE_NONE) {
@@ -169,33 +525,32 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
         // One pane diff view
         // designed for displayed on a single editor
         ///////////////////////////////////////////////////////////////////
-        std::vector<sesElem> seq = diff.getSes().getSequence();
         m_resultLeft.reserve(seq.size());
         int seqStartLine = wxNOT_FOUND;
         for(size_t i = 0; i < seq.size(); ++i) {
-            switch(seq.at(i).second.type) {
-            case dtl::SES_COMMON: {
+            switch(seq[i].type) {
+            case kEditCommon: {
                 if(seqStartLine != wxNOT_FOUND) {
                     m_sequences.push_back(std::make_pair(seqStartLine, m_resultLeft.size()));
                     seqStartLine = wxNOT_FOUND;
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_COMMON);
+                clDTL::LineInfo line(edit_line(seq[i]), LINE_COMMON);
                 m_resultLeft.push_back(line);
                 break;
             }
-            case dtl::SES_ADD: {
+            case kEditAdd: {
                 if(seqStartLine == wxNOT_FOUND) {
                     seqStartLine = m_resultLeft.size();
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_ADDED);
+                clDTL::LineInfo line(edit_line(seq[i]), LINE_ADDED);
                 m_resultLeft.push_back(line);
                 break;
             }
-            case dtl::SES_DELETE: {
+            case kEditDelete: {
                 if(seqStartLine == wxNOT_FOUND) {
                     seqStartLine = m_resultLeft.size();
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_REMOVED);
+                clDTL::LineInfo line(edit_line(seq[i]), LINE_REMOVED);
                 m_resultLeft.push_back(line);
                 break;
             }
@@ -211,38 +566,25 @@ void clDTL::DiffStrings(const wxString& before, const wxString& after, DiffMode
 
 std::vector<PatchStep> clDTL::CreatePatch(const wxString& before, const wxString& after) const
 {
-    typedef wxString elem;
-    typedef std::pair<elem, dtl::elemInfo> sesElem;
-
-    wxArrayString leftLines = wxStringTokenize(before, "\n", wxTOKEN_RET_DELIMS);
-    wxArrayString rightLines = wxStringTokenize(after, "\n", wxTOKEN_RET_DELIMS);
-
-    std::vector<elem> leftLinesVec;
-    std::vector<elem> rightLinesVec;
-    leftLinesVec.insert(leftLinesVec.end(), leftLines.begin(), leftLines.end());
-    rightLinesVec.insert(rightLinesVec.end(), rightLines.begin(), rightLines.end());
-
-    dtl::Diff<elem, std::vector<elem>> diff(leftLinesVec, rightLinesVec);
-    diff.onHuge();
-    diff.compose();
-
-    std::vector<sesElem> sesSeq = diff.getSes().getSequence();
+    std::vector<wxString> leftLines = SplitLines(before);
+    std::vector<wxString> rightLines = SplitLines(after);
+    std::vector<Edit> sesSeq = DiffLines(leftLines, rightLines);
 
     int line = 0;
     std::vector<PatchStep> steps;
     steps.reserve(sesSeq.size() * 2);
     for(auto sesIt = sesSeq.begin(); sesIt != sesSeq.end(); ++sesIt, ++line) {
-        switch(sesIt->second.type) {
-        case dtl::SES_ADD: {
-            steps.push_back({ line, PatchAction::ADD_LINE, sesIt->first });
+        switch(sesIt->type) {
+        case kEditAdd: {
+            steps.push_back({ line, PatchAction::ADD_LINE, rightLines[sesIt->index] });
             break;
         }
-        case dtl::SES_DELETE: {
+        case kEditDelete: {
             steps.push_back({ line, PatchAction::DELETE_LINE, wxEmptyString });
             --line;
             break;
         }
-        case dtl::SES_COMMON:
+        case kEditCommon:
         default:
             break;
         }
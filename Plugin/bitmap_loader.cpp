@@ -26,6 +26,7 @@
 
 #include "Zip/clZipReader.h"
 #include "clFilesCollector.h"
+#include "clSVGIconCache.hpp"
 #include "clSystemSettings.h"
 #include "cl_standard_paths.h"
 #include "editor_config.h"
@@ -113,17 +114,24 @@ void BitmapLoader::LoadSVGFiles(bool darkTheme)
 
     // load the cache
     if (bitmap_bundle_cache->empty()) {
-        clFilesScanner scanner;
-        clDEBUG() << "Loading SVG files from:" << svg_path.GetPath() << endl;
-        scanner.ScanWithCallbacks(svg_path.GetPath(), nullptr, [&](const wxArrayString& files) -> bool {
-            for (const wxString& filepath : files) {
-                auto bmpbundle = wxBitmapBundle::FromSVGFile(filepath, wxSize(16, 16));
-                if (bmpbundle.IsOk()) {
-                    bitmap_bundle_cache->insert({ wxFileName(filepath).GetName(), bmpbundle });
-                }
+        // Try the pre-rasterised icons first, and parse only the SVG files that are missing from it
+        clSVGIconCache icon_cache(svg_path.GetPath(), darkTheme);
+        clSVGIconCache::SVGFile::Vec_t stale_files;
+        icon_cache.Load(bitmap_bundle_cache, &stale_files);
+        if (stale_files.empty()) {
+            return;
+        }
+
+        clDEBUG() << "Loading" << stale_files.size() << "SVG files from:" << svg_path.GetPath() << endl;
+        for (const auto& svg : stale_files) {
+            auto bmpbundle = wxBitmapBundle::FromSVGFile(svg.fullpath, wxSize(16, 16));
+            if (bmpbundle.IsOk()) {
+                (*bitmap_bundle_cache)[svg.name] = bmpbundle;
             }
-            return true;
-        });
+        }
+
+        // update the cache for the next startup
+        icon_cache.Save(*bitmap_bundle_cache);
     }
 }
 
@@ -29,22 +29,23 @@
 #include "buildmanager.h"
 #include "cl_command_event.h"
 #include "configuration_mapping.h"
-#include "dirsaver.h"
 #include "editor_config.h"
 #include "environmentconfig.h"
 #include "envvarlist.h"
 #include "event_notifier.h"
 #include "file_logger.h"
 #include "fileextmanager.h"
+#include "fileutils.h"
 #include "globals.h"
 #include "macromanager.h"
 #include "macros.h"
 #include "project.h"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <wx/app.h>
 #include <wx/msgdlg.h>
-#include <wx/sstream.h>
 #include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
@@ -78,15 +79,12 @@ static wxString GetMakeDirCmd(BuildConfigPtr bldConf, const wxString& relPath =
 
 BuilderGNUMakeClassic::BuilderGNUMakeClassic()
     : Builder("Default")
-    , m_objectChunks(1)
-    , m_projectFilesMetadata(nullptr)
 {
 }
 
 BuilderGNUMakeClassic::BuilderGNUMakeClassic(const wxString& name, const wxString& buildTool,
                                              const wxString& buildToolOptions)
     : Builder(name)
-    , m_projectFilesMetadata(nullptr)
 {
 }
 
@@ -210,6 +208,7 @@ bool BuilderGNUMakeClassic::Export(const wxString& project, const wxString& conf
     BuildMatrixPtr matrix = clCxxWorkspaceST::Get()->GetBuildMatrix();
     wxString workspaceSelConf = matrix->GetSelectedConfigurationName();
     wxArrayString depsProjs;
+    std::vector<MakefileInfo> makefiles;
     if(!isProjectOnly) {
         for(size_t i = 0; i < depsArr.GetCount(); ++i) {
             bool isCustom(false);
@@ -294,14 +293,16 @@ bool BuilderGNUMakeClassic::Export(const wxString& project, const wxString& conf
                 dep_file << wxFileName::GetPathSeparator() << dependProj->GetName();
                 depsProjs.Add(dep_file);
 
-                GenerateMakefile(dependProj, projectSelConf, confToBuild.IsEmpty() ? force : true, wxArrayString());
+                PrepareMakefile(dependProj, projectSelConf, confToBuild.IsEmpty() ? force : true, wxArrayString(),
+                                makefiles);
                 text << GetProjectMakeCommand(wspfile, fn, dependProj, projectSelConf);
             }
         }
     }
 
     // Generate makefile for the project itself
-    GenerateMakefile(proj, confToBuild, confToBuild.IsEmpty() ? force : true, depsProjs);
+    PrepareMakefile(proj, confToBuild, confToBuild.IsEmpty() ? force : true, depsProjs, makefiles);
+    GenerateMakefiles(makefiles);
 
     // incase we manually specified the configuration to be built, set the project
     // as modified, so on next attempt to build it, CodeLite will sync the configuration
@@ -448,16 +449,15 @@ bool BuilderGNUMakeClassic::Export(const wxString& project, const wxString& conf
     }
 
     // dump the content to file
-    wxFileOutputStream output("Makefile");
-    wxStringInputStream content(text);
-    output << content;
+    wxFileName makefile(wspfile.GetPath(), "Makefile");
+    WriteMakefile(makefile.GetFullPath(), text, m_makefileStates[makefile.GetFullPath()]);
 
     clDEBUG() << "Generating Makefile...is completed" << endl;
     return true;
 }
 
-void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& confToBuild, bool force,
-                                             const wxArrayString& depsProj)
+void BuilderGNUMakeClassic::PrepareMakefile(ProjectPtr proj, const wxString& confToBuild, bool force,
+                                            const wxArrayString& depsProj, std::vector<MakefileInfo>& makefiles)
 {
     wxString pname(proj->GetName());
     wxString tmpConfigName(confToBuild.c_str());
@@ -488,11 +488,12 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
         return;
     }
 
-    wxString path = proj->GetFileName().GetPath();
+    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetCompiler(bldConf->GetCompilerType());
+    if(!cmp) {
+        return;
+    }
 
-    DirSaver ds;
-    // change directory to the project base dir
-    ::wxSetWorkingDirectory(path);
+    wxString path = proj->GetFileName().GetPath();
 
     // create new makefile file
     wxString fn(path);
@@ -507,13 +508,30 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
         }
     }
 
-    // Load the current project files
-    m_projectFilesMetadata = &(proj->GetFiles());
-
-    // generate the selected configuration for this project
-    // wxTextOutputStream text(output);
-    wxString text;
+    MakefileInfo info;
+    info.proj = proj;
+    info.bldConf = bldConf;
+    info.cmp = cmp;
+    info.confToBuild = confToBuild;
+    info.projectType = settings->GetProjectType(bldConf->GetName());
+    info.fileName = fn;
+    info.depsProj = depsProj;
+    info.markerDir = DoGetMarkerFileDir(wxEmptyString);
+    info.markerFile = DoGetMarkerFileDir(pname);
+    info.relativeMarkerFile = DoGetMarkerFileDir(pname, path);
+
+    // Load the current project files, sorted so the same project always generates the same makefile
+    for (const auto& [_, file] : proj->GetFiles()) {
+        // Include only files that don't have the 'exclude from build' flag set
+        if (!file->IsExcludeFromConfiguration(confToBuild)) {
+            info.files.push_back(file);
+        }
+    }
+    std::sort(info.files.begin(), info.files.end(), [](const clProjectFile::Ptr_t& a, const clProjectFile::Ptr_t& b) {
+        return a->GetFilename() < b->GetFilename();
+    });
 
+    wxString& text = info.variables;
     text << wxT("##") << wxT("\n");
     text << wxT("## Auto Generated makefile by CodeLite IDE") << wxT("\n");
     text << wxT("## any manual changes will be erased      ") << wxT("\n");
@@ -542,7 +560,60 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
         text << name << wxT(":=") << value << wxT("") << wxT("\n");
     }
 
-    CreateListMacros(proj, confToBuild, text); // list of srcs and list of objects
+    // the build events expand the macros, which can only be done here
+    CreatePostBuildEvents(proj, bldConf, info.postBuild);
+    CreatePreBuildEvents(proj, bldConf, info.preBuild);
+
+    auto iter = m_makefileStates.find(fn);
+    if(iter != m_makefileStates.end()) {
+        info.state = iter->second;
+    }
+    makefiles.push_back(std::move(info));
+}
+
+void BuilderGNUMakeClassic::GenerateMakefiles(std::vector<MakefileInfo>& makefiles)
+{
+    if(makefiles.empty()) {
+        return;
+    }
+
+    // the worker threads look up the file types by extension, make sure the table is ready before they start
+    FileExtManager::Init();
+
+    size_t threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), makefiles.size()));
+    std::atomic_size_t next(0);
+    auto worker = [&]() {
+        for(size_t i = next++; i < makefiles.size(); i = next++) {
+            GenerateMakefile(makefiles[i]);
+        }
+    };
+
+    // the calling thread generates makefiles as well
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(auto& thr : threads) {
+        thr.join();
+    }
+
+    for(const MakefileInfo& info : makefiles) {
+        m_makefileStates[info.fileName] = info.state;
+        // mark the project as non-modified one
+        info.proj->SetModified(false);
+    }
+}
+
+void BuilderGNUMakeClassic::GenerateMakefile(MakefileInfo& info)
+{
+    // generate the selected configuration for this project
+    wxString text;
+    text.reserve(info.variables.length() + info.preBuild.length() + info.postBuild.length() +
+                 info.files.size() * 256);
+    text << info.variables;
+
+    CreateListMacros(info, text); // list of srcs and list of objects
 
     //-----------------------------------------------------------
     // create the build targets
@@ -555,32 +626,54 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     // this is to workaround bug in the generated makefiles
     // which causes the makefile to report 'nothing to be done'
     // even when a dependency was modified
-    wxString targetName(bldConf->GetIntermediateDirectory());
-    CreateLinkTargets(proj->GetSettings()->GetProjectType(bldConf->GetName()), bldConf, text, targetName,
-                      proj->GetName(), depsProj);
+    wxString targetName(info.bldConf->GetIntermediateDirectory());
+    CreateLinkTargets(info, text, targetName);
 
-    CreatePostBuildEvents(proj, bldConf, text);
-    CreateMakeDirsTarget(proj, bldConf, targetName, text);
-    CreatePreBuildEvents(proj, bldConf, text);
-    CreatePreCompiledHeaderTarget(bldConf, text);
+    text << info.postBuild;
+    CreateMakeDirsTarget(info.proj, info.bldConf, targetName, text);
+    text << info.preBuild;
+    CreatePreCompiledHeaderTarget(info.bldConf, text);
 
     //-----------------------------------------------------------
     // Create a list of targets that should be built according to
     // projects' file list
     //-----------------------------------------------------------
-    CreateFileTargets(proj, confToBuild, text);
-    CreateCleanTargets(proj, confToBuild, text);
+    CreateFileTargets(info, text);
+    CreateCleanTargets(info, text);
 
     // dump the content to a file
-    wxFFile output;
-    output.Open(fn, wxT("w+"));
-    if(output.IsOpened()) {
-        output.Write(text);
-        output.Close();
+    WriteMakefile(info.fileName, text, info.state);
+}
+
+bool BuilderGNUMakeClassic::WriteMakefile(const wxString& fileName, const wxString& content,
+                                          MakefileState& state) const
+{
+    // Don't touch a makefile which already has this content: make would consider it as modified
+    size_t contentHash = std::hash<wxString>{}(content);
+    time_t lastModified = FileUtils::GetFileModificationTime(fileName);
+    if(lastModified != 0) {
+        if(state.lastModified == lastModified) {
+            // the file was not modified since we last wrote it, no need to read it
+            if(state.contentHash == contentHash) {
+                return false;
+            }
+        } else {
+            wxString current;
+            if(FileUtils::ReadFileContent(fileName, current) && current == content) {
+                state.contentHash = contentHash;
+                state.lastModified = lastModified;
+                return false;
+            }
+        }
     }
 
-    // mark the project as non-modified one
-    proj->SetModified(false);
+    if(!FileUtils::WriteFileContent(fileName, content)) {
+        state = MakefileState();
+        return false;
+    }
+    state.contentHash = contentHash;
+    state.lastModified = FileUtils::GetFileModificationTime(fileName);
+    return true;
 }
 
 void BuilderGNUMakeClassic::CreateMakeDirsTarget(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& targetName,
@@ -595,25 +688,18 @@ void BuilderGNUMakeClassic::CreateMakeDirsTarget(ProjectPtr proj, BuildConfigPtr
     text << wxT("\t") << GetMakeDirCmd(bldConf) << wxT("\n");
 }
 
-void BuilderGNUMakeClassic::CreateSrcList(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGNUMakeClassic::CreateSrcList(const MakefileInfo& info, wxString& text)
 {
     std::vector<wxFileName> files;
-
-    for (const auto& [_, file] : *m_projectFilesMetadata) {
-        // Include only files that don't have the 'exclude from build' flag set
-        if (!file->IsExcludeFromConfiguration(confToBuild)) {
-            files.push_back(wxFileName(file->GetFilenameRelpath()));
-        }
+    files.reserve(info.files.size());
+    for (const auto& file : info.files) {
+        files.push_back(wxFileName(file->GetFilenameRelpath()));
     }
 
     text << wxT("Srcs=");
 
-    BuildConfigPtr bldConf = clCxxWorkspaceST::Get()->GetProjBuildConf(proj->GetName(), confToBuild);
-    wxString cmpType = bldConf->GetCompilerType();
     wxString relPath;
-
-    // get the compiler settings
-    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetCompiler(cmpType);
+    CompilerPtr cmp = info.cmp;
 
     int counter = 1;
     Compiler::CmpFileTypeInfo ft;
@@ -646,27 +732,20 @@ void BuilderGNUMakeClassic::CreateSrcList(ProjectPtr proj, const wxString& confT
     text << wxT("\n\n");
 }
 
-void BuilderGNUMakeClassic::CreateObjectList(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGNUMakeClassic::CreateObjectList(MakefileInfo& info, wxString& text)
 {
-    m_objectChunks = 1;
+    info.objectChunks = 1;
     std::vector<wxFileName> files;
-
-    for (const auto& [_, file] : *m_projectFilesMetadata) {
-        // Include only files that don't have the 'exclude from build' flag set
-        if (!file->IsExcludeFromConfiguration(confToBuild)) {
-            files.push_back(wxFileName(file->GetFilename()));
-        }
+    files.reserve(info.files.size());
+    for (const auto& file : info.files) {
+        files.push_back(wxFileName(file->GetFilename()));
     }
 
-    BuildConfigPtr bldConf = clCxxWorkspaceST::Get()->GetProjBuildConf(proj->GetName(), confToBuild);
-    wxString cmpType = bldConf->GetCompilerType();
-
-    // get the compiler settings
-    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetCompiler(cmpType);
+    CompilerPtr cmp = info.cmp;
 
     int counter = 1;
     Compiler::CmpFileTypeInfo ft;
-    wxString projectPath = proj->GetFileName().GetPath();
+    wxString projectPath = info.proj->GetFileName().GetPath();
 
     wxString objectsList;
     size_t objCounter = 0;
@@ -729,32 +808,24 @@ void BuilderGNUMakeClassic::CreateObjectList(ProjectPtr proj, const wxString& co
         text << "$(Objects" << i << ") ";
 
     text << wxT("\n\n");
-    m_objectChunks = objCounter;
+    info.objectChunks = objCounter;
 }
 
-void BuilderGNUMakeClassic::CreateFileTargets(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGNUMakeClassic::CreateFileTargets(const MakefileInfo& info, wxString& text)
 {
-    // get the project specific build configuration for the workspace active
-    // configuration
-    BuildConfigPtr bldConf = clCxxWorkspaceST::Get()->GetProjBuildConf(proj->GetName(), confToBuild);
-    wxString cmpType = bldConf->GetCompilerType();
-    // get the compiler settings
-    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetCompiler(cmpType);
+    CompilerPtr cmp = info.cmp;
     bool generateDependenciesFiles = cmp->GetGenerateDependeciesFile() && !cmp->GetDependSuffix().IsEmpty();
     bool supportPreprocessOnlyFiles =
         !cmp->GetSwitch(wxT("PreprocessOnly")).IsEmpty() && !cmp->GetPreprocessSuffix().IsEmpty();
 
     std::vector<wxFileName> abs_files, rel_paths;
 
-    abs_files.reserve(m_projectFilesMetadata->size());
-    rel_paths.reserve(m_projectFilesMetadata->size());
+    abs_files.reserve(info.files.size());
+    rel_paths.reserve(info.files.size());
 
-    for (const auto& [_, file] : *m_projectFilesMetadata) {
-        // Include only files that don't have the 'exclude from build' flag set
-        if (!file->IsExcludeFromConfiguration(confToBuild)) {
-            abs_files.push_back(wxFileName(file->GetFilename()));
-            rel_paths.push_back(wxFileName(file->GetFilenameRelpath()));
-        }
+    for (const auto& file : info.files) {
+        abs_files.push_back(wxFileName(file->GetFilename()));
+        rel_paths.push_back(wxFileName(file->GetFilenameRelpath()));
     }
 
     text << wxT("\n\n");
@@ -768,7 +839,7 @@ void BuilderGNUMakeClassic::CreateFileTargets(ProjectPtr proj, const wxString& c
     // Collect all the sub-directories that we generate files for
     wxArrayString subDirs;
 
-    wxString cwd = proj->GetFileName().GetPath();
+    wxString cwd = info.proj->GetFileName().GetPath();
 
     for(size_t i = 0; i < abs_files.size(); i++) {
         // is this file interests the compiler?
@@ -805,7 +876,7 @@ void BuilderGNUMakeClassic::CreateFileTargets(ProjectPtr proj, const wxString& c
                 wxString dependFile;
                 wxString preprocessedFile;
 
-                bool isCFile = FileExtManager::GetType(rel_paths.at(i).GetFullName()) == FileExtManager::TypeSourceC;
+                bool isCFile = FileExtManager::GetTypeFromExtension(rel_paths.at(i)) == FileExtManager::TypeSourceC;
 
                 objectName << wxT("$(IntermediateDirectory)/") << objPrefix << fullnameOnly << wxT("$(ObjectSuffix)");
                 if(generateDependenciesFiles) {
@@ -880,14 +951,9 @@ static wxString GetIntermediateFolder(BuildConfigPtr bldConf)
     return IntermediateDirectory;
 }
 
-void BuilderGNUMakeClassic::CreateCleanTargets(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGNUMakeClassic::CreateCleanTargets(const MakefileInfo& info, wxString& text)
 {
-    // get the project specific build configuration for the workspace active
-    // configuration
-    BuildConfigPtr bldConf = clCxxWorkspaceST::Get()->GetProjBuildConf(proj->GetName(), confToBuild);
-    wxString cmpType = bldConf->GetCompilerType();
-    // get the compiler settings
-    CompilerPtr cmp = BuildSettingsConfigST::Get()->GetCompiler(cmpType);
+    BuildConfigPtr bldConf = info.bldConf;
 
     // Can we use asterisk in the clean command?
     wxString imd = GetIntermediateFolder(bldConf);
@@ -898,7 +964,6 @@ void BuilderGNUMakeClassic::CreateCleanTargets(ProjectPtr proj, const wxString&
     text << wxT("##\n");
     text << wxT("clean:\n");
 
-    wxString cwd = proj->GetFileName().GetPath();
     if(!imd.IsEmpty()) {
         // Remove the entire build folder
         text << wxT("\t") << wxT("$(RM) -r ") << imd << "\n";
@@ -916,7 +981,7 @@ void BuilderGNUMakeClassic::CreateCleanTargets(ProjectPtr proj, const wxString&
         text << wxT("\t") << wxT("$(RM) ") << imd << "*$(DependSuffix)" << wxT("\n");
         // delete the output file as well
         wxString exeExt(wxEmptyString);
-        if(proj->GetSettings()->GetProjectType(bldConf->GetName()) == PROJECT_TYPE_EXECUTABLE) {
+        if(info.projectType == PROJECT_TYPE_EXECUTABLE) {
             // under windows, g++ automatically adds the .exe extension to executable
             // make sure we delete it as well
             exeExt = wxT(".exe");
@@ -924,8 +989,7 @@ void BuilderGNUMakeClassic::CreateCleanTargets(ProjectPtr proj, const wxString&
 
         text << wxT("\t") << wxT("$(RM) ") << wxT("$(OutputFile)") << wxT("\n");
         text << wxT("\t") << wxT("$(RM) ") << wxT("$(OutputFile)") << exeExt << wxT("\n");
-        text << wxT("\t") << wxT("$(RM) ") << DoGetMarkerFileDir(proj->GetName(), proj->GetFileName().GetPath())
-             << wxT("\n");
+        text << wxT("\t") << wxT("$(RM) ") << info.relativeMarkerFile << wxT("\n");
 
         // Remove the pre-compiled header
         wxString pchFile = bldConf->GetPrecompiledHeader();
@@ -940,8 +1004,7 @@ void BuilderGNUMakeClassic::CreateCleanTargets(ProjectPtr proj, const wxString&
 
         // delete the output file as well
         text << wxT("\t") << wxT("$(RM) ") << wxT("$(OutputFile)\n");
-        text << wxT("\t") << wxT("$(RM) ") << DoGetMarkerFileDir(proj->GetName(), proj->GetFileName().GetPath())
-             << wxT("\n");
+        text << wxT("\t") << wxT("$(RM) ") << info.relativeMarkerFile << wxT("\n");
 
         // Remove the pre-compiled header
         wxString pchFile = bldConf->GetPrecompiledHeader();
@@ -954,18 +1017,19 @@ void BuilderGNUMakeClassic::CreateCleanTargets(ProjectPtr proj, const wxString&
     text << wxT("\n\n");
 }
 
-void BuilderGNUMakeClassic::CreateListMacros(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGNUMakeClassic::CreateListMacros(MakefileInfo& info, wxString& text)
 {
     // create a list of Sources
-    // CreateSrcList(proj, confToBuild, text);  // Not used/needed for multi-step build
+    // CreateSrcList(info, text);  // Not used/needed for multi-step build
     // create a list of objects
-    CreateObjectList(proj, confToBuild, text);
+    CreateObjectList(info, text);
 }
 
-void BuilderGNUMakeClassic::CreateLinkTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text,
-                                              wxString& targetName, const wxString& projName,
-                                              const wxArrayString& depsProj)
+void BuilderGNUMakeClassic::CreateLinkTargets(const MakefileInfo& info, wxString& text, wxString& targetName)
 {
+    const wxString& type = info.projectType;
+    const wxArrayString& depsProj = info.depsProj;
+
     // incase project is type exe or dll, force link
     // this is to workaround bug in the generated makefiles
     // which causes the makefile to report 'nothing to be done'
@@ -975,13 +1039,9 @@ void BuilderGNUMakeClassic::CreateLinkTargets(const wxString& type, BuildConfigP
     wxString extraDeps;
     wxString depsRules;
 
-    wxString errMsg;
-    ProjectPtr proj = clCxxWorkspaceST::Get()->FindProjectByName(projName, errMsg);
-
     for(size_t i = 0; i < depsProj.GetCount(); i++) {
         wxFileName fn(depsProj.Item(i));
-        // proj->GetFileName().GetPath().c_str());
-        fn.MakeRelativeTo(proj->GetProjectPath());
+        fn.MakeRelativeTo(info.proj->GetProjectPath());
         extraDeps << "\"" << fn.GetFullPath() << wxT("\" ");
 
         depsRules << "\"" << fn.GetFullPath() << wxT("\":\n");
@@ -1008,8 +1068,8 @@ void BuilderGNUMakeClassic::CreateLinkTargets(const wxString& type, BuildConfigP
         text << wxT("$(OutputFile): $(Objects)\n");
     }
 
-    if(bldConf->IsLinkerRequired()) {
-        CreateTargets(type, bldConf, text, projName);
+    if(info.bldConf->IsLinkerRequired()) {
+        CreateTargets(info, text);
 
         if(type == PROJECT_TYPE_EXECUTABLE || type == PROJECT_TYPE_DYNAMIC_LIBRARY) {
             if(depsRules.IsEmpty() == false) {
@@ -1019,18 +1079,18 @@ void BuilderGNUMakeClassic::CreateLinkTargets(const wxString& type, BuildConfigP
     }
 }
 
-void BuilderGNUMakeClassic::CreateTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text,
-                                          const wxString& projName)
+void BuilderGNUMakeClassic::CreateTargets(const MakefileInfo& info, wxString& text)
 {
+    const wxString& type = info.projectType;
     bool markRebuilt(true);
     text << wxT("\t@$(MakeDirCommand) $(@D)\n");
     text << wxT("\t@echo \"\" > $(IntermediateDirectory)/.d\n");
 
-    CompilerPtr cmp = bldConf->GetCompiler();
+    CompilerPtr cmp = info.cmp;
 
     // this is a special target that creates a file with the content of the
     // $(Objects) variable (to be used with the @<file-name> option of the LD
-    for(size_t i = 0; i < m_objectChunks; ++i) {
+    for(size_t i = 0; i < info.objectChunks; ++i) {
         wxString oper = ">>";
         if(i == 0)
             oper = " >";
@@ -1049,9 +1109,9 @@ void BuilderGNUMakeClassic::CreateTargets(const wxString& type, BuildConfigPtr b
 
     // If a link occurred, mark this project as "rebuilt" so the parent project will
     // know that a re-link is required
-    if(bldConf->IsLinkerRequired() && markRebuilt) {
-        text << wxT("\t@$(MakeDirCommand) \"") << DoGetMarkerFileDir(wxEmptyString) << wxT("\"\n");
-        text << wxT("\t@echo rebuilt > ") << DoGetMarkerFileDir(projName) << wxT("\n");
+    if(info.bldConf->IsLinkerRequired() && markRebuilt) {
+        text << wxT("\t@$(MakeDirCommand) \"") << info.markerDir << wxT("\"\n");
+        text << wxT("\t@echo rebuilt > ") << info.markerFile << wxT("\n");
     }
 }
 
@@ -1811,7 +1871,8 @@ wxString BuilderGNUMakeClassic::GetBuildToolCommand(const wxString& project, con
 wxString BuilderGNUMakeClassic::DoGetCompilerMacro(const wxString& filename)
 {
     wxString compilerMacro(wxT("$(CXX)"));
-    switch(FileExtManager::GetType(filename)) {
+    // by extension only: this is called from the makefile generation threads
+    switch(FileExtManager::GetTypeFromExtension(filename)) {
     case FileExtManager::TypeSourceC:
         compilerMacro = wxT("$(CC)");
         break;
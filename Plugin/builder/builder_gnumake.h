@@ -30,6 +30,9 @@
 #include "project.h"
 #include "workspace.h"
 
+#include <ctime>
+#include <unordered_map>
+#include <vector>
 #include <wx/txtstrm.h>
 #include <wx/wfstream.h>
 /*
@@ -38,9 +41,6 @@
  */
 class WXDLLIMPEXP_SDK BuilderGNUMakeClassic : public Builder
 {
-    size_t m_objectChunks;
-    Project::FilesMap_t* m_projectFilesMetadata;
-
 protected:
     enum eBuildFlags {
         kCleanOnly = (1 << 0),
@@ -49,6 +49,41 @@ protected:
         kIncludePostBuild = (1 << 3),
     };
 
+    /**
+     * @brief what we know about a makefile that was written (or found up to date) by this builder
+     */
+    struct MakefileState {
+        size_t contentHash = 0;
+        time_t lastModified = 0;
+    };
+
+    /**
+     * @brief everything needed to generate the makefile of a single project. It is collected on the main thread (it
+     * requires the workspace, the macros and the plugins), the makefile itself is then generated on a worker thread.
+     * The methods that take a MakefileInfo must not access any global state
+     */
+    struct MakefileInfo {
+        ProjectPtr proj;
+        BuildConfigPtr bldConf;
+        CompilerPtr cmp;
+        wxString confToBuild;
+        wxString projectType;
+        wxString fileName;                       ///< the full path of the .mk file
+        std::vector<clProjectFile::Ptr_t> files; ///< the files that are not excluded from the build, sorted
+        wxArrayString depsProj;                  ///< the marker files of the dependencies
+        wxString markerDir;                      ///< DoGetMarkerFileDir(wxEmptyString)
+        wxString markerFile;                     ///< DoGetMarkerFileDir(project)
+        wxString relativeMarkerFile;             ///< DoGetMarkerFileDir(project, project-path)
+        wxString variables;                      ///< the makefile header and variables
+        wxString preBuild;
+        wxString postBuild;
+        size_t objectChunks = 1;
+        MakefileState state;
+    };
+
+private:
+    std::unordered_map<wxString, MakefileState> m_makefileStates;
+
 public:
     BuilderGNUMakeClassic();
     BuilderGNUMakeClassic(const wxString& name, const wxString& buildTool, const wxString& buildToolOptions);
@@ -69,13 +104,12 @@ public:
                                          const wxString& arguments);
 
 protected:
-    virtual void CreateListMacros(ProjectPtr proj, const wxString& confToBuild, wxString& text);
-    void CreateSrcList(ProjectPtr proj, const wxString& confToBuild, wxString& text);
-    void CreateObjectList(ProjectPtr proj, const wxString& confToBuild, wxString& text);
-    virtual void CreateLinkTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text, wxString& targetName,
-                                   const wxString& projName, const wxArrayString& depsProj);
-    virtual void CreateFileTargets(ProjectPtr proj, const wxString& confToBuild, wxString& text);
-    void CreateCleanTargets(ProjectPtr proj, const wxString& confToBuild, wxString& text);
+    virtual void CreateListMacros(MakefileInfo& info, wxString& text);
+    void CreateSrcList(const MakefileInfo& info, wxString& text);
+    void CreateObjectList(MakefileInfo& info, wxString& text);
+    virtual void CreateLinkTargets(const MakefileInfo& info, wxString& text, wxString& targetName);
+    virtual void CreateFileTargets(const MakefileInfo& info, wxString& text);
+    void CreateCleanTargets(const MakefileInfo& info, wxString& text);
     // Override default methods defined in the builder interface
     virtual wxString GetBuildToolCommand(const wxString& project, const wxString& confToBuild,
                                          const wxString& arguments, bool isCommandlineCommand) const;
@@ -83,10 +117,27 @@ protected:
     bool SendBuildEvent(int eventId, const wxString& projectName, const wxString& configurationName);
 
 private:
-    void GenerateMakefile(ProjectPtr proj, const wxString& confToBuild, bool force, const wxArrayString& depsProj);
+    /**
+     * @brief collect what is needed to generate the project makefile into 'makefiles'. Nothing is added if the
+     * makefile is up to date or if it is generated by a plugin
+     */
+    void PrepareMakefile(ProjectPtr proj, const wxString& confToBuild, bool force, const wxArrayString& depsProj,
+                         std::vector<MakefileInfo>& makefiles);
+    /**
+     * @brief generate the prepared makefiles in parallel
+     */
+    void GenerateMakefiles(std::vector<MakefileInfo>& makefiles);
+    void GenerateMakefile(MakefileInfo& info);
+    /**
+     * @brief write 'content' to 'fileName' unless the file already has this content. Called from the worker threads
+     * @param state [in/out] the state of the file from the previous write
+     * @return true if the file was written
+     */
+    bool WriteMakefile(const wxString& fileName, const wxString& content, MakefileState& state) const;
+
     void CreateConfigsVariables(ProjectPtr proj, BuildConfigPtr bldConf, wxString& text);
     void CreateMakeDirsTarget(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& targetName, wxString& text);
-    void CreateTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text, const wxString& projName);
+    void CreateTargets(const MakefileInfo& info, wxString& text);
     void CreatePreBuildEvents(ProjectPtr proj, BuildConfigPtr bldConf, wxString& text);
     void CreatePostBuildEvents(ProjectPtr proj, BuildConfigPtr bldConf, wxString& text);
     void CreatePreCompiledHeaderTarget(BuildConfigPtr bldConf, wxString& text);
@@ -68,12 +68,12 @@ BuilderGnuMakeOneStep::BuilderGnuMakeOneStep()
 
 BuilderGnuMakeOneStep::~BuilderGnuMakeOneStep() {}
 
-void BuilderGnuMakeOneStep::CreateListMacros(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGnuMakeOneStep::CreateListMacros(MakefileInfo& info, wxString& text)
 {
     // create a list of Sources
-    BuilderGNUMakeClassic::CreateSrcList(proj, confToBuild, text);
+    BuilderGNUMakeClassic::CreateSrcList(info, text);
     // create a list of objects
-    BuilderGNUMakeClassic::CreateObjectList(proj, confToBuild, text);
+    BuilderGNUMakeClassic::CreateObjectList(info, text);
 }
 
 void BuilderGnuMakeOneStep::CreateLinkTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text,
@@ -90,7 +90,7 @@ void BuilderGnuMakeOneStep::CreateLinkTargets(const wxString& type, BuildConfigP
     //}
 }
 
-void BuilderGnuMakeOneStep::CreateFileTargets(ProjectPtr proj, const wxString& confToBuild, wxString& text)
+void BuilderGnuMakeOneStep::CreateFileTargets(const MakefileInfo& info, wxString& text)
 {
     // override to do do nothing (no link objects) build rule already given in CreateLinkTargets
 }
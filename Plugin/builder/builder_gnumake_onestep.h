@@ -56,9 +56,9 @@ public:
             virtual wxString GetPORebuildCommand(const wxString &project, const wxString &confToBuild);
     */
 protected:
-    virtual void CreateListMacros(ProjectPtr proj, const wxString& confToBuild, wxString& text);
+    virtual void CreateListMacros(MakefileInfo& info, wxString& text);
     virtual void CreateLinkTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text, wxString& targetName);
-    virtual void CreateFileTargets(ProjectPtr proj, const wxString& confToBuild, wxString& text);
+    virtual void CreateFileTargets(const MakefileInfo& info, wxString& text);
 
 private:
     void CreateTargets(const wxString& type, BuildConfigPtr bldConf, wxString& text);
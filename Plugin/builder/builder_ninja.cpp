@@ -0,0 +1,1076 @@
+#include "builder_ninja.h"
+
+#include "JSON.h"
+#include "StringUtils.h"
+#include "build_settings_config.h"
+#include "cl_command_event.h"
+#include "configuration_mapping.h"
+#include "environmentconfig.h"
+#include "event_notifier.h"
+#include "file_logger.h"
+#include "fileextmanager.h"
+#include "fileutils.h"
+#include "globals.h"
+#include "macromanager.h"
+#include "macros.h"
+
+#include <algorithm>
+#include <wx/tokenzr.h>
+
+namespace
+{
+const wxString NINJA_FILE = "build.ninja";
+
+/**
+ * @brief write the file only if its content was modified, an untouched build.ninja is not re-parsed by ninja's
+ * manifest check and tools watching compile_commands.json are not triggered
+ */
+void WriteFileIfChanged(const wxFileName& fn, const wxString& content)
+{
+    wxString current;
+    if (fn.FileExists() && FileUtils::ReadFileContent(fn, current) && current == content) {
+        return;
+    }
+    FileUtils::WriteFileContent(fn, content);
+}
+
+wxString Quote(const wxString& str) { return "\"" + str + "\""; }
+
+wxString ToUnixPath(const wxString& path)
+{
+    wxString unixPath = path;
+    unixPath.Replace("\\", "/");
+    return unixPath;
+}
+} // namespace
+
+BuilderNinja::BuilderNinja()
+    : Builder("Ninja")
+{
+    m_isWindows = wxGetOsVersion() & wxOS_WINDOWS ? true : false;
+}
+
+BuilderNinja::~BuilderNinja() {}
+
+wxString BuilderNinja::EscapePath(const wxString& path)
+{
+    wxString escaped;
+    escaped.reserve(path.length());
+    for (size_t i = 0; i < path.length(); ++i) {
+        wxUniChar ch = path[i];
+        if (ch == '$' || ch == ' ' || ch == ':') {
+            escaped << '$';
+        }
+        escaped << ch;
+    }
+    return escaped;
+}
+
+wxString BuilderNinja::EscapeValue(const wxString& value)
+{
+    wxString escaped = value;
+    escaped.Replace("$", "$$");
+    escaped.Replace("\r", "");
+    escaped.Replace("\n", " ");
+    return escaped;
+}
+
+bool BuilderNinja::Export(const wxString& project,
+                          const wxString& confToBuild,
+                          const wxString& arguments,
+                          bool isProjectOnly,
+                          bool force,
+                          wxString& errMsg)
+{
+    wxUnusedVar(arguments);
+    wxUnusedVar(isProjectOnly);
+    wxUnusedVar(force);
+
+    if (project.IsEmpty()) {
+        return false;
+    }
+
+    clCxxWorkspace* workspace = clCxxWorkspaceST::Get();
+    ProjectPtr proj = workspace->FindProjectByName(project, errMsg);
+    if (!proj) {
+        errMsg << _("Cant open project '") << project << "'";
+        return false;
+    }
+
+    clDEBUG() << "Generating build.ninja..." << endl;
+
+    // The build file covers the whole workspace regardless of the requested project, the requested target is selected
+    // on the ninja command line instead. This keeps a single dependency graph (and a single ninja log) for all the
+    // projects
+    wxString workspacePath = ToUnixPath(workspace->GetWorkspaceFileName().GetPath());
+    wxString buildDir;
+    buildDir << workspacePath << "/build-" << workspace->GetSelectedConfig()->GetName();
+
+    wxString text;
+    text << "##\n";
+    text << "## Auto Generated build.ninja by CodeLite IDE\n";
+    text << "## any manual changes will be erased\n";
+    text << "##\n";
+    text << "ninja_required_version = 1.5\n";
+    text << "builddir = " << EscapeValue(buildDir) << "\n\n";
+    CreateRules(text);
+
+    JSON root(cJSON_Array);
+    JSONItem compileCommands = root.toElement();
+
+    std::vector<ProjectInfo> projects = GetProjects(project, confToBuild);
+    wxString defaultTargets;
+    for (const ProjectInfo& info : projects) {
+        CreateProjectEdges(info, projects, text, compileCommands);
+        defaultTargets << " " << EscapePath(info.target);
+    }
+
+    if (!defaultTargets.IsEmpty()) {
+        text << "default" << defaultTargets << "\n";
+    }
+
+    WriteFileIfChanged(wxFileName(workspacePath, NINJA_FILE), text);
+
+    wxFileName compileCommandsFile(buildDir, "compile_commands.json");
+    compileCommandsFile.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    WriteFileIfChanged(compileCommandsFile, compileCommands.format());
+
+    clDEBUG() << "Generating build.ninja...is completed" << endl;
+    return true;
+}
+
+std::vector<BuilderNinja::ProjectInfo> BuilderNinja::GetProjects(const wxString& project, const wxString& confToBuild)
+{
+    std::vector<ProjectInfo> projects;
+
+    clCxxWorkspace* workspace = clCxxWorkspaceST::Get();
+    BuildMatrixPtr matrix = workspace->GetBuildMatrix();
+    wxString workspaceSelConf = matrix->GetSelectedConfigurationName();
+
+    wxArrayString names;
+    workspace->GetProjectList(names);
+    names.Sort();
+
+    for (const wxString& name : names) {
+        wxString errMsg;
+        ProjectPtr proj = workspace->FindProjectByName(name, errMsg);
+        if (!proj) {
+            continue;
+        }
+
+        // incase we manually specified the configuration to be built, use it for the requested project
+        wxString conf = matrix->GetProjectSelectedConf(workspaceSelConf, name);
+        if (name == project && !confToBuild.IsEmpty()) {
+            conf = confToBuild;
+        }
+
+        BuildConfigPtr bldConf = workspace->GetProjBuildConf(name, conf);
+        if (!bldConf || !bldConf->IsProjectEnabled() || !bldConf->GetCompiler()) {
+            // Ignore disabled projects
+            continue;
+        }
+
+        ProjectInfo info;
+        info.project = proj;
+        info.buildConf = bldConf;
+        info.target = name;
+        info.isCustom =
+            bldConf->IsCustomBuild() || SendBuildEvent(wxEVT_GET_IS_PLUGIN_MAKEFILE, name, bldConf->GetName());
+        if (!info.isCustom && bldConf->IsLinkerRequired()) {
+            info.outputFile = GetOutputFile(proj, bldConf);
+        }
+        projects.push_back(info);
+    }
+    return projects;
+}
+
+std::vector<const BuilderNinja::ProjectInfo*>
+BuilderNinja::GetProjectDependencies(const ProjectInfo& info, const std::vector<ProjectInfo>& projects) const
+{
+    std::vector<const ProjectInfo*> dependencies;
+    wxArrayString names = info.project->GetDependencies(info.buildConf->GetName());
+    for (const wxString& name : names) {
+        // Missing or disabled projects are not part of the build file, skip them
+        auto iter = std::find_if(projects.begin(), projects.end(),
+                                 [&](const ProjectInfo& p) { return p.project->GetName() == name; });
+        if (iter != projects.end()) {
+            dependencies.push_back(&(*iter));
+        }
+    }
+    return dependencies;
+}
+
+void BuilderNinja::CreateRules(wxString& text) const
+{
+    // The commands are fully expanded per edge (the toolchain compile lines are free text). The gcc and msvc rules
+    // let ninja record the header dependencies in its deps log, so no dependency file is parsed on the next build
+    text << "rule compile_gcc\n";
+    text << "  command = $cmd -MMD -MF \"$depfile\"\n";
+    text << "  deps = gcc\n";
+    text << "  description = $desc\n\n";
+
+    text << "rule compile_msvc\n";
+    text << "  command = $cmd /showIncludes\n";
+    text << "  deps = msvc\n";
+    text << "  description = $desc\n\n";
+
+    text << "rule compile\n";
+    text << "  command = $cmd\n";
+    text << "  description = $desc\n\n";
+
+    text << "rule link\n";
+    text << "  command = $cmd\n";
+    text << "  rspfile = $rspfile\n";
+    text << "  rspfile_content = $in\n";
+    text << "  description = $desc\n\n";
+
+    // custom commands (pre build, custom builds, clean) have no output file, so they run on every build
+    text << "rule custom\n";
+    text << "  command = $cmd\n";
+    text << "  description = $desc\n";
+    text << "  pool = console\n\n";
+}
+
+void BuilderNinja::CreateProjectEdges(const ProjectInfo& info,
+                                      const std::vector<ProjectInfo>& projects,
+                                      wxString& text,
+                                      JSONItem& compileCommands)
+{
+    ProjectPtr proj = info.project;
+    BuildConfigPtr bldConf = info.buildConf;
+    const wxString& name = proj->GetName();
+    wxString projectPath = ToUnixPath(proj->GetFileName().GetPath());
+
+    text << "##\n";
+    text << "## " << name << " - " << bldConf->GetName() << "\n";
+    text << "##\n";
+
+    // Projects that can be linked against are implicit inputs of the link edge: a modified library re-links its
+    // dependants. Custom builds are only ordered before this project (they may generate sources)
+    wxString linkDeps;
+    wxString orderOnlyDeps;
+    wxString allDeps;
+    for (const ProjectInfo* dep : GetProjectDependencies(info, projects)) {
+        if (dep->isCustom) {
+            orderOnlyDeps << " " << EscapePath(dep->target);
+        } else if (!dep->outputFile.IsEmpty()) {
+            linkDeps << " " << EscapePath(dep->outputFile);
+        }
+        allDeps << " " << EscapePath(dep->target);
+    }
+
+    if (info.isCustom) {
+        // nothing is known about the custom build, so it runs after all of its dependencies
+        CreateCustomBuildEdges(info, allDeps, text);
+        return;
+    }
+
+    CompilerPtr cmp = bldConf->GetCompiler();
+    wxStringMap_t macros = CreateMacros(proj, bldConf, cmp);
+    wxString intermediateDir = macros["IntermediateDirectory"];
+
+    // pre build commands run on every build (like the makefile 'PreBuild' target), before anything is compiled
+    BuildCommandList cmds;
+    bldConf->GetPreBuildCommands(cmds);
+    wxString preBuild = JoinBuildCommands(cmds, macros, proj, bldConf);
+    if (!preBuild.IsEmpty()) {
+        text << "build " << EscapePath(GetPreBuildTarget(name)) << ": custom";
+        if (!orderOnlyDeps.IsEmpty()) {
+            text << " ||" << orderOnlyDeps;
+        }
+        text << "\n";
+        text << "  cmd = " << EscapeValue(InDirectory(projectPath, preBuild)) << "\n";
+        text << "  desc = " << EscapeValue("Executing Pre Build commands for " + name) << "\n";
+        orderOnlyDeps << " " << EscapePath(GetPreBuildTarget(name));
+    }
+
+    wxString pchDeps;
+    wxString pchFile = bldConf->GetPrecompiledHeader();
+    pchFile.Trim().Trim(false);
+    if (!pchFile.IsEmpty() && bldConf->GetPCHFlagsPolicy() != BuildConfig::kPCHJustInclude) {
+        wxFileName fnPch(pchFile);
+        fnPch.MakeAbsolute(projectPath);
+        wxString pchPath = ToUnixPath(fnPch.GetFullPath());
+
+        wxString pchCommand;
+        pchCommand << (FileExtManager::GetType(pchPath) == FileExtManager::TypeSourceC ? "$(CC)" : "$(CXX)")
+                   << " $(SourceSwitch) " << pchFile << " $(PCHCompileFlags)";
+        if (bldConf->GetPCHFlagsPolicy() == BuildConfig::kPCHPolicyAppend) {
+            pchCommand << " $(CXXFLAGS) $(IncludePath)";
+        }
+
+        text << "build " << EscapePath(pchPath + ".gch") << ": compile " << EscapePath(pchPath);
+        if (!orderOnlyDeps.IsEmpty()) {
+            text << " ||" << orderOnlyDeps;
+        }
+        text << "\n";
+        text << "  cmd = " << EscapeValue(InDirectory(projectPath, ExpandMacros(pchCommand, macros))) << "\n";
+        text << "  desc = " << EscapeValue("PreCompiled Header " + pchFile) << "\n";
+        pchDeps << " " << EscapePath(pchPath + ".gch");
+    }
+
+    wxString compileRule = "compile";
+    if (cmp->IsGnuCompatibleCompiler()) {
+        compileRule = "compile_gcc";
+    } else if (cmp->GetCompilerFamily() == COMPILER_FAMILY_VC) {
+        compileRule = "compile_msvc";
+    }
+    wxString dependSuffix = cmp->GetDependSuffix();
+    if (dependSuffix.IsEmpty()) {
+        dependSuffix = cmp->GetObjectSuffix() + ".d";
+    }
+    bool supportPreprocessOnlyFiles =
+        !cmp->GetSwitch("PreprocessOnly").IsEmpty() && !cmp->GetPreprocessSuffix().IsEmpty();
+
+    // sort the files, so an unmodified project generates an identical build file
+    std::vector<clProjectFile::Ptr_t> files;
+    if (bldConf->IsCompilerRequired()) {
+        for (const auto& [_, file] : proj->GetFiles()) {
+            // Include only files that don't have the 'exclude from build' flag set
+            if (!file->IsExcludeFromConfiguration(bldConf->GetName())) {
+                files.push_back(file);
+            }
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const clProjectFile::Ptr_t& a, const clProjectFile::Ptr_t& b) {
+        return a->GetFilename() < b->GetFilename();
+    });
+
+    wxArrayString objects;
+    for (const auto& file : files) {
+        wxFileName fn(file->GetFilename());
+        Compiler::CmpFileTypeInfo ft;
+        if (!cmp->GetCmpFileType(fn.GetExt().Lower(), ft)) {
+            continue;
+        }
+
+        bool isResource = ft.kind == Compiler::CmpFileKindResource;
+        if ((isResource && !m_isWindows) || (!isResource && ft.kind != Compiler::CmpFileKindSource)) {
+            continue;
+        }
+
+        wxString fullpath = ToUnixPath(fn.GetFullPath());
+        wxString relPath = wxFileName(file->GetFilenameRelpath()).GetPath(true, wxPATH_UNIX);
+        wxString objPrefix = GetObjectNamePrefix(fn, proj->GetFileName().GetPath(), cmp);
+        wxString objectBase = intermediateDir + "/" + objPrefix + fn.GetFullName();
+        wxString objectFile = objectBase + cmp->GetObjectSuffix();
+        bool isCFile = FileExtManager::GetType(fn.GetFullName()) == FileExtManager::TypeSourceC;
+
+        // only the compiler (not the assembler or the resource compiler) knows how to write the dependencies
+        wxString rule = "compile";
+        if (ft.compilation_line.StartsWith("$(CXX)") || ft.compilation_line.StartsWith("$(CC)")) {
+            rule = compileRule;
+        }
+
+        wxString compilationLine = ft.compilation_line;
+        compilationLine.Replace("$(FileName)", fn.GetName());
+        compilationLine.Replace("$(FileFullName)", fn.GetFullName());
+        compilationLine.Replace("$(FileFullPath)", fullpath);
+        compilationLine.Replace("$(FilePath)", relPath);
+        compilationLine.Replace("$(ObjectName)", objPrefix + fn.GetFullName());
+        compilationLine.Replace("\\", "/");
+        if (!isCFile) {
+            // Add the PCH include line
+            compilationLine.Replace("$(CXX)", "$(CXX) $(IncludePCH)");
+        }
+        wxString command = ExpandMacros(compilationLine, macros);
+
+        text << "build " << EscapePath(objectFile) << ": " << rule << " " << EscapePath(fullpath);
+        if (!isResource && !pchDeps.IsEmpty()) {
+            text << " |" << pchDeps;
+        }
+        if (!orderOnlyDeps.IsEmpty()) {
+            text << " ||" << orderOnlyDeps;
+        }
+        text << "\n";
+        text << "  cmd = " << EscapeValue(InDirectory(projectPath, command)) << "\n";
+        if (rule == "compile_gcc") {
+            text << "  depfile = " << EscapeValue(objectBase + dependSuffix) << "\n";
+        }
+        text << "  desc = " << EscapeValue(file->GetFilenameRelpath()) << "\n";
+        objects.Add(objectFile);
+
+        if (isResource) {
+            continue;
+        }
+
+        JSONItem entry = JSONItem::createObject();
+        entry.addProperty("directory", projectPath);
+        entry.addProperty("file", fullpath);
+        entry.addProperty("command", command);
+        compileCommands.append(entry);
+
+        // preprocessed files are not part of the default targets, they are built on demand
+        if (supportPreprocessOnlyFiles) {
+            wxString preprocessedFile = objectBase + cmp->GetPreprocessSuffix();
+            wxString preprocessLine;
+            preprocessLine << (isCFile ? "$(CC) $(CFLAGS)" : "$(CXX) $(CXXFLAGS) $(IncludePCH)")
+                           << " $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) " << Quote(preprocessedFile)
+                           << " " << Quote(fullpath);
+            text << "build " << EscapePath(preprocessedFile) << ": compile " << EscapePath(fullpath);
+            if (!orderOnlyDeps.IsEmpty()) {
+                text << " ||" << orderOnlyDeps;
+            }
+            text << "\n";
+            text << "  cmd = " << EscapeValue(InDirectory(projectPath, ExpandMacros(preprocessLine, macros)))
+                 << "\n";
+            text << "  desc = " << EscapeValue("Preprocessing " + file->GetFilenameRelpath()) << "\n";
+        }
+    }
+
+    cmds.clear();
+    bldConf->GetPostBuildCommands(cmds);
+    wxString postBuild = JoinBuildCommands(cmds, macros, proj, bldConf);
+
+    if (info.outputFile.IsEmpty()) {
+        // nothing to link, building the project means compiling its files (and running the post build commands)
+        text << "build " << EscapePath(info.target) << ": " << (postBuild.IsEmpty() ? "phony" : "custom");
+        for (const wxString& object : objects) {
+            text << " " << EscapePath(object);
+        }
+        text << "\n";
+        if (!postBuild.IsEmpty()) {
+            text << "  cmd = " << EscapeValue(InDirectory(projectPath, postBuild)) << "\n";
+            text << "  desc = " << EscapeValue("Executing Post Build commands for " + name) << "\n";
+        }
+
+    } else {
+        wxString type = bldConf->GetProjectType();
+        bool readObjectsFromFile = cmp->GetReadObjectFilesFromList();
+
+        wxString objectsList;
+        for (const wxString& object : objects) {
+            objectsList << Quote(object) << " ";
+        }
+        macros["Objects"] = objectsList;
+
+        // the post build commands are part of the link command, so they run only when the project is re-linked
+        wxString command = ExpandMacros(cmp->GetLinkLine(type, readObjectsFromFile), macros);
+        if (!postBuild.IsEmpty()) {
+            command << " && " << postBuild;
+        }
+
+        text << "build " << EscapePath(info.outputFile) << ": link";
+        for (const wxString& object : objects) {
+            text << " " << EscapePath(object);
+        }
+        if (!linkDeps.IsEmpty()) {
+            text << " |" << linkDeps;
+        }
+        if (!orderOnlyDeps.IsEmpty()) {
+            text << " ||" << orderOnlyDeps;
+        }
+        text << "\n";
+        text << "  cmd = " << EscapeValue(InDirectory(projectPath, command)) << "\n";
+        if (readObjectsFromFile) {
+            text << "  rspfile = " << EscapeValue(macros["ObjectsFileList"]) << "\n";
+        }
+        text << "  desc = " << EscapeValue("Linking " + name) << "\n";
+        text << "build " << EscapePath(info.target) << ": phony " << EscapePath(info.outputFile) << "\n";
+    }
+
+    wxArrayString outputFiles;
+    if (!info.outputFile.IsEmpty()) {
+        outputFiles.Add(info.outputFile);
+    }
+    if (!pchDeps.IsEmpty()) {
+        wxFileName fnPch(pchFile);
+        fnPch.MakeAbsolute(projectPath);
+        outputFiles.Add(ToUnixPath(fnPch.GetFullPath()) + ".gch");
+    }
+    CreateCleanEdge(name, GetRemoveOutputsCommand(intermediateDir, outputFiles, projectPath, cmp), text);
+    text << "\n";
+}
+
+void BuilderNinja::CreateCustomBuildEdges(const ProjectInfo& info, const wxString& orderOnlyDeps, wxString& text)
+{
+    ProjectPtr proj = info.project;
+    BuildConfigPtr bldConf = info.buildConf;
+    const wxString& name = proj->GetName();
+
+    wxString buildCmd;
+    wxString cleanCmd;
+
+    if (!bldConf->IsCustomBuild()) {
+        // this project makefile is generated by a plugin, query the plugin about the commands. They are executed
+        // from the workspace folder
+        clBuildEvent buildEvent(wxEVT_GET_PROJECT_BUILD_CMD);
+        buildEvent.SetProjectName(name);
+        buildEvent.SetConfigurationName(bldConf->GetName());
+        buildEvent.SetProjectOnly(false);
+        EventNotifier::Get()->ProcessEvent(buildEvent);
+        buildCmd = buildEvent.GetCommand();
+
+        clBuildEvent cleanEvent(wxEVT_GET_PROJECT_CLEAN_CMD);
+        cleanEvent.SetProjectName(name);
+        cleanEvent.SetConfigurationName(bldConf->GetName());
+        cleanEvent.SetProjectOnly(false);
+        EventNotifier::Get()->ProcessEvent(cleanEvent);
+        cleanCmd = cleanEvent.GetCommand();
+
+        if (buildCmd.IsEmpty()) {
+            buildCmd << "echo Project has no build command!";
+        }
+        if (cleanCmd.IsEmpty()) {
+            cleanCmd << "echo Project has no clean command!";
+        }
+
+    } else {
+        wxString customWd = bldConf->GetCustomBuildWorkingDir();
+        customWd = ExpandAllVariables(customWd, clCxxWorkspaceST::Get(), name, bldConf->GetName(), wxEmptyString);
+        customWd.Trim().Trim(false);
+        if (customWd.IsEmpty()) {
+            customWd = proj->GetFileName().GetPath();
+        } else {
+            customWd = ExpandVariables(customWd, proj, NULL);
+        }
+
+        wxString build = ExpandAllVariables(
+            bldConf->GetCustomBuildCmd(), clCxxWorkspaceST::Get(), name, bldConf->GetName(), wxEmptyString);
+        build.Trim().Trim(false);
+        if (build.IsEmpty()) {
+            build << "echo Project has no custom build command!";
+        }
+
+        wxString clean = ExpandAllVariables(
+            bldConf->GetCustomCleanCmd(), clCxxWorkspaceST::Get(), name, bldConf->GetName(), wxEmptyString);
+        clean.Trim().Trim(false);
+        if (clean.IsEmpty()) {
+            clean << "echo Project has no custom clean command!";
+        }
+
+        // custom builds run their pre and post build commands around the build command
+        wxStringMap_t macros;
+        BuildCommandList cmds;
+        bldConf->GetPreBuildCommands(cmds);
+        wxString preBuild = JoinBuildCommands(cmds, macros, proj, bldConf);
+        cmds.clear();
+        bldConf->GetPostBuildCommands(cmds);
+        wxString postBuild = JoinBuildCommands(cmds, macros, proj, bldConf);
+
+        if (!preBuild.IsEmpty()) {
+            build.Prepend(preBuild + " && ");
+        }
+        if (!postBuild.IsEmpty()) {
+            build << " && " << postBuild;
+        }
+        buildCmd = InDirectory(ToUnixPath(customWd), build);
+        cleanCmd = InDirectory(ToUnixPath(customWd), clean);
+    }
+
+    text << "build " << EscapePath(info.target) << ": custom";
+    if (!orderOnlyDeps.IsEmpty()) {
+        text << " ||" << orderOnlyDeps;
+    }
+    text << "\n";
+    text << "  cmd = " << EscapeValue(buildCmd) << "\n";
+    text << "  desc = " << EscapeValue("Building " + name) << "\n";
+    CreateCleanEdge(name, cleanCmd, text);
+    text << "\n";
+}
+
+void BuilderNinja::CreateCleanEdge(const wxString& projectName, const wxString& command, wxString& text) const
+{
+    text << "build " << EscapePath(GetCleanTarget(projectName)) << ": custom\n";
+    text << "  cmd = " << EscapeValue(command) << "\n";
+    text << "  desc = " << EscapeValue("Cleaning " + projectName) << "\n";
+}
+
+wxStringMap_t BuilderNinja::CreateMacros(ProjectPtr proj, BuildConfigPtr bldConf, CompilerPtr cmp) const
+{
+    // The toolchain compile and link lines are written in terms of the makefile variables (e.g. $(CXXFLAGS)), this
+    // table holds the same variables as the ones generated by the makefile builder, already expanded
+    wxStringMap_t macros;
+
+    wxString workspacePath = ToUnixPath(clCxxWorkspaceST::Get()->GetWorkspaceFileName().GetPath());
+    wxString projectPath = ToUnixPath(proj->GetFileName().GetPath());
+    wxString startupDir = ToUnixPath(clCxxWorkspaceST::Get()->GetStartupDir());
+    wxString intermediateDir = GetIntermediateDirectory(proj, bldConf);
+    wxString outputFile = GetOutputFile(proj, bldConf);
+
+    macros["ProjectName"] = proj->GetName();
+    macros["ConfigurationName"] = NormalizeConfigName(bldConf->GetName());
+    macros["WorkspaceConfiguration"] = clCxxWorkspaceST::Get()->GetSelectedConfig()->GetName();
+    macros["WorkspacePath"] = ::WrapWithQuotes(workspacePath);
+    macros["ProjectPath"] = ::WrapWithQuotes(projectPath);
+    macros["IntermediateDirectory"] = intermediateDir;
+    macros["OutDir"] = intermediateDir;
+    macros["CodeLitePath"] = ::WrapWithQuotes(startupDir);
+    macros["User"] = wxGetUserId();
+    macros["LinkerName"] = cmp->GetTool("LinkerName");
+    macros["SharedObjectLinkerName"] = cmp->GetTool("SharedObjectLinkerName");
+    macros["ObjectSuffix"] = cmp->GetObjectSuffix();
+    macros["DependSuffix"] = cmp->GetDependSuffix();
+    macros["PreprocessSuffix"] = cmp->GetPreprocessSuffix();
+    macros["DebugSwitch"] = cmp->GetSwitch("Debug");
+    macros["IncludeSwitch"] = cmp->GetSwitch("Include");
+    macros["LibrarySwitch"] = cmp->GetSwitch("Library");
+    macros["OutputSwitch"] = cmp->GetSwitch("Output");
+    macros["LibraryPathSwitch"] = cmp->GetSwitch("LibraryPath");
+    macros["PreprocessorSwitch"] = cmp->GetSwitch("Preprocessor");
+    macros["SourceSwitch"] = cmp->GetSwitch("Source");
+    macros["OutputDirectory"] = wxFileName(outputFile).GetPath(wxPATH_GET_VOLUME, wxPATH_UNIX);
+    macros["OutputFile"] = outputFile;
+    macros["ObjectSwitch"] = cmp->GetSwitch("Object");
+    macros["ArchiveOutputSwitch"] = cmp->GetSwitch("ArchiveOutput");
+    macros["PreprocessOnlySwitch"] = cmp->GetSwitch("PreprocessOnly");
+    macros["ObjectsFileList"] = intermediateDir + "/ObjectsList.txt";
+    macros["AR"] = cmp->GetTool("AR");
+    macros["CXX"] = cmp->GetTool("CXX");
+    macros["CC"] = cmp->GetTool("CC");
+    macros["AS"] = cmp->GetTool("AS");
+
+    // user provided values may refer to the above variables and to the environment variables
+    auto expand = [&](const wxString& value) -> wxString {
+        wxString expanded = value;
+        expanded.Replace(";", " ");
+        expanded = ExpandMacros(expanded, macros);
+        expanded = EnvironmentConfig::Instance()->ExpandVariables(expanded, true);
+        if (!m_isWindows) {
+            // the commands are executed by the shell, which knows $(...) but not make's $(shell ...)
+            expanded.Replace("$(shell ", "$(");
+        }
+        return expanded;
+    };
+
+    wxString preprocessors;
+    for (wxString& p : StringUtils::BuildArgv(bldConf->GetPreprocessor())) {
+        p.Trim().Trim(false);
+        preprocessors << macros["PreprocessorSwitch"] << p << " ";
+    }
+    macros["Preprocessors"] = expand(preprocessors);
+    macros["PCHCompileFlags"] = expand(bldConf->GetPchCompileFlags());
+
+    wxString buildOpts = expand(bldConf->GetCompileOptions());
+    wxString cBuildOpts = expand(bldConf->GetCCompileOptions());
+
+    // Let the plugins add their content here
+    clBuildEvent e(wxEVT_GET_ADDITIONAL_COMPILEFLAGS);
+    e.SetProjectName(proj->GetName());
+    e.SetConfigurationName(bldConf->GetName());
+    EventNotifier::Get()->ProcessEvent(e);
+
+    wxString additionalCompileFlags = e.GetCommand();
+    if (!additionalCompileFlags.IsEmpty()) {
+        buildOpts << " " << additionalCompileFlags;
+        cBuildOpts << " " << additionalCompileFlags;
+    }
+
+    macros["CXXFLAGS"] = buildOpts + " " + macros["Preprocessors"];
+    macros["CFLAGS"] = cBuildOpts + " " + macros["Preprocessors"];
+    macros["ASFLAGS"] = expand(bldConf->GetAssmeblerOptions());
+    macros["LinkOptions"] = expand(bldConf->GetLinkOptions());
+
+    if (m_isWindows) {
+        macros["RcCmpOptions"] = expand(bldConf->GetResCompileOptions());
+        macros["RcCompilerName"] = cmp->GetTool("ResourceCompiler");
+    }
+
+    // If the PCH is required to be in the command line, add it here
+    // otherwise, we just make sure it is generated and the compiler will pick it by itself
+    wxString pchFile;
+    if (bldConf->GetPchInCommandLine()) {
+        pchFile = bldConf->GetPrecompiledHeader();
+        pchFile.Trim().Trim(false);
+        if (!pchFile.IsEmpty()) {
+            pchFile.Prepend(" -include ").Append(" ");
+        }
+    }
+    macros["IncludePCH"] = pchFile;
+
+    auto makePathList = [&](const wxString& paths, const wxString& pathSwitch) -> wxString {
+        wxString list;
+        wxArrayString tokens = ::wxStringTokenize(paths, ";", wxTOKEN_STRTOK);
+        for (wxString& path : tokens) {
+            path = expand(path);
+            path.Trim().Trim(false);
+            if (path.IsEmpty()) {
+                continue;
+            }
+            list << pathSwitch << ::WrapWithQuotes(path) << " ";
+        }
+        return list;
+    };
+
+    macros["IncludePath"] = makePathList(cmp->GetGlobalIncludePath(), macros["IncludeSwitch"]) + " " +
+                            makePathList(bldConf->GetIncludePath(), macros["IncludeSwitch"]);
+    macros["RcIncludePath"] = makePathList(bldConf->GetResCmpIncludePath(), macros["IncludeSwitch"]);
+    macros["LibPath"] = makePathList(cmp->GetGlobalLibPath(), macros["LibraryPathSwitch"]) + " " +
+                        makePathList(bldConf->GetLibPath(), macros["LibraryPathSwitch"]);
+
+    wxString libs;
+    wxString arLibs;
+    wxArrayString libsArr = ::wxStringTokenize(bldConf->GetLibraries(), ";", wxTOKEN_STRTOK);
+    for (wxString& lib : libsArr) {
+        lib.Trim().Trim(false);
+        arLibs << Quote(lib) << " ";
+
+        // remove lib prefix and the known suffixes
+        if (lib.StartsWith("lib")) {
+            lib = lib.Mid(3);
+        }
+        if (lib.EndsWith(".a") || lib.EndsWith(".so") || lib.EndsWith(".dylib") || lib.EndsWith(".dll")) {
+            lib = lib.BeforeLast('.');
+        }
+        libs << macros["LibrarySwitch"] << lib << " ";
+    }
+    macros["Libs"] = expand(libs);
+    macros["ArLibs"] = expand(arLibs);
+    return macros;
+}
+
+wxString BuilderNinja::ExpandMacros(const wxString& text, const wxStringMap_t& macros)
+{
+    wxString result;
+    size_t pos = 0;
+    while (pos < text.length()) {
+        size_t start = text.find("$(", pos);
+        if (start == wxString::npos) {
+            result << text.Mid(pos);
+            break;
+        }
+        result << text.Mid(pos, start - pos);
+
+        size_t end = text.find(')', start + 2);
+        if (end != wxString::npos) {
+            auto iter = macros.find(text.Mid(start + 2, end - start - 2));
+            if (iter != macros.end()) {
+                result << iter->second;
+                pos = end + 1;
+                continue;
+            }
+        }
+        // not one of ours (e.g. a shell command substitution), keep it as is
+        result << "$(";
+        pos = start + 2;
+    }
+    return result;
+}
+
+wxString BuilderNinja::GetIntermediateDirectory(ProjectPtr proj, BuildConfigPtr bldConf) const
+{
+    // same location as the one used by the makefile generator, but absolute: the build file is executed from the
+    // workspace folder
+    wxString workspacePath = clCxxWorkspaceST::Get()->GetWorkspaceFileName().GetPath();
+    wxString projectPath = proj->GetFileName().GetPath();
+    wxString intermediateDir = bldConf->GetIntermediateDirectory();
+    if (intermediateDir.IsEmpty()) {
+        wxFileName projName = proj->GetFileName();
+        projName.MakeRelativeTo(workspacePath);
+        wxString projRel = projName.GetPath(wxPATH_NO_SEPARATOR);
+        projRel.Replace(".", "_");
+        projRel.Replace(" ", "_");
+        intermediateDir << "$(WorkspacePath)/build-$(WorkspaceConfiguration)/" << projRel;
+    }
+    intermediateDir.Replace("$(WorkspacePath)", workspacePath);
+    intermediateDir.Replace("$(ProjectPath)", projectPath);
+    intermediateDir.Replace("$(WorkspaceConfiguration)", clCxxWorkspaceST::Get()->GetSelectedConfig()->GetName());
+    intermediateDir.Replace("$(ProjectName)", proj->GetName());
+    intermediateDir.Replace("$(ConfigurationName)", NormalizeConfigName(bldConf->GetName()));
+    intermediateDir = EnvironmentConfig::Instance()->ExpandVariables(intermediateDir, true);
+
+    wxFileName fnIntermediateDir(intermediateDir, "");
+    fnIntermediateDir.MakeAbsolute(projectPath);
+    return ToUnixPath(fnIntermediateDir.GetPath(wxPATH_GET_VOLUME | wxPATH_NO_SEPARATOR));
+}
+
+wxString BuilderNinja::GetOutputFile(ProjectPtr proj, BuildConfigPtr bldConf) const
+{
+    wxString workspacePath = clCxxWorkspaceST::Get()->GetWorkspaceFileName().GetPath();
+    wxString projectPath = proj->GetFileName().GetPath();
+    wxString intermediateDir = GetIntermediateDirectory(proj, bldConf);
+
+    wxString outputDir = bldConf->GetOutputDirectory();
+    if (outputDir.IsEmpty()) {
+        outputDir << "$(WorkspacePath)/build-$(WorkspaceConfiguration)/"
+                  << (bldConf->GetProjectType() == PROJECT_TYPE_EXECUTABLE ? "bin" : "lib");
+    }
+
+    wxString outputFile = bldConf->GetOutputFileName();
+    outputFile.Trim().Trim(false);
+    outputFile = outputFile.AfterLast('/');
+
+    for (wxString* str : { &outputDir, &outputFile }) {
+        str->Replace("$(WorkspacePath)", workspacePath);
+        str->Replace("$(ProjectPath)", projectPath);
+        str->Replace("$(IntermediateDirectory)", intermediateDir);
+        str->Replace("$(WorkspaceConfiguration)", clCxxWorkspaceST::Get()->GetSelectedConfig()->GetName());
+        str->Replace("$(ProjectName)", proj->GetName());
+        str->Replace("$(ConfigurationName)", NormalizeConfigName(bldConf->GetName()));
+        *str = EnvironmentConfig::Instance()->ExpandVariables(*str, true);
+    }
+
+    wxFileName fnOutputFile(outputDir, outputFile);
+    fnOutputFile.MakeAbsolute(projectPath);
+    return ToUnixPath(fnOutputFile.GetFullPath());
+}
+
+wxString BuilderNinja::GetObjectNamePrefix(const wxFileName& filename, const wxString& cwd, CompilerPtr cmp) const
+{
+    if (cwd == filename.GetPath() || (cmp && cmp->GetObjectNameIdenticalToFileName())) {
+        return wxEmptyString;
+    }
+
+    // remove cwd from filename
+    wxFileName relpath = filename;
+    relpath.MakeRelativeTo(cwd);
+
+    wxString prefix;
+    for (wxString dir : relpath.GetDirs()) {
+        // Handle special directory paths
+        if (dir == "..") {
+            dir = "up";
+        } else if (dir == ".") {
+            dir = "cur";
+        }
+        if (!dir.IsEmpty()) {
+            prefix << dir << "_";
+        }
+    }
+    return prefix;
+}
+
+wxString BuilderNinja::GetObjectFileBase(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& fileName) const
+{
+    wxFileName fn(fileName);
+    wxString objectBase;
+    objectBase << GetIntermediateDirectory(proj, bldConf) << "/"
+               << GetObjectNamePrefix(fn, proj->GetFileName().GetPath(), bldConf->GetCompiler()) << fn.GetFullName();
+    return objectBase;
+}
+
+wxString BuilderNinja::JoinBuildCommands(const BuildCommandList& cmds,
+                                         const wxStringMap_t& macros,
+                                         ProjectPtr proj,
+                                         BuildConfigPtr bldConf) const
+{
+    wxString joined;
+    for (const BuildCommand& cmd : cmds) {
+        if (!cmd.GetEnabled()) {
+            continue;
+        }
+        wxString command = ExpandMacros(cmd.GetCommand(), macros);
+        command = MacroManager::Instance()->Expand(command, clGetManager(), proj->GetName(), bldConf->GetName());
+        command.Trim().Trim(false);
+        if (command.IsEmpty()) {
+            continue;
+        }
+        if (!joined.IsEmpty()) {
+            joined << " && ";
+        }
+        joined << command;
+    }
+    return joined;
+}
+
+wxString BuilderNinja::GetRemoveOutputsCommand(const wxString& intermediateDir,
+                                               const wxArrayString& outputFiles,
+                                               const wxString& projectPath,
+                                               CompilerPtr cmp) const
+{
+    // Remove the entire intermediate folder, unless it contains the project itself (e.g. '.'). In that case remove
+    // only the files generated by the compiler
+    bool removeDir = !(projectPath + "/").StartsWith(intermediateDir + "/");
+    wxString dependSuffix = cmp->GetDependSuffix().IsEmpty() ? cmp->GetObjectSuffix() + ".d" : cmp->GetDependSuffix();
+
+    wxString command;
+    if (m_isWindows) {
+        wxString dir = intermediateDir;
+        dir.Replace("/", "\\");
+        command << "cmd /c ";
+        if (removeDir) {
+            command << "if exist " << Quote(dir) << " rmdir /s /q " << Quote(dir);
+        } else {
+            command << "del /q " << Quote(dir + "\\*" + cmp->GetObjectSuffix()) << " "
+                    << Quote(dir + "\\*" + dependSuffix) << " 2>nul";
+        }
+        for (wxString file : outputFiles) {
+            file.Replace("/", "\\");
+            command << " & del /q " << Quote(file) << " 2>nul";
+        }
+        command << " & exit 0";
+
+    } else {
+        if (removeDir) {
+            command << "rm -rf " << Quote(intermediateDir);
+        } else {
+            command << "rm -f " << Quote(intermediateDir) << "/*" << cmp->GetObjectSuffix() << " "
+                    << Quote(intermediateDir) << "/*" << dependSuffix;
+        }
+        for (const wxString& file : outputFiles) {
+            command << " " << Quote(file);
+        }
+    }
+    return command;
+}
+
+wxString BuilderNinja::InDirectory(const wxString& workingDirectory, const wxString& command) const
+{
+    // ninja does not use a shell on Windows
+    if (m_isWindows) {
+        return "cmd /c cd /d " + Quote(workingDirectory) + " && " + command;
+    }
+    return "cd " + Quote(workingDirectory) + " && " + command;
+}
+
+wxString BuilderNinja::GetNinjaCommand(const wxString& targets, const wxString& arguments) const
+{
+    wxString cmd;
+    cmd << "ninja -f " << NINJA_FILE;
+    if (!arguments.IsEmpty()) {
+        cmd << " " << arguments;
+    }
+    cmd << " " << targets;
+    return cmd;
+}
+
+bool BuilderNinja::SendBuildEvent(int eventId, const wxString& projectName, const wxString& configurationName)
+{
+    clBuildEvent e(eventId);
+    e.SetProjectName(projectName);
+    e.SetConfigurationName(configurationName);
+    return EventNotifier::Get()->ProcessEvent(e);
+}
+
+wxString BuilderNinja::GetBuildCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments)
+{
+    wxString errMsg;
+    if (!Export(project, confToBuild, arguments, false, false, errMsg)) {
+        return wxEmptyString;
+    }
+
+    // ninja brings the dependencies of the project up to date as well
+    wxString target = project;
+    return GetNinjaCommand(::WrapWithQuotes(target), arguments);
+}
+
+wxString BuilderNinja::GetCleanCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments)
+{
+    wxString errMsg;
+    if (!Export(project, confToBuild, arguments, false, false, errMsg)) {
+        return wxEmptyString;
+    }
+
+    // clean the project and its dependencies
+    wxString targets;
+    std::vector<ProjectInfo> projects = GetProjects(project, confToBuild);
+    for (const ProjectInfo& info : projects) {
+        if (info.project->GetName() != project) {
+            continue;
+        }
+        for (const ProjectInfo* dep : GetProjectDependencies(info, projects)) {
+            wxString target = GetCleanTarget(dep->target);
+            targets << ::WrapWithQuotes(target) << " ";
+        }
+        break;
+    }
+    wxString target = GetCleanTarget(project);
+    targets << ::WrapWithQuotes(target);
+    return GetNinjaCommand(targets, arguments);
+}
+
+wxString
+BuilderNinja::GetPOBuildCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments)
+{
+    // a project can not be built without its dependencies being up to date, so this is the same as the build command
+    return GetBuildCommand(project, confToBuild, arguments);
+}
+
+wxString
+BuilderNinja::GetPOCleanCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments)
+{
+    wxString errMsg;
+    if (!Export(project, confToBuild, arguments, true, false, errMsg)) {
+        return wxEmptyString;
+    }
+    wxString target = GetCleanTarget(project);
+    return GetNinjaCommand(::WrapWithQuotes(target), arguments);
+}
+
+wxString BuilderNinja::GetPORebuildCommand(const wxString& project,
+                                           const wxString& confToBuild,
+                                           const wxString& arguments)
+{
+    wxString cleanCmd = GetPOCleanCommand(project, confToBuild, arguments);
+    if (cleanCmd.IsEmpty()) {
+        return wxEmptyString;
+    }
+    wxString target = project;
+    return cleanCmd + " && " + GetNinjaCommand(::WrapWithQuotes(target), arguments);
+}
+
+wxString BuilderNinja::GetSingleFileCmd(const wxString& project,
+                                        const wxString& confToBuild,
+                                        const wxString& arguments,
+                                        const wxString& fileName)
+{
+    wxString errMsg;
+    ProjectPtr proj = clCxxWorkspaceST::Get()->FindProjectByName(project, errMsg);
+    if (!proj) {
+        return wxEmptyString;
+    }
+
+    BuildConfigPtr bldConf = clCxxWorkspaceST::Get()->GetProjBuildConf(project, confToBuild);
+    if (!bldConf || !bldConf->GetCompiler()) {
+        return wxEmptyString;
+    }
+
+    if (!Export(project, confToBuild, arguments, true, false, errMsg)) {
+        return wxEmptyString;
+    }
+
+    wxFileName fn(fileName);
+    if (FileExtManager::GetType(fileName) == FileExtManager::TypeHeader) {
+        // Attempting to build a header file, try to see if we got an implementation file instead
+        // We had the current extension to the array so incase we loop over the entire array
+        // we remain with the original file name unmodified
+        std::vector<wxString> implExtensions = { "cpp", "cxx", "cc", "c++", "c", fn.GetExt() };
+        for (const wxString& ext : implExtensions) {
+            fn.SetExt(ext);
+            if (fn.FileExists()) {
+                break;
+            }
+        }
+    }
+
+    wxString target = GetObjectFileBase(proj, bldConf, fn.GetFullPath()) + bldConf->GetCompiler()->GetObjectSuffix();
+    return GetNinjaCommand(::WrapWithQuotes(target), arguments);
+}
+
+wxString BuilderNinja::GetPreprocessFileCmd(const wxString& project,
+                                            const wxString& confToBuild,
+                                            const wxString& arguments,
+                                            const wxString& fileName,
+                                            wxString& errMsg)
+{
+    ProjectPtr proj = clCxxWorkspaceST::Get()->FindProjectByName(project, errMsg);
+    if (!proj) {
+        return wxEmptyString;
+    }
+
+    BuildConfigPtr bldConf = clCxxWorkspaceST::Get()->GetProjBuildConf(project, confToBuild);
+    if (!bldConf || !bldConf->GetCompiler()) {
+        return wxEmptyString;
+    }
+
+    if (!Export(project, confToBuild, arguments, true, false, errMsg)) {
+        return wxEmptyString;
+    }
+
+    wxString target = GetObjectFileBase(proj, bldConf, fileName) + bldConf->GetCompiler()->GetPreprocessSuffix();
+    return GetNinjaCommand(::WrapWithQuotes(target), arguments);
+}
+
+Builder::OptimalBuildConfig BuilderNinja::GetOptimalBuildConfig(const wxString& projectType) const
+{
+    OptimalBuildConfig conf;
+    conf.command = "$(WorkspacePath)/build-$(WorkspaceConfiguration)/bin/$(OutputFile)";
+    conf.workingDirectory = "$(WorkspacePath)/build-$(WorkspaceConfiguration)/lib";
+
+    if (projectType == PROJECT_TYPE_STATIC_LIBRARY || projectType == PROJECT_TYPE_DYNAMIC_LIBRARY) {
+        conf.outputFile << "lib";
+    }
+    conf.outputFile << "$(ProjectName)" << GetOutputFileSuffix(projectType);
+
+    return conf;
+}
@@ -0,0 +1,113 @@
+#ifndef BUILDER_NINJA_H
+#define BUILDER_NINJA_H
+
+#include "builder.h"
+#include "codelite_exports.h"
+#include "compiler.h"
+#include "project.h"
+#include "workspace.h"
+
+#include <vector>
+#include <wx/arrstr.h>
+
+class JSONItem;
+
+/*
+ * Build using a generated build.ninja file. Unlike the makefile builders (a makefile per project, invoked
+ * recursively), a single build.ninja describes the entire workspace: a compile edge per source file, a link edge per
+ * project and the dependencies between the projects. The header dependencies are collected by ninja itself
+ * (deps = gcc / deps = msvc), so incremental and no-op builds do not have to re-read any dependency file and all
+ * the projects are compiled in parallel. A compile_commands.json file is exported next to the ninja logs
+ */
+class WXDLLIMPEXP_SDK BuilderNinja : public Builder
+{
+    bool m_isWindows = false;
+
+protected:
+    /**
+     * @brief a project as seen by the generated build file
+     */
+    struct ProjectInfo {
+        ProjectPtr project;
+        BuildConfigPtr buildConf;
+        wxString target;       ///< the phony target that builds this project
+        wxString outputFile;   ///< absolute path to the project output file, empty if nothing is linked
+        bool isCustom = false; ///< custom build or a makefile generated by a plugin
+    };
+
+public:
+    BuilderNinja();
+    virtual ~BuilderNinja();
+
+    // Implement the Builder Interface
+    virtual bool Export(const wxString& project, const wxString& confToBuild, const wxString& arguments,
+                        bool isProjectOnly, bool force, wxString& errMsg);
+    virtual wxString GetBuildCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments);
+    virtual wxString GetCleanCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments);
+    virtual wxString GetPOBuildCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments);
+    virtual wxString GetPOCleanCommand(const wxString& project, const wxString& confToBuild, const wxString& arguments);
+    virtual wxString GetSingleFileCmd(const wxString& project, const wxString& confToBuild, const wxString& arguments,
+                                      const wxString& fileName);
+    virtual wxString GetPreprocessFileCmd(const wxString& project, const wxString& confToBuild,
+                                          const wxString& arguments, const wxString& fileName, wxString& errMsg);
+    virtual wxString GetPORebuildCommand(const wxString& project, const wxString& confToBuild,
+                                         const wxString& arguments);
+    virtual OptimalBuildConfig GetOptimalBuildConfig(const wxString& projectType) const;
+
+protected:
+    /**
+     * @brief escape a path so it can be placed in a 'build' line (spaces, colons and dollars are escaped)
+     */
+    static wxString EscapePath(const wxString& path);
+    /**
+     * @brief escape a variable value
+     */
+    static wxString EscapeValue(const wxString& value);
+
+    /**
+     * @brief return the enabled projects of the workspace with the configuration to use for each of them
+     * @param project the project that 'confToBuild' applies to
+     */
+    std::vector<ProjectInfo> GetProjects(const wxString& project, const wxString& confToBuild);
+    std::vector<const ProjectInfo*> GetProjectDependencies(const ProjectInfo& info,
+                                                           const std::vector<ProjectInfo>& projects) const;
+
+    void CreateRules(wxString& text) const;
+    void CreateProjectEdges(const ProjectInfo& info, const std::vector<ProjectInfo>& projects, wxString& text,
+                            JSONItem& compileCommands);
+    void CreateCustomBuildEdges(const ProjectInfo& info, const wxString& orderOnlyDeps, wxString& text);
+    void CreateCleanEdge(const wxString& projectName, const wxString& command, wxString& text) const;
+
+    /**
+     * @brief build the table of the makefile macros used by the toolchain compile and link lines
+     */
+    wxStringMap_t CreateMacros(ProjectPtr proj, BuildConfigPtr bldConf, CompilerPtr cmp) const;
+    static wxString ExpandMacros(const wxString& text, const wxStringMap_t& macros);
+
+    wxString GetIntermediateDirectory(ProjectPtr proj, BuildConfigPtr bldConf) const;
+    wxString GetOutputFile(ProjectPtr proj, BuildConfigPtr bldConf) const;
+    wxString GetObjectNamePrefix(const wxFileName& filename, const wxString& cwd, CompilerPtr cmp) const;
+    /**
+     * @brief return the object file path for a source file, without the object (or preprocess) suffix
+     */
+    wxString GetObjectFileBase(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& fileName) const;
+
+    /**
+     * @brief join the enabled commands into a single shell command
+     */
+    wxString JoinBuildCommands(const BuildCommandList& cmds, const wxStringMap_t& macros, ProjectPtr proj,
+                               BuildConfigPtr bldConf) const;
+    wxString GetRemoveOutputsCommand(const wxString& intermediateDir, const wxArrayString& outputFiles,
+                                     const wxString& projectPath, CompilerPtr cmp) const;
+    /**
+     * @brief prefix 'command' so it is executed from 'workingDirectory'
+     */
+    wxString InDirectory(const wxString& workingDirectory, const wxString& command) const;
+
+    wxString GetNinjaCommand(const wxString& targets, const wxString& arguments) const;
+    bool SendBuildEvent(int eventId, const wxString& projectName, const wxString& configurationName);
+
+    static wxString GetCleanTarget(const wxString& projectName) { return projectName + "-clean"; }
+    static wxString GetPreBuildTarget(const wxString& projectName) { return projectName + "-prebuild"; }
+};
+#endif // BUILDER_NINJA_H
@@ -30,6 +30,7 @@
 #include "builder/builder_gnumake.h"
 #include "builder/builder_gnumake_default.h"
 #include "builder/builder_gnumake_onestep.h"
+#include "builder/builder_ninja.h"
 
 BuildManager::BuildManager()
 {
@@ -37,6 +38,7 @@ BuildManager::BuildManager()
     AddBuilder(std::make_shared<BuilderGnuMake>());
     AddBuilder(std::make_shared<BuilderGNUMakeClassic>());
     AddBuilder(std::make_shared<BuilderGnuMakeOneStep>());
+    AddBuilder(std::make_shared<BuilderNinja>());
 #ifdef __WXMSW__
     AddBuilder(std::make_shared<BuilderNMake>());
     AddBuilder(std::make_shared<BuilderGnuMakeMSYS>());
@@ -2,14 +2,20 @@
 
 #include "ColoursAndFontsManager.h"
 #include "drawingutils.h"
-#include "file_logger.h"
-
-#include <wx/tokenzr.h>
 
 namespace
 {
 constexpr int X_MARGIN = 5;
-}
+
+// SGR colours encoding: the colour kind in the top byte, its value in the lower 24 bits. 0 is the default colour
+constexpr wxUint32 COLOUR_TABLE = (1u << 24); // 30-37, 40-47, 90-97 or 100-107
+constexpr wxUint32 COLOUR_8_BIT = (2u << 24); // index in the 256 colours table
+constexpr wxUint32 COLOUR_RGB = (3u << 24);   // 0xRRGGBB
+constexpr wxUint32 COLOUR_KIND_MASK = (0xFFu << 24);
+constexpr wxUint32 COLOUR_VALUE_MASK = 0xFFFFFF;
+
+wxUint64 ColourKey(const wxColour& colour) { return colour.IsOk() ? colour.GetRGBA() : 0; }
+} // namespace
 
 clAnsiEscapeCodeHandler::clAnsiEscapeCodeHandler()
 {
@@ -332,693 +338,521 @@ clAnsiEscapeCodeHandler::clAnsiEscapeCodeHandler()
         colour = colour.ChangeLightness(80);
     }
 
-    m_8_bit_colours = &m_8_bit_colours_normal;
-    m_colours = &m_colours_normal;
+    // style 0 is the default style
+    m_styles.emplace_back();
+    m_styleIds.insert({ 0, 0 });
 }
 
 clAnsiEscapeCodeHandler::~clAnsiEscapeCodeHandler() {}
 
-#define NEXT(__is_eol)                               \
-    chunk->is_eol = __is_eol;                        \
-    if(chunk->is_style_reset || !chunk->d.empty()) { \
-        chunk->is_completed = true;                  \
-    }                                                \
-    EnsureCurrent();                                 \
-    chunk = &m_chunks.back().back();
-
-namespace
-{
-wxChar look_ahead(const wxString& buffer, size_t curpos, size_t count)
-{
-    if((curpos + count) < buffer.length()) {
-        return buffer[curpos + count];
-    }
-    return wxChar(0);
-}
-} // namespace
-
 void clAnsiEscapeCodeHandler::Parse(const wxString& buffer)
 {
-    EnsureCurrent();
-    eColourHandlerState kCR_prev_state = eColourHandlerState::kNormal;
-    auto chunk = &m_chunks.back().back();
-    for(size_t i = 0; i < buffer.length(); ++i) {
+    EnsureLine();
+    const size_t length = buffer.length();
+    for(size_t i = 0; i < length; ++i) {
         wxChar ch = buffer[i];
         switch(m_state) {
         case eColourHandlerState::kCR:
-            switch(ch) {
-            case '\n':
-                // "\r\n"
-                --i;
-                m_state = kCR_prev_state;
-                break;
-            default:
-                // any other char, we delete this entire line
-                chunk->d.clear();
-                --i;
-                m_state = kCR_prev_state;
-                break;
+            m_state = eColourHandlerState::kNormal;
+            if(ch != '\n') {
+                // a lone CR: the text that follows overwrites the current line
+                ClearCurrentLine();
             }
+            --i;
             break;
-        case eColourHandlerState::kNormal:
-            switch(ch) {
+        case eColourHandlerState::kNormal: {
+            // consume the plain text in one go
+            size_t start = i;
+            while(i < length && buffer[i] != 0x1B && buffer[i] != '\r' && buffer[i] != '\n') {
+                ++i;
+            }
+            if(i > start) {
+                AppendText(buffer, start, i - start);
+            }
+            if(i == length) {
+                break;
+            }
+
+            switch(buffer[i]) {
             case 0x1B: // ESC
-                NEXT(false);
-                // remove the text flag
-                chunk->is_text = false;
                 m_state = eColourHandlerState::kInEscape;
                 break;
             case '\r':
-                kCR_prev_state = m_state;
                 m_state = eColourHandlerState::kCR;
                 break;
             case '\n':
-                NEXT(true);
-                break;
-            default:
-                chunk->d.append(1, ch);
+                StartLine();
                 break;
             }
-            break;
+        } break;
         case eColourHandlerState::kInEscape:
-            switch(ch) {
-            // CSI - Control Sequence Introducer
-            case '[':
+            m_sequence.clear();
+            if(ch == '[') {
                 m_state = eColourHandlerState::kInCsi;
-                break;
-            case ']':
+            } else if(ch == ']') {
                 m_state = eColourHandlerState::kInOsc;
-                break;
-            default:
-                // do nothing
-                break;
+            } else if(ch < 0x20 || ch > 0x2F) {
+                // anything but an intermediate byte (e.g. the '(' in "ESC(B") ends the sequence
+                m_state = eColourHandlerState::kNormal;
             }
             break;
         case eColourHandlerState::kInOsc:
             // ESC ]
-            switch(ch) {
-            case 0x07: // BELL
-                // bell, leave the current state
-                chunk->is_completed = true;
-                NEXT(false);
+            if(ch == 0x07) { // BELL
+                HandleOSC();
                 m_state = eColourHandlerState::kNormal;
-                break;
-            case '0':
-            case '2':
-                m_state = eColourHandlerState::kOSC_Title;
-                break;
-            case '8':
-                m_state = eColourHandlerState::kOSC_Url;
-                break;
-            default:
-                chunk->d.append(1, ch);
-                break;
+            } else if(ch == 0x1B) {
+                m_state = eColourHandlerState::kInOscEscape;
+            } else {
+                m_sequence.append(1, ch);
             }
             break;
-        case eColourHandlerState::kOSC_Title: {
-            // In this state we skip the first char (';')
-            // and read everything until we find the BELL or EOF
-            chunk->is_title = true;
-            wxChar next_char = look_ahead(buffer, i, 1);
-            while(next_char != 0x07 && next_char != 0) { // while NEXT is NOT BELL
-                chunk->d.append(1, next_char);
-                ++i;
-                next_char = look_ahead(buffer, i, 1);
-            }
-            m_state = eColourHandlerState::kInOsc;
-        } break;
-        case eColourHandlerState::kOSC_Url: {
-            // In this state we skip the first char (';')
-            // and read everything until we find the BELL or EOF, but we don't collect it!
-            wxChar next_char = look_ahead(buffer, i, 1);
-            while(next_char != 0x07 && next_char != 0) { // while NEXT is NOT BELL
-                ++i;
-                next_char = look_ahead(buffer, i, 1);
+        case eColourHandlerState::kInOscEscape:
+            HandleOSC();
+            if(ch == '\\') {
+                // ST
+                m_state = eColourHandlerState::kNormal;
+            } else {
+                // a new escape sequence
+                m_state = eColourHandlerState::kInEscape;
+                --i;
             }
-            m_state = eColourHandlerState::kInOsc;
-        } break;
+            break;
         case eColourHandlerState::kInCsi:
             // found ESC[
-            switch(ch) {
-            case 'K':
-                // clear the current line
-                chunk->d.clear();
-                m_state = eColourHandlerState::kNormal;
-                break;
-            case 'A':
-            case 'B':
-            case 'C':
-            case 'D':
-            case 'E':
-            case 'F':
-            case 'G':
-            case 'H':
-            case 'J':
-            case 'S':
-            case 'T':
-            case 'f':
-            case 'i':
-            case 'n':
-            case 'u':
-            case 's':
-                // exit the CSI mode back to normal mode
-                NEXT(false);
-                m_state = eColourHandlerState::kNormal;
-                break;
-            case '?':
-                // Some popular private sequences
-                m_state = eColourHandlerState::kInPrivateSequence;
-                break;
-            case 'm':
-                // update the style
-                if(chunk->d.empty() || chunk->d == "0") {
-                    chunk->is_style_reset = true;
+            if(ch >= 0x40 && ch <= 0x7E) {
+                // the final byte
+                if(ch == 'm') {
+                    ApplySGR();
+                } else if(ch == 'K') {
+                    // clear the current line
+                    ClearCurrentLine();
                 }
-                NEXT(false);
-                m_state = eColourHandlerState::kNormal;
-                break;
-            default:
-                chunk->d.append(1, ch);
-                break;
-            }
-            break;
-        case eColourHandlerState::kInPrivateSequence:
-            // https://en.wikipedia.org/wiki/ANSI_escape_code#CSI_(Control_Sequence_Introducer)_sequences
-            // (Some popular private sequences)
-            switch(ch) {
-            case '?':
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-                // consume [digits]
-                break;
-            case '\n':
-                NEXT(true);
                 m_state = eColourHandlerState::kNormal;
-                break;
-            case 'h':
-            case 'l':
-                NEXT(false);
+            } else if(ch < 0x20) {
+                // control char in the middle of the sequence, abort it
                 m_state = eColourHandlerState::kNormal;
-                break;
-            case '\r':
-                *chunk = Chunk{};
-                m_state = eColourHandlerState::kNormal;
-                break;
-            default:
-                // get back to the prev state
-                m_state = eColourHandlerState::kInCsi;
-                break;
+                --i;
+            } else {
+                m_sequence.append(1, ch);
             }
             break;
         }
     }
+}
 
-    chunk->is_completed = true;
-    // remove the last chunk if it is empty
-    if(!m_chunks.empty() && m_chunks.back().back().is_empty()) {
-        m_chunks.back().pop_back();
-    }
+size_t clAnsiEscapeCodeHandler::ParseLine(const wxString& text)
+{
+    // the line does not inherit anything from the text parsed before it
+    m_sequence.clear();
+    m_attributes = Attributes{};
+    m_curstyle = 0;
+    m_state = eColourHandlerState::kNormal;
+
+    size_t line = m_lines.size();
+    StartLine();
+    Parse(text);
+    return line;
 }
 
 void clAnsiEscapeCodeHandler::Reset()
 {
-    m_chunks.clear();
+    ClearText();
     m_windowTitle.clear();
+    m_sequence.clear();
+    m_attributes = Attributes{};
+    m_curstyle = 0;
     m_state = eColourHandlerState::kNormal;
 }
 
-void clAnsiEscapeCodeHandler::EnsureCurrent()
+void clAnsiEscapeCodeHandler::ClearText()
+{
+    // clear() keeps the capacity, re-parsing does not allocate
+    m_text.clear();
+    m_spans.clear();
+    m_lines.clear();
+}
+
+void clAnsiEscapeCodeHandler::EnsureLine()
+{
+    if(m_lines.empty()) {
+        StartLine();
+    }
+}
+
+void clAnsiEscapeCodeHandler::StartLine()
+{
+    Line line;
+    line.text_offset = m_text.length();
+    line.first_span = m_spans.size();
+    m_lines.push_back(line);
+}
+
+void clAnsiEscapeCodeHandler::AppendText(const wxString& buffer, size_t from, size_t count)
 {
-    if(m_chunks.empty() || m_chunks.back().back().is_eol) {
-        // add new row
-        m_chunks.emplace_back(Chunk::Vec_t{});
-        // make sure we have at least 1 element in that row
-        m_chunks.back().push_back(Chunk{});
+    size_t offset = m_text.length();
+    m_text.append(buffer, from, count);
+
+    // the last span always ends at the end of the text, extend it if the style did not change
+    if(m_spans.size() > m_lines.back().first_span && m_spans.back().style == m_curstyle) {
+        m_spans.back().length += count;
     } else {
-        // start new chunk for the current line
-        m_chunks.back().push_back(Chunk{});
+        Span span;
+        span.offset = offset;
+        span.length = count;
+        span.style = m_curstyle;
+        m_spans.push_back(span);
     }
 }
 
-void clAnsiEscapeCodeHandler::RenderNoStyle(wxDC& dc, const clRenderDefaultStyle& defaultStyle, int line,
-                                            const wxRect& rect, bool isLightTheme)
+void clAnsiEscapeCodeHandler::ClearCurrentLine()
 {
-    // find the line chunks
-    if(line >= (int)m_chunks.size()) {
-        return;
+    const Line& line = m_lines.back();
+    m_text.Truncate(line.text_offset);
+    m_spans.resize(line.first_span);
+}
+
+void clAnsiEscapeCodeHandler::HandleOSC()
+{
+    // ESC ]0;this is the window title <BEL>
+    // ESC ]2;this is the window title <BEL>
+    // ESC ]8;;link <BEL> - ignored
+    if(m_sequence.length() >= 2 && (m_sequence[0] == '0' || m_sequence[0] == '2') && m_sequence[1] == ';') {
+        m_windowTitle = m_sequence.Mid(2);
+    }
+    m_sequence.clear();
+}
+
+void clAnsiEscapeCodeHandler::ApplySGR()
+{
+    // see: https://en.wikipedia.org/wiki/ANSI_escape_code#SGR_(Select_Graphic_Rendition)_parameters
+    m_sgrParams.clear();
+    long value = 0;
+    for(wxChar ch : m_sequence) {
+        if(ch >= '0' && ch <= '9') {
+            value = value * 10 + (ch - '0');
+        } else {
+            // ';' or ':'
+            m_sgrParams.push_back(value);
+            value = 0;
+        }
+    }
+    // "ESC[m" is the same as "ESC[0m"
+    m_sgrParams.push_back(value);
+
+    Attributes& attrs = m_attributes;
+    const size_t count = m_sgrParams.size();
+    for(size_t i = 0; i < count; ++i) {
+        long number = m_sgrParams[i];
+        switch(number) {
+        case 0:
+            // reset attributes
+            attrs = Attributes{};
+            break;
+        case 1:
+            attrs.font_flags = (attrs.font_flags & ~kFontLight) | kFontBold;
+            break;
+        case 2:
+            attrs.font_flags = (attrs.font_flags & ~kFontBold) | kFontLight;
+            break;
+        case 3:
+            attrs.font_flags |= kFontItalic;
+            break;
+        case 4:
+            attrs.font_flags |= kFontUnderlined;
+            break;
+        case 22:
+            attrs.font_flags &= ~(kFontBold | kFontLight);
+            break;
+        case 23:
+            attrs.font_flags &= ~kFontItalic;
+            break;
+        case 24:
+            attrs.font_flags &= ~kFontUnderlined;
+            break;
+        case 39:
+            attrs.fg = 0;
+            break;
+        case 49:
+            attrs.bg = 0;
+            break;
+        case 38:
+        case 48: {
+            wxUint32 colour = 0;
+            if(i + 2 < count && m_sgrParams[i + 1] == 5) {
+                // ESC[38;5;N
+                colour = COLOUR_8_BIT | (m_sgrParams[i + 2] & 0xFF);
+                i += 2;
+            } else if(i + 4 < count && m_sgrParams[i + 1] == 2) {
+                // ESC[38;2;R;G;B
+                colour = COLOUR_RGB | ((m_sgrParams[i + 2] & 0xFF) << 16) | ((m_sgrParams[i + 3] & 0xFF) << 8) |
+                         (m_sgrParams[i + 4] & 0xFF);
+                i += 4;
+            } else {
+                // malformed, ignore the rest of the sequence
+                i = count;
+                break;
+            }
+            (number == 38 ? attrs.fg : attrs.bg) = colour;
+        } break;
+        default:
+            if((number >= 30 && number <= 37) || (number >= 90 && number <= 97)) {
+                attrs.fg = COLOUR_TABLE | number;
+            } else if((number >= 40 && number <= 47) || (number >= 100 && number <= 107)) {
+                attrs.bg = COLOUR_TABLE | number;
+            }
+            break;
+        }
+    }
+    m_curstyle = GetStyleId(attrs);
+}
+
+wxUint32 clAnsiEscapeCodeHandler::GetStyleId(const Attributes& attributes)
+{
+    // the colours use 26 bits each
+    wxUint64 key = (wxUint64)attributes.fg | ((wxUint64)attributes.bg << 26) | ((wxUint64)attributes.font_flags << 52);
+    auto iter = m_styleIds.find(key);
+    if(iter != m_styleIds.end()) {
+        return iter->second;
     }
 
-    const auto& v = m_chunks[line];
+    Style style;
+    for(int theme = 0; theme < 2; ++theme) {
+        style.fg[theme] = ResolveColour(attributes.fg, theme == 0);
+        style.bg[theme] = ResolveColour(attributes.bg, theme == 0);
+    }
+    style.font_flags = attributes.font_flags;
 
-    dc.SetFont(defaultStyle.font);
-    int text_height = dc.GetTextExtent("Tp").GetHeight();
+    wxUint32 style_id = m_styles.size();
+    m_styles.push_back(style);
+    m_styleIds.insert({ key, style_id });
+    return style_id;
+}
 
-    wxRect tmpRect(0, 0, 20, text_height);
-    tmpRect = tmpRect.CenterIn(rect, wxVERTICAL);
-    dc.SetTextForeground(defaultStyle.fg_colour);
-    int yy = rect.y;
-    int xx = X_MARGIN;
-    dc.SetClippingRegion(rect);
-    for(const auto& chunk : v) {
-        // ensure to restore the dont once we are done with this line
-        wxDCFontChanger font_changer(dc);
-        if(chunk.is_text) {
-            // draw the text
-            wxSize text_size = dc.GetTextExtent(chunk.d);
-            dc.DrawText(chunk.d, xx, yy);
-            xx += text_size.GetWidth();
+wxColour clAnsiEscapeCodeHandler::ResolveColour(wxUint32 colour, bool isLightTheme) const
+{
+    wxUint32 value = colour & COLOUR_VALUE_MASK;
+    switch(colour & COLOUR_KIND_MASK) {
+    case COLOUR_TABLE:
+        return GetColour(isLightTheme ? m_colours_normal : m_colours_for_dark_theme, value);
+    case COLOUR_8_BIT:
+        return GetColour(isLightTheme ? m_8_bit_colours_normal : m_8_bit_colours_for_dark_theme, value);
+    case COLOUR_RGB:
+        return wxColour((value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF);
+    default:
+        return wxNullColour;
+    }
+}
+
+const wxFont& clAnsiEscapeCodeHandler::GetFont(const wxFont& base, int font_flags)
+{
+    if(font_flags == 0 || !base.IsOk()) {
+        return base;
+    }
+
+    if(!m_fontCacheBase.IsOk() || m_fontCacheBase != base) {
+        // the default font changed, drop the derived fonts
+        for(auto& font : m_fontCache) {
+            font = wxNullFont;
         }
+        m_fontCacheBase = base;
+    }
 
-        // if this chunk was EOL, reset the style here
-        if(chunk.is_eol) {
-            defaultStyle.ResetDC(dc);
+    wxFont& font = m_fontCache[font_flags];
+    if(!font.IsOk()) {
+        font = base;
+        if(font_flags & kFontBold) {
+            font.SetWeight(wxFONTWEIGHT_BOLD);
+        }
+        if(font_flags & kFontLight) {
+            font.SetWeight(wxFONTWEIGHT_LIGHT);
+        }
+        if(font_flags & kFontItalic) {
+            font.SetStyle(wxFONTSTYLE_ITALIC);
         }
+        if(font_flags & kFontUnderlined) {
+            font.SetUnderlined(true);
+        }
+    }
+    return font;
+}
+
+void clAnsiEscapeCodeHandler::GetLineRange(size_t line, size_t* first_span, size_t* last_span, size_t* text_end) const
+{
+    bool is_last = (line + 1) == m_lines.size();
+    *first_span = m_lines[line].first_span;
+    *last_span = is_last ? m_spans.size() : m_lines[line + 1].first_span;
+    *text_end = is_last ? m_text.length() : m_lines[line + 1].text_offset;
+}
+
+std::vector<clAnsiEscapeCodeHandler::Segment> clAnsiEscapeCodeHandler::GetLineSegments(size_t line,
+                                                                                     bool isLightTheme) const
+{
+    std::vector<Segment> segments;
+    if(line >= m_lines.size()) {
+        return segments;
+    }
+
+    const int theme = isLightTheme ? 0 : 1;
+    size_t first_span, last_span, text_end;
+    GetLineRange(line, &first_span, &last_span, &text_end);
+    segments.reserve(last_span - first_span);
+    for(size_t i = first_span; i < last_span; ++i) {
+        const Span& span = m_spans[i];
+        const Style& style = m_styles[span.style];
+        Segment segment;
+        segment.text = m_text.Mid(span.offset, span.length);
+        segment.fg = style.fg[theme];
+        segment.bg = style.bg[theme];
+        segment.font_flags = style.font_flags;
+        segments.push_back(segment);
     }
+    return segments;
+}
+
+void clAnsiEscapeCodeHandler::RenderNoStyle(wxDC& dc, const clRenderDefaultStyle& defaultStyle, int line,
+                                            const wxRect& rect, bool isLightTheme)
+{
+    wxUnusedVar(isLightTheme);
+    if(line < 0 || line >= (int)m_lines.size()) {
+        return;
+    }
+
+    size_t first_span, last_span, text_end;
+    GetLineRange(line, &first_span, &last_span, &text_end);
+
+    wxDCFontChanger font_changer(dc);
+    defaultStyle.ResetDC(dc);
+    dc.SetClippingRegion(rect);
+    size_t text_offset = m_lines[line].text_offset;
+    m_drawBuffer.assign(m_text, text_offset, text_end - text_offset);
+    dc.DrawText(m_drawBuffer, X_MARGIN, rect.y);
     dc.DestroyClippingRegion();
 }
 
 void clAnsiEscapeCodeHandler::Render(wxSTCStyleProvider* style_provider, bool isLightTheme)
 {
-    // find the line chunks
-    if(m_chunks.empty()) {
+    if(m_lines.empty()) {
         return;
     }
 
     wxStyledTextCtrl* stc = style_provider->m_ctrl;
-    // Check if this is a dark theme
-    if(isLightTheme) {
-        // normal
-        m_8_bit_colours = &m_8_bit_colours_normal;
-        m_colours = &m_colours_normal;
-    } else {
-        // dark theme background
-        m_8_bit_colours = &m_8_bit_colours_for_dark_theme;
-        m_colours = &m_colours_for_dark_theme;
-    }
+    const int theme = isLightTheme ? 0 : 1;
+    wxTextAttr defaultStyle = style_provider->GetDefaultStyle();
 
     // render everything
-    int curstyle = 0;
-    for(const auto& v : m_chunks) {
-        for(const auto& chunk : v) {
-            // ensure to restore the dont once we are done with this line
-            if(chunk.is_style_reset) {
-                // reset the style
-                curstyle = 0;
-            } else if(chunk.is_text) {
-                if(!chunk.d.empty()) {
-                    // append and style the next text
-                    int pos = stc->GetLength();
-                    int curline = stc->LineFromPosition(pos);
-                    clDEBUG() << "styling from line:" << curline << "with style:" << curstyle << endl;
-                    stc->AppendText(chunk.d);
-                    stc->StartStyling(pos);
-                    stc->SetStyling(chunk.d.length(), curstyle);
-                }
-            } else if(chunk.is_title) {
-                m_windowTitle = chunk.d;
-            } else if(chunk.is_empty()) {
-                // skip it
-            } else {
-                wxTextAttr result;
-                UpdateStyle(chunk, style_provider->GetDefaultStyle(), &result);
-                curstyle = style_provider->GetStyle(result.GetTextColour(), result.GetBackgroundColour());
-            }
+    for(size_t line = 0; line < m_lines.size(); ++line) {
+        if(line > 0) {
+            stc->AppendText("\n");
+        }
 
-            // if this chunk was EOL, reset the style here
-            if(chunk.is_eol) {
-                stc->AppendText("\n");
+        size_t first_span, last_span, text_end;
+        GetLineRange(line, &first_span, &last_span, &text_end);
+        for(size_t i = first_span; i < last_span; ++i) {
+            const Span& span = m_spans[i];
+            int curstyle = 0;
+            if(span.style != 0) {
+                const Style& style = m_styles[span.style];
+                curstyle = style_provider->GetStyle(
+                    style.fg[theme].IsOk() ? style.fg[theme] : defaultStyle.GetTextColour(),
+                    style.bg[theme].IsOk() ? style.bg[theme] : defaultStyle.GetBackgroundColour());
             }
+
+            // append and style the next text
+            int pos = stc->GetLength();
+            m_drawBuffer.assign(m_text, span.offset, span.length);
+            stc->AppendText(m_drawBuffer);
+            stc->StartStyling(pos);
+            stc->SetStyling(stc->GetLength() - pos, curstyle);
         }
     }
-    m_chunks.clear();
+    ClearText();
 }
 
 void clAnsiEscapeCodeHandler::Render(wxTextCtrl* ctrl, const wxTextAttr& defaultStyle, bool isLightTheme)
 {
-    // find the line chunks
-    if(m_chunks.empty()) {
+    if(m_lines.empty()) {
         return;
     }
 
-    // Check if this is a dark theme
-    if(isLightTheme) {
-        // normal
-        m_8_bit_colours = &m_8_bit_colours_normal;
-        m_colours = &m_colours_normal;
-    } else {
-        // dark theme background
-        m_8_bit_colours = &m_8_bit_colours_for_dark_theme;
-        m_colours = &m_colours_for_dark_theme;
-    }
+    const int theme = isLightTheme ? 0 : 1;
 
     // render everything
-    for(const auto& v : m_chunks) {
-        for(const auto& chunk : v) {
-            // ensure to restore the dont once we are done with this line
-            if(chunk.is_style_reset) {
-                // reset the style
-                ctrl->SetDefaultStyle(defaultStyle);
-            } else if(chunk.is_text) {
-                // draw the text
-                // ctrl->SetInsertionPointEnd();
-                ctrl->AppendText(chunk.d);
-
-            } else if(chunk.is_title || chunk.is_empty()) {
-                m_windowTitle = chunk.d;
-            } else {
-                wxTextAttr result;
-                UpdateStyle(chunk, defaultStyle, &result);
-                ctrl->SetDefaultStyle(result);
-            }
+    for(size_t line = 0; line < m_lines.size(); ++line) {
+        if(line > 0) {
+            // reset the style at the end of the line
+            ctrl->AppendText("\n");
+            ctrl->SetDefaultStyle(defaultStyle);
+        }
 
-            // if this chunk was EOL, reset the style here
-            if(chunk.is_eol) {
-                // ctrl->SetInsertionPointEnd();
-                ctrl->AppendText("\n");
-                ctrl->SetDefaultStyle(defaultStyle);
+        size_t first_span, last_span, text_end;
+        GetLineRange(line, &first_span, &last_span, &text_end);
+        for(size_t i = first_span; i < last_span; ++i) {
+            const Span& span = m_spans[i];
+            const Style& style = m_styles[span.style];
+            wxTextAttr attr = defaultStyle;
+            if(style.fg[theme].IsOk()) {
+                attr.SetTextColour(style.fg[theme]);
             }
+            if(style.bg[theme].IsOk()) {
+                attr.SetBackgroundColour(style.bg[theme]);
+            }
+            if(style.font_flags && defaultStyle.GetFont().IsOk()) {
+                attr.SetFont(GetFont(defaultStyle.GetFont(), style.font_flags));
+            }
+            ctrl->SetDefaultStyle(attr);
+
+            m_drawBuffer.assign(m_text, span.offset, span.length);
+            ctrl->AppendText(m_drawBuffer);
         }
     }
-    m_chunks.clear();
+    ClearText();
 }
 
 void clAnsiEscapeCodeHandler::Render(wxDC& dc, const clRenderDefaultStyle& defaultStyle, int line, const wxRect& rect,
                                      bool isLightTheme)
 {
-    // find the line chunks
-    if(line >= (int)m_chunks.size()) {
+    if(line < 0 || line >= (int)m_lines.size()) {
         return;
     }
-    // Check if this is a dark theme
-    if(isLightTheme) {
-        // normal
-        m_8_bit_colours = &m_8_bit_colours_normal;
-        m_colours = &m_colours_normal;
-    } else {
-        // dark theme background
-        m_8_bit_colours = &m_8_bit_colours_for_dark_theme;
-        m_colours = &m_colours_for_dark_theme;
-    }
 
-    const auto& v = m_chunks[line];
+    const int theme = isLightTheme ? 0 : 1;
+    size_t first_span, last_span, text_end;
+    GetLineRange(line, &first_span, &last_span, &text_end);
 
-    dc.SetFont(defaultStyle.font);
-    int text_height = dc.GetTextExtent("Tp").GetHeight();
-
-    wxRect tmpRect(0, 0, 20, text_height);
-    tmpRect = tmpRect.CenterIn(rect, wxVERTICAL);
-    dc.SetTextForeground(defaultStyle.fg_colour);
+    // ensure to restore the font once we are done with this line
+    wxDCFontChanger font_changer(dc);
+    defaultStyle.ResetDC(dc);
 
     int yy = rect.y;
     int xx = X_MARGIN;
+    wxUint32 curstyle = 0;
     dc.SetClippingRegion(rect);
-    for(const auto& chunk : v) {
-        // ensure to restore the dont once we are done with this line
-        wxDCFontChanger font_changer(dc);
-        if(chunk.is_style_reset) {
-            // reset the style
-            defaultStyle.ResetDC(dc);
-        } else if(chunk.is_text) {
-            // draw the text
-            wxSize text_size = dc.GetTextExtent(chunk.d);
-            dc.DrawText(chunk.d, xx, yy);
-            xx += text_size.GetWidth();
-
-        } else if(chunk.is_title || chunk.is_empty()) {
-            m_windowTitle = chunk.d;
-        } else {
-            UpdateStyle(chunk, dc, defaultStyle);
+    for(size_t i = first_span; i < last_span; ++i) {
+        const Span& span = m_spans[i];
+        if(span.style != curstyle) {
+            const Style& style = m_styles[span.style];
+            dc.SetTextForeground(style.fg[theme].IsOk() ? style.fg[theme] : defaultStyle.fg_colour);
+            dc.SetTextBackground(style.bg[theme].IsOk() ? style.bg[theme] : defaultStyle.bg_colour);
+            dc.SetFont(GetFont(defaultStyle.font, style.font_flags));
+            curstyle = span.style;
         }
 
-        // if this chunk was EOL, reset the style here
-        if(chunk.is_eol) {
-            defaultStyle.ResetDC(dc);
-        }
+        // the draw buffer keeps its capacity, drawing does not allocate
+        m_drawBuffer.assign(m_text, span.offset, span.length);
+        dc.DrawText(m_drawBuffer, xx, yy);
+        xx += dc.GetTextExtent(m_drawBuffer).GetWidth();
     }
     dc.DestroyClippingRegion();
 }
 
-#define NEXT_ATTR(index, channel)                 \
-    {                                             \
-        long number_attr = wxNOT_FOUND;           \
-        channel = 0;                              \
-        if((index) < attrs.size()) {              \
-            attrs[(index)].ToCLong(&number_attr); \
-            channel = number_attr;                \
-        }                                         \
-    }
-
-void clAnsiEscapeCodeHandler::UpdateStyle(const Chunk& chunk, const wxTextAttr& defaultStyle, wxTextAttr* updatedStyle)
-{
-    constexpr int STATE_NORMAL = 0;
-    constexpr int STATE_SET_FG = 1;
-    constexpr int STATE_SET_BG = 2;
-
-    // see: https://en.wikipedia.org/wiki/ANSI_escape_code#SGR_(Select_Graphic_Rendition)_parameters
-    *updatedStyle = defaultStyle;
-    if(chunk.d == "0") {
-        *updatedStyle = defaultStyle;
-    } else {
-        int state = STATE_NORMAL;
-        wxArrayString attrs = ::wxStringTokenize(chunk.d, ";", wxTOKEN_RET_EMPTY);
-        wxFont f = defaultStyle.GetFont();
-        for(size_t i = 0; i < attrs.size(); ++i) {
-            const wxString& attr = attrs[i];
-            long number;
-            if(!attr.ToCLong(&number)) {
-                continue;
-            }
-            switch(state) {
-            case STATE_NORMAL:
-                switch(number) {
-                case 0:
-                    // reset attributes
-                    *updatedStyle = defaultStyle;
-                    break;
-                case 1:
-                    f.SetWeight(wxFONTWEIGHT_BOLD);
-                    break;
-                case 2:
-                    f.SetWeight(wxFONTWEIGHT_LIGHT);
-                    break;
-                case 3:
-                    f.SetStyle(wxFONTSTYLE_ITALIC);
-                    break;
-                case 4:
-                    f.SetUnderlined(true);
-                    break;
-                case 38:
-                    state = STATE_SET_FG;
-                    break;
-                case 48:
-                    state = STATE_SET_BG;
-                    break;
-                default:
-                    if((number >= 30 && number <= 37) || (number >= 90 && number <= 97)) {
-                        // use colour table to set the text colour
-                        wxColour c = GetColour(*m_colours, number);
-                        if(c.IsOk()) {
-                            updatedStyle->SetTextColour(c);
-                        }
-                    } else if((number >= 40 && number <= 47) || (number >= 100 && number <= 107)) {
-                        wxColour c = GetColour(*m_colours, number);
-                        if(c.IsOk()) {
-                            updatedStyle->SetBackgroundColour(c);
-                        }
-                    }
-                    break;
-                }
-                break;
-            case STATE_SET_BG:
-                switch(number) {
-                case 5:
-                    break;
-                case 2: {
-                    // ESC[38;2;R;G;B
-                    wxColour::ChannelType r, g, b;
-                    NEXT_ATTR(i + 1, r);
-                    NEXT_ATTR(i + 2, g);
-                    NEXT_ATTR(i + 3, b);
-                    wxColour c{ r, g, b };
-                    if(c.IsOk()) {
-                        updatedStyle->SetTextColour(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                default: {
-                    // use colour table to set the text colour
-                    wxColour c = GetColour(*m_8_bit_colours, number);
-                    if(c.IsOk()) {
-                        updatedStyle->SetBackgroundColour(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                }
-                break;
-            case STATE_SET_FG:
-                switch(number) {
-                case 5:
-                    break;
-                case 2: {
-                    // ESC[38;2;R;G;B
-                    wxColour::ChannelType r, g, b;
-                    NEXT_ATTR(i + 1, r);
-                    NEXT_ATTR(i + 2, g);
-                    NEXT_ATTR(i + 3, b);
-                    wxColour c{ r, g, b };
-                    if(c.IsOk()) {
-                        updatedStyle->SetTextColour(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                default: {
-                    // use colour table to set the text colour
-                    wxColour c = GetColour(*m_8_bit_colours, number);
-                    if(c.IsOk()) {
-                        updatedStyle->SetTextColour(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                }
-                break;
-            }
-        }
-        updatedStyle->SetFont(f);
-    }
-}
-
-void clAnsiEscapeCodeHandler::UpdateStyle(const Chunk& chunk, wxDC& dc, const clRenderDefaultStyle& defaultStyle)
-{
-    constexpr int STATE_NORMAL = 0;
-    constexpr int STATE_SET_FG = 1;
-    constexpr int STATE_SET_BG = 2;
-
-    // see: https://en.wikipedia.org/wiki/ANSI_escape_code#SGR_(Select_Graphic_Rendition)_parameters
-    if(chunk.d == "0") {
-        defaultStyle.ResetDC(dc);
-    } else {
-        int state = STATE_NORMAL;
-        wxArrayString attrs = ::wxStringTokenize(chunk.d, ";", wxTOKEN_RET_EMPTY);
-        wxFont f = defaultStyle.font;
-        for(size_t i = 0; i < attrs.size(); ++i) {
-            const wxString& attr = attrs[i];
-            long number;
-            if(!attr.ToCLong(&number)) {
-                continue;
-            }
-            switch(state) {
-            case STATE_NORMAL:
-                switch(number) {
-                case 0:
-                    // reset attributes
-                    defaultStyle.ResetDC(dc);
-                    break;
-                case 1:
-                    f.SetWeight(wxFONTWEIGHT_BOLD);
-                    break;
-                case 2:
-                    f.SetWeight(wxFONTWEIGHT_LIGHT);
-                    break;
-                case 3:
-                    f.SetStyle(wxFONTSTYLE_ITALIC);
-                    break;
-                case 4:
-                    f.SetUnderlined(true);
-                    break;
-                case 38:
-                    state = STATE_SET_FG;
-                    break;
-                case 48:
-                    state = STATE_SET_BG;
-                    break;
-                default:
-                    if((number >= 30 && number <= 37) || (number >= 90 && number <= 97)) {
-                        // use colour table to set the text colour
-                        wxColour c = GetColour(*m_colours, number);
-                        if(c.IsOk()) {
-                            dc.SetTextForeground(c);
-                        }
-                    } else if((number >= 40 && number <= 47) || (number >= 100 && number <= 107)) {
-                        wxColour c = GetColour(*m_colours, number);
-                        if(c.IsOk()) {
-                            dc.SetTextBackground(c);
-                        }
-                    }
-                    break;
-                }
-                break;
-            case STATE_SET_BG:
-                switch(number) {
-                case 5:
-                    break;
-                case 2: {
-                    // ESC[38;2;R;G;B
-                    wxColour::ChannelType r, g, b;
-                    NEXT_ATTR(i + 1, r);
-                    NEXT_ATTR(i + 2, g);
-                    NEXT_ATTR(i + 3, b);
-                    wxColour c{ r, g, b };
-                    if(c.IsOk()) {
-                        dc.SetTextBackground(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                default: {
-                    // use colour table to set the text colour
-                    wxColour c = GetColour(*m_8_bit_colours, number);
-                    if(c.IsOk()) {
-                        dc.SetTextBackground(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                }
-                break;
-            case STATE_SET_FG:
-                switch(number) {
-                case 5:
-                    break;
-                case 2: {
-                    // ESC[38;2;R;G;B
-                    wxColour::ChannelType r, g, b;
-                    NEXT_ATTR(i + 1, r);
-                    NEXT_ATTR(i + 2, g);
-                    NEXT_ATTR(i + 3, b);
-                    wxColour c{ r, g, b };
-                    if(c.IsOk()) {
-                        dc.SetTextForeground(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                default: {
-                    // use colour table to set the text colour
-                    wxColour c = GetColour(*m_8_bit_colours, number);
-                    if(c.IsOk()) {
-                        dc.SetTextForeground(c);
-                    }
-                    state = STATE_NORMAL;
-                } break;
-                }
-                break;
-            }
-        }
-        dc.SetFont(f);
-    }
-}
-
 const wxColour& clAnsiEscapeCodeHandler::GetColour(const ColoursMap_t& m, int num) const
 {
-    if(m.count(num) == 0) {
+    auto iter = m.find(num);
+    if(iter == m.end()) {
         return wxNullColour;
     }
-    return m.find(num)->second;
+    return iter->second;
 }
 
 // ===------------------------------------------------------------------------
@@ -1027,10 +861,10 @@ const wxColour& clAnsiEscapeCodeHandler::GetColour(const ColoursMap_t& m, int nu
 int wxSTCStyleProvider::GetStyle(const wxColour& fg, const wxColour& bg)
 {
     // build the key for the style
-    wxString key;
-    key << "fg:" << fg.GetAsString(wxC2S_HTML_SYNTAX) << ";bg:" << bg.GetAsString(wxC2S_HTML_SYNTAX);
-    if(m_styleCache.count(key)) {
-        return m_styleCache[key];
+    wxUint64 key = (ColourKey(fg) << 32) | ColourKey(bg);
+    auto iter = m_styleCache.find(key);
+    if(iter != m_styleCache.end()) {
+        return iter->second;
     }
 
     // no such style, create it
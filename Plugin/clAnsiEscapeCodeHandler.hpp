@@ -22,11 +22,9 @@ enum class eColourHandlerState {
     kNormal = 0,
     kInEscape,          // found ESC char
     kInOsc,             // Operating System Command
+    kInOscEscape,       // found ESC inside an OSC, expecting the ST terminator
     kInCsi,             // Control Sequence Introducer
-    kInPrivateSequence, // Some popular private sequences
     kCR,                // Found CR in Normal
-    kOSC_Title,
-    kOSC_Url,
 };
 
 struct WXDLLIMPEXP_SDK wxSTCStyleProvider : public wxEvtHandler {
@@ -39,7 +37,8 @@ struct WXDLLIMPEXP_SDK wxSTCStyleProvider : public wxEvtHandler {
 public:
     wxStyledTextCtrl* m_ctrl = nullptr;
     int m_curstyle = wxSTC_STYLE_LASTPREDEFINED + 1;
-    std::unordered_map<wxString, int> m_styleCache;
+    // key: the foreground and background colours packed as RGBA
+    std::unordered_map<wxUint64, int> m_styleCache;
 
 public:
     /// Return style for a given colour
@@ -51,20 +50,6 @@ public:
     void OnIdle(wxIdleEvent& event);
 };
 
-struct WXDLLIMPEXP_SDK Chunk {
-    wxString d;
-
-    // chunk flags
-    bool is_text = true;
-    bool is_eol = false;
-    bool is_completed = false;
-    bool is_style_reset = false;
-    bool is_title = false;
-
-    bool is_empty() const { return is_text && d.empty(); }
-    typedef std::vector<Chunk> Vec_t;
-};
-
 struct WXDLLIMPEXP_SDK clRenderDefaultStyle {
     wxColour bg_colour; // background colour
     wxColour fg_colour; // text colour
@@ -78,31 +63,114 @@ struct WXDLLIMPEXP_SDK clRenderDefaultStyle {
     }
 };
 
+/**
+ * @class clAnsiEscapeCodeHandler
+ * @brief incremental ANSI escape code parser.
+ *
+ * Parse() only processes the new data: the parser state (including an incomplete escape sequence and the current
+ * SGR attributes) is kept between calls. The visible text is stored in a single buffer and the styling as
+ * (offset, length, style-id) spans over that buffer. Styles are deduplicated and resolved to colours for both the
+ * light and the dark themes once, when first seen, so rendering a line does not parse or allocate anything.
+ */
 class WXDLLIMPEXP_SDK clAnsiEscapeCodeHandler
 {
+public:
+    enum eFontFlags {
+        kFontBold = (1 << 0),
+        kFontLight = (1 << 1),
+        kFontItalic = (1 << 2),
+        kFontUnderlined = (1 << 3),
+        kFontFlagsCount = (1 << 4),
+    };
+
+    /// a run of text of a parsed line with its style. An invalid colour means the default colour
+    struct Segment {
+        wxString text;
+        wxColour fg;
+        wxColour bg;
+        int font_flags = 0;
+    };
+
+private:
     typedef std::map<int, wxColour> ColoursMap_t;
+
+    struct Span {
+        wxUint32 offset = 0; // offset in m_text
+        wxUint32 length = 0;
+        wxUint32 style = 0; // index in m_styles, 0 is the default style
+    };
+
+    struct Line {
+        wxUint32 text_offset = 0; // where the line starts in m_text
+        wxUint32 first_span = 0;  // index of the first span of the line in m_spans
+    };
+
+    struct Style {
+        // invalid colour means "use the default colour". Index 0 is for light themes, 1 is for dark themes
+        wxColour fg[2];
+        wxColour bg[2];
+        int font_flags = 0;
+    };
+
+    /// the current SGR attributes. The colours are encoded as a kind (table, 8 bit, RGB) and a value, 0 is default
+    struct Attributes {
+        wxUint32 fg = 0;
+        wxUint32 bg = 0;
+        int font_flags = 0;
+    };
+
     ColoursMap_t m_8_bit_colours_normal;
     ColoursMap_t m_8_bit_colours_for_dark_theme;
     ColoursMap_t m_colours_normal;
     ColoursMap_t m_colours_for_dark_theme;
-    ColoursMap_t* m_8_bit_colours = nullptr;
-    ColoursMap_t* m_colours = nullptr;
     eColourHandlerState m_state = eColourHandlerState::kNormal;
     wxString m_windowTitle;
-    // Every entry in the below vector represents a single line, splitted into "chunks"
-    std::vector<Chunk::Vec_t> m_chunks;
+
+    wxString m_text;
+    std::vector<Span> m_spans;
+    std::vector<Line> m_lines;
+    std::vector<Style> m_styles;
+    std::unordered_map<wxUint64, wxUint32> m_styleIds;
+    Attributes m_attributes;
+    wxUint32 m_curstyle = 0;
+    wxString m_sequence; // parameters of the CSI / OSC being parsed
+    std::vector<long> m_sgrParams;
+
+    // rendering
+    wxString m_drawBuffer;
+    wxFont m_fontCacheBase;
+    wxFont m_fontCache[kFontFlagsCount];
 
 private:
-    void EnsureCurrent();
-    void UpdateStyle(const Chunk& chunk, wxDC& dc, const clRenderDefaultStyle& defaultStyle);
-    void UpdateStyle(const Chunk& chunk, const wxTextAttr& defaultStyle, wxTextAttr* updatedStyle);
+    void EnsureLine();
+    void StartLine();
+    void ClearText();
+    void AppendText(const wxString& buffer, size_t from, size_t count);
+    void ClearCurrentLine();
+    void ApplySGR();
+    void HandleOSC();
+    wxUint32 GetStyleId(const Attributes& attributes);
+    wxColour ResolveColour(wxUint32 colour, bool isLightTheme) const;
     const wxColour& GetColour(const ColoursMap_t& m, int num) const;
+    const wxFont& GetFont(const wxFont& base, int font_flags);
+    void GetLineRange(size_t line, size_t* first_span, size_t* last_span, size_t* text_end) const;
 
 public:
     clAnsiEscapeCodeHandler();
     ~clAnsiEscapeCodeHandler();
 
+    /**
+     * @brief parse the next chunk of the output
+     */
     void Parse(const wxString& buffer);
+    /**
+     * @brief parse `text` on a new line, starting from a clean parser state (as if it was parsed on its own).
+     * Return the index of the line, so it can be rendered later without parsing it again
+     */
+    size_t ParseLine(const wxString& text);
+    /**
+     * @brief clear the parsed text and the parser state. The style table (and its memory) is kept
+     */
     void Reset();
 
     /**
@@ -111,11 +179,11 @@ public:
     void Render(wxDC& dc, const clRenderDefaultStyle& defaultStyle, int line, const wxRect& rect, bool isLightTheme);
 
     /**
-     * @brief draw the text onto the text control
+     * @brief draw the text onto the text control. The parsed text is consumed
      */
     void Render(wxTextCtrl* ctrl, const wxTextAttr& defaultStyle, bool isLightTheme);
     /**
-     * @brief draw the text onto the wxStyledTextCtrl control
+     * @brief draw the text onto the wxStyledTextCtrl control. The parsed text is consumed
      */
     void Render(wxSTCStyleProvider* style_provider, bool isLightTheme);
 
@@ -125,7 +193,12 @@ public:
     void RenderNoStyle(wxDC& dc, const clRenderDefaultStyle& defaultStyle, int line, const wxRect& rect,
                        bool isLightTheme);
 
-    size_t GetLineCount() const { return m_chunks.size(); }
+    size_t GetLineCount() const { return m_lines.size(); }
+
+    /**
+     * @brief return the styled segments of a parsed line, colours resolved for the given theme
+     */
+    std::vector<Segment> GetLineSegments(size_t line, bool isLightTheme) const;
 
     /**
      * @brief return the window title found
@@ -21,6 +21,8 @@
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_RESTARTED, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_LIST_FILES, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_LIST_FILES_DONE, clCommandEvent);
+wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES, clCommandEvent);
+wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES_DONE, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_FIND_RESULTS, clFindInFilesEvent);
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_FIND_RESULTS_DONE, clFindInFilesEvent);
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_REPLACE_RESULTS, clFindInFilesEvent);
@@ -369,6 +371,27 @@ void clCodeLiteRemoteProcess::ListFiles(const wxString& root_dir, const wxString
     m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnListFilesOutput, nullptr, nullptr });
 }
 
+void clCodeLiteRemoteProcess::ListFilesChanges(const wxString& root_dir, const wxString& extensions,
+                                               const wxString& since)
+{
+    if (!m_process) {
+        return;
+    }
+
+    // build the command and send it
+    JSON root(cJSON_Object);
+    auto item = root.toElement();
+    item.addProperty("command", "ls_changes");
+    item.addProperty("root_dir", root_dir);
+    item.addProperty("file_extensions", ::wxStringTokenize(extensions, ",; |", wxTOKEN_STRTOK));
+    item.addProperty("since", since);
+    LOG_IF_TRACE { clDEBUG1() << "ListFilesChanges: sending command:" << item.format(false) << endl; }
+    m_process->Write(item.format(false) + "\n");
+
+    // push a callback
+    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnListFilesChangesOutput, nullptr, nullptr });
+}
+
 void clCodeLiteRemoteProcess::Search(
     const wxString& root_dir, const wxString& extensions, const wxString& find_what, bool whole_word, bool icase)
 {
@@ -585,6 +608,23 @@ void clCodeLiteRemoteProcess::OnListFilesOutput(const wxString& output, bool is_
     }
 }
 
+void clCodeLiteRemoteProcess::OnListFilesChangesOutput(const wxString& output, bool is_completed)
+{
+    clCommandEvent event(wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES);
+
+    LOG_IF_TRACE { clDEBUG1() << output << endl; }
+
+    // pass the raw lines, the receiver interprets the prefixes
+    wxArrayString lines = ::wxStringTokenize(output, "\r\n", wxTOKEN_STRTOK);
+    event.GetStrings().swap(lines);
+    AddPendingEvent(event);
+
+    if (is_completed) {
+        clCommandEvent event_done(wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES_DONE);
+        AddPendingEvent(event_done);
+    }
+}
+
 void clCodeLiteRemoteProcess::OnFindPathOutput(const wxString& output, bool is_completed)
 {
     clCommandEvent event(wxEVT_CODELITE_REMOTE_FINDPATH);
@@ -56,6 +56,7 @@ protected:
 
     // prepare an event from list command output
     void OnListFilesOutput(const wxString& output, bool is_completed);
+    void OnListFilesChangesOutput(const wxString& output, bool is_completed);
     void OnListLSPsOutput(const wxString& output, bool is_completed);
     void OnFindOutput(const wxString& buffer, bool is_completed);
     void OnReplaceOutput(const wxString& buffer, bool is_completed);
@@ -118,6 +119,14 @@ public:
      */
     void ListFiles(const wxString& root_dir, const wxString& extensions);
 
+    /**
+     * @brief same as ListFiles(), but only report the changes since a previous listing
+     * @param since the token of the previous listing (as reported by wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES)
+     * or an empty string to list all the files. The output is delivered as raw lines with
+     * wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES events: "token:<token>", "reset", "+<added file>" and "-<removed file>"
+     */
+    void ListFilesChanges(const wxString& root_dir, const wxString& extensions, const wxString& since);
+
     /**
      * @brief list all configured LSPs on the remote machine
      * the configuration is read from `codelite-remote.json` config file
@@ -212,6 +221,8 @@ public:
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_RESTARTED, clCommandEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_LIST_FILES, clCommandEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_LIST_FILES_DONE, clCommandEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES, clCommandEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES_DONE, clCommandEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_FIND_RESULTS, clFindInFilesEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_FIND_RESULTS_DONE, clFindInFilesEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_CODELITE_REMOTE_REPLACE_RESULTS, clFindInFilesEvent);
@@ -16,6 +16,7 @@
 #include "ieditor.h"
 #include "imanager.h"
 #include "libssh/libssh.h"
+#include "libssh/sftp.h"
 #include "macros.h"
 
 #include <condition_variable>
@@ -26,6 +27,7 @@
 #include <vector>
 #include <wx/debug.h>
 #include <wx/event.h>
+#include <wx/ffile.h>
 #include <wx/msgdlg.h>
 #include <wx/stc/stc.h>
 #include <wx/thread.h>
@@ -37,6 +39,23 @@ wxDEFINE_EVENT(wxEVT_SFTP_ASYNC_EXEC_ERROR, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_SFTP_ASYNC_EXEC_STDOUT, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_SFTP_ASYNC_EXEC_STDERR, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_SFTP_ASYNC_EXEC_DONE, clCommandEvent);
+wxDEFINE_EVENT(wxEVT_SFTP_BATCH_TRANSFER_PROGRESS, clCommandEvent);
+wxDEFINE_EVENT(wxEVT_SFTP_BATCH_TRANSFER_DONE, clCommandEvent);
+
+namespace
+{
+/// the state shared by the workers of a single batch transfer
+struct BatchTransferState {
+    std::vector<clSFTPTransfer> transfers;
+    std::atomic_size_t next{ 0 };
+    std::atomic_size_t completed{ 0 };
+    std::atomic_size_t running{ 0 };
+    std::atomic_size_t opened{ 0 }; ///< number of additional sessions the workers obtained
+    std::shared_ptr<std::atomic_bool> cancelled = std::make_shared<std::atomic_bool>(false);
+    std::mutex failed_mutex;
+    wxArrayString failed;
+};
+} // namespace
 
 clSFTPManager::clSFTPManager()
 {
@@ -56,6 +75,7 @@ clSFTPManager::clSFTPManager()
 clSFTPManager::~clSFTPManager()
 {
     StopWorkerThread();
+    StopBatchTransfers();
     if (m_eventsConnected) {
         EventNotifier::Get()->Unbind(wxEVT_GOING_DOWN, &clSFTPManager::OnGoingDown, this);
         EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &clSFTPManager::OnFileSaved, this);
@@ -80,6 +100,8 @@ clSFTPManager& clSFTPManager::Get()
 void clSFTPManager::Release()
 {
     StopWorkerThread();
+    StopBatchTransfers();
+    ClosePooledSessions();
     while (!m_connections.empty()) {
         const auto& conn_info = *(m_connections.begin());
         DeleteConnection(conn_info.first, false);
@@ -497,9 +519,10 @@ bool clSFTPManager::DeleteConnection(const wxString& accountName, bool promptUse
         }
     }
 
-    // before we can delete a connection, we must stop the worker thread
+    // before we can delete a connection, we must stop the worker thread and the batch transfers of this account
     // delete the connection and then restart it
     StopWorkerThread();
+    StopBatchTransfers(accountName);
 
     // notify that a session was closed
     clSFTPEvent event(wxEVT_SFTP_SESSION_CLOSED);
@@ -508,6 +531,7 @@ bool clSFTPManager::DeleteConnection(const wxString& accountName, bool promptUse
 
     // and finally remove the connection
     m_connections.erase(iter);
+    ClosePooledSessions(accountName);
 
     // start the worker thread again
     StartWorkerThread();
@@ -782,14 +806,54 @@ bool clSFTPManager::GetLocalPath(const wxString& remote_path, const wxString& ac
 
 void clSFTPManager::StopWorkerThread()
 {
+    m_shutdown.store(true);
     if (m_worker_thread) {
-        m_shutdown.store(true);
         m_worker_thread->join();
         wxDELETE(m_worker_thread);
     }
     m_shutdown.store(false);
 }
 
+void clSFTPManager::StopBatchTransfers(const wxString& account_name)
+{
+    std::vector<batch_transfer> stopped;
+    for (auto iter = m_batches.begin(); iter != m_batches.end();) {
+        if (account_name.empty() || iter->second.account_name == account_name) {
+            iter->second.cancelled->store(true);
+            stopped.push_back(std::move(iter->second));
+            iter = m_batches.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    // batch transfers stop after the file they are currently transferring
+    for (auto& batch : stopped) {
+        for (auto& t : batch.threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    }
+}
+
+void clSFTPManager::ReapBatchTransfer(size_t batch_id)
+{
+    auto iter = m_batches.find(batch_id);
+    if (iter == m_batches.end()) {
+        // already stopped
+        return;
+    }
+
+    // the workers are done, joining only waits for their threads to exit
+    for (auto& t : iter->second.threads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    m_batches.erase(iter);
+}
+
 void clSFTPManager::StartWorkerThread()
 {
     if (m_worker_thread) {
@@ -809,6 +873,210 @@ void clSFTPManager::StartWorkerThread()
         std::ref(m_q), std::ref(m_shutdown));
 }
 
+clSFTP::Ptr_t clSFTPManager::CheckoutSession(const SSHAccountInfo& account)
+{
+    std::vector<pooled_session> broken;
+    {
+        std::lock_guard<std::mutex> lk{ m_poolMutex };
+        auto& pool = m_pool[account.GetAccountName()];
+        while (!pool.empty()) {
+            auto session = pool.back();
+            pool.pop_back();
+            if (session.healthy) {
+                return session.sftp;
+            }
+            broken.push_back(session);
+        }
+    }
+    // the broken sessions are released here, outside of the lock
+    broken.clear();
+
+    // open a new session. The server was already authenticated by the main connection of this account so we do not
+    // prompt the user here. The IDE environment is not applied: the process environment can not be changed safely
+    // from a worker thread
+    try {
+        clSSH::Ptr_t ssh(new clSSH(account.GetHost(), account.GetUsername(), account.GetPassword(),
+                                   account.GetKeyFiles(), account.GetPort()));
+        ssh->Open();
+        wxString message;
+        if (!ssh->AuthenticateServer(message)) {
+            return nullptr;
+        }
+        ssh->Login();
+        clSFTP::Ptr_t sftp(new clSFTP(ssh));
+        sftp->Initialize();
+        sftp->SetAccount(account.GetAccountName());
+        return sftp;
+    } catch (const clException& e) {
+        clWARNING() << "SFTP Manager: failed to open additional session for account" << account.GetAccountName()
+                    << "." << e.What() << endl;
+    }
+    return nullptr;
+}
+
+void clSFTPManager::CheckinSession(const wxString& account_name, clSFTP::Ptr_t sftp, bool healthy)
+{
+    std::lock_guard<std::mutex> lk{ m_poolMutex };
+    m_pool[account_name].push_back({ sftp, healthy });
+}
+
+void clSFTPManager::ClosePooledSessions(const wxString& account_name)
+{
+    std::lock_guard<std::mutex> lk{ m_poolMutex };
+    if (account_name.empty()) {
+        m_pool.clear();
+    } else {
+        m_pool.erase(account_name);
+    }
+}
+
+bool clSFTPManager::DoTransfer(clSFTP::Ptr_t conn, const clSFTPTransfer& transfer, int* error_code)
+{
+    try {
+        wxString remote_dir = transfer.remote_path.BeforeLast('/');
+        if (!remote_dir.empty()) {
+            try {
+                conn->Mkpath(remote_dir);
+            } catch (const clException& e) {
+                // another session might have created part of the path in the meantime, try again
+                wxUnusedVar(e);
+                conn->Mkpath(remote_dir);
+            }
+        }
+        conn->Write(wxFileName(transfer.local_path), transfer.remote_path);
+    } catch (const clException& e) {
+        clERROR() << "SFTP Manager: failed to transfer file:" << transfer.remote_path << "." << e.What() << endl;
+        *error_code = e.ErrorCode();
+        return false;
+    }
+    return true;
+}
+
+void clSFTPManager::AsyncBatchTransfer(const std::vector<clSFTPTransfer>& transfers, const wxString& accountName,
+                                       wxEvtHandler* sink, size_t max_sessions)
+{
+    // make sure that the account has a main connection, this is where the server is authenticated
+    auto conn = GetConnectionPtrAddIfMissing(accountName);
+    CHECK_PTR_RET(conn);
+
+    SSHAccountInfo account = GetConnectionPair(accountName).first;
+    std::shared_ptr<BatchTransferState> state = std::make_shared<BatchTransferState>();
+    state->transfers = transfers;
+
+    const size_t batch_id = ++m_nextBatchId;
+    const size_t sessions_count = std::max<size_t>(1, std::min(max_sessions, transfers.size()));
+    clDEBUG() << "SFTP Manager: uploading" << transfers.size() << "files using up to" << sessions_count
+              << "sessions" << endl;
+
+    // the events are delivered to the sink on the main thread, if it still exists
+    auto notify = [this, batch_id](const clCommandEvent& event) {
+        CallAfter(&clSFTPManager::NotifyBatchSink, batch_id, event);
+    };
+
+    // the transfer loop, executed once per session
+    auto transfer_files = [this, state, accountName, notify](clSFTP::Ptr_t session, bool pooled) {
+        bool healthy = true;
+        const size_t total = state->transfers.size();
+        // the main connection fallback runs on the worker thread and stops with it
+        while (!state->cancelled->load() && (pooled || !m_shutdown.load())) {
+            size_t index = state->next.fetch_add(1);
+            if (index >= total) {
+                break;
+            }
+
+            const auto& transfer = state->transfers[index];
+            int error_code = 0;
+            if (!DoTransfer(session, transfer, &error_code)) {
+                std::lock_guard<std::mutex> lk{ state->failed_mutex };
+                state->failed.Add(transfer.remote_path);
+                if (error_code == SSH_FX_NO_CONNECTION || error_code == SSH_FX_CONNECTION_LOST) {
+                    healthy = false;
+                    break;
+                }
+            }
+
+            clCommandEvent event_progress(wxEVT_SFTP_BATCH_TRANSFER_PROGRESS);
+            event_progress.SetInt(++state->completed);
+            event_progress.SetExtraLong(total);
+            event_progress.SetFileName(transfer.remote_path);
+            event_progress.SetSshAccount(accountName);
+            notify(event_progress);
+        }
+
+        if (pooled) {
+            CheckinSession(accountName, session, healthy);
+        }
+    };
+
+    // report the result and release the batch, called once all the files are done
+    auto finish = [this, state, accountName, notify, batch_id]() {
+        const size_t total = state->transfers.size();
+        clCommandEvent event_done(wxEVT_SFTP_BATCH_TRANSFER_DONE);
+        {
+            std::lock_guard<std::mutex> lk{ state->failed_mutex };
+            // files that were not transferred at all (cancelled, or all sessions were lost)
+            for (size_t i = state->next.load(); i < total; ++i) {
+                state->failed.Add(state->transfers[i].remote_path);
+            }
+            event_done.SetInt(total - state->failed.size());
+            event_done.GetStrings().swap(state->failed);
+        }
+        event_done.SetSshAccount(accountName);
+        notify(event_done);
+        // join the threads of this batch on the main thread
+        CallAfter(&clSFTPManager::ReapBatchTransfer, batch_id);
+    };
+
+    // the sessions are opened by the workers, so a slow or unreachable host does not block the UI
+    auto worker = [this, state, account, conn, transfer_files, finish]() {
+        clSFTP::Ptr_t session = state->cancelled->load() ? nullptr : CheckoutSession(account);
+        if (session) {
+            ++state->opened;
+            transfer_files(session, true);
+        }
+
+        if (--state->running > 0) {
+            return;
+        }
+        if (state->opened.load() == 0 && !state->cancelled->load()) {
+            // no additional session could be opened: transfer the files one by one using the main connection
+            clDEBUG() << "SFTP Manager: batch transfer: no additional sessions, using the main connection" << endl;
+            m_q.push_back([transfer_files, finish, conn]() {
+                transfer_files(conn, false);
+                finish();
+            });
+            return;
+        }
+        finish();
+    };
+
+    state->running.store(sessions_count);
+    batch_transfer& batch = m_batches[batch_id];
+    batch.account_name = accountName;
+    batch.cancelled = state->cancelled;
+    batch.sink = sink;
+    for (size_t i = 0; i < sessions_count; ++i) {
+        batch.threads.emplace_back(worker);
+    }
+}
+
+void clSFTPManager::NotifyBatchSink(size_t batch_id, clCommandEvent event)
+{
+    auto iter = m_batches.find(batch_id);
+    if (iter == m_batches.end()) {
+        // the batch was stopped
+        return;
+    }
+
+    batch_transfer& batch = iter->second;
+    if (!batch.sink) {
+        // the sink was destroyed, nobody is waiting for the remaining files
+        batch.cancelled->store(true);
+        return;
+    }
+    batch.sink->AddPendingEvent(event);
+}
+
 void clSFTPManager::OnSaveCompleted(clCommandEvent& e)
 {
     clGetManager()->SetStatusMessage("SFTP: " + e.GetFileName() + _(" saved"), 3);
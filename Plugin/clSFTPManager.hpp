@@ -13,19 +13,29 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 #include <wx/event.h>
 #include <wx/msgqueue.h>
 #include <wx/string.h>
 #include <wx/thread.h>
+#include <wx/weakref.h>
 #include <wx/timer.h>
 
 class IEditor;
 class SFTPClientData;
 
 typedef std::tuple<std::string, std::string, int> ReadOutput_t;
+
+/// a single file upload, see clSFTPManager::AsyncBatchTransfer()
+struct WXDLLIMPEXP_SDK clSFTPTransfer {
+    wxString local_path;
+    wxString remote_path;
+};
+
 class WXDLLIMPEXP_SDK clSFTPManager : public wxEvtHandler
 {
 protected:
@@ -35,6 +45,18 @@ protected:
         wxString account_name;
     };
 
+    struct pooled_session {
+        clSFTP::Ptr_t sftp;
+        bool healthy = true;
+    };
+
+    struct batch_transfer {
+        wxString account_name;
+        std::shared_ptr<std::atomic_bool> cancelled;
+        std::vector<std::thread> threads;
+        wxWeakRef<wxEvtHandler> sink; ///< reset when the sink is destroyed
+    };
+
 protected:
     std::unordered_map<wxString, std::pair<SSHAccountInfo, clSFTP::Ptr_t>> m_connections;
     wxTimer* m_timer = nullptr;
@@ -45,12 +67,47 @@ protected:
     wxString m_lastError;
     std::unordered_map<wxString, saved_file> m_downloadedFileToAccount;
 
+    // idle sessions used by batch transfers, per account. A session is used by a single thread at a time
+    std::mutex m_poolMutex;
+    std::unordered_map<wxString, std::vector<pooled_session>> m_pool;
+    // running batch transfers by their id. Accessed on the main thread only
+    std::unordered_map<size_t, batch_transfer> m_batches;
+    size_t m_nextBatchId = 0;
+
 protected:
     std::pair<SSHAccountInfo, clSFTP::Ptr_t> GetConnectionPair(const wxString& account) const;
     clSFTP::Ptr_t GetConnectionPtr(const wxString& account) const;
     size_t GetAllConnectionsPtr(std::vector<clSFTP::Ptr_t>& connections) const;
     clSFTP::Ptr_t GetConnectionPtrAddIfMissing(const wxString& account);
 
+    /**
+     * @brief return a session for `account` from the pool, or open a new one. Return nullptr if no session could
+     * be opened. This method can be called from any thread
+     */
+    clSFTP::Ptr_t CheckoutSession(const SSHAccountInfo& account);
+    /**
+     * @brief return a session to the pool. This method can be called from any thread
+     */
+    void CheckinSession(const wxString& account_name, clSFTP::Ptr_t sftp, bool healthy);
+    /**
+     * @brief close the pooled sessions of `account_name` (all accounts if empty)
+     */
+    void ClosePooledSessions(const wxString& account_name = wxEmptyString);
+    static bool DoTransfer(clSFTP::Ptr_t conn, const clSFTPTransfer& transfer, int* error_code);
+    /**
+     * @brief stop the batch transfers of `account_name` (all accounts if empty) after the file they are currently
+     * transferring and join their threads
+     */
+    void StopBatchTransfers(const wxString& account_name = wxEmptyString);
+    /**
+     * @brief join the threads of a batch transfer whose workers are done
+     */
+    void ReapBatchTransfer(size_t batch_id);
+    /**
+     * @brief deliver a batch transfer event to the batch sink, if it still exists. Called on the main thread
+     */
+    void NotifyBatchSink(size_t batch_id, clCommandEvent event);
+
 protected:
     void OnGoingDown(clCommandEvent& event);
     void OnFileSaved(clCommandEvent& event);
@@ -138,6 +195,21 @@ public:
     void AsyncWriteFile(const wxString& content, const wxString& remotePath, const wxString& accountName,
                         wxEvtHandler* sink = nullptr);
 
+    /**
+     * @brief upload a list of files, using up to `max_sessions` SFTP sessions in parallel. The sessions are opened
+     * by the worker threads, kept in a pool and reused by the next batch. This function is async
+     * @param transfers the files to upload. The remote folders are created as needed
+     * @param accountName the account name to use
+     * @param sink callback object for progress events. The batch is cancelled if the sink is destroyed before it
+     * completes
+     * @event wxEVT_SFTP_BATCH_TRANSFER_PROGRESS after each file. GetInt() = files done, GetExtraLong() = total files,
+     * GetFileName() = the remote path of the file
+     * @event wxEVT_SFTP_BATCH_TRANSFER_DONE once all files are done. GetInt() = files transferred successfully,
+     * GetStrings() = the remote paths of the files that could not be transferred
+     */
+    void AsyncBatchTransfer(const std::vector<clSFTPTransfer>& transfers, const wxString& accountName,
+                            wxEvtHandler* sink, size_t max_sessions = 4);
+
     /**
      * @brief read file content. this function is async
      * @param remotePath file path on the remote machine
@@ -292,5 +364,7 @@ wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_SFTP_ASYNC_EXEC_ERROR, clCommand
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_SFTP_ASYNC_EXEC_STDOUT, clCommandEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_SFTP_ASYNC_EXEC_STDERR, clCommandEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_SFTP_ASYNC_EXEC_DONE, clCommandEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_SFTP_BATCH_TRANSFER_PROGRESS, clCommandEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_SFTP_BATCH_TRANSFER_DONE, clCommandEvent);
 #endif
 #endif // CLSFTPMANAGER_HPP
@@ -0,0 +1,318 @@
+#include "clSVGIconCache.hpp"
+
+#include "clFilesCollector.h"
+#include "cl_standard_paths.h"
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <cstring>
+#include <string>
+#include <wx/file.h>
+#include <wx/image.h>
+
+namespace
+{
+// bump this whenever the file layout changes
+constexpr uint32_t CACHE_MAGIC = 0x4349434C; // "CLIC"
+constexpr uint32_t CACHE_VERSION = 2;
+
+// entry flags
+constexpr uint32_t ENTRY_FAILED = 1 << 0; // the SVG could not be rasterised, the entry has no pixels
+
+void WriteU32(std::string& buffer, uint32_t value) { buffer.append(reinterpret_cast<const char*>(&value), 4); }
+void WriteU64(std::string& buffer, uint64_t value) { buffer.append(reinterpret_cast<const char*>(&value), 8); }
+void WriteString(std::string& buffer, const wxString& str)
+{
+    const wxCharBuffer cb = str.mb_str(wxConvUTF8);
+    uint32_t len = ::strlen(cb.data());
+    WriteU32(buffer, len);
+    buffer.append(cb.data(), len);
+}
+
+/// a simple reader over the memory buffer loaded from the cache file
+struct BufferReader {
+    const char* m_cur;
+    const char* m_end;
+
+    BufferReader(const std::string& buffer)
+        : m_cur(buffer.data())
+        , m_end(buffer.data() + buffer.size())
+    {
+    }
+
+    bool CanRead(size_t bytes) const { return (size_t)(m_end - m_cur) >= bytes; }
+
+    bool ReadU32(uint32_t* value)
+    {
+        if (!CanRead(4)) {
+            return false;
+        }
+        ::memcpy(value, m_cur, 4);
+        m_cur += 4;
+        return true;
+    }
+
+    bool ReadU64(uint64_t* value)
+    {
+        if (!CanRead(8)) {
+            return false;
+        }
+        ::memcpy(value, m_cur, 8);
+        m_cur += 8;
+        return true;
+    }
+
+    bool ReadString(wxString* str)
+    {
+        uint32_t len = 0;
+        if (!ReadU32(&len) || !CanRead(len)) {
+            return false;
+        }
+        *str = wxString::FromUTF8(m_cur, len);
+        m_cur += len;
+        return true;
+    }
+
+    const unsigned char* ReadBytes(size_t bytes)
+    {
+        if (!CanRead(bytes)) {
+            return nullptr;
+        }
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(m_cur);
+        m_cur += bytes;
+        return p;
+    }
+};
+
+/// FNV-1a
+uint64_t Hash(uint64_t hash, const void* data, size_t len)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+} // namespace
+
+clSVGIconCache::clSVGIconCache(const wxString& svgDir, bool darkTheme)
+    : m_svgDir(svgDir)
+{
+    m_cacheFile = wxFileName(clStandardPaths::Get().GetUserDataDir(),
+                             darkTheme ? "icons-dark-theme.cache" : "icons-light-theme.cache");
+    m_cacheFile.AppendDir("cache");
+}
+
+clSVGIconCache::~clSVGIconCache() {}
+
+const std::vector<int>& clSVGIconCache::GetSizes()
+{
+    static const std::vector<int> sizes = { 16, 24, 32 };
+    return sizes;
+}
+
+void clSVGIconCache::ScanSVGFiles()
+{
+    m_files.clear();
+    clFilesScanner scanner;
+    scanner.ScanWithCallbacks(m_svgDir, nullptr, [&](const wxArrayString& files) {
+        for (const wxString& filepath : files) {
+            wxFileName fn(filepath);
+            if (fn.GetExt().CmpNoCase("svg") != 0) {
+                continue;
+            }
+
+            // We only stat the file here: reading all the SVG files on every startup is what we want to avoid
+            SVGFile svg;
+            svg.name = fn.GetName();
+            svg.fullpath = filepath;
+
+            uint64_t size = FileUtils::GetFileSize(fn);
+            uint64_t mtime = FileUtils::GetFileModificationTime(fn);
+            const wxCharBuffer cb = svg.name.mb_str(wxConvUTF8);
+            svg.key = Hash(14695981039346656037ULL, cb.data(), ::strlen(cb.data()));
+            svg.key = Hash(svg.key, &size, sizeof(size));
+            svg.key = Hash(svg.key, &mtime, sizeof(mtime));
+            m_files.push_back(svg);
+        }
+    });
+}
+
+bool clSVGIconCache::Load(BundleMap_t* bundles, SVGFile::Vec_t* stale)
+{
+    ScanSVGFiles();
+
+    // by default, everything is stale
+    stale->clear();
+    stale->insert(stale->end(), m_files.begin(), m_files.end());
+
+    wxFile fp;
+    if (!m_cacheFile.FileExists() || !fp.Open(m_cacheFile.GetFullPath(), wxFile::read)) {
+        return false;
+    }
+
+    // read the entire cache with a single read
+    std::string buffer;
+    buffer.resize(fp.Length());
+    if (fp.Read(&buffer[0], buffer.size()) != (ssize_t)buffer.size()) {
+        clWARNING() << "Failed to read icon cache:" << m_cacheFile << endl;
+        return false;
+    }
+    fp.Close();
+
+    BufferReader reader(buffer);
+    uint32_t magic = 0, version = 0, sizesCount = 0, count = 0;
+    if (!reader.ReadU32(&magic) || !reader.ReadU32(&version) || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        clDEBUG() << "Icon cache" << m_cacheFile << "is of an unknown format, ignoring it" << endl;
+        return false;
+    }
+
+    const std::vector<int>& sizes = GetSizes();
+    if (!reader.ReadU32(&sizesCount) || sizesCount != sizes.size()) {
+        return false;
+    }
+
+    std::unordered_map<wxString, uint64_t> keys;
+    for (const SVGFile& svg : m_files) {
+        keys.insert({ svg.name, svg.key });
+    }
+
+    if (!reader.ReadU32(&count)) {
+        return false;
+    }
+
+    wxStringSet_t loaded;
+    for (uint32_t i = 0; i < count; ++i) {
+        wxString name;
+        uint64_t key = 0;
+        uint32_t flags = 0;
+        if (!reader.ReadString(&name) || !reader.ReadU64(&key) || !reader.ReadU32(&flags)) {
+            return false;
+        }
+
+        auto iter = keys.find(name);
+        bool upToDate = iter != keys.end() && iter->second == key;
+        if (flags & ENTRY_FAILED) {
+            // parsing the same SVG file again would fail again
+            if (upToDate) {
+                loaded.insert(name);
+            }
+            continue;
+        }
+
+        wxVector<wxBitmap> bitmaps;
+        for (int size : sizes) {
+            size_t pixels = size * size;
+            const unsigned char* rgb = reader.ReadBytes(pixels * 3);
+            const unsigned char* alpha = reader.ReadBytes(pixels);
+            if (!rgb || !alpha) {
+                return false;
+            }
+
+            if (upToDate) {
+                wxImage img(size, size, false);
+                ::memcpy(img.GetData(), rgb, pixels * 3);
+                img.SetAlpha();
+                ::memcpy(img.GetAlpha(), alpha, pixels);
+                bitmaps.push_back(wxBitmap(img));
+            }
+        }
+
+        if (upToDate) {
+            bundles->insert({ name, wxBitmapBundle::FromBitmaps(bitmaps) });
+            loaded.insert(name);
+        }
+    }
+
+    // whatever was not loaded from the cache, needs to be parsed
+    stale->clear();
+    for (const SVGFile& svg : m_files) {
+        if (loaded.count(svg.name) == 0) {
+            stale->push_back(svg);
+        }
+    }
+    clDEBUG() << "Loaded" << loaded.size() << "icons from cache." << stale->size() << "icons are stale" << endl;
+    return true;
+}
+
+bool clSVGIconCache::Save(const BundleMap_t& bundles) const
+{
+    std::unordered_map<wxString, uint64_t> keys;
+    for (const SVGFile& svg : m_files) {
+        keys.insert({ svg.name, svg.key });
+    }
+
+    const std::vector<int>& sizes = GetSizes();
+
+    std::string buffer;
+    WriteU32(buffer, CACHE_MAGIC);
+    WriteU32(buffer, CACHE_VERSION);
+    WriteU32(buffer, sizes.size());
+
+    // reserve room for the entries count, it is updated below
+    size_t countOffset = buffer.size();
+    WriteU32(buffer, 0);
+
+    uint32_t count = 0;
+    wxStringSet_t written;
+    for (const auto& vt : bundles) {
+        auto iter = keys.find(vt.first);
+        if (iter == keys.end()) {
+            continue;
+        }
+
+        std::string entry;
+        WriteString(entry, vt.first);
+        WriteU64(entry, iter->second);
+        WriteU32(entry, 0);
+
+        bool ok = true;
+        for (int size : sizes) {
+            wxImage img = vt.second.GetBitmap(wxSize(size, size)).ConvertToImage();
+            if (!img.IsOk() || img.GetWidth() != size || img.GetHeight() != size) {
+                ok = false;
+                break;
+            }
+
+            size_t pixels = size * size;
+            entry.append(reinterpret_cast<const char*>(img.GetData()), pixels * 3);
+            if (img.HasAlpha()) {
+                entry.append(reinterpret_cast<const char*>(img.GetAlpha()), pixels);
+            } else {
+                entry.append(pixels, (char)wxALPHA_OPAQUE);
+            }
+        }
+
+        if (ok) {
+            buffer.append(entry);
+            written.insert(vt.first);
+            ++count;
+        }
+    }
+
+    // Record the SVG files that could not be rasterised, otherwise the cache is never complete and they are parsed
+    // (and the cache rewritten) on every startup
+    for (const SVGFile& svg : m_files) {
+        if (!written.insert(svg.name).second) {
+            continue;
+        }
+        WriteString(buffer, svg.name);
+        WriteU64(buffer, svg.key);
+        WriteU32(buffer, ENTRY_FAILED);
+        ++count;
+    }
+    ::memcpy(&buffer[countOffset], &count, sizeof(count));
+
+    if (!m_cacheFile.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+        return false;
+    }
+
+    // WriteFileContentRaw() writes into a temporary file and renames it, so a partially written cache is never loaded
+    if (!FileUtils::WriteFileContentRaw(m_cacheFile, buffer)) {
+        clWARNING() << "Failed to write icon cache:" << m_cacheFile << endl;
+        return false;
+    }
+    clDEBUG() << "Icon cache" << m_cacheFile << "written with" << count << "entries" << endl;
+    return true;
+}
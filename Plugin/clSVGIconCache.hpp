@@ -0,0 +1,67 @@
+#ifndef CLSVGICONCACHE_HPP
+#define CLSVGICONCACHE_HPP
+
+#include "codelite_exports.h"
+#include "wxStringHash.h"
+
+#include <vector>
+#include <wx/bmpbndl.h>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @class clSVGIconCache
+ * @brief an on-disk cache of pre-rasterised SVG icons, one file per theme.
+ *
+ * Parsing and rendering hundreds of SVG files is the most expensive part of
+ * BitmapLoader's initialisation. This class keeps the rendered pixels of every
+ * icon (at a fixed set of DPI scales) in a single binary file which is read with
+ * one read call on startup. Each entry is keyed by a fingerprint of its SVG source
+ * file (name, size and modification time) so only icons whose SVG has changed need
+ * to be parsed again. SVG files that fail to rasterise are kept as entries without
+ * pixels, so they are not parsed again until they change
+ */
+class WXDLLIMPEXP_SDK clSVGIconCache
+{
+public:
+    typedef std::unordered_map<wxString, wxBitmapBundle> BundleMap_t;
+
+    struct SVGFile {
+        wxString name;     // the icon name, e.g. "mime-cpp"
+        wxString fullpath; // path to the SVG file
+        uint64_t key = 0;  // fingerprint of the SVG file
+        typedef std::vector<SVGFile> Vec_t;
+    };
+
+private:
+    wxFileName m_cacheFile;
+    wxString m_svgDir;
+    SVGFile::Vec_t m_files;
+
+private:
+    void ScanSVGFiles();
+
+public:
+    clSVGIconCache(const wxString& svgDir, bool darkTheme);
+    ~clSVGIconCache();
+
+    /**
+     * @brief load all the up-to-date icons from the cache into 'bundles'
+     * @param stale [output] SVG files that are missing from the cache or were modified since it was written
+     * @return true if the cache file exists and is of the expected format
+     */
+    bool Load(BundleMap_t* bundles, SVGFile::Vec_t* stale);
+
+    /**
+     * @brief rasterise 'bundles' and write them into the cache file, replacing its content. SVG files found by
+     * Load() that have no usable bundle are recorded as failed
+     */
+    bool Save(const BundleMap_t& bundles) const;
+
+    /**
+     * @brief the icon sizes stored per entry (1x, 1.5x and 2x of 16 pixels)
+     */
+    static const std::vector<int>& GetSizes();
+};
+
+#endif // CLSVGICONCACHE_HPP
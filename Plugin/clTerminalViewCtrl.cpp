@@ -6,15 +6,44 @@
 #include "event_notifier.h"
 #include "file_logger.h"
 
+#include <unordered_map>
+
 namespace
 {
 class MyAnsiCodeRenderer : public clControlWithItemsRowRenderer
 {
+    struct ParsedRow {
+        wxString label; // the label the line was parsed from
+        size_t line = 0;
+    };
+
+    // every row is parsed once into the handler, painting only draws its spans
     clAnsiEscapeCodeHandler handler;
+    std::unordered_map<clRowEntry*, ParsedRow> m_rows;
     wxFont m_font;
     clDataViewListCtrl* m_ctrl = nullptr;
 
 private:
+    size_t GetParsedLine(clRowEntry* entry)
+    {
+        const wxString& label = entry->GetLabel(0);
+        auto iter = m_rows.find(entry);
+        if(iter != m_rows.end() && iter->second.label == label) {
+            return iter->second.line;
+        }
+
+        // we are not told about deleted or replaced rows: start over once most of the parsed lines are stale
+        if(handler.GetLineCount() > 2 * m_ctrl->GetItemCount() + 100) {
+            handler.Reset();
+            m_rows.clear();
+        }
+
+        ParsedRow& row = m_rows[entry];
+        row.label = label;
+        row.line = handler.ParseLine(label);
+        return row.line;
+    }
+
     void DoRenderBackground(wxDC& dc, const wxRect& rect, const clColours& colours)
     {
         wxColour bg_colour = colours.GetBgColour();
@@ -31,7 +60,6 @@ public:
     MyAnsiCodeRenderer(clDataViewListCtrl* ctrl)
         : m_ctrl(ctrl)
     {
-        wxUnusedVar(m_ctrl);
     }
 
     void SetFont(const wxFont& f) { this->m_font = f; }
@@ -58,9 +86,7 @@ public:
     {
         wxUnusedVar(window);
 
-        // draw the ascii line
-        handler.Reset();
-        handler.Parse(entry->GetLabel(0));
+        int line = GetParsedLine(entry);
 
         // draw item background
         DoRenderBackground(dc, entry->GetItemRect(), colours);
@@ -76,11 +102,11 @@ public:
             dc.SetPen(colours.GetSelItemBgColour());
             dc.SetBrush(colours.GetSelItemBgColour());
             dc.DrawRectangle(entry->GetItemRect());
-            handler.RenderNoStyle(dc, ds, 0, entry->GetItemRect(), colours.IsLightTheme());
+            handler.RenderNoStyle(dc, ds, line, entry->GetItemRect(), colours.IsLightTheme());
         } else {
             ds.bg_colour = colours.GetItemBgColour();
             ds.fg_colour = colours.GetItemTextColour();
-            handler.Render(dc, ds, 0, entry->GetItemRect(), colours.IsLightTheme());
+            handler.Render(dc, ds, line, entry->GetItemRect(), colours.IsLightTheme());
         }
     }
 };
@@ -39,6 +39,9 @@ public:
     enum eFlags {
         kNone = 0,
         kDisabledByDefault = (1 << 0),
+        // The plugin does not need to be ready before the main frame is shown. Its construction
+        // is postponed until it is first requested or until the IDE is idle after startup
+        kLoadDeferred = (1 << 1),
     };
 
 protected:
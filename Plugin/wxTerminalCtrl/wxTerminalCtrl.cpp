@@ -151,17 +151,9 @@ void wxTerminalCtrl::Run(const wxString& command)
 
 void wxTerminalCtrl::AppendText(wxStringView text)
 {
-    wxString window_title;
-    m_outputView->StyleAndAppend(text, &window_title);
-    m_outputView->SetCaretEnd();
+    // rendered asynchronously, the view fires wxEVT_TERMINAL_CTRL_SET_TITLE if the output sets the window title
+    m_outputView->StyleAndAppend(text);
     m_inputCtrl->SetWritePositionEnd();
-
-    if (!window_title.empty()) {
-        wxTerminalEvent titleEvent(wxEVT_TERMINAL_CTRL_SET_TITLE);
-        titleEvent.SetEventObject(this);
-        titleEvent.SetString(window_title);
-        GetEventHandler()->AddPendingEvent(titleEvent);
-    }
 }
 
 void wxTerminalCtrl::GenerateCtrlC()
@@ -355,9 +347,6 @@ void wxTerminalCtrl::ProcessOutputBuffer()
             break;
         }
     }
-
-    // see if we need to prompt for password
-    m_inputCtrl->CallAfter(&wxTerminalInputCtrl::NotifyTerminalOutput);
 }
 
 void wxTerminalCtrl::ProcessIdle()
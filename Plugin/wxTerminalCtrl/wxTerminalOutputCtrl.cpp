@@ -7,6 +7,7 @@
 #include "clIdleEventThrottler.hpp"
 #include "clSystemSettings.h"
 #include "clWorkspaceManager.h"
+#include "cl_config.h"
 #include "codelite_events.h"
 #include "dirsaver.h"
 #include "event_notifier.h"
@@ -14,8 +15,10 @@
 #include "imanager.h"
 #include "procutils.h"
 #include "wxTerminalCtrl.h"
+#include "wxTerminalEvent.hpp"
 #include "wxTerminalInputCtrl.hpp"
 
+#include <algorithm>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
 #include <wx/sizer.h>
@@ -24,6 +27,39 @@
 
 namespace
 {
+/// render the pending output at most once per frame (~60Hz)
+constexpr int RENDER_INTERVAL_MS = 16;
+
+/// an incomplete escape sequence longer than this is not waited for, it is rendered as is
+constexpr size_t MAX_INCOMPLETE_SEQUENCE = 4096;
+
+/// the text itself is styled by the control's lexer, this renderer only collects the window title. All other
+/// callbacks do nothing so the parser thread does not touch any shared wx object
+class TitleRenderer : public wxTerminalAnsiRendererInterface
+{
+public:
+    void Bell() override {}
+    void Backspace() override {}
+    void Tab() override {}
+    void LineFeed() override {}
+    void FormFeed() override {}
+    void CarriageReturn() override {}
+    void MoveCaret(long n, wxDirection direction) override {}
+    void SetCaretX(long n) override {}
+    void SetCaretY(long n) override {}
+    void ClearLine(size_t dir) override {}
+    void ClearDisplay(size_t dir) override {}
+    void ResetStyle() override {}
+    void SetTextColour(const wxColour& col) override {}
+    void SetTextBgColour(const wxColour& col) override {}
+    void SetTextFont(const wxFont& font) override {}
+    void SetWindowTitle(wxStringView window_title) override
+    {
+        m_windowTitle = wxString(window_title.data(), window_title.length());
+    }
+    void ClearWindowTitle() { m_windowTitle.clear(); }
+};
+
 /// given range, [start, end), return the string in this range without any ANSI escape codes
 wxString GetSelectedRange(wxStyledTextCtrl* ctrl, int start_pos, int end_pos)
 {
@@ -129,6 +165,7 @@ void wxTerminalOutputCtrl::Initialise(const wxFont& font, const wxColour& bg_col
     m_ctrl->SetLexer(wxSTC_LEX_CONTAINER);
     m_ctrl->SetWrapMode(wxSTC_WRAP_CHAR);
     m_ctrl->SetEditable(false);
+    m_ctrl->SetUndoCollection(false);
     m_ctrl->SetWordChars(R"#(\:~abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_$/.-+@)#");
     m_ctrl->IndicatorSetStyle(INDICATOR_HYPERLINK, wxSTC_INDIC_COMPOSITIONTHICK);
     auto lexer = ColoursAndFontsManager::Get().GetLexer("terminal");
@@ -147,10 +184,27 @@ void wxTerminalOutputCtrl::Initialise(const wxFont& font, const wxColour& bg_col
 
     m_ctrl->Bind(wxEVT_KILL_FOCUS, &wxTerminalOutputCtrl::OnFocusLost, this);
     m_ctrl->Bind(wxEVT_SET_FOCUS, &wxTerminalOutputCtrl::OnFocus, this);
+
+    m_scrollbackLines = wxMax(clConfig::Get().Read("terminal/scrollback_lines", 10000), 100);
+    m_renderTimer = new wxTimer(this);
+    Bind(wxEVT_TIMER, &wxTerminalOutputCtrl::OnRenderTimer, this, m_renderTimer->GetId());
+    m_parserThread = std::thread(&wxTerminalOutputCtrl::ParserThreadMain, this);
 }
 
 wxTerminalOutputCtrl::~wxTerminalOutputCtrl()
 {
+    {
+        std::lock_guard<std::mutex> lk{ m_parserMutex };
+        m_parserShutdown = true;
+    }
+    m_parserCv.notify_one();
+    if (m_parserThread.joinable()) {
+        m_parserThread.join();
+    }
+    m_renderTimer->Stop();
+    Unbind(wxEVT_TIMER, &wxTerminalOutputCtrl::OnRenderTimer, this, m_renderTimer->GetId());
+    wxDELETE(m_renderTimer);
+
     wxDELETE(m_stcRenderer);
     m_ctrl->Unbind(wxEVT_CHAR_HOOK, &wxTerminalOutputCtrl::OnKeyDown, this);
     m_ctrl->Unbind(wxEVT_LEFT_UP, &wxTerminalOutputCtrl::OnLeftUp, this);
@@ -202,11 +256,126 @@ wxString wxTerminalOutputCtrl::GetLineText(int lineNumber) const { return m_ctrl
 
 void wxTerminalOutputCtrl::ReloadSettings() { ApplyTheme(); }
 
-void wxTerminalOutputCtrl::StyleAndAppend(wxStringView buffer, [[maybe_unused]] wxString* window_title)
+void wxTerminalOutputCtrl::StyleAndAppend(wxStringView buffer)
 {
-    EditorEnabler enabler{ m_ctrl };
-    m_ctrl->AppendText(StringUtils::StripTerminalOSC(buffer));
-    RequestScrollToEnd();
+    {
+        std::lock_guard<std::mutex> lk{ m_parserMutex };
+        m_parserInput.append(buffer.data(), buffer.length());
+    }
+    m_parserCv.notify_one();
+}
+
+void wxTerminalOutputCtrl::ParserThreadMain()
+{
+    TitleRenderer renderer;
+    // output that ends with an incomplete escape sequence is kept here until the rest of it arrives
+    wxString buffer;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk{ m_parserMutex };
+            m_parserCv.wait(lk, [this] { return m_parserShutdown || !m_parserInput.empty(); });
+            if (m_parserShutdown) {
+                return;
+            }
+            buffer << m_parserInput;
+            m_parserInput.clear();
+        }
+
+        wxStringView sv{ buffer.wc_str(), buffer.length() };
+        size_t consumed = m_outputHandler.ProcessBuffer(sv, &renderer);
+        if (buffer.length() - consumed > MAX_INCOMPLETE_SEQUENCE) {
+            consumed = buffer.length();
+        }
+        if (consumed == 0) {
+            continue;
+        }
+
+        // the consumed part ends on a sequence boundary, so no OSC is split here
+        wxString text = StringUtils::StripTerminalOSC(sv.substr(0, consumed));
+        buffer.erase(0, consumed);
+        QueueRender(text, renderer.GetWindowTitle());
+        renderer.ClearWindowTitle();
+    }
+}
+
+void wxTerminalOutputCtrl::QueueRender(const wxString& text, const wxString& window_title)
+{
+    {
+        std::lock_guard<std::mutex> lk{ m_parserMutex };
+        m_pendingOutput << text;
+        m_pendingLines += std::count(text.begin(), text.end(), '\n');
+        if (m_pendingLines > m_scrollbackLines) {
+            // the lines that would be scrolled out by the time this buffer is rendered are never rendered
+            size_t excess = m_pendingLines - m_scrollbackLines;
+            size_t pos = 0;
+            for (size_t i = 0; i < excess; ++i) {
+                pos = m_pendingOutput.find('\n', pos) + 1;
+            }
+            m_pendingOutput.erase(0, pos);
+            m_pendingLines -= excess;
+        }
+
+        if (!window_title.empty()) {
+            m_pendingTitle = window_title;
+        }
+
+        if (m_renderQueued) {
+            return;
+        }
+        m_renderQueued = true;
+    }
+    CallAfter(&wxTerminalOutputCtrl::StartRenderTimer);
+}
+
+void wxTerminalOutputCtrl::StartRenderTimer()
+{
+    if (!m_renderTimer->IsRunning()) {
+        m_renderTimer->StartOnce(RENDER_INTERVAL_MS);
+    }
+}
+
+void wxTerminalOutputCtrl::OnRenderTimer(wxTimerEvent& event)
+{
+    wxUnusedVar(event);
+    wxString text;
+    wxString window_title;
+    {
+        std::lock_guard<std::mutex> lk{ m_parserMutex };
+        text.swap(m_pendingOutput);
+        window_title.swap(m_pendingTitle);
+        m_pendingLines = 0;
+        m_renderQueued = false;
+    }
+
+    if (!text.empty()) {
+        ClearIndicators();
+        {
+            EditorEnabler enabler{ m_ctrl };
+            m_ctrl->AppendText(text);
+            TrimScrollback();
+        }
+        SetCaretEnd();
+        RequestScrollToEnd();
+        if (m_terminal && m_terminal->GetInputCtrl()) {
+            m_terminal->GetInputCtrl()->NotifyTerminalOutput();
+        }
+    }
+
+    if (!window_title.empty() && m_terminal) {
+        wxTerminalEvent titleEvent(wxEVT_TERMINAL_CTRL_SET_TITLE);
+        titleEvent.SetEventObject(m_terminal);
+        titleEvent.SetString(window_title);
+        m_terminal->GetEventHandler()->AddPendingEvent(titleEvent);
+    }
+}
+
+void wxTerminalOutputCtrl::TrimScrollback()
+{
+    int lines = m_ctrl->GetLineCount();
+    if (lines <= (int)m_scrollbackLines) {
+        return;
+    }
+    m_ctrl->DeleteRange(0, m_ctrl->PositionFromLine(lines - (int)m_scrollbackLines));
 }
 
 void wxTerminalOutputCtrl::ShowCommandLine()
@@ -242,6 +411,11 @@ int wxTerminalOutputCtrl::GetCurrentStyle() { return 0; }
 
 void wxTerminalOutputCtrl::Clear()
 {
+    {
+        std::lock_guard<std::mutex> lk{ m_parserMutex };
+        m_pendingOutput.clear();
+        m_pendingLines = 0;
+    }
     EditorEnabler d{ m_ctrl };
     m_ctrl->ClearAll();
 }
@@ -8,8 +8,12 @@
 #include "wxTerminalAnsiRendererSTC.hpp"
 #include "wxTerminalColourHandler.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <wx/stc/stc.h>
 #include <wx/textctrl.h>
+#include <wx/timer.h>
 
 class wxTerminalCtrl;
 class wxTerminalInputCtrl;
@@ -58,6 +62,21 @@ class WXDLLIMPEXP_SDK wxTerminalOutputCtrl : public wxWindow
 
     wxStyledTextCtrl* m_ctrl = nullptr;
     wxTerminalAnsiEscapeHandler m_outputHandler;
+
+    // the ANSI parser thread. Raw output is queued by StyleAndAppend() and the parsed text is kept in a bounded
+    // buffer until the render timer appends it to the control (at most once per frame)
+    std::thread m_parserThread;
+    std::mutex m_parserMutex;
+    std::condition_variable m_parserCv;
+    wxString m_parserInput;
+    bool m_parserShutdown = false;
+    wxString m_pendingOutput;
+    size_t m_pendingLines = 0;
+    wxString m_pendingTitle;
+    bool m_renderQueued = false;
+    wxTimer* m_renderTimer = nullptr;
+    size_t m_scrollbackLines = 10000;
+
     wxTerminalAnsiRendererSTC* m_stcRenderer = nullptr;
 
     wxEvtHandler* m_sink = nullptr;
@@ -94,6 +113,14 @@ protected:
     void OnFocusLost(wxFocusEvent& event);
     void OnFocus(wxFocusEvent& event);
 
+    void ParserThreadMain();
+    /// append the parsed text to the render buffer, keeping only the last m_scrollbackLines lines
+    void QueueRender(const wxString& text, const wxString& window_title);
+    void StartRenderTimer();
+    void OnRenderTimer(wxTimerEvent& event);
+    /// remove the oldest lines from the control so it holds at most m_scrollbackLines lines
+    void TrimScrollback();
+
 public:
     explicit wxTerminalOutputCtrl(wxTerminalCtrl* parent,
                                   wxWindowID winid = wxNOT_FOUND,
@@ -109,7 +136,12 @@ public:
 
     // API
     void AppendText(const wxString& buffer);
-    void StyleAndAppend(wxStringView buffer, wxString* window_title);
+    /**
+     * @brief queue raw terminal output. The ANSI escape sequences are processed by a worker thread and the text is
+     * rendered by batches, at most once per frame. A window title found in the output is sent to the terminal as
+     * wxEVT_TERMINAL_CTRL_SET_TITLE
+     */
+    void StyleAndAppend(wxStringView buffer);
     long GetLastPosition() const;
     wxString GetRange(int from, int to) const;
     bool PositionToXY(long pos, long* x, long* y) const;
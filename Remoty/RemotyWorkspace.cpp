@@ -147,9 +147,9 @@ void RemotyWorkspace::BindEvents()
     m_codeliteRemoteFinder.Bind(
         wxEVT_CODELITE_REMOTE_REPLACE_RESULTS, &RemotyWorkspace::OnCodeLiteRemoteReplaceProgress, this);
     m_codeliteRemoteFinder.Bind(
-        wxEVT_CODELITE_REMOTE_LIST_FILES, &RemotyWorkspace::OnCodeLiteRemoteListFilesProgress, this);
+        wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES, &RemotyWorkspace::OnCodeLiteRemoteListFilesChanges, this);
     m_codeliteRemoteFinder.Bind(
-        wxEVT_CODELITE_REMOTE_LIST_FILES_DONE, &RemotyWorkspace::OnCodeLiteRemoteListFilesDone, this);
+        wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES_DONE, &RemotyWorkspace::OnCodeLiteRemoteListFilesChangesDone, this);
 
     // builder
     m_codeliteRemoteBuilder.Bind(
@@ -195,9 +195,9 @@ void RemotyWorkspace::UnbindEvents()
         wxEVT_CODELITE_REMOTE_FIND_RESULTS_DONE, &RemotyWorkspace::OnCodeLiteRemoteFindDone, this);
     m_codeliteRemoteFinder.Unbind(wxEVT_CODELITE_REMOTE_RESTARTED, &RemotyWorkspace::OnCodeLiteRemoteTerminated, this);
     m_codeliteRemoteFinder.Unbind(
-        wxEVT_CODELITE_REMOTE_LIST_FILES, &RemotyWorkspace::OnCodeLiteRemoteListFilesProgress, this);
+        wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES, &RemotyWorkspace::OnCodeLiteRemoteListFilesChanges, this);
     m_codeliteRemoteFinder.Unbind(
-        wxEVT_CODELITE_REMOTE_LIST_FILES_DONE, &RemotyWorkspace::OnCodeLiteRemoteListFilesDone, this);
+        wxEVT_CODELITE_REMOTE_LIST_FILES_CHANGES_DONE, &RemotyWorkspace::OnCodeLiteRemoteListFilesChangesDone, this);
 
     // builder
     m_codeliteRemoteBuilder.Unbind(
@@ -269,6 +269,10 @@ void RemotyWorkspace::DoClose(bool notify)
     m_localWorkspaceFile.clear();
     m_localUserWorkspaceFile.clear();
     m_replaceInFilesModifiedFiles.clear();
+    m_workspaceFiles.clear();
+    m_workspaceFilesToken.clear();
+    m_pendingWorkspaceFilesToken.clear();
+    m_workspaceFilesCacheFile.clear();
 
     m_codeliteRemoteBuilder.Stop();
     m_codeliteRemoteFinder.Stop();
@@ -921,32 +925,87 @@ void RemotyWorkspace::RestartCodeLiteRemote(clCodeLiteRemoteProcess* proc, const
     clDEBUG() << "Starting codelite-remote...(" << context << ") ... done" << endl;
 }
 
-void RemotyWorkspace::OnCodeLiteRemoteListFilesProgress(clCommandEvent& event)
+void RemotyWorkspace::OnCodeLiteRemoteListFilesChanges(clCommandEvent& event)
 {
-    m_workspaceFiles.reserve(event.GetStrings().size() + m_workspaceFiles.size());
-    m_workspaceFiles.insert(m_workspaceFiles.end(), event.GetStrings().begin(), event.GetStrings().end());
+    // each line is one of: "token:<token>", "reset", "+<added file>" or "-<removed file>"
+    for (const wxString& line : event.GetStrings()) {
+        if (line.StartsWith("token:")) {
+            m_pendingWorkspaceFilesToken = line.Mid(6);
+        } else if (line == "reset") {
+            m_workspaceFiles.clear();
+        } else if (line.StartsWith("+")) {
+            m_workspaceFiles.insert(line.Mid(1));
+        } else if (line.StartsWith("-")) {
+            m_workspaceFiles.erase(line.Mid(1));
+        }
+    }
 }
 
-void RemotyWorkspace::OnCodeLiteRemoteListFilesDone(clCommandEvent& event)
+void RemotyWorkspace::OnCodeLiteRemoteListFilesChangesDone(clCommandEvent& event)
 {
+    wxUnusedVar(event);
+    m_workspaceFilesToken.swap(m_pendingWorkspaceFilesToken);
+    m_pendingWorkspaceFilesToken.clear();
+    SaveWorkspaceFilesCache();
+
     wxString message;
     message << _("Remote file system scan completed. Found: ") << m_workspaceFiles.size() << _(" files");
     clGetManager()->SetStatusMessage(message);
+    NotifyWorkspaceFilesScanned();
+}
 
-    // notify that scan is completed
+void RemotyWorkspace::NotifyWorkspaceFilesScanned()
+{
     clDEBUG() << "Sending wxEVT_WORKSPACE_FILES_SCANNED event..." << endl;
     clWorkspaceEvent event_scan{ wxEVT_WORKSPACE_FILES_SCANNED };
     event_scan.SetIsRemote(true);
     EventNotifier::Get()->ProcessEvent(event_scan);
 }
 
+void RemotyWorkspace::LoadWorkspaceFilesCache()
+{
+    m_workspaceFiles.clear();
+    m_workspaceFilesToken.clear();
+
+    wxString content;
+    if (m_workspaceFilesCacheFile.empty() || !wxFileName::FileExists(m_workspaceFilesCacheFile) ||
+        !FileUtils::ReadFileContent(m_workspaceFilesCacheFile, content)) {
+        return;
+    }
+
+    // the first line is the token of the listing, the rest are the files
+    wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
+    if (lines.empty()) {
+        return;
+    }
+    m_workspaceFilesToken = lines[0];
+    m_workspaceFiles.insert(lines.begin() + 1, lines.end());
+    clDEBUG() << "Remoty: loaded" << m_workspaceFiles.size() << "files from cache" << m_workspaceFilesCacheFile
+              << endl;
+}
+
+void RemotyWorkspace::SaveWorkspaceFilesCache()
+{
+    if (m_workspaceFilesCacheFile.empty() || m_workspaceFilesToken.empty()) {
+        return;
+    }
+
+    wxString content;
+    content << m_workspaceFilesToken << "\n";
+    for (const wxString& file : m_workspaceFiles) {
+        content << file << "\n";
+    }
+    FileUtils::WriteFileContent(m_workspaceFilesCacheFile, content);
+}
+
 void RemotyWorkspace::ScanForWorkspaceFiles()
 {
     wxString root_dir = GetRemoteWorkingDir();
     wxString file_extensions = GetSettings().GetSelectedConfig()->GetFileExtensions();
 
     auto files_exts = ::wxStringTokenize(file_extensions, ";,", wxTOKEN_STRTOK);
-    std::unordered_set<wxString> S{ files_exts.begin(), files_exts.end() };
+    // keep the list sorted: the remote side identifies a listing by the root dir + extensions
+    std::set<wxString> S{ files_exts.begin(), files_exts.end() };
 
     // common file extensions
     S.insert("*.txt");
@@ -957,10 +1016,24 @@ void RemotyWorkspace::ScanForWorkspaceFiles()
     for (const auto& s : S) {
         file_extensions << s << ";";
     }
-    m_workspaceFiles.clear();
+
+    // start with the list from the previous session, and fetch only what changed since then
+    wxFileName cache_file{ clStandardPaths::Get().GetUserDataDir(), wxEmptyString };
+    cache_file.AppendDir("Remoty");
+    cache_file.AppendDir("FilesCache");
+    cache_file.Mkdir(wxPATH_MKDIR_FULL);
+    size_t key = std::hash<wxString>{}(root_dir + "|" + file_extensions);
+    cache_file.SetFullName(wxString() << m_account.GetAccountName() << "-" << key << ".txt");
+    m_workspaceFilesCacheFile = cache_file.GetFullPath();
+
+    LoadWorkspaceFilesCache();
+    m_pendingWorkspaceFilesToken.clear();
+    if (!m_workspaceFiles.empty()) {
+        NotifyWorkspaceFilesScanned();
+    }
 
     // use the finder codelite-remote
-    m_codeliteRemoteFinder.ListFiles(root_dir, file_extensions);
+    m_codeliteRemoteFinder.ListFilesChanges(root_dir, file_extensions, m_workspaceFilesToken);
 }
 
 void RemotyWorkspace::OnOpenResourceFile(clCommandEvent& event)
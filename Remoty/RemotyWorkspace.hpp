@@ -17,6 +17,7 @@
 
 #include <deque>
 #include <functional>
+#include <set>
 #include <wx/arrstr.h>
 #include <wx/event.h>
 
@@ -50,7 +51,10 @@ private:
     clCodeLiteRemoteProcess m_codeliteRemoteFinder;
     long m_execPID = wxNOT_FOUND;
     clRemoteTerminal::ptr_t m_remote_terminal;
-    wxArrayString m_workspaceFiles;
+    std::set<wxString> m_workspaceFiles;
+    wxString m_workspaceFilesToken;
+    wxString m_pendingWorkspaceFilesToken;
+    wxString m_workspaceFilesCacheFile;
     clRemoteFinderHelper m_remoteFinder;
     bool m_buildInProgress = false;
     std::unordered_map<wxString, bool> m_old_servers_state;
@@ -121,8 +125,8 @@ protected:
     void OnCodeLiteRemoteReplaceProgress(clFindInFilesEvent& event);
     void OnCodeLiteRemoteReplaceDone(clFindInFilesEvent& event);
 
-    void OnCodeLiteRemoteListFilesProgress(clCommandEvent& event);
-    void OnCodeLiteRemoteListFilesDone(clCommandEvent& event);
+    void OnCodeLiteRemoteListFilesChanges(clCommandEvent& event);
+    void OnCodeLiteRemoteListFilesChangesDone(clCommandEvent& event);
 
     wxString CreateEnvScriptContent() const;
     wxString UploadScript(const wxString& content, const wxString& script_path = wxEmptyString) const;
@@ -191,6 +195,18 @@ public:
      * @brief refresh the workspace files list (by scanning them on the remote machine)
      */
     void ScanForWorkspaceFiles();
+    /**
+     * @brief load the workspace files list stored locally by a previous scan
+     */
+    void LoadWorkspaceFilesCache();
+    /**
+     * @brief store the workspace files list locally, so the next session can start with it
+     */
+    void SaveWorkspaceFilesCache();
+    /**
+     * @brief notify that the workspace files list is ready
+     */
+    void NotifyWorkspaceFilesScanned();
 
     /**
      * @brief perform find in files
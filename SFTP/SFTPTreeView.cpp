@@ -36,6 +36,7 @@
 #include "bitmap_loader.h"
 #include "clFileOrFolderDropTarget.h"
 #include "clToolBarButtonBase.h"
+#include "clSFTPManager.hpp"
 #include "cl_config.h"
 #include "event_notifier.h"
 #include "file_logger.h"
@@ -51,7 +52,10 @@
 #include <algorithm>
 #include <vector>
 #include <wx/busyinfo.h>
+#include <wx/dir.h>
+#include <wx/dirdlg.h>
 #include <wx/fdrepdlg.h>
+#include <wx/filedlg.h>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
 #include <wx/progdlg.h>
@@ -64,6 +68,9 @@ SFTPTreeView::SFTPTreeView(wxWindow* parent, SFTP* plugin)
 {
     m_view = new clRemoteDirCtrl(this);
     GetSizer()->Add(m_view, 1, wxEXPAND);
+    m_view->GetTree()->Bind(wxEVT_REMOTEDIR_DIR_CONTEXT_MENU_SHOWING, &SFTPTreeView::OnRemoteDirContextMenu, this);
+    Bind(wxEVT_SFTP_BATCH_TRANSFER_PROGRESS, &SFTPTreeView::OnBatchTransferProgress, this);
+    Bind(wxEVT_SFTP_BATCH_TRANSFER_DONE, &SFTPTreeView::OnBatchTransferDone, this);
 
     m_timer = new wxTimer(this);
     Bind(wxEVT_TIMER, &SFTPTreeView::OnKeepAliveTimer, this, m_timer->GetId());
@@ -115,6 +122,10 @@ SFTPTreeView::~SFTPTreeView()
     m_timer->Stop();
     Unbind(wxEVT_TIMER, &SFTPTreeView::OnKeepAliveTimer, this, m_timer->GetId());
     wxDELETE(m_timer);
+
+    m_view->GetTree()->Unbind(wxEVT_REMOTEDIR_DIR_CONTEXT_MENU_SHOWING, &SFTPTreeView::OnRemoteDirContextMenu, this);
+    Unbind(wxEVT_SFTP_BATCH_TRANSFER_PROGRESS, &SFTPTreeView::OnBatchTransferProgress, this);
+    Unbind(wxEVT_SFTP_BATCH_TRANSFER_DONE, &SFTPTreeView::OnBatchTransferDone, this);
 }
 
 void SFTPTreeView::OnDisconnect(wxCommandEvent& event) { DoCloseSession(); }
@@ -435,3 +446,100 @@ void SFTPTreeView::OnFindFinished(clCommandEvent& event) {}
 void SFTPTreeView::OnFindError(clCommandEvent& event) {}
 
 void SFTPTreeView::DoChangeLocation(const wxString& path) { m_view->SetNewRoot(path); }
+
+void SFTPTreeView::OnRemoteDirContextMenu(clContextMenuEvent& event)
+{
+    event.Skip();
+    wxMenu* menu = event.GetMenu();
+    CHECK_PTR_RET(menu);
+
+    wxString folder = m_view->GetSelectedFolder();
+    if (folder.empty()) {
+        return;
+    }
+
+    menu->AppendSeparator();
+    menu->Append(XRCID("sftp_upload_files"), _("Upload files..."));
+    menu->Append(XRCID("sftp_upload_folder"), _("Upload folder..."));
+    menu->Bind(
+        wxEVT_MENU, [this, folder](wxCommandEvent& e) { CallAfter(&SFTPTreeView::DoUpload, folder, false); },
+        XRCID("sftp_upload_files"));
+    menu->Bind(
+        wxEVT_MENU, [this, folder](wxCommandEvent& e) { CallAfter(&SFTPTreeView::DoUpload, folder, true); },
+        XRCID("sftp_upload_folder"));
+}
+
+void SFTPTreeView::DoUpload(const wxString& remoteFolder, bool uploadFolder)
+{
+    // the local files and the folder that their remote paths are relative to
+    wxArrayString localFiles;
+    wxString baseDir;
+    if (uploadFolder) {
+        wxString path = ::wxDirSelector(_("Select a folder to upload"));
+        if (path.empty()) {
+            return;
+        }
+        wxDir::GetAllFiles(path, &localFiles);
+        // keep the folder name on the remote side
+        wxFileName parentDir = wxFileName::DirName(path);
+        parentDir.RemoveLastDir();
+        baseDir = parentDir.GetPath();
+
+    } else {
+        wxFileDialog dlg(this, _("Select files to upload"), wxEmptyString, wxEmptyString, wxFileSelectorDefaultWildcardStr,
+                         wxFD_OPEN | wxFD_MULTIPLE | wxFD_FILE_MUST_EXIST);
+        if (dlg.ShowModal() != wxID_OK) {
+            return;
+        }
+        dlg.GetPaths(localFiles);
+        baseDir = dlg.GetDirectory();
+    }
+
+    if (localFiles.empty()) {
+        return;
+    }
+
+    SFTPUploadDialog dlg(EventNotifier::Get()->TopFrame());
+    dlg.SetRemoteFolder(remoteFolder);
+    if (dlg.ShowModal() != wxID_OK) {
+        return;
+    }
+
+    wxString targetFolder = dlg.GetRemoteFolder();
+    if (!targetFolder.EndsWith("/")) {
+        targetFolder << "/";
+    }
+
+    std::vector<clSFTPTransfer> transfers;
+    transfers.reserve(localFiles.size());
+    for (const wxString& localFile : localFiles) {
+        wxFileName fn(localFile);
+        fn.MakeRelativeTo(baseDir);
+
+        clSFTPTransfer transfer;
+        transfer.local_path = localFile;
+        transfer.remote_path = targetFolder + fn.GetFullPath(wxPATH_UNIX);
+        transfers.push_back(transfer);
+    }
+    clSFTPManager::Get().AsyncBatchTransfer(transfers, m_account.GetAccountName(), this);
+}
+
+void SFTPTreeView::OnBatchTransferProgress(clCommandEvent& event)
+{
+    wxString message;
+    message << _("SFTP: uploading files ") << event.GetInt() << "/" << event.GetExtraLong();
+    clGetManager()->SetStatusMessage(message);
+}
+
+void SFTPTreeView::OnBatchTransferDone(clCommandEvent& event)
+{
+    wxString message;
+    message << _("SFTP: uploaded ") << event.GetInt() << _(" files");
+    if (!event.GetStrings().empty()) {
+        message << ", " << event.GetStrings().size() << _(" failed");
+        for (const wxString& file : event.GetStrings()) {
+            clWARNING() << "SFTP: failed to upload file:" << file << endl;
+        }
+    }
+    clGetManager()->SetStatusMessage(message, 5);
+}
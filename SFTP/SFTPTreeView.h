@@ -79,6 +79,9 @@ protected:
     void OnDisconnectUI(wxUpdateUIEvent& event);
     void OnConnect(wxCommandEvent& event);
     void OnKeepAliveTimer(wxTimerEvent& event);
+    void OnRemoteDirContextMenu(clContextMenuEvent& event);
+    void OnBatchTransferProgress(clCommandEvent& event);
+    void OnBatchTransferDone(clCommandEvent& event);
 
     // Edit events
     void OnCopy(wxCommandEvent& event);
@@ -98,6 +101,10 @@ protected:
     void DoBuildTree(const wxString& initialFolder);
     void ManageBookmarks();
     void DoChangeLocation(const wxString& path);
+    /**
+     * @brief let the user pick local files (or a folder) and upload them to `remoteFolder`
+     */
+    void DoUpload(const wxString& remoteFolder, bool uploadFolder);
 
     bool GetAccountFromUser(SSHAccountInfo& account);
     //    SFTPSessionInfo& GetSession(bool createIfMissing);
@@ -9,6 +9,4 @@ SFTPUploadDialog::~SFTPUploadDialog()
 {
 }
 
-void SFTPUploadDialog::OnOKUI(wxUpdateUIEvent& event)
-{
-}
+void SFTPUploadDialog::OnOKUI(wxUpdateUIEvent& event) { event.Enable(GetRemoteFolder().StartsWith("/")); }
@@ -32,6 +32,10 @@ class SFTPUploadDialog : public SFTPUploadDialogBase
 public:
     SFTPUploadDialog(wxWindow* parent);
     virtual ~SFTPUploadDialog();
+
+    void SetRemoteFolder(const wxString& folder) { m_textCtrlRemoteFolder->ChangeValue(folder); }
+    wxString GetRemoteFolder() const { return m_textCtrlRemoteFolder->GetValue().Trim().Trim(false); }
+
 protected:
     virtual void OnOKUI(wxUpdateUIEvent& event);
 };
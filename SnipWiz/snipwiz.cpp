@@ -82,6 +82,7 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
     info.SetName(plugName);
     info.SetDescription(_("A small tool to add expandable code snippets and template classes"));
     info.SetVersion(wxT("v1.0"));
+    info.EnableFlag(PluginInfo::kLoadDeferred, true);
     return &info;
 }
 //------------------------------------------------------------
@@ -52,6 +52,7 @@
 #include "scGlobals.h"
 #include "spellcheck.h"
 
+#include <algorithm>
 #include <wx/arrimpl.cpp>
 #include <wx/filename.h>
 #include <wx/regex.h>
@@ -166,10 +167,34 @@ void HighlightWord(IEditor* editor, int pos)
     editor->SetUserIndicator(indicator_start, len);
 }
 
+/// the number of misspelled words the background check collects before passing them to the plugin
+constexpr size_t RESULTS_BATCH_SIZE = 200;
+
+/// returns true if the (UTF-8) byte is one of the words delimiters
+bool IsDelimiter(unsigned char ch)
+{
+    static const std::vector<bool> delimiters = []() {
+        std::vector<bool> table(128, false);
+        for (size_t i = 0; i < s_defDelimiters.length(); ++i) {
+            table[s_defDelimiters[i].GetValue()] = true;
+        }
+        return table;
+    }();
+    return ch < 0x80 && delimiters[ch];
+}
+
+const std::unordered_set<int>* FindAllowedStyles(std::unordered_map<int, std::unordered_set<int>>& table, int lexerId)
+{
+    auto iter = table.find(lexerId);
+    return iter == table.end() ? nullptr : &iter->second;
+}
+
 } // namespace
 
 // ------------------------------------------------------------
 #define MIN_TOKEN_LEN 3
+#define IS_STYLE_ALLOWED(pset, style_id) \
+    (!pset /* no limit */ || (pset && pset->count(style_id) /* we have a set -> it must contain the id*/))
 // ------------------------------------------------------------
 IHunSpell::IHunSpell()
     : m_caseSensitiveUserDictionary(true)
@@ -233,6 +258,8 @@ bool IHunSpell::InitEngine()
 // ------------------------------------------------------------
 void IHunSpell::CloseEngine()
 {
+    CancelCheck();
+    m_wordsCache.clear();
     if (m_pSpell != NULL) {
         Hunspell_destroy(m_pSpell);
         SaveUserDict(m_userDictPath + s_userDict);
@@ -243,6 +270,7 @@ void IHunSpell::CloseEngine()
 bool IHunSpell::CheckWord(const wxString& word) const
 {
     static thread_local wxRegEx rehex(s_dectHex, wxRE_ADVANCED);
+    std::lock_guard<std::mutex> lk{ m_mutex };
 
     // look in ignore list
     if (m_ignoreList.count(word) != 0)
@@ -252,11 +280,15 @@ bool IHunSpell::CheckWord(const wxString& word) const
     if (m_userDict.count(word) != 0)
         return true;
 
-    // see if hex number
-    if (rehex.Matches(word))
-        return true;
+    // the same words are checked over and over by the continuous check
+    auto iter = m_wordsCache.find(word);
+    if (iter != m_wordsCache.end())
+        return iter->second;
 
-    return Hunspell_spell(m_pSpell, word.ToUTF8()) != 0;
+    // see if hex number
+    bool isValid = rehex.Matches(word) || Hunspell_spell(m_pSpell, word.ToUTF8()) != 0;
+    m_wordsCache.insert({ word, isValid });
+    return isValid;
 }
 // ------------------------------------------------------------
 wxArrayString IHunSpell::GetSuggestions(const wxString& misspelled)
@@ -264,6 +296,7 @@ wxArrayString IHunSpell::GetSuggestions(const wxString& misspelled)
     wxArrayString suggestions;
     suggestions.Empty();
 
+    std::lock_guard<std::mutex> lk{ m_mutex };
     if (m_pSpell) {
         char** wlst;
 
@@ -307,9 +340,6 @@ void IHunSpell::CheckSpelling()
         COMMENT_STYLES = &ALLOWED_STYLES_COMMENTS[pEditor->GetLexerId()];
     }
 
-#define IS_STYLE_ALLOWED(pset, style_id) \
-    (!pset /* no limit */ || (pset && pset->count(style_id) /* we have a set -> it must contain the id*/))
-
     LOG_IF_TRACE { clDEBUG1() << "SpellChecker: checking file:" << pEditor->GetFileName() << endl; }
     for (size_t line_number = 0; line_number < lines.size(); ++line_number) {
         // Now parse each line separately
@@ -339,7 +369,7 @@ void IHunSpell::CheckSpelling()
                 continue;
 
             // process token
-            if (!CheckWord(token)) {
+            if (!CheckWord(token) && !IsSymbol(token)) {
                 HighlightWord(pEditor, pos + (token.length() / 2));
                 // pEditor->SetUserIndicator(pos, token.length());
 
@@ -375,7 +405,6 @@ void IHunSpell::CheckSpelling()
             }
         }
     }
-#undef IS_STYLE_ALLOWED
 
     LOG_IF_TRACE { clDEBUG1() << "SpellChecker:: checking file:" << pEditor->GetFileName() << "is done" << endl; }
     if (!m_pPlugIn->GetCheckContinuous()) {
@@ -387,6 +416,129 @@ void IHunSpell::CheckSpelling()
     }
 }
 // ------------------------------------------------------------
+void IHunSpell::CheckSpellingAsync(IEditor* editor)
+{
+    CHECK_PTR_RET(editor);
+    CancelCheck();
+    CHECK_COND_RET(InitEngine());
+    ++m_checkId;
+
+    // snapshot the text together with its styles
+    wxStyledTextCtrl* ctrl = editor->GetCtrl();
+    wxMemoryBuffer buffer = ctrl->GetStyledText(0, ctrl->GetLength());
+    std::string styled(static_cast<const char*>(buffer.GetData()), buffer.GetDataLen());
+
+    int firstLine = ctrl->DocLineFromVisible(ctrl->GetFirstVisibleLine());
+    int lastLine = ctrl->DocLineFromVisible(ctrl->GetFirstVisibleLine() + ctrl->LinesOnScreen());
+    size_t length = styled.length() / 2;
+    size_t visibleStart = std::min<size_t>(ctrl->PositionFromLine(firstLine), length);
+    size_t visibleEnd = std::max(visibleStart, std::min<size_t>(ctrl->GetLineEndPosition(lastLine), length));
+
+    const std::unordered_set<int>* stringStyles = FindAllowedStyles(ALLOWED_STYLES_STRINGS, editor->GetLexerId());
+    const std::unordered_set<int>* commentStyles = FindAllowedStyles(ALLOWED_STYLES_COMMENTS, editor->GetLexerId());
+
+    LOG_IF_TRACE { clDEBUG1() << "SpellChecker: background check of file:" << editor->GetFileName() << endl; }
+    m_checkThread = std::thread(&IHunSpell::CheckStyledText, this, m_checkId, std::move(styled), visibleStart,
+                                visibleEnd, stringStyles, commentStyles);
+}
+// ------------------------------------------------------------
+void IHunSpell::CheckStyledText(size_t checkId, const std::string& styled, size_t visibleStart, size_t visibleEnd,
+                                const std::unordered_set<int>* stringStyles,
+                                const std::unordered_set<int>* commentStyles)
+{
+    SpellingResults batch;
+    batch.checkId = checkId;
+    batch.first = true;
+    auto flush = [&]() {
+        if (m_cancelCheck.load()) {
+            return;
+        }
+        // the first batch is sent even if it is empty: the plugin replaces the previous indicators when it arrives
+        m_pPlugIn->CallAfter(&SpellCheck::OnSpellingResults, batch);
+        batch.words.clear();
+        batch.first = false;
+    };
+
+    auto check_range = [&](size_t start, size_t end) {
+        std::string utf8;
+        size_t pos = start;
+        while (pos < end && !m_cancelCheck.load()) {
+            while (pos < end && IsDelimiter(styled[pos * 2])) {
+                ++pos;
+            }
+            size_t tokenStart = pos;
+            utf8.clear();
+            while (pos < end && !IsDelimiter(styled[pos * 2])) {
+                utf8 += styled[pos * 2];
+                ++pos;
+            }
+            if (utf8.empty()) {
+                continue;
+            }
+
+            // Check the style at the middle of the token
+            int style_at_pos = static_cast<unsigned char>(styled[(tokenStart + utf8.length() / 2) * 2 + 1]);
+            if (!IS_STYLE_ALLOWED(stringStyles, style_at_pos) && !IS_STYLE_ALLOWED(commentStyles, style_at_pos))
+                continue;
+
+            wxString token = wxString::FromUTF8(utf8.c_str(), utf8.length());
+            if (token.length() <= MIN_TOKEN_LEN || CheckWord(token))
+                continue;
+
+            MisspelledWord word;
+            word.pos = tokenStart;
+            word.len = utf8.length();
+            word.word = token;
+            batch.words.push_back(word);
+            if (batch.words.size() >= RESULTS_BATCH_SIZE) {
+                flush();
+            }
+        }
+    };
+
+    size_t length = styled.length() / 2;
+    check_range(visibleStart, visibleEnd);
+    flush();
+    check_range(visibleEnd, length);
+    check_range(0, visibleStart);
+    if (!batch.words.empty()) {
+        flush();
+    }
+}
+// ------------------------------------------------------------
+void IHunSpell::CancelCheck()
+{
+    if (m_checkThread.joinable()) {
+        m_cancelCheck.store(true);
+        m_checkThread.join();
+    }
+    m_cancelCheck.store(false);
+}
+// ------------------------------------------------------------
+void IHunSpell::MarkMisspelled(IEditor* editor, const MisspelledWords& words)
+{
+    for (const MisspelledWord& word : words) {
+        if (!IsSymbol(word.word)) {
+            HighlightWord(editor, word.pos + (word.len / 2));
+        }
+    }
+}
+// ------------------------------------------------------------
+bool IHunSpell::IsSymbol(const wxString& word)
+{
+    if (!m_ignoreSymbolsInTagsDatabase)
+        return false;
+
+    auto iter = m_symbolsCache.find(word);
+    if (iter != m_symbolsCache.end())
+        return iter->second;
+
+    std::vector<TagEntryPtr> tags;
+    TagsManagerST::Get()->FindSymbol(word, tags);
+    m_symbolsCache.insert({ word, !tags.empty() });
+    return !tags.empty();
+}
+// ------------------------------------------------------------
 // tools
 // ------------------------------------------------------------
 
@@ -396,6 +548,7 @@ void IHunSpell::AddWordToIgnoreList(const wxString& word)
     if (word.IsEmpty())
         return;
 
+    std::lock_guard<std::mutex> lk{ m_mutex };
     m_ignoreList.insert(word);
 }
 // ------------------------------------------------------------
@@ -404,6 +557,7 @@ void IHunSpell::AddWordToUserDict(const wxString& word)
     if (word.IsEmpty())
         return;
 
+    std::lock_guard<std::mutex> lk{ m_mutex };
     m_userDict.insert(word);
 }
 // ------------------------------------------------------------
@@ -561,6 +715,7 @@ void IHunSpell::EnableScannerType(int type, bool state)
 void IHunSpell::SetCaseSensitiveUserDictionary(const bool caseSensitiveUserDictionary)
 {
     if (caseSensitiveUserDictionary != m_caseSensitiveUserDictionary) {
+        std::lock_guard<std::mutex> lk{ m_mutex };
         m_caseSensitiveUserDictionary = caseSensitiveUserDictionary;
 
         // Re-order user dictionary and ignores.
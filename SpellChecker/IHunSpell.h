@@ -38,7 +38,12 @@
 // ------------------------------------------------------------
 #include "wxStringHash.h"
 
+#include <atomic>
 #include <hunspell/hunspell.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -49,6 +54,21 @@ WX_DECLARE_STRING_HASH_MAP(wxString, languageMap);
 typedef std::pair<int, int> posLen;
 typedef std::pair<posLen, int> parseEntry;
 typedef std::vector<parseEntry> partList;
+
+/// a word reported by the background check, the position and the length are in bytes (editor positions)
+struct MisspelledWord {
+    int pos = 0;
+    int len = 0;
+    wxString word;
+};
+typedef std::vector<MisspelledWord> MisspelledWords;
+
+/// a batch of results of the background check
+struct SpellingResults {
+    size_t checkId = 0;
+    bool first = false; ///< the first batch holds the visible lines results
+    MisspelledWords words;
+};
 // ------------------------------------------------------------
 class CorrectSpellingDlg;
 class SpellCheck;
@@ -116,6 +136,17 @@ public:
     wxArrayString GetSuggestions(const wxString& misspelled);
     /// makes a spell check for the given plain text. Canceled is set to true when the user cancels.
     void CheckSpelling();
+    /// checks a snapshot of the editor text on a worker thread, the visible lines are checked first. The misspelled
+    /// words are passed to SpellCheck::OnSpellingResults() in batches
+    void CheckSpellingAsync(IEditor* editor);
+    /// stops the background check, if any
+    void CancelCheck();
+    /// returns the id of the last background check
+    size_t GetCheckId() const { return m_checkId; }
+    /// highlights the misspelled words that are not known symbols
+    void MarkMisspelled(IEditor* editor, const MisspelledWords& words);
+    /// forgets the symbols found (or not) in the tags database
+    void ClearSymbolsCache() { m_symbolsCache.clear(); }
     /// checks for predefined language names, which could be found in path
     void GetAvailableLanguageKeyNames(const wxString& path, wxArrayString& lang);
     /// returns the base filename for language key without extension
@@ -134,6 +165,7 @@ public:
     void SetIgnoreSymbolsInTagsDatabase(const bool ignoreSymbolsInTagsDatabase)
     {
         m_ignoreSymbolsInTagsDatabase = ignoreSymbolsInTagsDatabase;
+        m_symbolsCache.clear();
     }
     /// gets whether to ignore words that match ctags symbols
     bool GetIgnoreSymbolsInTagsDatabase() const { return m_ignoreSymbolsInTagsDatabase; }
@@ -177,6 +209,11 @@ protected:
 
     bool LoadUserDict(const wxString& filename);
     bool SaveUserDict(const wxString& filename);
+    /// returns true if the word is a symbol found in the tags database (and the option to ignore them is set)
+    bool IsSymbol(const wxString& word);
+    /// the background check, `styled` holds a (character, style) pair of bytes per editor position
+    void CheckStyledText(size_t checkId, const std::string& styled, size_t visibleStart, size_t visibleEnd,
+                         const std::unordered_set<int>* stringStyles, const std::unordered_set<int>* commentStyles);
 
     wxString m_dicPath;      // dictionary path
     wxString m_dictionary;   // dictionary base filename
@@ -194,5 +231,12 @@ protected:
     partList m_parseValues; // list with position results for CPP parsing
 
     int m_scanners; // flags for scanner types
+
+    mutable std::mutex m_mutex; // guards the hunspell handle, the user words, the ignore list and the words cache
+    mutable std::unordered_map<wxString, bool> m_wordsCache; // hunspell results for this session
+    std::unordered_map<wxString, bool> m_symbolsCache;       // tags database lookups, used from the main thread only
+    std::thread m_checkThread;
+    std::atomic_bool m_cancelCheck{ false };
+    size_t m_checkId = 0;
 };
 #endif // _HUNSPELLINTERFACE_
@@ -249,6 +249,7 @@ void SpellCheck::UnPlug()
     if(m_timer.IsRunning()) {
         m_timer.Stop();
     }
+    m_pEngine->CancelCheck();
 }
 
 // ------------------------------------------------------------
@@ -373,10 +374,7 @@ void SpellCheck::OnContinuousCheck(wxCommandEvent& e)
     IEditor* editor = m_mgr->GetActiveEditor();
     CHECK_PTR_RET(editor);
 
-    m_pEngine->CheckSpelling();
-    if(!GetCheckContinuous()) {
-        editor->ClearUserIndicators();
-    }
+    DoCheckContinuous(editor);
     m_timer.Start(PARSE_TIME);
 }
 
@@ -399,13 +397,36 @@ void SpellCheck::OnTimer(wxTimerEvent& e)
         return;
     }
 
-    m_pLastEditor = editor;
-    m_lastModificationCount = modificationCount;
-    m_pLastEditor->ClearUserIndicators();
-    m_pEngine->CheckSpelling();
+    DoCheckContinuous(editor);
     m_forceCheck = false; // consume it
 }
 
+// ------------------------------------------------------------
+void SpellCheck::DoCheckContinuous(IEditor* editor)
+{
+    // the indicators are replaced once the results of the visible lines arrive
+    m_pLastEditor = editor;
+    m_lastModificationCount = editor->GetModificationCount();
+    m_pEngine->CheckSpellingAsync(editor);
+}
+
+// ------------------------------------------------------------
+void SpellCheck::OnSpellingResults(const SpellingResults& results)
+{
+    CHECK_COND_RET(GetCheckContinuous());
+    CHECK_COND_RET(results.checkId == m_pEngine->GetCheckId());
+
+    // the results positions are valid only if the editor was not modified since the check started
+    IEditor* editor = m_mgr->GetActiveEditor();
+    CHECK_PTR_RET(editor);
+    CHECK_COND_RET(editor == m_pLastEditor && editor->GetModificationCount() == m_lastModificationCount);
+
+    if(results.first) {
+        editor->ClearUserIndicators();
+    }
+    m_pEngine->MarkMisspelled(editor, results.words);
+}
+
 // ------------------------------------------------------------
 void SpellCheck::SetCheckContinuous(bool value)
 {
@@ -424,6 +445,7 @@ void SpellCheck::SetCheckContinuous(bool value)
         if(m_timer.IsRunning()) {
             m_timer.Stop();
         }
+        m_pEngine->CancelCheck();
         if(btn) {
             btn->Check(false);
             clGetManager()->GetToolBar()->Refresh();
@@ -435,11 +457,16 @@ void SpellCheck::SetCheckContinuous(bool value)
 void SpellCheck::OnWspLoaded(clWorkspaceEvent& e)
 {
     m_currentWspPath = e.GetString();
+    m_pEngine->ClearSymbolsCache();
     e.Skip();
 }
 
 // ------------------------------------------------------------
-void SpellCheck::OnWspClosed(clWorkspaceEvent& e) { e.Skip(); }
+void SpellCheck::OnWspClosed(clWorkspaceEvent& e)
+{
+    m_pEngine->ClearSymbolsCache();
+    e.Skip();
+}
 // ------------------------------------------------------------
 void SpellCheck::OnSuggestion(wxCommandEvent& e)
 {
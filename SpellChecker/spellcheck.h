@@ -43,6 +43,7 @@
 #include <wx/timer.h>
 //------------------------------------------------------------
 class IHunSpell;
+struct SpellingResults;
 class SpellCheck : public IPlugin
 {
 public:
@@ -71,6 +72,8 @@ public:
     void OnSuggestion(wxCommandEvent& e);
     void OnIgnoreWord(wxCommandEvent& e);
     void OnAddWord(wxCommandEvent& e);
+    /// called with the results of the background check
+    void OnSpellingResults(const SpellingResults& results);
 
     wxMenuItem* m_sepItem;
     wxEvtHandler* m_topWin;
@@ -82,6 +85,7 @@ protected:
     void LoadSettings();
     void SaveSettings();
     void ClearIndicatorsFromEditors();
+    void DoCheckContinuous(IEditor* editor);
     void OnContextMenu(clContextMenuEvent& e);
     void AppendSubMenuItems(wxMenu& subMenu);
 
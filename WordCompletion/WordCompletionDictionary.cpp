@@ -59,7 +59,11 @@ void WordCompletionDictionary::OnEditorChanged(wxCommandEvent& event)
                         std::back_inserter(closedEditors));
 
     for(size_t i = 0; i < closedEditors.size(); ++i) {
-        m_files.erase(closedEditors.Item(i));
+        std::map<wxString, wxStringSet_t>::iterator iter = m_files.find(closedEditors.Item(i));
+        if(iter != m_files.end()) {
+            m_index.Remove(iter->second);
+            m_files.erase(iter);
+        }
     }
 
     // 2: cache the active editor
@@ -68,18 +72,22 @@ void WordCompletionDictionary::OnEditorChanged(wxCommandEvent& event)
 
 void WordCompletionDictionary::OnSuggestThread(const WordCompletionThreadReply& reply)
 {
-    // Remove the current file's dictionary
     std::map<wxString, wxStringSet_t>::iterator iter = m_files.find(reply.filename.GetFullPath());
-    if(iter != m_files.end()) m_files.erase(iter);
+    if(iter == m_files.end()) {
+        // The file was closed while it was being parsed
+        return;
+    }
 
-    // Keep the words
-    m_files.insert(std::make_pair(reply.filename.GetFullPath(), reply.suggest));
+    // Replace the file's contribution to the index with the new words
+    m_index.Update(iter->second, reply.suggest);
+    iter->second = reply.suggest;
 }
 
 void WordCompletionDictionary::OnAllEditorsClosed(wxCommandEvent& event)
 {
     event.Skip();
     m_files.clear();
+    m_index.Clear();
 }
 
 void WordCompletionDictionary::DoCacheActiveEditor(bool overwrite)
@@ -90,12 +98,11 @@ void WordCompletionDictionary::DoCacheActiveEditor(bool overwrite)
 
     if(!overwrite && m_files.count(activeEditor->GetFileName().GetFullPath()))
         return; // we already have this file in the cache
-        
-    m_files.erase(activeEditor->GetFileName().GetFullPath());
-    
-    // Insert a dummy entry, so we won't queue this file if not needed
+
+    // Insert a dummy entry, so we won't queue this file if not needed.
+    // When overwriting, the current words are kept in the index until the new ones arrive
     m_files.insert(std::make_pair(activeEditor->GetFileName().GetFullPath(), wxStringSet_t()));
-    
+
     // Queue this file
     wxStyledTextCtrl* stc = activeEditor->GetCtrl();
     
@@ -112,12 +119,3 @@ void WordCompletionDictionary::OnFileSaved(clCommandEvent& event)
     event.Skip();
     DoCacheActiveEditor(true);
 }
-
-wxStringSet_t WordCompletionDictionary::GetWords() const
-{
-    wxStringSet_t words;
-    for (const auto& p : m_files) {
-        words.insert(p.second.begin(), p.second.end());
-    }
-    return words;
-}
@@ -31,11 +31,13 @@
 #include <wx/event.h>
 #include "WordCompletionThread.h"
 #include "WordCompletionRequestReply.h"
+#include "WordCompletionIndex.h"
 #include "cl_command_event.h"
 
 class WordCompletionDictionary : public wxEvtHandler
 {
     std::map<wxString, wxStringSet_t> m_files;
+    WordCompletionIndex m_index;
     WordCompletionThread* m_thread;
 
 protected:
@@ -57,9 +59,9 @@ public:
     void OnSuggestThread(const WordCompletionThreadReply& reply);
     
     /**
-     * @brief return a set of words from the current editors
+     * @brief return the index of words collected from the current editors
      */
-    wxStringSet_t GetWords() const;
+    const WordCompletionIndex& GetIndex() const { return m_index; }
 };
 
 #endif // WORDCOMPLETIONDICTIONARY_H
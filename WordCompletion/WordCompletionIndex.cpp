@@ -0,0 +1,90 @@
+#include "WordCompletionIndex.h"
+
+void WordCompletionIndex::DoAdd(const wxString& word)
+{
+    RefCountMap_t& refs = m_index[word.Lower()];
+    ++refs[word];
+}
+
+void WordCompletionIndex::DoRemove(const wxString& word)
+{
+    Index_t::iterator iter = m_index.find(word.Lower());
+    if(iter == m_index.end()) {
+        return;
+    }
+
+    RefCountMap_t& refs = iter->second;
+    RefCountMap_t::iterator refIter = refs.find(word);
+    if(refIter == refs.end()) {
+        return;
+    }
+
+    if(--refIter->second == 0) {
+        refs.erase(refIter);
+        if(refs.empty()) {
+            m_index.erase(iter);
+        }
+    }
+}
+
+void WordCompletionIndex::Add(const wxStringSet_t& words)
+{
+    for(const wxString& word : words) {
+        DoAdd(word);
+    }
+}
+
+void WordCompletionIndex::Remove(const wxStringSet_t& words)
+{
+    for(const wxString& word : words) {
+        DoRemove(word);
+    }
+}
+
+void WordCompletionIndex::Update(const wxStringSet_t& before, const wxStringSet_t& after)
+{
+    // Saving a file usually changes only a handful of words, so apply the delta only
+    for(const wxString& word : before) {
+        if(after.count(word) == 0) {
+            DoRemove(word);
+        }
+    }
+
+    for(const wxString& word : after) {
+        if(before.count(word) == 0) {
+            DoAdd(word);
+        }
+    }
+}
+
+void WordCompletionIndex::FindStartsWith(const wxString& lcFilter, wxStringSet_t& matches) const
+{
+    // All the keys that start with 'lcFilter' are placed in a continuous range
+    // that starts at the first key which is not less than the filter
+    Index_t::const_iterator iter = m_index.lower_bound(lcFilter);
+    for(; iter != m_index.end() && iter->first.StartsWith(lcFilter); ++iter) {
+        for(const auto& p : iter->second) {
+            matches.insert(p.first);
+        }
+    }
+}
+
+void WordCompletionIndex::FindContains(const wxString& lcFilter, wxStringSet_t& matches) const
+{
+    for(const auto& p : m_index) {
+        if(p.first.Contains(lcFilter)) {
+            for(const auto& ref : p.second) {
+                matches.insert(ref.first);
+            }
+        }
+    }
+}
+
+void WordCompletionIndex::GetAll(wxStringSet_t& words) const
+{
+    for(const auto& p : m_index) {
+        for(const auto& ref : p.second) {
+            words.insert(ref.first);
+        }
+    }
+}
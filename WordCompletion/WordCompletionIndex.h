@@ -0,0 +1,76 @@
+#ifndef WORDCOMPLETIONINDEX_H
+#define WORDCOMPLETIONINDEX_H
+
+#include "macros.h"
+
+#include <map>
+#include <wx/string.h>
+
+/**
+ * @brief a reference counted, sorted index of all the words collected from the open editors.
+ * Each file contributes its words with Add() and withdraws them with Remove(), so
+ * a word stays in the index as long as at least one file references it.
+ * Words are kept ordered by their lower case form, so prefix queries are answered
+ * with a single range scan and without copying the entire word list
+ */
+class WordCompletionIndex
+{
+    // lower case word -> { word -> reference count }
+    typedef std::map<wxString, size_t> RefCountMap_t;
+    typedef std::map<wxString, RefCountMap_t> Index_t;
+    Index_t m_index;
+
+public:
+    WordCompletionIndex() = default;
+    ~WordCompletionIndex() = default;
+
+    /**
+     * @brief add a reference for every word in 'words'
+     */
+    void Add(const wxStringSet_t& words);
+
+    /**
+     * @brief drop a reference for every word in 'words'. Words that are no longer
+     * referenced by any file are removed from the index
+     */
+    void Remove(const wxStringSet_t& words);
+
+    /**
+     * @brief replace the contribution of a file: 'before' are the words previously added for it
+     * and 'after' are its new words. Only the difference between the two sets is applied
+     */
+    void Update(const wxStringSet_t& before, const wxStringSet_t& after);
+
+    /**
+     * @brief clear the index
+     */
+    void Clear() { m_index.clear(); }
+
+    /**
+     * @brief return true if the index is empty
+     */
+    bool IsEmpty() const { return m_index.empty(); }
+
+    /**
+     * @brief add all words whose lower case form starts with 'lcFilter' into 'matches'
+     * @param lcFilter the filter, in lower case
+     */
+    void FindStartsWith(const wxString& lcFilter, wxStringSet_t& matches) const;
+
+    /**
+     * @brief add all words whose lower case form contains 'lcFilter' into 'matches'
+     * @param lcFilter the filter, in lower case
+     */
+    void FindContains(const wxString& lcFilter, wxStringSet_t& matches) const;
+
+    /**
+     * @brief add all the words in the index into 'words'
+     */
+    void GetAll(wxStringSet_t& words) const;
+
+private:
+    void DoAdd(const wxString& word);
+    void DoRemove(const wxString& word);
+};
+
+#endif // WORDCOMPLETIONINDEX_H
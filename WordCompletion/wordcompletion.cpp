@@ -105,21 +105,19 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
 
     wxString filter = event.GetWord().Lower(); // stc->GetTextRange(start, curPos);
 
-    wxStringSet_t words = m_dictionary->GetWords();
+    // Words that are not part of the index: the unsaved buffer and the language keywords
+    wxStringSet_t words;
+
     // Parse the current buffer (if modified), to include non saved words
     if(activeEditor->IsEditorModified()) {
         // For performance (this parsing is done in the main thread)
         // only parse the visible area of the document
-        wxStringSet_t unsavedBufferWords;
         wxStyledTextCtrl* stc = activeEditor->GetCtrl();
         int startPos = stc->PositionFromLine(stc->GetFirstVisibleLine());
         int endPos = stc->GetCurrentPos();
 
         wxString buffer = stc->GetTextRange(startPos, endPos);
-        WordCompletionThread::ParseBuffer(buffer, unsavedBufferWords);
-
-        // Merge the results
-        words.insert(unsavedBufferWords.begin(), unsavedBufferWords.end());
+        WordCompletionThread::ParseBuffer(buffer, words);
     }
 
     // Get the editor keywords and add them
@@ -133,14 +131,26 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
         words.insert(langWords.begin(), langWords.end());
     }
 
+    const WordCompletionIndex& index = m_dictionary->GetIndex();
+    bool startsWith = settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith;
+
     wxStringSet_t filteredSet;
     if(filter.IsEmpty()) {
         filteredSet.swap(words);
+        index.GetAll(filteredSet);
     } else {
+        // Query the shared index directly, this only copies the matching words
+        if(startsWith) {
+            index.FindStartsWith(filter, filteredSet);
+        } else {
+            index.FindContains(filter, filteredSet);
+        }
+        filteredSet.erase(filter);
+
         for(wxStringSet_t::iterator iter = words.begin(); iter != words.end(); ++iter) {
-            wxString word = *iter;
+            const wxString& word = *iter;
             wxString lcWord = word.Lower();
-            if(settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith) {
+            if(startsWith) {
                 if(lcWord.StartsWith(filter) && filter != word) {
                     filteredSet.insert(word);
                 }
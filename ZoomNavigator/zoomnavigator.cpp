@@ -66,26 +66,6 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
 
 CL_PLUGIN_API int GetPluginInterfaceVersion() { return PLUGIN_INTERFACE_VERSION; }
 
-namespace
-{
-/// @[param]in ctrl the control
-/// @[param]in marker_mask marker type to check
-std::vector<int> GetMarkers(wxStyledTextCtrl& ctrl, marker_mask_type marker_mask)
-{
-    std::vector<int> lines;
-    int nFoundLine = 0;
-    while (true) {
-        nFoundLine = ctrl.MarkerNext(nFoundLine, marker_mask);
-        if (nFoundLine == wxNOT_FOUND) {
-            break;
-        }
-        lines.push_back(nFoundLine);
-        ++nFoundLine;
-    }
-    return lines;
-}
-} // namespace
-
 ZoomNavigator::ZoomNavigator(IManager* manager)
     : IPlugin(manager)
     , m_config(new clConfig("zoom-navigator.conf"))
@@ -181,10 +161,6 @@ void ZoomNavigator::DoUpdate()
     CHECK_CONDITION(stc);
     CHECK_CONDITION(stc->IsShown());
 
-    // locate any error and warning markers in the main editor and duplicate then into the zoomed view
-    m_text->UpdateMarkers(GetMarkers(*stc, mmt_error), ZoomText::MarkerType::Error);
-    m_text->UpdateMarkers(GetMarkers(*stc, mmt_warning), ZoomText::MarkerType::Warning);
-
     if (curEditor->GetFileName().GetFullPath() != m_curfile) {
         SetEditorText(curEditor);
     }
@@ -204,7 +180,6 @@ void ZoomNavigator::SetEditorText(IEditor* editor)
     m_text->UpdateText(editor);
     if (editor) {
         m_curfile = editor->GetFileName().GetFullPath();
-        m_text->UpdateLexer(editor);
     }
 }
 
@@ -222,7 +197,6 @@ void ZoomNavigator::SetZoomTextScrollPosToMiddle(wxStyledTextCtrl& stc)
         first = 0;
 
     m_text->SetFirstVisibleLine(first);
-    m_text->ClearSelections();
 }
 
 void ZoomNavigator::PatchUpHighlights(const int first, const int last)
@@ -304,8 +278,7 @@ void ZoomNavigator::OnFileSaved(clCommandEvent& e)
     e.Skip();
 
     if (e.GetString() == m_curfile) {
-        // Update the file content
-        m_curfile.Clear();
+        // The content is shared with the editor, so it is already up to date. Just re-sync the view
         m_markerFirstLine = m_markerLastLine = wxNOT_FOUND; // forces a scrolling
         DoUpdate();
     }
@@ -334,7 +307,6 @@ void ZoomNavigator::OnInitDone(wxCommandEvent& e)
 {
     e.Skip();
     m_startupCompleted = true;
-    m_text->Startup();
 }
 
 void ZoomNavigator::OnIdle(wxIdleEvent& e) { e.Skip(); }
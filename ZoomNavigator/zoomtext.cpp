@@ -37,6 +37,7 @@
 #include "cl_config.h"
 #include "editor_config.h"
 #include "event_notifier.h"
+#include "file_logger.h"
 #include "fileextmanager.h"
 #include "globals.h"
 #include "lexer_configuration.h"
@@ -45,27 +46,14 @@
 #include "znSettingsDlg.h"
 #include "zn_config_item.h"
 
-#include <vector>
 #include <wx/app.h>
+#include <wx/dnd.h>
 #include <wx/settings.h>
-#include <wx/timer.h>
 #include <wx/xrc/xmlres.h>
 
 namespace
 {
-static constexpr int TIMER_DELAY = 150;
-static constexpr int FIRST_LINE_MARKER = 1;
-
-sci_marker_types ToSciMarkerTypes(ZoomText::MarkerType type)
-{
-    switch (type) {
-    default:
-    case ZoomText::MarkerType::Error:
-        return smt_error;
-    case ZoomText::MarkerType::Warning:
-        return smt_warning;
-    }
-}
+static constexpr int HIGHLIGHT_ALPHA = 50;
 } // namespace
 
 ZoomText::ZoomText(wxWindow* parent, wxWindowID id, const wxPoint& pos, const wxSize& size, long style,
@@ -88,7 +76,10 @@ ZoomText::ZoomText(wxWindow* parent, wxWindowID id, const wxPoint& pos, const wx
     SetEditable(false);
     SetUseHorizontalScrollBar(false);
     SetUseVerticalScrollBar(data.IsUseScrollbar());
-    HideSelection(true);
+
+    // The visible part of the editor is highlighted using the selection: unlike markers,
+    // the selection belongs to the view and not to the (shared) document
+    SetSelEOLFilled(true);
 
     SetMarginWidth(1, 0);
     SetMarginWidth(2, 0);
@@ -100,8 +91,19 @@ ZoomText::ZoomText(wxWindow* parent, wxWindowID id, const wxPoint& pos, const wx
     EventNotifier::Get()->Bind(wxEVT_ZN_SETTINGS_UPDATED, &ZoomText::OnSettingsChanged, this);
     EventNotifier::Get()->Bind(wxEVT_CL_THEME_CHANGED, &ZoomText::OnThemeChanged, this);
 
-    MarkerDefine(FIRST_LINE_MARKER, wxSTC_MARK_BACKGROUND, m_colour, m_colour);
-
+    // The view is attached to the editor's document, so it must never modify it. The read-only flag belongs to the
+    // document and would lock the editor as well: block every input that can edit the text instead
+    UsePopUp(wxSTC_POPUP_NEVER);
+    Bind(wxEVT_KEY_DOWN, &ZoomText::OnKeyboardInput, this);
+    Bind(wxEVT_CHAR, &ZoomText::OnKeyboardInput, this);
+    Bind(wxEVT_MIDDLE_DOWN, [](wxMouseEvent& e) { wxUnusedVar(e); });
+    Bind(wxEVT_CONTEXT_MENU, [](wxContextMenuEvent& e) { wxUnusedVar(e); });
+    Bind(wxEVT_STC_START_DRAG, &ZoomText::OnStartDrag, this);
+    Bind(wxEVT_STC_DO_DROP, &ZoomText::OnDoDrop, this);
+    Bind(wxEVT_SET_FOCUS, &ZoomText::OnSetFocus, this);
+    Bind(wxEVT_STC_MODIFIED, &ZoomText::OnModified, this);
+
+    // Error and warning markers are part of the editor's document, we only define how to display them here
     MarkerDefine(smt_warning, wxSTC_MARK_SHORTARROW);
     MarkerSetForeground(smt_error, wxColor(128, 128, 0));
     MarkerSetBackground(smt_warning, wxColor(255, 215, 0));
@@ -117,9 +119,6 @@ ZoomText::ZoomText(wxWindow* parent, wxWindowID id, const wxPoint& pos, const wx
     SetBufferedDraw(false);
     SetLayoutCache(wxSTC_CACHE_DOCUMENT);
 #endif
-
-    m_timer = new wxTimer(this);
-    Bind(wxEVT_TIMER, &ZoomText::OnTimer, this, m_timer->GetId());
     Show();
 }
 
@@ -127,12 +126,13 @@ ZoomText::~ZoomText()
 {
     EventNotifier::Get()->Unbind(wxEVT_ZN_SETTINGS_UPDATED, &ZoomText::OnSettingsChanged, this);
     EventNotifier::Get()->Unbind(wxEVT_CL_THEME_CHANGED, &ZoomText::OnThemeChanged, this);
-    Unbind(wxEVT_TIMER, &ZoomText::OnTimer, this, m_timer->GetId());
-
-    if (m_timer->IsRunning()) {
-        m_timer->Stop();
-    }
-    wxDELETE(m_timer);
+    Unbind(wxEVT_KEY_DOWN, &ZoomText::OnKeyboardInput, this);
+    Unbind(wxEVT_CHAR, &ZoomText::OnKeyboardInput, this);
+    Unbind(wxEVT_STC_START_DRAG, &ZoomText::OnStartDrag, this);
+    Unbind(wxEVT_STC_DO_DROP, &ZoomText::OnDoDrop, this);
+    Unbind(wxEVT_SET_FOCUS, &ZoomText::OnSetFocus, this);
+    Unbind(wxEVT_STC_MODIFIED, &ZoomText::OnModified, this);
+    DoDetach();
 }
 
 void ZoomText::UpdateLexer(IEditor* editor)
@@ -145,6 +145,17 @@ void ZoomText::UpdateLexer(IEditor* editor)
         return;
     }
 
+    // Applying a lexer modifies the document (its lexer and keywords). Apply it while the view
+    // is detached so the editor's document is left untouched, the style definitions are kept
+    // by the view when it is attached again
+    DoDetach();
+    DoApplyLexer(editor);
+    m_editorCtrl = editor->GetCtrl();
+    SetDocPointer(m_editorCtrl->GetDocPointer());
+}
+
+void ZoomText::DoApplyLexer(IEditor* editor)
+{
     znConfigItem data;
     clConfig conf("zoom-navigator.conf");
     conf.ReadItem(&data);
@@ -156,13 +167,12 @@ void ZoomText::UpdateLexer(IEditor* editor)
     }
     lexer->Apply(this, true);
 
-    MarkerSetAlpha(FIRST_LINE_MARKER, 30);
+    SetSelBackground(true, m_colour);
+    SetSelAlpha(HIGHLIGHT_ALPHA);
 
     SetZoom(m_zoomFactor);
-    SetEditable(false);
     SetUseHorizontalScrollBar(false);
     SetUseVerticalScrollBar(data.IsUseScrollbar());
-    HideSelection(true);
     SetSTCCursor(wxSTC_CURSORARROW);
 }
 
@@ -175,11 +185,10 @@ void ZoomText::OnSettingsChanged(wxCommandEvent& e)
         m_zoomFactor = data.GetZoomFactor();
         m_colour = data.GetHighlightColour();
 
-        MarkerSetBackground(FIRST_LINE_MARKER, m_colour);
-        MarkerSetAlpha(FIRST_LINE_MARKER, 50);
+        SetSelBackground(true, m_colour);
+        SetSelAlpha(HIGHLIGHT_ALPHA);
 
         SetZoom(m_zoomFactor);
-        Colourise(0, wxSTC_INVALID_POSITION);
     }
 }
 
@@ -189,10 +198,8 @@ void ZoomText::UpdateText(IEditor* editor)
         DoClear();
 
     } else {
-        SetReadOnly(false);
-        SetText(editor->GetEditorText());
-        SetReadOnly(true);
-        SetCurrentPos(editor->GetCurrentPosition());
+        // No copy is made here: the view is attached to the editor's document
+        UpdateLexer(editor);
     }
 }
 
@@ -207,11 +214,9 @@ void ZoomText::HighlightLines(int start, int end)
             start = 0;
     }
 
-    MarkerDeleteAll(FIRST_LINE_MARKER);
-
-    for (int i = start; i <= end; ++i) {
-        MarkerAdd(i, FIRST_LINE_MARKER);
-    }
+    // SetAnchor() and SetCurrentPos() do not scroll the view
+    SetAnchor(PositionFromLine(start));
+    SetCurrentPos(GetLineEndPosition(end));
 }
 
 void ZoomText::OnThemeChanged(wxCommandEvent& e)
@@ -220,101 +225,56 @@ void ZoomText::OnThemeChanged(wxCommandEvent& e)
     UpdateLexer(nullptr);
 }
 
-void ZoomText::OnTimer(wxTimerEvent& event)
-{
-    // sanity
-    if (IsEmpty()) {
-        m_timer->Start(TIMER_DELAY, true);
-        return;
-    }
-
-    IEditor* editor = clGetManager()->GetActiveEditor();
-    if (!editor || !editor->GetCtrl()->IsShown()) {
-        m_timer->Start(TIMER_DELAY, true);
-        return;
-    }
-
-    if (!editor->GetKeywordClasses().IsEmpty() && (editor->GetFileName().GetFullPath() == m_filename)) {
-        // Sync between the keywords
-        SetSemanticTokens(editor->GetKeywordClasses(), editor->GetKeywordLocals(), editor->GetKeywordMethods(),
-                          wxEmptyString);
-    }
-    m_timer->Start(TIMER_DELAY, true);
-}
-
 void ZoomText::DoClear()
 {
+    DoDetach();
     SetReadOnly(false);
     SetText("");
     SetReadOnly(true);
 }
 
-void ZoomText::Startup() { m_timer->Start(TIMER_DELAY, true); }
-
-void ZoomText::UpdateMarkers(const std::vector<int>& lines, MarkerType type)
+void ZoomText::DoDetach()
 {
-    const int marker_number = ToSciMarkerTypes(type);
-    MarkerDeleteAll(marker_number);
-    for (int line : lines) {
-        MarkerAdd(line, marker_number);
+    if (m_editorCtrl) {
+        // Attach to a new empty document, this releases our reference to the editor's document
+        SetDocPointer(nullptr);
+        m_editorCtrl = nullptr;
     }
 }
 
-void ZoomText::SetSemanticTokens(const wxString& classes, const wxString& variables, const wxString& methods,
-                                 const wxString& others)
+void ZoomText::OnKeyboardInput(wxKeyEvent& e)
 {
-    IEditor* editor = clGetManager()->GetActiveEditor();
-    CHECK_PTR_RET(editor);
-
-    wxString flatStrClasses = classes;
-    wxString flatStrLocals = variables;
-    wxString flatStrOthers = others;
-    wxString flatStrMethods = methods;
-
-    flatStrClasses.Trim().Trim(false);
-    flatStrLocals.Trim().Trim(false);
-    flatStrOthers.Trim().Trim(false);
-    flatStrMethods.Trim().Trim(false);
+    // The document belongs to the editor: swallow all keyboard input
+    wxUnusedVar(e);
+}
 
-    // locate the lexer
-    auto lexer = ColoursAndFontsManager::Get().GetLexerForFile(editor->GetFileName().GetFullName());
-    CHECK_PTR_RET(lexer);
+void ZoomText::OnDoDrop(wxStyledTextEvent& e) { e.SetDragResult(wxDragNone); }
 
-    if (lexer->GetWordSet(LexerConf::WS_CLASS).is_ok()) {
-        lexer->ApplyWordSet(this, LexerConf::WS_CLASS, flatStrClasses);
-        lexer->ApplyWordSet(this, LexerConf::WS_FUNCTIONS, flatStrMethods);
-        lexer->ApplyWordSet(this, LexerConf::WS_VARIABLES, flatStrLocals);
-        lexer->ApplyWordSet(this, LexerConf::WS_OTHERS, flatStrOthers);
+void ZoomText::OnStartDrag(wxStyledTextEvent& e)
+{
+    // moving the text out of the view would delete it from the editor
+    e.SetDragAllowed(false);
+}
 
-    } else {
+void ZoomText::OnSetFocus(wxFocusEvent& e)
+{
+    e.Skip();
+    // the view never keeps the focus, so clipboard and edit commands can not target it
+    if (m_editorCtrl) {
+        CallAfter([this]() {
+            if (m_editorCtrl) {
+                m_editorCtrl->SetFocus();
+            }
+        });
+    }
+}
 
-        int keywords_class = wxNOT_FOUND;
-        int keywords_variables = wxNOT_FOUND;
-
-        switch (lexer->GetLexerId()) {
-        case wxSTC_LEX_CPP:
-            keywords_class = 1;
-            keywords_variables = 3;
-            break;
-
-        case wxSTC_LEX_RUST:
-            keywords_class = 3;
-            keywords_variables = 4;
-            break;
-
-        case wxSTC_LEX_PYTHON:
-            keywords_variables = 1;
-            break;
-        default:
-            break;
-        }
-        if (!flatStrClasses.empty() && keywords_class != wxNOT_FOUND) {
-            SetKeyWords(keywords_class, flatStrClasses);
-        }
-
-        if (!flatStrLocals.empty() && keywords_variables != wxNOT_FOUND) {
-            SetKeyWords(keywords_variables, flatStrLocals);
-        }
+void ZoomText::OnModified(wxStyledTextEvent& e)
+{
+    e.Skip();
+    // All the changes of the shared document are reported to the view, they must all come from the editor
+    const int textChanged = wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT;
+    if (m_editorCtrl && (e.GetModificationType() & textChanged) && wxWindow::FindFocus() == this) {
+        clWARNING() << "ZoomNavigator: the editor document was modified from the preview:" << m_filename << endl;
     }
-    Colourise(0, wxSTC_INVALID_POSITION);
 }
@@ -37,28 +37,29 @@
 
 #include <wx/stc/stc.h>
 
-class wxTimer;
-class wxTimerEvent;
-
+/**
+ * @brief a zoomed out view of the active editor. The view does not hold a copy of the editor text, instead
+ * it is attached to the editor's Scintilla document, so both the text and the styling are shared with the
+ * editor. Only view properties (style colours, zoom, selection) belong to this control, anything that is stored
+ * in the document (read-only state, markers, lexer and its keywords) must not be modified from here
+ */
 class ZoomText : public wxStyledTextCtrl
 {
     int m_zoomFactor;
     wxColour m_colour;
     wxString m_filename;
-    wxTimer* m_timer = nullptr;
-
-public:
-    enum class MarkerType {
-        Error,
-        Warning,
-    };
+    wxStyledTextCtrl* m_editorCtrl = nullptr;
 
 protected:
     void OnThemeChanged(wxCommandEvent& e);
-    void OnTimer(wxTimerEvent& event);
+    void OnKeyboardInput(wxKeyEvent& e);
+    void OnDoDrop(wxStyledTextEvent& e);
+    void OnStartDrag(wxStyledTextEvent& e);
+    void OnSetFocus(wxFocusEvent& e);
+    void OnModified(wxStyledTextEvent& e);
     void DoClear();
-    void SetSemanticTokens(const wxString& classes, const wxString& variables, const wxString& methods,
-                           const wxString& others);
+    void DoDetach();
+    void DoApplyLexer(IEditor* editor);
 
 public:
     explicit ZoomText(wxWindow* parent, wxWindowID id = wxID_ANY, const wxPoint& pos = wxDefaultPosition,
@@ -68,8 +69,6 @@ public:
     void OnSettingsChanged(wxCommandEvent& e);
     void UpdateText(IEditor* editor);
     void HighlightLines(int start, int end);
-    void UpdateMarkers(const std::vector<int>& lines, MarkerType type);
-    void Startup();
 };
 
 #endif // ZOOM_NAV_TEXT
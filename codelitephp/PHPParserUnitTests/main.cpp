@@ -5,8 +5,10 @@
 #include "tester.h"
 
 #include <stdio.h>
+#include <thread>
 #include <wx/ffile.h>
 #include <wx/init.h>
+#include <wx/stopwatch.h>
 
 #ifdef __WXMSW__
 #define SYMBOLS_DB_PATH "%TEMP%"
@@ -870,6 +872,106 @@ TEST_FUNC(test_func_arg_in_lambda_in_assignment)
 }
 
 
+//======================-------------------------------------------------
+// Parser benchmark
+//======================-------------------------------------------------
+
+static const size_t BENCHMARK_FILES = 600;
+static const size_t BENCHMARK_NAMESPACES = 20;
+
+/**
+ * @brief generate a tree of BENCHMARK_FILES PHP classes (each extending the previous one) under 'dir'
+ */
+static wxArrayString GenerateBenchmarkTree(const wxString& dir)
+{
+    wxArrayString files;
+    for(size_t i = 0; i < BENCHMARK_FILES; ++i) {
+        wxFileName fn(dir, wxString::Format("Class%u.php", (unsigned)i));
+        fn.AppendDir(wxString::Format("Module%u", (unsigned)(i % BENCHMARK_NAMESPACES)));
+        fn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+
+        wxString code;
+        code << "<?php\nnamespace Bench\\Module" << (i % BENCHMARK_NAMESPACES) << ";\n\n";
+        code << "/**\n * @property int $count\n */\n";
+        code << "class Class" << i;
+        if(i > 0) {
+            code << " extends \\Bench\\Module" << ((i - 1) % BENCHMARK_NAMESPACES) << "\\Class" << (i - 1);
+        }
+        code << "\n{\n";
+        code << "    const VERSION = " << i << ";\n";
+        code << "    private $m_options = [];\n\n";
+        for(size_t m = 0; m < 20; ++m) {
+            code << "    /**\n     * @param string $name\n     * @param array $options\n     * @return Class" << i
+                 << "\n     */\n";
+            code << "    public function method" << m << "(string $name, array $options = [])\n    {\n";
+            code << "        $result = new Class" << i << "();\n";
+            code << "        foreach($options as $key => $value) {\n";
+            code << "            $result->method" << m << "($name . $key, [$value]);\n";
+            code << "        }\n";
+            code << "        return $result;\n";
+            code << "    }\n\n";
+        }
+        code << "}\n";
+
+        wxFFile fp(fn.GetFullPath(), "w+b");
+        if(fp.IsOpened()) {
+            fp.Write(code);
+            fp.Close();
+        }
+        files.Add(fn.GetFullPath());
+    }
+    return files;
+}
+
+/**
+ * @brief parse the benchmark tree into a new database using 'threads' parser threads
+ * @param classes [output] the number of benchmark classes found in the database
+ * @return the time it took, in milliseconds
+ */
+static long RunBenchmark(const wxString& dir, const wxArrayString& files, size_t threads, size_t& classes)
+{
+    PHPLookupTable table;
+    table.Open(dir);
+    table.ClearAll();
+    table.SetParserThreads(threads);
+
+    wxStopWatch sw;
+    table.RecreateSymbolsDatabase(files, PHPLookupTable::kUpdateMode_Full, []() { return false; });
+    long elapsed = sw.Time();
+
+    classes = 0;
+    for(size_t i = 0; i < BENCHMARK_FILES; ++i) {
+        wxString fullname;
+        fullname << "\\Bench\\Module" << (i % BENCHMARK_NAMESPACES) << "\\Class" << i;
+        if(table.FindClass(fullname)) {
+            ++classes;
+        }
+    }
+    table.Close();
+    return elapsed;
+}
+
+TEST_FUNC(test_parallel_parsing_benchmark)
+{
+    wxFileName benchDir(SYMBOLS_DB_PATH, "");
+    benchDir.AppendDir("php_parser_benchmark");
+    benchDir.Normalize();
+    wxArrayString files = GenerateBenchmarkTree(benchDir.GetPath());
+
+    size_t serialClasses = 0;
+    size_t parallelClasses = 0;
+    long serialTime = RunBenchmark(benchDir.GetPath(), files, 1, serialClasses);
+    long parallelTime = RunBenchmark(benchDir.GetPath(), files, 0, parallelClasses);
+    printf("Parsed %u files: %ld ms using 1 thread, %ld ms using %u threads\n", (unsigned)files.size(), serialTime,
+           parallelTime, (unsigned)std::thread::hardware_concurrency());
+    wxFileName::Rmdir(benchDir.GetPath(), wxPATH_RMDIR_RECURSIVE);
+
+    CHECK_SIZE(serialClasses, BENCHMARK_FILES);
+    CHECK_SIZE(parallelClasses, BENCHMARK_FILES);
+    return true;
+}
+
+
 //======================-------------------------------------------------
 // Main
 //======================-------------------------------------------------
@@ -74,6 +74,7 @@ CL_PLUGIN_API int GetPluginInterfaceVersion() { return PLUGIN_INTERFACE_VERSION;
 Cscope::Cscope(IManager* manager)
     : IPlugin(manager)
     , m_topWindow(NULL)
+    , m_queryId(0)
 {
     m_longName = _("CScope Integration for CodeLite");
     m_shortName = CSCOPE_NAME;
@@ -85,6 +86,7 @@ Cscope::Cscope(IManager* manager)
     m_tabHelper.reset(new clTabTogglerHelper(CSCOPE_NAME, m_cscopeWin, "", NULL));
 
     Connect(wxEVT_CSCOPE_THREAD_DONE, wxCommandEventHandler(Cscope::OnCScopeThreadEnded), NULL, this);
+    Connect(wxEVT_CSCOPE_THREAD_RESULTS, wxCommandEventHandler(Cscope::OnCScopeThreadResults), NULL, this);
     Connect(wxEVT_CSCOPE_THREAD_UPDATE_STATUS, wxCommandEventHandler(Cscope::OnCScopeThreadUpdateStatus), NULL, this);
 
     // start the helper thread
@@ -362,7 +364,8 @@ wxString Cscope::DoCreateListFile(bool force)
     return list_file.GetFullPath();
 }
 
-void Cscope::DoCscopeCommand(const wxString& command, const wxString& findWhat, const wxString& endMsg)
+void Cscope::DoCscopeCommand(const wxString& command, const wxString& findWhat, const wxString& endMsg,
+                             const wxString& listFile)
 {
     // We haven't yet found a valid cscope exe, so look for one
     wxString where;
@@ -395,7 +398,11 @@ void Cscope::DoCscopeCommand(const wxString& command, const wxString& findWhat,
     req->SetEndMsg(endMsg);
     req->SetFindWhat(findWhat);
     req->SetWorkingDir(GetWorkingDirectory());
+    req->SetListFile(listFile);
+    req->SetQueryId(++m_queryId);
 
+    // a query that is still running is stopped, its results would be discarded anyway
+    CScopeThreadST::Get()->SetCurrentQueryId(m_queryId);
     CScopeThreadST::Get()->Add(req);
 }
 
@@ -442,6 +449,10 @@ void Cscope::OnFindFunctionsCalledByThisFunction(wxCommandEvent& e)
     if(!settings.GetRebuildOption()) {
         rebuildOption = " -d";
     }
+    if(settings.GetBuildRevertedIndexOption()) {
+        // use the inverted index
+        rebuildOption << " -q";
+    }
 
     // Do the actual search
     wxString command;
@@ -469,6 +480,10 @@ void Cscope::OnFindFunctionsCallingThisFunction(wxCommandEvent& e)
     if(!settings.GetRebuildOption()) {
         rebuildOption = " -d";
     }
+    if(settings.GetBuildRevertedIndexOption()) {
+        // use the inverted index
+        rebuildOption << " -q";
+    }
 
     // Do the actual search
     wxString command;
@@ -511,6 +526,10 @@ void Cscope::OnFindFilesIncludingThisFname(wxCommandEvent& e)
     if(!settings.GetRebuildOption()) {
         rebuildOption = " -d";
     }
+    if(settings.GetBuildRevertedIndexOption()) {
+        // use the inverted index
+        rebuildOption << " -q";
+    }
 
     // Do the actual search
     wxString command;
@@ -535,23 +554,24 @@ void Cscope::OnCreateDB(wxCommandEvent& e)
     wxString endMsg;
     CScopeConfData settings;
 
-    command << GetCscopeExeName();
+    command << GetCscopeExeName() << " -b";
 
     m_mgr->GetConfigTool()->ReadObject("CscopeSettings", &settings);
     if(settings.GetBuildRevertedIndexOption()) {
         command << " -q";
         endMsg << _("Recreated inverted CScope DB");
     } else {
-        command << " -b";
         endMsg << _("Recreated CScope DB");
     }
 
     // Do the actual create db
     // since the process is always running from the workspace
     // directory, there is no need to specify the full path of the list file
+    // cscope re-parses only the files that were modified since the database was last built (and the build is skipped
+    // altogether if none was modified)
 
-    command << " -L -i cscope_file.list";
-    DoCscopeCommand(command, wxEmptyString, endMsg);
+    command << " -i cscope_file.list";
+    DoCscopeCommand(command, wxEmptyString, endMsg, "cscope_file.list");
 }
 
 void Cscope::OnDoSettings(wxCommandEvent& e)
@@ -579,7 +599,14 @@ wxString Cscope::GetCscopeExeName()
 void Cscope::OnCScopeThreadEnded(wxCommandEvent& e)
 {
     CScopeResultTable_t* result = (CScopeResultTable_t*)e.GetClientData();
-    m_cscopeWin->BuildTable(result);
+    m_cscopeWin->AddResults(result, (size_t)e.GetExtraLong() == m_queryId);
+}
+
+void Cscope::OnCScopeThreadResults(wxCommandEvent& e)
+{
+    // partial results of a query that is still running
+    CScopeResultTable_t* result = (CScopeResultTable_t*)e.GetClientData();
+    m_cscopeWin->AddResults(result, (size_t)e.GetExtraLong() == m_queryId);
 }
 
 void Cscope::OnCScopeThreadUpdateStatus(wxCommandEvent& e)
@@ -652,6 +679,10 @@ void Cscope::DoFindSymbol(const wxString& word)
     if(!settings.GetRebuildOption()) {
         rebuildOption = " -d";
     }
+    if(settings.GetBuildRevertedIndexOption()) {
+        // use the inverted index
+        rebuildOption << " -q";
+    }
 
     // Do the actual search
     wxString command;
@@ -40,6 +40,7 @@ class Cscope : public IPlugin
     wxEvtHandler* m_topWindow;
     CscopeTab* m_cscopeWin;
     clTabTogglerHelper::Ptr_t m_tabHelper;
+    size_t m_queryId; ///< id of the last command sent to the cscope thread, results of older commands are ignored
 
 public:
     Cscope(IManager* manager);
@@ -58,7 +59,8 @@ protected:
     wxMenu* CreateEditorPopMenu();
     wxString GetCscopeExeName();
     wxString DoCreateListFile(bool force);
-    void DoCscopeCommand(const wxString& command, const wxString& findWhat, const wxString& endMsg);
+    void DoCscopeCommand(const wxString& command, const wxString& findWhat, const wxString& endMsg,
+                         const wxString& listFile = wxEmptyString);
     void DoFindSymbol(const wxString& word);
     wxString GetSearchPattern() const;
     wxString GetWorkingDirectory() const;
@@ -75,6 +77,7 @@ protected:
     void OnCreateDB(wxCommandEvent& e);
     void OnDoSettings(wxCommandEvent& e);
     void OnCScopeThreadEnded(wxCommandEvent& e);
+    void OnCScopeThreadResults(wxCommandEvent& e);
     void OnCScopeThreadUpdateStatus(wxCommandEvent& e);
     void OnCscopeUI(wxUpdateUIEvent& e);
     void OnWorkspaceOpenUI(wxUpdateUIEvent& e);
@@ -24,101 +24,209 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "cscopedbbuilderthread.h"
 
+#include "AsyncProcess/asyncprocess.h"
 #include "cscope.h"
 #include "cscopestatusmessage.h"
-#include "dirsaver.h"
 #include "file_logger.h"
-#include "procutils.h"
+#include "fileutils.h"
 
+#include <memory>
 #include <wx/filefn.h>
+#include <wx/tokenzr.h>
 
 int wxEVT_CSCOPE_THREAD_DONE = wxNewId();
 int wxEVT_CSCOPE_THREAD_UPDATE_STATUS = wxNewId();
+int wxEVT_CSCOPE_THREAD_RESULTS = wxNewId();
 
-CscopeDbBuilderThread::CscopeDbBuilderThread() {}
+namespace
+{
+// stored next to the database: the modification times of the files it was built from
+const wxString MANIFEST_FILE = "cscope_file.stamps";
+
+void DeleteResults(CScopeResultTable_t* results)
+{
+    for(CScopeResultTable_t::iterator iter = results->begin(); iter != results->end(); ++iter) {
+        delete iter->second;
+    }
+    delete results;
+}
+} // namespace
+
+CscopeDbBuilderThread::CscopeDbBuilderThread()
+    : m_currentQueryId(0)
+{
+}
 
 CscopeDbBuilderThread::~CscopeDbBuilderThread() {}
 
+wxString CscopeDbBuilderThread::CreateManifest(CscopeRequest* req)
+{
+    wxString content;
+    if(!FileUtils::ReadFileContent(wxFileName(req->GetWorkingDir(), req->GetListFile()), content)) {
+        return wxEmptyString;
+    }
+
+    // the command is part of the manifest, so changing the options (e.g. the inverted index) rebuilds the database
+    wxString manifest;
+    manifest << req->GetCmd() << "\n";
+    wxArrayString files = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
+    for(const wxString& file : files) {
+        wxFileName fn(file);
+        fn.MakeAbsolute(req->GetWorkingDir());
+        manifest << (long long)FileUtils::GetFileModificationTime(fn) << " " << file << "\n";
+    }
+    return manifest;
+}
+
 void CscopeDbBuilderThread::ProcessRequest(ThreadRequest* request)
 {
     CscopeRequest* req = (CscopeRequest*)request;
+    if(!req->IsBuildDb() && req->GetQueryId() != m_currentQueryId.load()) {
+        // a newer query was issued before this one started
+        return;
+    }
 
-    // change dir to the workspace directory
-    DirSaver ds;
+    wxString manifest;
+    wxFileName manifestFile(req->GetWorkingDir(), MANIFEST_FILE);
+    if(req->IsBuildDb()) {
+        // cscope re-parses only the files that changed since the database was built, but it still has to be fed the
+        // whole list and it rewrites the database. Don't run it at all if nothing changed
+        SendStatusEvent(_("Checking for modified files..."), 5, wxEmptyString, req->GetOwner());
+        manifest = CreateManifest(req);
+
+        wxString lastManifest;
+        if(!manifest.IsEmpty() && wxFileName(req->GetWorkingDir(), "cscope.out").FileExists() &&
+           FileUtils::ReadFileContent(manifestFile, lastManifest) && lastManifest == manifest) {
+            SendStatusEvent(_("CScope DB is up to date"), 100, wxEmptyString, req->GetOwner());
+            SendResults(wxEVT_CSCOPE_THREAD_DONE, new CScopeResultTable_t(), req);
+            return;
+        }
+    }
 
-    wxSetWorkingDirectory(req->GetWorkingDir());
     SendStatusEvent(_("Executing cscope..."), 10, req->GetFindWhat(), req->GetOwner());
 
-    // notify the database creation process as completed
-    wxArrayString output;
-
     // set environment variables required by cscope
     wxSetEnv(wxT("TMPDIR"), wxFileName::GetTempDir());
     clDEBUG() << "CScope:" << req->GetCmd() << clEndl;
-    ProcUtils::SafeExecuteCommand(req->GetCmd(), output);
-    SendStatusEvent(_("Parsing results..."), 50, wxEmptyString, req->GetOwner());
-    clDEBUG1() << "CScope:\n" << output << clEndl;
-    CScopeResultTable_t* result = ParseResults(output);
-    SendStatusEvent(_("Done"), 100, wxEmptyString, req->GetOwner());
+
+    IProcess::Ptr_t proc(::CreateSyncProcess(req->GetCmd(), IProcessCreateDefault | IProcessCreateWithHiddenConsole,
+                                             req->GetWorkingDir()));
+    if(!proc) {
+        SendStatusEvent(_("Failed to execute cscope"), 0, wxEmptyString, req->GetOwner());
+        SendResults(wxEVT_CSCOPE_THREAD_DONE, new CScopeResultTable_t(), req);
+        return;
+    }
+
+    // results are sent in batches, as cscope prints them
+    std::unique_ptr<CScopeResultTable_t> results(new CScopeResultTable_t());
+    wxString pending;
+    wxString out, err;
+    std::string rawOut, rawErr;
+    bool cscopeErrors = false;
+    // Read() returns false once the process exited and all its output was read
+    while(proc->Read(out, err, rawOut, rawErr)) {
+        if(out.Contains("cscope:") || err.Contains("cscope:")) {
+            cscopeErrors = true;
+        }
+        if(!req->IsBuildDb() && req->GetQueryId() != m_currentQueryId.load()) {
+            // the query was replaced by a newer one
+            proc->Terminate();
+            DeleteResults(results.release());
+            return;
+        }
+
+        pending << out;
+        size_t lineEnd = pending.rfind('\n');
+        if(lineEnd == wxString::npos) {
+            continue;
+        }
+        wxArrayString lines = ::wxStringTokenize(pending.Mid(0, lineEnd), "\r\n", wxTOKEN_STRTOK);
+        pending.Remove(0, lineEnd + 1);
+        for(const wxString& line : lines) {
+            AddResult(line, results.get());
+        }
+        if(!results->empty()) {
+            SendResults(wxEVT_CSCOPE_THREAD_RESULTS, results.release(), req);
+            results.reset(new CScopeResultTable_t());
+        }
+    }
+    AddResult(pending, results.get());
+
+    if(req->IsBuildDb() && !manifest.IsEmpty()) {
+        // record the files only if they were indexed: otherwise the next build would skip them
+        int exitCode = 0;
+        bool exitCodeKnown = IProcess::GetProcessExitCode(proc->GetPid(), exitCode);
+        bool ok = !cscopeErrors && (!exitCodeKnown || exitCode == 0) &&
+                  wxFileName(req->GetWorkingDir(), "cscope.out").FileExists();
+        if(ok) {
+            FileUtils::WriteFileContent(manifestFile, manifest);
+        } else {
+            FileUtils::RemoveFile(manifestFile);
+            clWARNING() << "CScope: building the database failed, it will be rebuilt next time" << clEndl;
+        }
+    }
 
     // send status message
+    SendStatusEvent(_("Done"), 100, wxEmptyString, req->GetOwner());
     SendStatusEvent(req->GetEndMsg(), 100, wxEmptyString, req->GetOwner());
 
-    // send the results
-    wxCommandEvent e(wxEVT_CSCOPE_THREAD_DONE);
-    e.SetClientData(result);
-    req->GetOwner()->AddPendingEvent(e);
+    // send the remaining results
+    SendResults(wxEVT_CSCOPE_THREAD_DONE, results.release(), req);
 }
 
-CScopeResultTable_t* CscopeDbBuilderThread::ParseResults(const wxArrayString& output)
+void CscopeDbBuilderThread::AddResult(const wxString& output, CScopeResultTable_t* results)
 {
-    CScopeResultTable_t* results = new CScopeResultTable_t();
-    for(size_t i = 0; i < output.GetCount(); i++) {
-        // parse each line
-        wxString line = output.Item(i);
-        CscopeEntryData data;
-
-        // first is the file name
-        line = line.Trim().Trim(false);
-        // skip errors
-        if(line.StartsWith(wxT("cscope:"))) { continue; }
-
-        wxString file = line.BeforeFirst(wxT(' '));
-        data.SetFile(file);
-        line = line.AfterFirst(wxT(' '));
-
-        // next is the scope
-        line = line.Trim().Trim(false);
-        wxString scope = line.BeforeFirst(wxT(' '));
-        line = line.AfterFirst(wxT(' '));
-        data.SetScope(scope);
-
-        // next is the line number
-        line = line.Trim().Trim(false);
-        long nn;
-        wxString line_number = line.BeforeFirst(wxT(' '));
-        line_number.ToLong(&nn);
-        data.SetLine(nn);
-        line = line.AfterFirst(wxT(' '));
-
-        // the rest is the pattern
-        wxString pattern = line;
-        data.SetPattern(pattern);
-
-        // insert the result
-        CScopeResultTable_t::const_iterator iter = results->find(data.GetFile());
-        std::vector<CscopeEntryData>* vec(NULL);
-        if(iter != results->end()) {
-            // this file already exist, append the result
-            vec = iter->second;
-        } else {
-            vec = new std::vector<CscopeEntryData>();
-            // add it to the map
-            (*results)[data.GetFile()] = vec;
-        }
-        vec->push_back(data);
+    // parse the line
+    wxString line = output;
+    CscopeEntryData data;
+
+    // first is the file name
+    line = line.Trim().Trim(false);
+    // skip errors
+    if(line.IsEmpty() || line.StartsWith(wxT("cscope:"))) { return; }
+
+    wxString file = line.BeforeFirst(wxT(' '));
+    data.SetFile(file);
+    line = line.AfterFirst(wxT(' '));
+
+    // next is the scope
+    line = line.Trim().Trim(false);
+    wxString scope = line.BeforeFirst(wxT(' '));
+    line = line.AfterFirst(wxT(' '));
+    data.SetScope(scope);
+
+    // next is the line number
+    line = line.Trim().Trim(false);
+    long nn;
+    wxString line_number = line.BeforeFirst(wxT(' '));
+    line_number.ToLong(&nn);
+    data.SetLine(nn);
+    line = line.AfterFirst(wxT(' '));
+
+    // the rest is the pattern
+    wxString pattern = line;
+    data.SetPattern(pattern);
+
+    // insert the result
+    CScopeResultTable_t::const_iterator iter = results->find(data.GetFile());
+    std::vector<CscopeEntryData>* vec(NULL);
+    if(iter != results->end()) {
+        // this file already exist, append the result
+        vec = iter->second;
+    } else {
+        vec = new std::vector<CscopeEntryData>();
+        // add it to the map
+        (*results)[data.GetFile()] = vec;
     }
-    return results;
+    vec->push_back(data);
+}
+
+void CscopeDbBuilderThread::SendResults(int eventType, CScopeResultTable_t* results, CscopeRequest* req)
+{
+    wxCommandEvent e(eventType);
+    e.SetClientData(results);
+    e.SetExtraLong(req->GetQueryId());
+    req->GetOwner()->AddPendingEvent(e);
 }
 
 void CscopeDbBuilderThread::SendStatusEvent(const wxString& msg, int percent, const wxString& findWhat,
@@ -29,6 +29,7 @@
 #include "singleton.h"
 #include "worker_thread.h"
 
+#include <atomic>
 #include <map>
 #include <vector>
 #include <wx/event.h>
@@ -38,6 +39,8 @@
 
 extern int wxEVT_CSCOPE_THREAD_DONE;
 extern int wxEVT_CSCOPE_THREAD_UPDATE_STATUS;
+// results of a query that is still running, sent as they are read from cscope
+extern int wxEVT_CSCOPE_THREAD_RESULTS;
 
 typedef std::vector<CscopeEntryData> CScopeEntryDataVec_t;
 typedef std::map<wxString, CScopeEntryDataVec_t*> CScopeResultTable_t;
@@ -56,6 +59,8 @@ class CscopeRequest : public ThreadRequest
     wxString m_outfile;
     wxString m_endMsg;
     wxString m_findWhat;
+    size_t m_queryId = 0;
+    wxString m_listFile;
 
 public:
     CscopeRequest(){};
@@ -77,22 +82,46 @@ public:
     const wxString& GetFindWhat() const { return m_findWhat; }
     void SetEndMsg(const wxString& endMsg) { this->m_endMsg = endMsg; }
     const wxString& GetEndMsg() const { return m_endMsg; }
+    void SetQueryId(size_t queryId) { this->m_queryId = queryId; }
+    size_t GetQueryId() const { return m_queryId; }
+
+    /**
+     * @brief set for database builds only: the list of files the database is built from. The build is skipped if
+     * none of the files changed since the last build
+     */
+    void SetListFile(const wxString& listFile) { this->m_listFile = listFile; }
+    const wxString& GetListFile() const { return m_listFile; }
+    bool IsBuildDb() const { return !m_listFile.IsEmpty(); }
 };
 
 class CscopeDbBuilderThread : public WorkerThread
 {
     friend class Singleton<CscopeDbBuilderThread>;
 
+    std::atomic<size_t> m_currentQueryId;
+
 protected:
     void ProcessRequest(ThreadRequest* req);
-    CScopeResultTable_t* ParseResults(const wxArrayString& output);
+    void AddResult(const wxString& line, CScopeResultTable_t* results);
+
+    /**
+     * @brief return the modification time of every file in the list file, in the format stored next to the database
+     */
+    wxString CreateManifest(CscopeRequest* req);
 
 protected:
     void SendStatusEvent(const wxString& msg, int percent, const wxString& findWhat, wxEvtHandler* owner);
+    void SendResults(int eventType, CScopeResultTable_t* results, CscopeRequest* req);
 
 public:
     CscopeDbBuilderThread();
     ~CscopeDbBuilderThread();
+
+    /**
+     * @brief a new query was issued. A query that is still running with a different id is stopped (database builds
+     * always run to completion)
+     */
+    void SetCurrentQueryId(size_t queryId) { m_currentQueryId.store(queryId); }
 };
 
 typedef Singleton<CscopeDbBuilderThread> CScopeThreadST;
@@ -82,37 +82,48 @@ void CscopeTab::Clear()
     m_stc->ClearAll();
     m_stc->SetEditable(false);
     m_matchesInStc.clear();
+    m_insertedItems.clear();
+    m_lastFile.clear();
 }
 
-void CscopeTab::BuildTable(CScopeResultTable_t* table)
+void CscopeTab::AddResults(CScopeResultTable_t* table, bool isCurrent)
 {
     CHECK_PTR_RET(table);
     // Free the old table
     FreeTable();
 
     m_table = table;
-    ClearText();
-    m_matchesInStc.clear();
-    m_styler->SetStyles(m_stc);
+    if(!isCurrent) {
+        FreeTable();
+        return;
+    }
+
+    if(m_matchesInStc.empty()) {
+        // first results of this query
+        m_styler->SetStyles(m_stc);
+    }
 
-    wxStringSet_t insertedItems;
     CScopeResultTable_t::iterator iter = m_table->begin();
     for(; iter != m_table->end(); ++iter) {
-        wxString file = iter->first;
-
-        // Add line for the file
-        AddFile(file);
+        const wxString& file = iter->first;
+        bool fileAdded = false;
 
         // Add the entries for this file
         CScopeEntryDataVec_t* vec = iter->second;
         for(size_t i = 0; i < vec->size(); ++i) {
-            CscopeEntryData entry = vec->at(i);
+            const CscopeEntryData& entry = vec->at(i);
             // Dont insert duplicate entries to the match view
             wxString display_string;
-            display_string << _("Line: ") << entry.GetLine() << wxT(", ") << entry.GetScope() << wxT(", ")
-                           << entry.GetPattern();
-            if(insertedItems.count(display_string) == 0) {
-                insertedItems.insert(display_string);
+            display_string << file << wxT(": ") << _("Line: ") << entry.GetLine() << wxT(", ") << entry.GetScope()
+                           << wxT(", ") << entry.GetPattern();
+            if(m_insertedItems.count(display_string) == 0) {
+                m_insertedItems.insert(display_string);
+                if(!fileAdded && file != m_lastFile) {
+                    // Add line for the file, unless the previous batch ended with the same file
+                    AddFile(file);
+                }
+                fileAdded = true;
+                m_lastFile = file;
                 int lineno = m_stc->GetLineCount() - 1; // STC line number *before* we add the result
                 AddMatch(entry.GetLine(), entry.GetPattern());
                 m_matchesInStc.insert(std::make_pair(lineno, entry));
@@ -64,6 +64,8 @@ class CscopeTab : public CscopeTabBase
     wxFont m_font;
     clFindResultsStyler::Ptr_t m_styler;
     std::map<int, CscopeEntryData> m_matchesInStc;
+    wxStringSet_t m_insertedItems; ///< matches already displayed, used to skip duplicates
+    wxString m_lastFile;           ///< the file of the last displayed match
 
 protected:
     void FreeTable();
@@ -86,7 +88,12 @@ public:
     CscopeTab(wxWindow* parent, IManager* mgr);
     virtual ~CscopeTab();
 
-    void BuildTable(CScopeResultTable_t* table);
+    /**
+     * @brief append results to the view. Results of a running query arrive in several batches. The table is freed
+     * @param isCurrent false if the results belong to a query that was already replaced by a newer one, they are only
+     * freed
+     */
+    void AddResults(CScopeResultTable_t* table, bool isCurrent);
     void Clear();
     void SetMessage(const wxString& msg, int percent);
 
@@ -5,9 +5,11 @@
 #include "Cxx/CxxScannerTokens.h"
 #include "Cxx/CxxTokenizer.h"
 #include "Cxx/CxxVariableScanner.h"
+#include "Diff/clDTL.h"
 #include "LSPUtils.hpp"
 #include "Settings.hpp"
 #include "SimpleTokenizer.hpp"
+#include "clAnsiEscapeCodeHandler.hpp"
 #include "clFilesCollector.h"
 #include "ctags_manager.h"
 #include "database/tags_storage_sqlite3.h"
@@ -16,7 +18,9 @@
 #include "strings.hpp"
 #include "tester.hpp"
 
+#include <chrono>
 #include <iostream>
+#include <random>
 #include <wx/init.h>
 #include <wx/log.h>
 #include <wx/wxcrtvararg.h>
@@ -112,6 +116,109 @@ wxString get_sample_file(const wxString& filename)
     return test_file.GetFullPath();
 }
 
+/// length of the longest common subsequence of the lines, the brute force way
+size_t lcs_length(const vector<wxString>& a, const vector<wxString>& b)
+{
+    vector<vector<size_t>> table(a.size() + 1, vector<size_t>(b.size() + 1, 0));
+    for(size_t i = 1; i <= a.size(); ++i) {
+        for(size_t j = 1; j <= b.size(); ++j) {
+            table[i][j] = a[i - 1] == b[j - 1] ? table[i - 1][j - 1] + 1 : max(table[i - 1][j], table[i][j - 1]);
+        }
+    }
+    return table[a.size()][b.size()];
+}
+
+vector<wxString> split_lines(const wxString& text)
+{
+    vector<wxString> lines;
+    size_t start = 0;
+    while(start < text.length()) {
+        size_t end = text.find('\n', start);
+        if(end == wxString::npos) {
+            lines.push_back(text.Mid(start));
+            break;
+        }
+        lines.push_back(text.Mid(start, end - start + 1));
+        start = end + 1;
+    }
+    return lines;
+}
+
+/// apply the patch steps the way the LSP changes built from them are applied
+wxString apply_patch(const wxString& before, const vector<PatchStep>& steps)
+{
+    vector<wxString> lines = split_lines(before);
+    for(const auto& step : steps) {
+        if(step.line_number < 0 || step.line_number > (int)lines.size()) {
+            return "<invalid line number>";
+        }
+        if(step.action == PatchAction::ADD_LINE) {
+            lines.insert(lines.begin() + step.line_number, step.content);
+        } else if(step.action == PatchAction::DELETE_LINE) {
+            if(step.line_number == (int)lines.size()) {
+                return "<invalid line number>";
+            }
+            lines.erase(lines.begin() + step.line_number);
+        }
+    }
+
+    wxString result;
+    for(const auto& line : lines) {
+        result << line;
+    }
+    return result;
+}
+
+/// random text made of a few distinct lines, so the two sides have many lines in common
+wxString random_lines(mt19937& rng, size_t max_lines)
+{
+    static const char* words[] = { "a\n", "b\n", "c\n", "d\n", "\n" };
+    wxString text;
+    size_t count = rng() % (max_lines + 1);
+    for(size_t i = 0; i < count; ++i) {
+        text << words[rng() % 5];
+    }
+    if(!text.empty() && rng() % 4 == 0) {
+        // no terminating new line
+        text.RemoveLast();
+    }
+    return text;
+}
+
+/// parse `input` in chunks of `chunk_size` characters, as it arrives from a process
+void ansi_parse_chunks(clAnsiEscapeCodeHandler& handler, const wxString& input, size_t chunk_size)
+{
+    for(size_t i = 0; i < input.length(); i += chunk_size) {
+        handler.Parse(input.Mid(i, chunk_size));
+    }
+}
+
+wxString ansi_colour(const wxColour& colour)
+{
+    return colour.IsOk() ? colour.GetAsString(wxC2S_HTML_SYNTAX) : wxString();
+}
+
+/// describe the segments of a line as "text[fg,bg,font flags]..." so a whole line is checked at once
+wxString ansi_describe_line(const clAnsiEscapeCodeHandler& handler, size_t line)
+{
+    wxString desc;
+    for(const auto& segment : handler.GetLineSegments(line, false)) {
+        desc << segment.text << "[" << ansi_colour(segment.fg) << "," << ansi_colour(segment.bg) << ","
+             << segment.font_flags << "]";
+    }
+    return desc;
+}
+
+wxString ansi_describe(const clAnsiEscapeCodeHandler& handler)
+{
+    wxString desc;
+    for(size_t line = 0; line < handler.GetLineCount(); ++line) {
+        desc << ansi_describe_line(handler, line) << "\n";
+    }
+    desc << "title:" << handler.GetWindowTitle();
+    return desc;
+}
+
 } // namespace
 
 TEST_FUNC(test_lexing_raw_strings)
@@ -1512,6 +1619,205 @@ TEST_FUNC(test_cxx_code_completion)
     return true;
 }
 
+TEST_FUNC(test_dtl_edit_script_is_minimal)
+{
+    mt19937 rng(12345);
+    for(size_t iteration = 0; iteration < 2000; ++iteration) {
+        wxString before = random_lines(rng, 12);
+        wxString after = random_lines(rng, 12);
+
+        clDTL dtl;
+        dtl.DiffStrings(before, after, clDTL::kOnePane);
+        if(before == after) {
+            CHECK_BOOL(dtl.GetResultLeft().empty());
+            continue;
+        }
+
+        // the common and removed lines rebuild `before`, the common and added lines rebuild `after`
+        wxString left, right;
+        size_t common = 0;
+        for(const auto& line : dtl.GetResultLeft()) {
+            if(line.m_type == clDTL::LINE_COMMON) {
+                ++common;
+                left << line.m_line;
+                right << line.m_line;
+            } else if(line.m_type == clDTL::LINE_REMOVED) {
+                left << line.m_line;
+            } else if(line.m_type == clDTL::LINE_ADDED) {
+                right << line.m_line;
+            }
+        }
+        CHECK_WXSTRING(left, before);
+        CHECK_WXSTRING(right, after);
+        CHECK_SIZE(common, lcs_length(split_lines(before), split_lines(after)));
+    }
+    return true;
+}
+
+TEST_FUNC(test_dtl_create_patch)
+{
+    mt19937 rng(54321);
+    for(size_t iteration = 0; iteration < 2000; ++iteration) {
+        wxString before = random_lines(rng, 12);
+        wxString after = random_lines(rng, 12);
+
+        clDTL dtl;
+        auto steps = dtl.CreatePatch(before, after);
+        CHECK_WXSTRING(apply_patch(before, steps), after);
+    }
+    return true;
+}
+
+TEST_FUNC(test_dtl_large_file)
+{
+    // 200K lines with scattered modifications, insertions and deletions
+    const size_t LINE_COUNT = 200000;
+    wxString before, after;
+    before.reserve(LINE_COUNT * 16);
+    after.reserve(LINE_COUNT * 16);
+    size_t changes = 0;
+    for(size_t i = 0; i < LINE_COUNT; ++i) {
+        wxString line;
+        line << "line " << i << "\n";
+        before << line;
+        if(i % 997 == 0) {
+            // modified
+            after << "modified " << i << "\n";
+            changes += 2;
+        } else if(i % 1499 == 0) {
+            // deleted
+            changes += 1;
+        } else if(i % 2003 == 0) {
+            // inserted block
+            after << line << "new line 1\nnew line 2\nnew line 3\n";
+            changes += 3;
+        } else {
+            after << line;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    clDTL dtl;
+    dtl.DiffStrings(before, after, clDTL::kOnePane);
+    auto steps = dtl.CreatePatch(before, after);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    cout << "diff of " << LINE_COUNT << " lines: " << elapsed << "ms" << endl;
+
+    CHECK_SIZE(steps.size(), changes);
+    CHECK_WXSTRING(apply_patch(before, steps), after);
+    size_t changed_lines = count_if(dtl.GetResultLeft().begin(), dtl.GetResultLeft().end(),
+                                    [](const clDTL::LineInfo& line) { return line.m_type != clDTL::LINE_COMMON; });
+    CHECK_SIZE(changed_lines, changes);
+    // both diffs of 200K lines, generous enough for a debug build
+    CHECK_BOOL(elapsed < 10000);
+    return true;
+}
+
+TEST_FUNC(test_ansi_truecolour_foreground)
+{
+    clAnsiEscapeCodeHandler handler;
+    handler.Parse("\x1b[38;2;10;20;30mabc\x1b[0mdef");
+    CHECK_SIZE(handler.GetLineCount(), 1);
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "abc[#0A141E,,0]def[,,0]");
+
+    // R, G and B must not be applied as SGR codes (1 = bold, 3 = italic, 4 = underline)
+    handler.Reset();
+    handler.Parse("\x1b[38;2;1;4;3mx");
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "x[#010403,,0]");
+    return true;
+}
+
+TEST_FUNC(test_ansi_truecolour_background)
+{
+    clAnsiEscapeCodeHandler handler;
+    handler.Parse("\x1b[48;2;255;0;128mx\x1b[49my");
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "x[,#FF0080,0]y[,,0]");
+
+    handler.Reset();
+    handler.Parse("\x1b[1;38;2;1;2;3;48;2;4;5;6mz");
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "z[#010203,#040506,1]");
+    return true;
+}
+
+TEST_FUNC(test_ansi_osc_terminated_with_st)
+{
+    clAnsiEscapeCodeHandler handler;
+    handler.Parse("\x1b]0;my title\x1b\\visible");
+    CHECK_WXSTRING(handler.GetWindowTitle(), "my title");
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "visible[,,0]");
+
+    // the ESC of the ST starts the next sequence
+    handler.Reset();
+    handler.Parse("\x1b]2;other\x1b[38;2;1;2;3mred");
+    CHECK_WXSTRING(handler.GetWindowTitle(), "other");
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "red[#010203,,0]");
+
+    // BEL terminated
+    handler.Reset();
+    handler.Parse("\x1b]0;bell\x07text");
+    CHECK_WXSTRING(handler.GetWindowTitle(), "bell");
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "text[,,0]");
+    return true;
+}
+
+TEST_FUNC(test_ansi_sequence_split_across_chunks)
+{
+    clAnsiEscapeCodeHandler handler;
+    handler.Parse("a\x1b");
+    handler.Parse("[38;2;1");
+    handler.Parse("0;20;3");
+    handler.Parse("0mb\x1b]0;ti");
+    handler.Parse("tle\x1b");
+    handler.Parse("\\c");
+    CHECK_SIZE(handler.GetLineCount(), 1);
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "a[,,0]bc[#0A141E,,0]");
+    CHECK_WXSTRING(handler.GetWindowTitle(), "title");
+    return true;
+}
+
+TEST_FUNC(test_ansi_chunked_input)
+{
+    // whatever the chunks are, the result must be the same as parsing the whole input at once
+    wxString input = "plain\n"
+                     "\x1b[1;32mbold green\x1b[0m and \x1b[38;5;208m8 bit\x1b[m\r\n"
+                     "progress 10%\rprogress \x1b[48;2;0;0;255m20%\x1b[0m\n"
+                     "\x1b]0;title\x1b\\\x1b[38;2;10;20;30;48;2;40;50;60mtrue colour\x1b[K cleared\n"
+                     "\x1b(Bcharset \x1b[3;4mitalic underlined";
+
+    clAnsiEscapeCodeHandler whole;
+    whole.Parse(input);
+    CHECK_SIZE(whole.GetLineCount(), 5);
+    CHECK_WXSTRING(ansi_describe_line(whole, 0), "plain[,,0]");
+    CHECK_WXSTRING(ansi_describe_line(whole, 2), "progress [,,0]20%[,#0000FF,0]");
+    CHECK_WXSTRING(ansi_describe_line(whole, 3), " cleared[#0A141E,#28323C,0]");
+    // the attributes are kept across lines
+    CHECK_WXSTRING(ansi_describe_line(whole, 4),
+                   "charset [#0A141E,#28323C,0]italic underlined[#0A141E,#28323C,12]");
+    CHECK_WXSTRING(whole.GetWindowTitle(), "title");
+
+    wxString expected = ansi_describe(whole);
+    for(size_t chunk_size = 1; chunk_size <= input.length(); ++chunk_size) {
+        clAnsiEscapeCodeHandler handler;
+        ansi_parse_chunks(handler, input, chunk_size);
+        CHECK_WXSTRING(ansi_describe(handler), expected);
+    }
+    return true;
+}
+
+TEST_FUNC(test_ansi_parse_line)
+{
+    // every line parsed with ParseLine() is independent of the previous ones
+    clAnsiEscapeCodeHandler handler;
+    CHECK_EXPECTED(handler.ParseLine("\x1b[38;2;1;2;3mred\x1b"), 0);
+    CHECK_EXPECTED(handler.ParseLine("[31mplain"), 1);
+    CHECK_EXPECTED(handler.ParseLine(""), 2);
+    CHECK_SIZE(handler.GetLineCount(), 3);
+    CHECK_WXSTRING(ansi_describe_line(handler, 0), "red[#010203,,0]");
+    CHECK_WXSTRING(ansi_describe_line(handler, 1), "[31mplain[,,0]");
+    CHECK_WXSTRING(ansi_describe_line(handler, 2), "");
+    return true;
+}
+
 int main(int argc, char** argv)
 {
     wxInitializer initializer(argc, argv);
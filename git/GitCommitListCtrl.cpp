@@ -0,0 +1,71 @@
+#include "GitCommitListCtrl.h"
+
+#include "GitCommitTable.hpp"
+
+namespace
+{
+// start fetching the next commits when the displayed rows are this close to the end of the list
+constexpr long FETCH_AHEAD_ROWS = 200;
+} // namespace
+
+GitCommitListCtrl::GitCommitListCtrl(wxWindow* parent,
+                                     wxWindowID id,
+                                     const wxPoint& pos,
+                                     const wxSize& size,
+                                     long style,
+                                     const wxValidator& validator,
+                                     const wxString& name)
+    : wxListCtrl(parent, id, pos, size, style, validator, name)
+{
+}
+
+void GitCommitListCtrl::SetData(const GitCommitTable* commits, const std::vector<size_t>* rows)
+{
+    m_commits = commits;
+    m_rows = rows;
+    UpdateItemCount();
+}
+
+void GitCommitListCtrl::UpdateItemCount()
+{
+    size_t count = 0;
+    if (m_rows) {
+        count = m_rows->size();
+    } else if (m_commits) {
+        count = m_commits->GetCount();
+    }
+
+    if ((long)count != GetItemCount()) {
+        SetItemCount(count);
+    }
+    Refresh();
+}
+
+size_t GitCommitListCtrl::GetCommitRow(long item) const
+{
+    if (item < 0 || !m_commits) {
+        return wxString::npos;
+    }
+    if (m_rows) {
+        return (size_t)item < m_rows->size() ? m_rows->at(item) : wxString::npos;
+    }
+    return (size_t)item < m_commits->GetCount() ? (size_t)item : wxString::npos;
+}
+
+size_t GitCommitListCtrl::GetSelectedCommitRow() const
+{
+    return GetCommitRow(GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED));
+}
+
+wxString GitCommitListCtrl::OnGetItemText(long item, long column) const
+{
+    if (m_fetchMore && item + FETCH_AHEAD_ROWS >= GetItemCount()) {
+        m_fetchMore();
+    }
+
+    size_t row = GetCommitRow(item);
+    if (row == wxString::npos || column < 0 || column >= GitCommitTable::kFieldCount) {
+        return wxEmptyString;
+    }
+    return m_commits->GetField(row, (GitCommitTable::eField)column);
+}
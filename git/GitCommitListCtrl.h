@@ -0,0 +1,58 @@
+#ifndef GITCOMMITLISTCTRL_H
+#define GITCOMMITLISTCTRL_H
+
+#include <functional>
+#include <vector>
+#include <wx/listctrl.h>
+
+class GitCommitTable;
+
+/**
+ * @class GitCommitListCtrl
+ * @brief a virtual list (wxLC_VIRTUAL) that displays the rows of a GitCommitTable. Only the visible rows are converted
+ * to text. When the rows near the end of the list are displayed, the "fetch more" callback is called so the owner can
+ * load the next commits before the user reaches the end of the list
+ */
+class GitCommitListCtrl : public wxListCtrl
+{
+    const GitCommitTable* m_commits = nullptr;
+    const std::vector<size_t>* m_rows = nullptr;
+    std::function<void()> m_fetchMore;
+
+public:
+    GitCommitListCtrl(wxWindow* parent,
+                      wxWindowID id,
+                      const wxPoint& pos = wxDefaultPosition,
+                      const wxSize& size = wxDefaultSize,
+                      long style = wxLC_REPORT | wxLC_VIRTUAL,
+                      const wxValidator& validator = wxDefaultValidator,
+                      const wxString& name = wxListCtrlNameStr);
+    virtual ~GitCommitListCtrl() = default;
+
+    /**
+     * @brief set the table to display. If `rows` is not null, only these rows of the table are displayed (filtered
+     * view)
+     */
+    void SetData(const GitCommitTable* commits, const std::vector<size_t>* rows = nullptr);
+    void SetFetchMoreCallback(std::function<void()> cb) { m_fetchMore = std::move(cb); }
+
+    /**
+     * @brief call this after the table (or the filtered rows) changed
+     */
+    void UpdateItemCount();
+
+    /**
+     * @brief return the table row displayed at `item`, or wxString::npos
+     */
+    size_t GetCommitRow(long item) const;
+
+    /**
+     * @brief return the table row of the selected item, or wxString::npos
+     */
+    size_t GetSelectedCommitRow() const;
+
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+};
+
+#endif // GITCOMMITLISTCTRL_H
@@ -0,0 +1,143 @@
+#include "GitCommitTable.hpp"
+
+#include <algorithm>
+
+namespace
+{
+// the fields are separated with the ASCII "unit separator", which can not appear in a commit subject
+constexpr char FIELD_SEPARATOR = '\x1f';
+} // namespace
+
+wxString GitCommitTable::GetLogFormat() { return "--pretty=format:%h%x1f%an%x1f%ci%x1f%s"; }
+
+size_t GitCommitTable::Append(const wxString& output)
+{
+    if (output.empty()) {
+        return 0;
+    }
+
+    const wxScopedCharBuffer buffer = output.ToUTF8();
+    const char* data = buffer.data();
+    size_t len = buffer.length();
+
+    size_t count_before = m_count;
+    size_t line_start = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (data[i] != '\n') {
+            continue;
+        }
+        if (!m_partialLine.empty()) {
+            // complete the line left over from the previous chunk
+            m_partialLine.append(data + line_start, i - line_start);
+            DoParseLine(m_partialLine.c_str(), m_partialLine.length());
+            m_partialLine.clear();
+        } else {
+            DoParseLine(data + line_start, i - line_start);
+        }
+        line_start = i + 1;
+    }
+    m_partialLine.append(data + line_start, len - line_start);
+    return m_count - count_before;
+}
+
+size_t GitCommitTable::Flush()
+{
+    if (m_partialLine.empty()) {
+        return 0;
+    }
+    size_t count_before = m_count;
+    DoParseLine(m_partialLine.c_str(), m_partialLine.length());
+    m_partialLine.clear();
+    return m_count - count_before;
+}
+
+void GitCommitTable::DoParseLine(const char* line, size_t len)
+{
+    if (len && line[len - 1] == '\r') {
+        --len;
+    }
+
+    // locate the fields first, lines that are not in our format (e.g. warnings) are skipped
+    size_t starts[kFieldCount];
+    size_t ends[kFieldCount];
+    size_t field = 0;
+    starts[0] = 0;
+    for (size_t i = 0; i < len && field < kFieldCount - 1; ++i) {
+        if (line[i] == FIELD_SEPARATOR) {
+            ends[field] = i;
+            ++field;
+            starts[field] = i + 1;
+        }
+    }
+    if (field != kFieldCount - 1) {
+        return;
+    }
+    ends[field] = len;
+
+    for (size_t f = 0; f < kFieldCount; ++f) {
+        m_offsets.push_back((uint32_t)m_pool.length());
+        m_pool.append(line + starts[f], ends[f] - starts[f]);
+    }
+    m_offsets.push_back((uint32_t)m_pool.length());
+    ++m_count;
+}
+
+void GitCommitTable::Clear()
+{
+    m_pool.clear();
+    m_offsets.clear();
+    m_partialLine.clear();
+    m_count = 0;
+}
+
+wxString GitCommitTable::GetField(size_t row, eField field) const
+{
+    if (row >= m_count) {
+        return wxEmptyString;
+    }
+    const uint32_t* offsets = m_offsets.data() + row * (kFieldCount + 1);
+    return wxString::FromUTF8(m_pool.data() + offsets[field], offsets[field + 1] - offsets[field]);
+}
+
+GitCommitTable GitCommitTable::Slice(size_t first, size_t last) const
+{
+    GitCommitTable slice;
+    last = std::min(last, m_count);
+    if (first >= last) {
+        return slice;
+    }
+
+    uint32_t pool_start = m_offsets[first * (kFieldCount + 1)];
+    uint32_t pool_end = m_offsets[last * (kFieldCount + 1) - 1];
+    slice.m_pool = m_pool.substr(pool_start, pool_end - pool_start);
+    slice.m_offsets.reserve((last - first) * (kFieldCount + 1));
+    for (size_t i = first * (kFieldCount + 1); i < last * (kFieldCount + 1); ++i) {
+        slice.m_offsets.push_back(m_offsets[i] - pool_start);
+    }
+    slice.m_count = last - first;
+    return slice;
+}
+
+std::vector<size_t> GitCommitTable::FindSubjects(const std::vector<wxString>& words, bool ignore_case) const
+{
+    std::vector<wxString> needles = words;
+    if (ignore_case) {
+        for (wxString& needle : needles) {
+            needle.MakeLower();
+        }
+    }
+
+    std::vector<size_t> matches;
+    for (size_t row = 0; row < m_count; ++row) {
+        wxString subject = GetField(row, kSubject);
+        if (ignore_case) {
+            subject.MakeLower();
+        }
+        bool match = std::all_of(
+            needles.begin(), needles.end(), [&subject](const wxString& needle) { return subject.Contains(needle); });
+        if (match) {
+            matches.push_back(row);
+        }
+    }
+    return matches;
+}
@@ -0,0 +1,75 @@
+#ifndef GITCOMMITTABLE_HPP
+#define GITCOMMITTABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief a compact, append only, table of the commits listed by "git log".
+ *
+ * The output of "git log" (in the format returned by GetLogFormat()) is parsed incrementally, as it arrives from the
+ * process. The fields of all the commits are kept in a single UTF-8 buffer, a commit costs its text plus a few offsets
+ * so a large history can be kept in memory. The fields are converted to wxString only when requested (e.g. for the
+ * visible rows of a virtual list)
+ */
+class GitCommitTable
+{
+public:
+    enum eField {
+        kHash = 0,
+        kAuthor,
+        kDate,
+        kSubject,
+        kFieldCount,
+    };
+
+private:
+    std::string m_pool;
+    // the start offset of each field in m_pool, kFieldCount + 1 entries per row (the last one is the end of the row)
+    std::vector<uint32_t> m_offsets;
+    size_t m_count = 0;
+    std::string m_partialLine;
+
+    void DoParseLine(const char* line, size_t len);
+
+public:
+    GitCommitTable() = default;
+    ~GitCommitTable() = default;
+
+    /**
+     * @brief the "--pretty" argument to pass to "git log"
+     */
+    static wxString GetLogFormat();
+
+    /**
+     * @brief parse a chunk of "git log" output. A line split between two chunks is parsed once it is complete
+     * @return the number of commits added
+     */
+    size_t Append(const wxString& output);
+
+    /**
+     * @brief parse whatever is left from the last chunk. Call this when the process terminates
+     */
+    size_t Flush();
+
+    void Clear();
+    size_t GetCount() const { return m_count; }
+    bool IsEmpty() const { return m_count == 0; }
+
+    wxString GetField(size_t row, eField field) const;
+
+    /**
+     * @brief return a copy of the rows [first, last). Used to search a part of the table on a worker thread while the
+     * table keeps growing
+     */
+    GitCommitTable Slice(size_t first, size_t last) const;
+
+    /**
+     * @brief return the rows whose subject contains all the words in `words`
+     */
+    std::vector<size_t> FindSubjects(const std::vector<wxString>& words, bool ignore_case) const;
+};
+
+#endif // GITCOMMITTABLE_HPP
@@ -0,0 +1,499 @@
+#include "GitIndex.hpp"
+
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <cstring>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#ifndef __WXMSW__
+#include <unistd.h>
+#endif
+
+namespace
+{
+// index entry flags
+constexpr uint16_t FLAG_ASSUME_VALID = 0x8000;
+constexpr uint16_t FLAG_EXTENDED = 0x4000;
+constexpr uint16_t FLAG_STAGE_MASK = 0x3000;
+constexpr uint16_t FLAG_NAME_MASK = 0x0FFF;
+// extended flags (version 3 and later)
+constexpr uint16_t EXT_FLAG_SKIP_WORKTREE = 0x4000;
+
+constexpr uint32_t MODE_TYPE_MASK = 0170000;
+constexpr uint32_t MODE_GITLINK = 0160000;
+constexpr uint32_t MODE_SYMLINK = 0120000;
+constexpr uint32_t MODE_EXECUTABLE = 0100;
+constexpr uint32_t MODE_DIRECTORY = 0040000;
+
+uint32_t ReadUInt32(const unsigned char* p) { return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+uint16_t ReadUInt16(const unsigned char* p) { return (p[0] << 8) | p[1]; }
+
+bool ReadRawFile(const wxString& path, std::string& content)
+{
+    wxFFile fp(path, "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+    content.resize(fp.Length());
+    if (content.empty()) {
+        return true;
+    }
+    return fp.Read(&content[0], content.size()) == content.size();
+}
+
+/// a minimal SHA-1, used to compute git blob hashes
+class SHA1
+{
+    uint32_t m_state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    unsigned char m_block[64];
+    size_t m_blockLen = 0;
+    uint64_t m_totalLen = 0;
+
+    static uint32_t Rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+    void Transform(const unsigned char* block)
+    {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = ReadUInt32(block + i * 4);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = Rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = Rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = Rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+    }
+
+public:
+    void Update(const void* data, size_t len)
+    {
+        const unsigned char* p = (const unsigned char*)data;
+        m_totalLen += len;
+        while (len > 0) {
+            size_t n = std::min(len, sizeof(m_block) - m_blockLen);
+            memcpy(m_block + m_blockLen, p, n);
+            m_blockLen += n;
+            p += n;
+            len -= n;
+            if (m_blockLen == sizeof(m_block)) {
+                Transform(m_block);
+                m_blockLen = 0;
+            }
+        }
+    }
+
+    void Final(unsigned char digest[20])
+    {
+        uint64_t bits = m_totalLen * 8;
+        unsigned char pad = 0x80;
+        Update(&pad, 1);
+        pad = 0;
+        while (m_blockLen != 56) {
+            Update(&pad, 1);
+        }
+        unsigned char len_be[8];
+        for (int i = 0; i < 8; ++i) {
+            len_be[i] = (unsigned char)(bits >> (56 - 8 * i));
+        }
+        Update(len_be, 8);
+        for (int i = 0; i < 5; ++i) {
+            digest[i * 4] = (unsigned char)(m_state[i] >> 24);
+            digest[i * 4 + 1] = (unsigned char)(m_state[i] >> 16);
+            digest[i * 4 + 2] = (unsigned char)(m_state[i] >> 8);
+            digest[i * 4 + 3] = (unsigned char)(m_state[i]);
+        }
+    }
+};
+
+/// compare the git blob hash of `content` with `hash`
+bool IsSameBlob(const std::string& content, const uint8_t hash[20])
+{
+    unsigned char digest[20];
+    SHA1 sha;
+    std::string header = "blob " + std::to_string(content.size());
+    sha.Update(header.c_str(), header.size() + 1); // including the NUL terminator
+    sha.Update(content.data(), content.size());
+    sha.Final(digest);
+    return memcmp(digest, hash, sizeof(digest)) == 0;
+}
+
+#ifndef __WXMSW__
+/// git stores the target of a symbolic link as the blob content
+bool ReadSymlink(const wxString& path, std::string& target)
+{
+    target.resize(4096);
+    ssize_t len = readlink(path.mb_str(wxConvUTF8), &target[0], target.size());
+    if (len < 0 || (size_t)len == target.size()) {
+        return false;
+    }
+    target.resize(len);
+    return true;
+}
+#endif
+
+/// return the .git folder of a working tree (it can be a file pointing to the real folder)
+wxString GetGitDir(const wxString& repo_dir)
+{
+    wxFileName dotgit(repo_dir, ".git");
+    if (wxFileName::DirExists(dotgit.GetFullPath())) {
+        return dotgit.GetFullPath();
+    }
+
+    // worktrees and submodules: ".git" is a file with "gitdir: <path>"
+    wxString content;
+    if (!dotgit.FileExists() || !FileUtils::ReadFileContent(dotgit, content)) {
+        return wxEmptyString;
+    }
+    content.Trim().Trim(false);
+    if (!content.StartsWith("gitdir:", &content)) {
+        return wxEmptyString;
+    }
+    wxFileName gitdir(content.Trim(false), "");
+    gitdir.MakeAbsolute(repo_dir);
+    return gitdir.GetPath();
+}
+} // namespace
+
+bool GitIndex::Load(const wxString& repo_dir)
+{
+    m_repoDir = repo_dir;
+    m_indexFile.clear();
+    m_entries.clear();
+    m_pathToEntry.clear();
+    m_statCache.clear();
+    m_contentCompareReliable = true;
+    m_checkExecBit = true;
+
+    wxString gitdir = GetGitDir(repo_dir);
+    if (gitdir.empty()) {
+        return false;
+    }
+
+    wxString index_file = wxFileName(gitdir, "index").GetFullPath();
+    wxStructStat st;
+    if (wxStat(index_file, &st) != 0) {
+        return false;
+    }
+
+    std::string content;
+    if (!ReadRawFile(index_file, content)) {
+        return false;
+    }
+
+    // read the config before parsing: SHA-256 repositories use a different index layout
+    wxString config;
+    if (FileUtils::ReadFileContent(wxFileName(gitdir, "config"), config)) {
+        config.Replace(" ", wxEmptyString);
+        config.Replace("\t", wxEmptyString);
+        config.MakeLower();
+        if (config.Contains("objectformat=sha256")) {
+            clDEBUG() << "Git index: SHA-256 repositories are not supported" << endl;
+            return false;
+        }
+    }
+
+    if (!DoParse(content)) {
+        m_entries.clear();
+        m_pathToEntry.clear();
+        return false;
+    }
+
+    m_indexFile = index_file;
+    m_indexMTime = st.st_mtime;
+    m_indexSize = st.st_size;
+    DoReadConfig();
+    if (config.Contains("autocrlf=true") || config.Contains("autocrlf=input")) {
+        m_contentCompareReliable = false;
+    }
+    if (config.Contains("filemode=false")) {
+        m_checkExecBit = false;
+    }
+    clDEBUG() << "Git index:" << m_entries.size() << "entries loaded from" << m_indexFile << endl;
+    return true;
+}
+
+void GitIndex::DoReadConfig()
+{
+#ifdef __WXMSW__
+    // git for Windows enables core.autocrlf in its system wide configuration and has no executable bit
+    m_contentCompareReliable = false;
+    m_checkExecBit = false;
+#endif
+
+    // the user's global configuration
+    wxString global_config;
+    wxFileName global_config_file(wxGetHomeDir(), ".gitconfig");
+    if (global_config_file.FileExists() && FileUtils::ReadFileContent(global_config_file, global_config)) {
+        global_config.Replace(" ", wxEmptyString);
+        global_config.Replace("\t", wxEmptyString);
+        global_config.MakeLower();
+        if (global_config.Contains("autocrlf=true") || global_config.Contains("autocrlf=input")) {
+            m_contentCompareReliable = false;
+        }
+    }
+
+    // content conversion or filters declared in .gitattributes
+    wxString attributes;
+    wxFileName attributes_file(m_repoDir, ".gitattributes");
+    if (attributes_file.FileExists() && FileUtils::ReadFileContent(attributes_file, attributes)) {
+        if (attributes.Contains("text") || attributes.Contains("eol=") || attributes.Contains("filter=") ||
+            attributes.Contains("ident")) {
+            m_contentCompareReliable = false;
+        }
+    }
+}
+
+bool GitIndex::DoParse(const std::string& content)
+{
+    const unsigned char* data = (const unsigned char*)content.data();
+    const size_t size = content.size();
+
+    // header (12 bytes) + trailing checksum (20 bytes)
+    if (size < 32 || memcmp(data, "DIRC", 4) != 0) {
+        return false;
+    }
+
+    uint32_t version = ReadUInt32(data + 4);
+    uint32_t count = ReadUInt32(data + 8);
+    if (version < 2 || version > 4) {
+        clDEBUG() << "Git index: unsupported version" << version << endl;
+        return false;
+    }
+
+    m_entries.reserve(count);
+    m_pathToEntry.reserve(count);
+
+    const size_t end = size - 20;
+    size_t offset = 12;
+    std::string prev_path;
+    for (uint32_t i = 0; i < count; ++i) {
+        const size_t entry_start = offset;
+        // fixed part: 10 x 32 bit stat fields, 20 bytes of hash, 16 bit flags
+        if (offset + 62 > end) {
+            return false;
+        }
+        const unsigned char* p = data + offset;
+        Entry entry;
+        entry.mtime_sec = ReadUInt32(p + 8);
+        entry.mtime_nsec = ReadUInt32(p + 12);
+        entry.mode = ReadUInt32(p + 24);
+        entry.size = ReadUInt32(p + 36);
+        memcpy(entry.hash, p + 40, 20);
+        uint16_t flags = ReadUInt16(p + 60);
+        offset += 62;
+
+        entry.assume_valid = flags & FLAG_ASSUME_VALID;
+        if (flags & FLAG_EXTENDED) {
+            if (version < 3 || offset + 2 > end) {
+                return false;
+            }
+            uint16_t ext_flags = ReadUInt16(data + offset);
+            entry.skip_worktree = ext_flags & EXT_FLAG_SKIP_WORKTREE;
+            offset += 2;
+        }
+
+        std::string path;
+        if (version == 4) {
+            // the path is compressed: number of bytes to strip from the previous path + NUL terminated suffix
+            size_t strip = 0;
+            unsigned char c = 0;
+            do {
+                if (offset >= end) {
+                    return false;
+                }
+                c = data[offset++];
+                strip = (strip << 7) | (c & 0x7F);
+                if (c & 0x80) {
+                    ++strip;
+                }
+            } while (c & 0x80);
+            if (strip > prev_path.size()) {
+                return false;
+            }
+            const char* suffix = (const char*)data + offset;
+            size_t suffix_len = strnlen(suffix, end - offset);
+            if (offset + suffix_len >= end) {
+                return false;
+            }
+            path = prev_path.substr(0, prev_path.size() - strip);
+            path.append(suffix, suffix_len);
+            offset += suffix_len + 1;
+
+        } else {
+            size_t name_len = flags & FLAG_NAME_MASK;
+            const char* name = (const char*)data + offset;
+            if (name_len == FLAG_NAME_MASK) {
+                // long name: look for the terminator
+                name_len = strnlen(name, end - offset);
+            }
+            if (offset + name_len >= end) {
+                return false;
+            }
+            path.assign(name, name_len);
+            // entries are padded with 1-8 NUL bytes to a multiple of 8
+            size_t entry_len = offset - entry_start + name_len;
+            offset = entry_start + ((entry_len + 8) & ~(size_t)7);
+        }
+        prev_path = path;
+
+        // sparse directory entries and submodules are not files in the working tree
+        uint32_t type = entry.mode & MODE_TYPE_MASK;
+        if (type == MODE_DIRECTORY || type == MODE_GITLINK) {
+            continue;
+        }
+
+        // conflicts (stage > 0) appear once per stage, keep only one entry per path
+        entry.path = wxString(path.c_str(), wxConvUTF8);
+        if ((flags & FLAG_STAGE_MASK) && !m_entries.empty() && m_entries.back().path == entry.path) {
+            continue;
+        }
+        wxFileName fn(m_repoDir + "/" + entry.path);
+        m_pathToEntry.insert({ fn.GetFullPath(), m_entries.size() });
+        m_entries.push_back(entry);
+    }
+
+    // the split index extension means that the entries we read are not complete
+    while (offset + 8 <= end) {
+        if (memcmp(data + offset, "link", 4) == 0) {
+            clDEBUG() << "Git index: split index is not supported" << endl;
+            return false;
+        }
+        offset += 8 + ReadUInt32(data + offset + 4);
+    }
+    return true;
+}
+
+bool GitIndex::IsStale() const
+{
+    if (m_indexFile.empty()) {
+        return true;
+    }
+    wxStructStat st;
+    if (wxStat(m_indexFile, &st) != 0) {
+        return true;
+    }
+    return st.st_mtime != m_indexMTime || st.st_size != m_indexSize;
+}
+
+void GitIndex::GetTrackedFiles(wxStringSet_t& files) const
+{
+    files.clear();
+    files.reserve(m_pathToEntry.size());
+    for (const auto& vt : m_pathToEntry) {
+        files.insert(vt.first);
+    }
+}
+
+void GitIndex::GetModifiedFiles(wxStringSet_t& files)
+{
+    files.clear();
+    for (const auto& vt : m_pathToEntry) {
+        if (DoIsModified(m_entries[vt.second], vt.first)) {
+            files.insert(vt.first);
+        }
+    }
+}
+
+bool GitIndex::IsModified(const wxString& fullpath, bool* tracked)
+{
+    auto iter = m_pathToEntry.find(wxFileName(fullpath).GetFullPath());
+    *tracked = iter != m_pathToEntry.end();
+    if (!*tracked) {
+        return false;
+    }
+    return DoIsModified(m_entries[iter->second], iter->first);
+}
+
+bool GitIndex::DoIsModified(const Entry& entry, const wxString& fullpath)
+{
+    if (entry.assume_valid || entry.skip_worktree) {
+        return false;
+    }
+
+    // git records the stat info of the link itself, not of its target
+    wxStructStat st;
+#ifdef __WXMSW__
+    int rc = wxStat(fullpath, &st);
+#else
+    int rc = wxLstat(fullpath, &st);
+#endif
+    if (rc != 0) {
+        // deleted
+        return true;
+    }
+
+#ifndef __WXMSW__
+    const bool is_symlink = (entry.mode & MODE_TYPE_MASK) == MODE_SYMLINK;
+    // a file replaced by a link or vice versa
+    if (is_symlink != S_ISLNK(st.st_mode)) {
+        return true;
+    }
+
+    // chmod +x / -x
+    if (!is_symlink && m_checkExecBit && ((st.st_mode & S_IXUSR) != 0) != ((entry.mode & MODE_EXECUTABLE) != 0)) {
+        return true;
+    }
+#endif
+
+    // the index keeps the lower 32 bits of the size
+    if ((uint32_t)st.st_size != entry.size) {
+        return true;
+    }
+
+    // same stat info as recorded by git. If the file was written in the same second as the index, it could have been
+    // modified after git recorded it ("racy git"), so compare the content
+    if ((uint32_t)st.st_mtime == entry.mtime_sec && st.st_mtime < m_indexMTime) {
+        return false;
+    }
+
+    // did we already check this version of the file?
+    auto iter = m_statCache.find(fullpath);
+    if (iter != m_statCache.end() && iter->second.mtime == st.st_mtime && iter->second.size == st.st_size) {
+        return iter->second.modified;
+    }
+
+    // for links, compare the link text. Without symlink support (core.symlinks=false) git checks them out as plain
+    // files holding the link text, so reading the file gives the same result
+    bool modified = true;
+    std::string content;
+#ifndef __WXMSW__
+    bool content_ok = is_symlink ? ReadSymlink(fullpath, content) : ReadRawFile(fullpath, content);
+#else
+    bool content_ok = ReadRawFile(fullpath, content);
+#endif
+    if (content_ok) {
+        modified = !IsSameBlob(content, entry.hash);
+    }
+    m_statCache[fullpath] = { st.st_mtime, (long long)st.st_size, modified };
+    return modified;
+}
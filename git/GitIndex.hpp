@@ -0,0 +1,97 @@
+#ifndef GITINDEX_HPP
+#define GITINDEX_HPP
+
+#include "wxStringHash.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief an in-process reader of the repository's .git/index file.
+ *
+ * The index lists the tracked files together with the stat information (mtime, size) and the blob hash git recorded
+ * for them. This is enough to tell which files are tracked and which of them were modified in the working tree,
+ * without running "git ls-files". Files whose stat information did not change since they were checked are not read
+ * again (this is what git does as well).
+ */
+class GitIndex
+{
+public:
+    struct Entry {
+        wxString path; // relative to the repository root, with '/' as separator
+        uint32_t mtime_sec = 0;
+        uint32_t mtime_nsec = 0;
+        uint32_t size = 0;
+        uint32_t mode = 0;
+        uint8_t hash[20] = { 0 };
+        bool skip_worktree = false;
+        bool assume_valid = false;
+    };
+
+private:
+    struct StatCacheEntry {
+        time_t mtime = 0;
+        long long size = -1;
+        bool modified = false;
+    };
+
+    wxString m_repoDir;
+    wxString m_indexFile;
+    time_t m_indexMTime = 0;
+    long long m_indexSize = -1;
+    std::vector<Entry> m_entries;
+    std::unordered_map<wxString, size_t> m_pathToEntry; // full path -> index in m_entries
+    std::unordered_map<wxString, StatCacheEntry> m_statCache;
+    bool m_contentCompareReliable = true;
+    bool m_checkExecBit = true; // core.filemode
+
+    bool DoParse(const std::string& content);
+    bool DoIsModified(const Entry& entry, const wxString& fullpath);
+    void DoReadConfig();
+
+public:
+    GitIndex() = default;
+    ~GitIndex() = default;
+
+    /**
+     * @brief load the index of the repository rooted at `repo_dir`
+     * @return false if the index does not exist or uses an unsupported format (split index, SHA-256 repository)
+     */
+    bool Load(const wxString& repo_dir);
+
+    /**
+     * @brief return true if the index file changed on disk since it was loaded
+     */
+    bool IsStale() const;
+
+    bool IsOk() const { return !m_indexFile.empty(); }
+
+    /**
+     * @brief can we tell whether a file was modified by comparing its content with the index? This is not the case
+     * when git converts the content on checkout (core.autocrlf, .gitattributes filters)
+     */
+    bool CanDetectModifiedFiles() const { return m_contentCompareReliable; }
+
+    const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+    /**
+     * @brief return the full paths of the tracked files
+     */
+    void GetTrackedFiles(wxStringSet_t& files) const;
+
+    /**
+     * @brief return the full paths of the tracked files that differ from the index (including deleted files)
+     */
+    void GetModifiedFiles(wxStringSet_t& files);
+
+    /**
+     * @brief check a single file
+     * @param tracked [output] set to true if the file is tracked
+     * @return true if the file is tracked and was modified
+     */
+    bool IsModified(const wxString& fullpath, bool* tracked);
+};
+
+#endif // GITINDEX_HPP
@@ -478,6 +478,8 @@ void GitPlugin::HookPopupMenu(wxMenu* menu, MenuType type)
 void GitPlugin::UnPlug()
 {
     ClearCodeLiteRemoteInfo();
+    DoJoinGitIndexThread();
+    DoKillReadOnlyProcesses();
     // before this plugin is un-plugged we must remove the tab we added
     if (!m_mgr->BookDeletePage(PaneId::BOTTOM_BAR, m_console)) {
         m_console->Destroy();
@@ -859,9 +861,15 @@ void GitPlugin::OnCommit(wxCommandEvent& e)
 void GitPlugin::OnCommitList(wxCommandEvent& e)
 {
     wxUnusedVar(e);
-    gitAction ga(gitCommitList, wxT(""));
-    m_gitActionQueue.push_back(ga);
-    ProcessGitActionQueue();
+    if (m_repositoryDirectory.empty()) {
+        return;
+    }
+
+    if (!m_commitListDlg) {
+        m_commitListDlg = new GitCommitListDlg(EventNotifier::Get()->TopFrame(), m_repositoryDirectory, this);
+    }
+    m_commitListDlg->LoadCommits(wxEmptyString);
+    m_commitListDlg->Display();
 }
 
 void GitPlugin::OnShowDiffs(wxCommandEvent& e)
@@ -1054,6 +1062,13 @@ void GitPlugin::DoAnyFileModified()
 void GitPlugin::OnFileSaved(clCommandEvent& e)
 {
     e.Skip();
+    if (!m_isRemoteWorkspace && DoUpdateFileStatusFromIndex(e.GetFileName())) {
+        // only the saved file needs to be checked
+        CHECK_VIEW_SHOWN();
+        DoLoadBlameInfo(true);
+        RefreshFileListView();
+        return;
+    }
     DoAnyFileModified();
 }
 
@@ -1123,24 +1138,132 @@ void GitPlugin::OnWorkspaceLoaded(clWorkspaceEvent& e)
     CallAfter(&GitPlugin::DoRefreshView, false);
 }
 
-void GitPlugin::ProcessGitActionQueue()
+bool GitPlugin::IsReadOnlyAction(int action)
 {
-    if (m_gitActionQueue.size() == 0)
-        return;
+    switch (action) {
+    case gitBlameSummary:
+    case gitBlame:
+    case gitDiffFile:
+    case gitDiffRepoShow:
+    case gitRevlist:
+    case gitListAll:
+    case gitListModified:
+    case gitStatus:
+    case gitListRemotes:
+    case gitBranchCurrent:
+    case gitBranchList:
+    case gitBranchListRemote:
+        return true;
+    default:
+        return false;
+    }
+}
 
-    // Sanity:
-    // if there is no repo and the command is not 'clone'
-    // return
-    gitAction ga = m_gitActionQueue.front();
-    if (m_repositoryDirectory.IsEmpty() && ga.action != gitClone) {
-        m_gitActionQueue.pop_front();
-        return;
+bool GitPlugin::IsInteractiveAction(int action)
+{
+    switch (action) {
+    case gitBlameSummary:
+    case gitBlame:
+    case gitDiffFile:
+    case gitDiffRepoShow:
+        return true;
+    default:
+        return false;
     }
+}
 
-    if (m_process) {
-        return;
+bool GitPlugin::IsWorkingTreeAction(int action)
+{
+    switch (action) {
+    case gitUpdateRemotes:
+    case gitPush:
+        // these only talk to the remote, the working tree and the index are not changed
+        return false;
+    default:
+        return true;
+    }
+}
+
+std::list<gitAction>::iterator GitPlugin::DoFindNextGitAction()
+{
+    auto iter = m_gitActionQueue.begin();
+    if (iter == m_gitActionQueue.end()) {
+        return m_gitActionQueue.end();
+    }
+
+    // the remote workspace runs all its commands through a single codelite-remote process
+    bool concurrency_enabled = !m_isRemoteWorkspace;
+    if (!m_process) {
+        if (!concurrency_enabled || !IsReadOnlyAction(iter->action)) {
+            // a mutating action starts only after the read-only actions queued before it are done
+            bool can_start = !concurrency_enabled || m_readOnlyProcesses.empty() || !IsWorkingTreeAction(iter->action);
+            return can_start ? iter : m_gitActionQueue.end();
+        }
+    } else {
+        // the action at the top of the queue is running
+        if (!concurrency_enabled || IsWorkingTreeAction(iter->action)) {
+            return m_gitActionQueue.end();
+        }
+        ++iter;
+    }
+
+    if (m_readOnlyProcesses.size() >= MAX_CONCURRENT_GIT_ACTIONS) {
+        return m_gitActionQueue.end();
+    }
+
+    // any read-only action queued before the next mutating action can start now. Actions requested by the user come
+    // first, the background refreshes next
+    auto first_read_only = m_gitActionQueue.end();
+    for (; iter != m_gitActionQueue.end() && IsReadOnlyAction(iter->action); ++iter) {
+        if (IsInteractiveAction(iter->action)) {
+            return iter;
+        }
+        if (first_read_only == m_gitActionQueue.end()) {
+            first_read_only = iter;
+        }
+    }
+    return first_read_only;
+}
+
+void GitPlugin::ProcessGitActionQueue()
+{
+    while (true) {
+        auto iter = DoFindNextGitAction();
+        if (iter == m_gitActionQueue.end()) {
+            break;
+        }
+
+        // Sanity:
+        // if there is no repo and the command is not 'clone'
+        // drop it
+        gitAction ga = *iter;
+        if (m_repositoryDirectory.IsEmpty() && ga.action != gitClone) {
+            m_gitActionQueue.erase(iter);
+            continue;
+        }
+
+        if ((ga.action == gitListAll || (ga.action == gitListModified && m_gitIndexCanDetectModified)) &&
+            DoScanGitIndex()) {
+            // the file lists are read from the index file, no need to run git
+            m_gitActionQueue.erase(iter);
+            continue;
+        }
+
+        // read-only actions are removed from the queue once started, the queue top is kept for the running
+        // mutating action
+        bool concurrent = !m_isRemoteWorkspace && IsReadOnlyAction(ga.action);
+        if (concurrent) {
+            m_gitActionQueue.erase(iter);
+        }
+
+        if (!DoRunGitAction(ga, concurrent)) {
+            break;
+        }
     }
+}
 
+bool GitPlugin::DoRunGitAction(const gitAction& ga, bool concurrent)
+{
     wxString command_args;
     size_t createFlags = 0;
     bool log_message = false;
@@ -1302,12 +1425,6 @@ void GitPlugin::ProcessGitActionQueue()
         createFlags |= IProcessRawOutput;
         break;
 
-    case gitCommitList:
-        ShowProgress(wxT("Fetching commit list"));
-        // hash @ author-name @ date @ subject
-        command_args << wxT("--no-pager log --pretty=\"%h@%an@%ci@%s\" -n 100 ") << ga.arguments;
-        break;
-
     case gitBlame:
         command_args << "--no-pager blame --line-porcelain " << ga.arguments;
         log_message = true;
@@ -1334,7 +1451,10 @@ void GitPlugin::ProcessGitActionQueue()
 
     default:
         GIT_MESSAGE(wxT("Unknown git action"));
-        return;
+        if (!concurrent) {
+            m_gitActionQueue.pop_front();
+        }
+        return true;
     }
 
     clConfig conf("git.conf");
@@ -1375,16 +1495,26 @@ void GitPlugin::ProcessGitActionQueue()
         GIT_MESSAGE("Launching command: %s", cmd);
         FileUtils::OpenTerminal(workingDirectory, cmd);
         m_gitActionQueue.pop_front();
+    } else if (concurrent) {
+        IProcess* process =
+            AsyncRunGit(this, command_args, createFlags | IProcessWrapInShell, workingDirectory, log_message);
+        if (!process) {
+            GIT_MESSAGE(wxT("Failed to execute git command!"));
+            return true;
+        }
+        m_readOnlyProcesses.insert({ process, { ga, wxEmptyString } });
     } else {
         m_process = AsyncRunGit(this, command_args, createFlags | IProcessWrapInShell, workingDirectory, log_message);
         if (!m_process) {
             GIT_MESSAGE(wxT("Failed to execute git command!"));
             DoRecoverFromGitCommandError();
+            return false;
         }
     }
+    return true;
 }
 
-void GitPlugin::FinishGitListAction(const gitAction& ga)
+void GitPlugin::FinishGitListAction(const gitAction& ga, const wxString& output)
 {
     clConfig conf("git.conf");
     GitEntry data;
@@ -1393,7 +1523,7 @@ void GitPlugin::FinishGitListAction(const gitAction& ga)
     if (!(data.GetFlags() & GitEntry::ColourTreeView))
         return;
 
-    wxArrayString tmpArray = wxStringTokenize(m_commandOutput, wxT("\n"), wxTOKEN_STRTOK);
+    wxArrayString tmpArray = wxStringTokenize(output, wxT("\n"), wxTOKEN_STRTOK);
 
     // Convert path to absolute
     for (unsigned i = 0; i < tmpArray.GetCount(); ++i) {
@@ -1407,51 +1537,188 @@ void GitPlugin::FinishGitListAction(const gitAction& ga)
     gitFileSet.insert(tmpArray.begin(), tmpArray.end());
 
     if (ga.action == gitListAll) {
-        m_mgr->SetStatusMessage(_("Colouring tracked git files..."), 0);
-        ColourFileTree(m_mgr->GetWorkspaceTree(), gitFileSet, OverlayTool::Bmp_OK);
-        m_trackedFiles.swap(gitFileSet);
+        DoUpdateTrackedFiles(gitFileSet);
 
     } else if (ga.action == gitListModified) {
-        m_mgr->SetStatusMessage(_("Colouring modified git files..."), 0);
-        // Reset modified files
-        ColourFileTree(m_mgr->GetWorkspaceTree(), m_modifiedFiles, OverlayTool::Bmp_OK);
-        // First get an up to date map of the filepaths/treeitemids
-        // (Trying to cache these results in segfaults when the tree has been modified)
-        std::map<wxString, wxTreeItemId> IDs;
-        CreateFilesTreeIDsMap(IDs);
-
-        // Now filter using the list of modified files, gitFileList, to find which IDs to colour differently
-        wxStringSet_t toColour;
-        wxStringSet_t::const_iterator iter = gitFileSet.begin();
-        for (; iter != gitFileSet.end(); ++iter) {
-            wxTreeItemId id = IDs[(*iter)];
-            if (id.IsOk()) {
-                DoSetTreeItemImage(m_mgr->GetWorkspaceTree(), id, OverlayTool::Bmp_Modified);
+        DoUpdateModifiedFiles(gitFileSet);
+    }
+}
 
-            } else {
-                toColour.insert(*iter);
+void GitPlugin::DoUpdateTrackedFiles(wxStringSet_t& files)
+{
+    m_mgr->SetStatusMessage(_("Colouring tracked git files..."), 0);
+    ColourFileTree(m_mgr->GetWorkspaceTree(), files, OverlayTool::Bmp_OK);
+    m_trackedFiles.swap(files);
+    m_mgr->SetStatusMessage("", 0);
+}
+
+void GitPlugin::DoUpdateModifiedFiles(wxStringSet_t& files)
+{
+    m_mgr->SetStatusMessage(_("Colouring modified git files..."), 0);
+    // Reset modified files
+    ColourFileTree(m_mgr->GetWorkspaceTree(), m_modifiedFiles, OverlayTool::Bmp_OK);
+    // First get an up to date map of the filepaths/treeitemids
+    // (Trying to cache these results in segfaults when the tree has been modified)
+    std::map<wxString, wxTreeItemId> IDs;
+    CreateFilesTreeIDsMap(IDs);
+
+    // Now filter using the list of modified files, gitFileList, to find which IDs to colour differently
+    wxStringSet_t toColour;
+    wxStringSet_t::const_iterator iter = files.begin();
+    for (; iter != files.end(); ++iter) {
+        wxTreeItemId id = IDs[(*iter)];
+        if (id.IsOk()) {
+            DoSetTreeItemImage(m_mgr->GetWorkspaceTree(), id, OverlayTool::Bmp_Modified);
+
+        } else {
+            toColour.insert(*iter);
+        }
+    }
+
+    if (!toColour.empty()) {
+        ColourFileTree(m_mgr->GetWorkspaceTree(), toColour, OverlayTool::Bmp_Modified);
+    }
+
+    // Finally, cache the modified-files list: it's used in other functions
+    m_modifiedFiles.swap(files);
+    m_mgr->SetStatusMessage("", 0);
+}
+
+bool GitPlugin::DoScanGitIndex()
+{
+    if (m_isRemoteWorkspace || m_repositoryDirectory.empty() || m_gitIndexUnsupported) {
+        return false;
+    }
+
+    if (m_gitIndexThread) {
+        // a scan is already running, scan again once it is done
+        m_gitIndexScanPending = true;
+        return true;
+    }
+
+    wxString repo_dir = m_repositoryDirectory;
+    m_gitIndexThread = new std::thread([this, repo_dir]() {
+        auto result = std::make_shared<GitIndexScanResult>();
+        result->repo_dir = repo_dir;
+        result->index = std::make_shared<GitIndex>();
+        result->ok = result->index->Load(repo_dir);
+        if (result->ok) {
+            result->index->GetTrackedFiles(result->tracked);
+            result->modified_ok = result->index->CanDetectModifiedFiles();
+            if (result->modified_ok) {
+                result->index->GetModifiedFiles(result->modified);
             }
         }
+        CallAfter(&GitPlugin::OnGitIndexScanned, result);
+    });
+    return true;
+}
+
+void GitPlugin::OnGitIndexScanned(std::shared_ptr<GitIndexScanResult> result)
+{
+    DoJoinGitIndexThread();
+    if (result->repo_dir != m_repositoryDirectory) {
+        // the repository changed while we were scanning
+        m_gitIndexScanPending = false;
+        return;
+    }
 
-        if (!toColour.empty()) {
-            ColourFileTree(m_mgr->GetWorkspaceTree(), toColour, OverlayTool::Bmp_Modified);
+    if (!result->ok) {
+        clDEBUG() << "git: could not read the index of" << m_repositoryDirectory << ", using git ls-files" << endl;
+        m_gitIndexUnsupported = true;
+        m_gitIndexScanPending = false;
+        m_gitActionQueue.emplace_back(gitListAll, wxT(""));
+        m_gitActionQueue.emplace_back(gitListModified, wxT(""));
+        ProcessGitActionQueue();
+        return;
+    }
+
+    m_gitIndex = result->index;
+    m_bActionRequiresTreUpdate = false;
+
+    clConfig conf("git.conf");
+    GitEntry data;
+    conf.ReadItem(&data);
+    bool colour_tree = data.GetFlags() & GitEntry::ColourTreeView;
+    if (colour_tree) {
+        DoUpdateTrackedFiles(result->tracked);
+    }
+
+    if (result->modified_ok) {
+        if (colour_tree) {
+            DoUpdateModifiedFiles(result->modified);
         }
+    } else {
+        // git converts the files content on checkout, let git compute the modified files
+        m_gitIndexCanDetectModified = false;
+        m_gitActionQueue.emplace_back(gitListModified, wxT(""));
+    }
 
-        // Finally, cache the modified-files list: it's used in other functions
-        m_modifiedFiles.swap(gitFileSet);
+    if (m_gitIndexScanPending) {
+        m_gitIndexScanPending = false;
+        DoScanGitIndex();
     }
-    m_mgr->SetStatusMessage("", 0);
+    ProcessGitActionQueue();
+}
+
+void GitPlugin::DoKillReadOnlyProcesses()
+{
+    for (auto& vt : m_readOnlyProcesses) {
+        vt.first->Detach();
+        delete vt.first;
+    }
+    m_readOnlyProcesses.clear();
+}
+
+void GitPlugin::DoJoinGitIndexThread()
+{
+    if (m_gitIndexThread) {
+        m_gitIndexThread->join();
+        wxDELETE(m_gitIndexThread);
+    }
+}
+
+bool GitPlugin::DoUpdateFileStatusFromIndex(const wxString& fullpath)
+{
+    if (!m_gitIndex || !m_gitIndexCanDetectModified || m_gitIndexThread || m_gitIndex->IsStale()) {
+        return false;
+    }
+
+    bool tracked = false;
+    bool modified = m_gitIndex->IsModified(fullpath, &tracked);
+    if (!tracked) {
+        // untracked files are not coloured
+        return true;
+    }
+
+    wxFileName fn(fullpath);
+    wxString path = fn.GetFullPath();
+    bool was_modified = m_modifiedFiles.count(path) > 0;
+    if (modified == was_modified) {
+        return true;
+    }
+
+    wxStringSet_t files = { path };
+    if (modified) {
+        m_modifiedFiles.insert(path);
+        ColourFileTree(m_mgr->GetWorkspaceTree(), files, OverlayTool::Bmp_Modified);
+    } else {
+        m_modifiedFiles.erase(path);
+        ColourFileTree(m_mgr->GetWorkspaceTree(), files, OverlayTool::Bmp_OK);
+    }
+    return true;
 }
 
-void GitPlugin::ListBranchAction(const gitAction& ga)
+void GitPlugin::ListBranchAction(const gitAction& ga, const wxString& output)
 {
-    wxArrayString gitList = wxStringTokenize(m_commandOutput, wxT("\n"));
+    wxArrayString gitList = wxStringTokenize(output, wxT("\n"));
     if (gitList.GetCount() == 0)
         return;
 
     wxArrayString branchList;
     for (unsigned i = 0; i < gitList.GetCount(); ++i) {
-        if (!gitList[i].Contains(wxT("->"))) {
+        // skip the current branch (marked with '*'), this does not depend on gitBranchCurrent completing first
+        if (!gitList[i].Contains(wxT("->")) && !gitList[i].StartsWith(wxT("*"))) {
             branchList.Add(gitList[i].Mid(2));
         }
     }
@@ -1467,9 +1734,9 @@ void GitPlugin::ListBranchAction(const gitAction& ga)
     }
 }
 
-void GitPlugin::GetCurrentBranchAction(const gitAction& ga)
+void GitPlugin::GetCurrentBranchAction(const gitAction& ga, const wxString& output)
 {
-    wxArrayString gitList = wxStringTokenize(m_commandOutput, wxT("\n"));
+    wxArrayString gitList = wxStringTokenize(output, wxT("\n"));
     if (gitList.GetCount() == 0)
         return;
 
@@ -1488,7 +1755,7 @@ void GitPlugin::GetCurrentBranchAction(const gitAction& ga)
         bmp, m_currentBranch, "Git", _("Using git\nClick to open the git view"));
 }
 
-void GitPlugin::UpdateFileTree()
+void GitPlugin::UpdateFileTree(const wxString& output)
 {
     if (!m_mgr->GetWorkspace()->IsOpen()) {
         return;
@@ -1512,7 +1779,7 @@ void GitPlugin::UpdateFileTree()
     }
     wxFileName rootPath(path);
 
-    wxArrayString gitfiles = wxStringTokenize(m_commandOutput, wxT("\n"));
+    wxArrayString gitfiles = wxStringTokenize(output, wxT("\n"));
     wxArrayString files;
 
     // clProgressDlg *prgDlg = new clProgressDlg (EventNotifier::Get()->TopFrame(), _("Importing files ..."), wxT(""),
@@ -1608,6 +1875,12 @@ void GitPlugin::UpdateFileTree()
 
 void GitPlugin::OnProcessTerminated(clProcessEvent& event)
 {
+    auto iter = m_readOnlyProcesses.find(event.GetProcess());
+    if (iter != m_readOnlyProcesses.end()) {
+        OnReadOnlyProcessTerminated(iter);
+        return;
+    }
+
     HideProgress();
     wxDELETE(m_process);
     if (m_gitActionQueue.empty())
@@ -1639,9 +1912,59 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
         return;
     }
 
+    if (!DoHandleGitActionOutput(ga, m_commandOutput)) {
+        return;
+    }
+
+    m_commandOutput.Clear();
+    m_gitActionQueue.pop_front();
+
+#ifdef __WXGTK__
+    int statLoc;
+    ::waitpid(-1, &statLoc, WNOHANG);
+#endif
+    ProcessGitActionQueue();
+}
+
+void GitPlugin::OnReadOnlyProcessTerminated(std::unordered_map<IProcess*, ReadOnlyProcess>::iterator iter)
+{
+    gitAction ga = iter->second.action;
+    wxString output;
+    output.swap(iter->second.output);
+    delete iter->first;
+    m_readOnlyProcesses.erase(iter);
+
+    if (!m_process) {
+        HideProgress();
+    }
+
+    if (ga.action != gitDiffFile) {
+        // Dont manipulate the output if its a diff...
+        output.Replace(wxT("\r"), wxT(""));
+    }
+
+    if (output.StartsWith(wxT("fatal")) || output.StartsWith(wxT("error"))) {
+        // a failed read-only action does not affect the rest of the queue
+        LOG_IF_TRACE { clDEBUG1() << "[git]" << output << clEndl; }
+        if (ga.action != gitBlameSummary) {
+            GetConsole()->ShowLog();
+        }
+    } else {
+        DoHandleGitActionOutput(ga, output);
+    }
+
+#ifdef __WXGTK__
+    int statLoc;
+    ::waitpid(-1, &statLoc, WNOHANG);
+#endif
+    ProcessGitActionQueue();
+}
+
+bool GitPlugin::DoHandleGitActionOutput(const gitAction& ga, const wxString& output)
+{
     switch (ga.action) {
     case gitBlameSummary: {
-        DoUpdateBlameInfo(m_commandOutput, ga.arguments);
+        DoUpdateBlameInfo(output, ga.arguments);
     } break;
     case gitPush: {
         clSourceControlEvent evt(wxEVT_SOURCE_CONTROL_PUSHED);
@@ -1652,12 +1975,12 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
     case gitListModified:
     case gitResetRepo: {
         if (ga.action == gitListAll && m_bActionRequiresTreUpdate) {
-            if (m_commandOutput.Lower().Contains(_("created"))) {
-                UpdateFileTree();
+            if (output.Lower().Contains(_("created"))) {
+                UpdateFileTree(output);
             }
         }
         m_bActionRequiresTreUpdate = false;
-        FinishGitListAction(ga);
+        FinishGitListAction(ga, output);
         if (ga.action == gitResetRepo) {
             // Reload files if needed
             EventNotifier::Get()->PostReloadExternallyModifiedEvent(true);
@@ -1668,21 +1991,21 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
         }
     } break;
     case gitStatus: {
-        m_console->UpdateTreeView(m_commandOutput);
-        FinishGitListAction(ga);
+        m_console->UpdateTreeView(output);
+        FinishGitListAction(ga, output);
     } break;
     case gitListRemotes: {
-        wxArrayString gitList = wxStringTokenize(m_commandOutput, wxT("\n"));
+        wxArrayString gitList = wxStringTokenize(output, wxT("\n"));
         m_remotes = gitList;
     } break;
     case gitDiffFile: {
 
         // Show the diff in the diff-viewer
-        DoShowDiffViewer(m_commandOutput, ga.arguments);
+        DoShowDiffViewer(output, ga.arguments);
     } break;
     case gitDiffRepoCommit: {
         wxString commitArgs;
-        DoShowCommitDialog(m_commandOutput, commitArgs);
+        DoShowCommitDialog(output, commitArgs);
         if (!commitArgs.IsEmpty()) {
             m_gitActionQueue.emplace_back(gitCommit, commitArgs);
             AddDefaultActions();
@@ -1690,7 +2013,7 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
     } break;
     case gitBlame: {
         GitBlamePage* page = new GitBlamePage(clGetManager()->GetMainNotebook(), this, ga.arguments);
-        page->ParseBlameOutput(m_commandOutput);
+        page->ParseBlameOutput(output);
         wxString tooltip = wxString::Format("[Git Blame]\n%s", ga.arguments);
         wxString title = wxString::Format("[Git Blame]: %s", wxFileName(ga.arguments).GetFullName());
         clGetManager()->AddEditorPage(page, title, tooltip);
@@ -1718,21 +2041,21 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
 
     } break;
     case gitBranchCurrent:
-        GetCurrentBranchAction(ga);
+        GetCurrentBranchAction(ga, output);
         break;
     case gitBranchList:
     case gitBranchListRemote: {
-        ListBranchAction(ga);
+        ListBranchAction(ga, output);
     } break;
     case gitBranchSwitch:
     case gitBranchSwitchRemote:
     case gitPull: {
         if (ga.action == gitPull) {
-            if (m_commandOutput.Contains(wxT("Already"))) {
+            if (output.Contains(wxT("Already"))) {
                 // do nothing
             } else {
-                wxString log = m_commandOutput.Mid(m_commandOutput.Find(wxT("From")));
-                if (m_commandOutput.Contains(wxT("Merge made by"))) {
+                wxString log = output.Mid(output.Find(wxT("From")));
+                if (output.Contains(wxT("Merge made by"))) {
                     if (wxMessageBox(
                             _("Merged after pull. Rebase?"), _("Rebase"), wxYES_NO, EventNotifier::Get()->TopFrame()) ==
                         wxYES) {
@@ -1752,15 +2075,15 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
                         }
 
                         if (selection.IsEmpty())
-                            return;
+                            return false;
 
                         m_gitActionQueue.emplace_back(gitRebase, selection);
                     }
-                } else if (m_commandOutput.Contains(wxT("CONFLICT"))) {
+                } else if (output.Contains(wxT("CONFLICT"))) {
                     // Do nothing, will be coloured in the console view
                     GetConsole()->ShowLog();
                 }
-                if (m_commandOutput.Contains(wxT("Updating")))
+                if (output.Contains(wxT("Updating")))
                     m_bActionRequiresTreUpdate = true;
 
                 if (m_bActionRequiresTreUpdate) {
@@ -1783,13 +2106,6 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
         // Reload files if needed
         EventNotifier::Get()->PostReloadExternallyModifiedEvent(true);
     } break;
-    case gitCommitList: {
-        if (!m_commitListDlg) {
-            m_commitListDlg = new GitCommitListDlg(EventNotifier::Get()->TopFrame(), m_repositoryDirectory, this);
-        }
-        m_commitListDlg->SetCommitList(m_commandOutput);
-        m_commitListDlg->Display();
-    } break;
     case gitCommit: {
         clSourceControlEvent evt(wxEVT_SOURCE_CONTROL_COMMIT_LOCALLY);
         evt.SetSourceControlName("git");
@@ -1810,15 +2126,7 @@ void GitPlugin::OnProcessTerminated(clProcessEvent& event)
         // Reload externally modified files
         EventNotifier::Get()->PostReloadExternallyModifiedEvent(true);
     }
-
-    m_commandOutput.Clear();
-    m_gitActionQueue.pop_front();
-
-#ifdef __WXGTK__
-    int statLoc;
-    ::waitpid(-1, &statLoc, WNOHANG);
-#endif
-    ProcessGitActionQueue();
+    return true;
 }
 
 bool GitPlugin::HandleErrorsOnRemoteRepo(const wxString& output) const
@@ -1844,6 +2152,13 @@ void GitPlugin::OnProcessOutput(clProcessEvent& event)
 {
     wxString output = event.GetOutput();
     auto process = event.GetProcess();
+    auto iter = m_readOnlyProcesses.find(process);
+    if (iter != m_readOnlyProcesses.end()) {
+        // read-only actions do not prompt the user, just collect their output
+        iter->second.output.Append(output);
+        return;
+    }
+
     gitAction ga;
     if (!m_gitActionQueue.empty()) {
         ga = m_gitActionQueue.front();
@@ -1859,7 +2174,7 @@ void GitPlugin::OnProcessOutput(clProcessEvent& event)
     tmpOutput.Trim().Trim(false);
     tmpOutput.MakeLower();
 
-    static std::unordered_set<int> exclude_commands = { gitDiffRepoCommit, gitDiffFile, gitCommitList,  gitDiffRepoShow,
+    static std::unordered_set<int> exclude_commands = { gitDiffRepoCommit, gitDiffFile, gitDiffRepoShow,
                                                         gitBlame,          gitRevlist,  gitBlameSummary };
     if (process && exclude_commands.count(ga.action) == 0) {
         if (HandleErrorsOnRemoteRepo(tmpOutput)) {
@@ -2151,7 +2466,13 @@ void GitPlugin::DoCleanup()
     m_progressMessage.Clear();
     m_commandOutput.Clear();
     m_bActionRequiresTreUpdate = false;
+    DoJoinGitIndexThread();
+    m_gitIndex.reset();
+    m_gitIndexScanPending = false;
+    m_gitIndexUnsupported = false;
+    m_gitIndexCanDetectModified = true;
     wxDELETE(m_process);
+    DoKillReadOnlyProcesses();
     m_mgr->GetDockingManager()->GetPane(PANE_LEFT_SIDEBAR).Caption(PANE_LEFT_SIDEBAR);
     m_mgr->GetDockingManager()->Update();
     m_filesSelected.Clear();
@@ -2805,15 +3126,6 @@ void GitPlugin::WorkspaceClosed()
     m_workspace_file.Clear();
 }
 
-void GitPlugin::FetchNextCommits(int skip, const wxString& args)
-{
-    wxString skipCommits;
-    skipCommits << " --skip=" << skip;
-    gitAction ga(gitCommitList, args + skipCommits);
-    m_gitActionQueue.push_back(ga);
-    ProcessGitActionQueue();
-}
-
 void GitPlugin::OnFileGitBlame(wxCommandEvent& event)
 {
     // Sanity
@@ -2842,11 +3154,8 @@ void GitPlugin::OnFileCommitListSelected(wxCommandEvent& e)
     if (!m_commitListDlg) {
         m_commitListDlg = new GitCommitListDlg(EventNotifier::Get()->TopFrame(), m_repositoryDirectory, this);
     }
-    m_commitListDlg->GetComboExtraArgs()->SetValue(wxT(" -- ") + fn.GetFullPath());
-
-    gitAction ga(gitCommitList, wxT(" -- ") + fn.GetFullPath());
-    m_gitActionQueue.push_back(ga);
-    ProcessGitActionQueue();
+    m_commitListDlg->LoadCommits(wxT(" -- ") + fn.GetFullPath());
+    m_commitListDlg->Display();
 }
 
 void GitPlugin::DisplayMessage(const wxString& message) const
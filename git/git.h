@@ -35,6 +35,7 @@
 
 #include "AsyncProcess/asyncprocess.h"
 #include "AsyncProcess/processreaderthread.h"
+#include "GitIndex.hpp"
 #include "clCodeLiteRemoteProcess.hpp"
 #include "clTabTogglerHelper.h"
 #include "cl_command_event.h"
@@ -46,8 +47,11 @@
 #include "project.h" // wxStringSet_t
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <wx/progdlg.h>
 #if USE_SFTP
@@ -125,7 +129,6 @@ class GitPlugin : public IPlugin
         gitBranchListRemote,
         gitBranchSwitch,
         gitBranchSwitchRemote,
-        gitCommitList,
         gitBlame,
         gitBlameSummary,
         gitRevlist,
@@ -142,6 +145,25 @@ class GitPlugin : public IPlugin
         gitConfig,
     };
 
+    /// The result of reading the .git/index file in the background
+    struct GitIndexScanResult {
+        wxString repo_dir;
+        std::shared_ptr<GitIndex> index;
+        wxStringSet_t tracked;
+        wxStringSet_t modified;
+        bool ok = false;
+        bool modified_ok = false;
+    };
+
+    /// A read-only git action running alongside the action at the top of the queue
+    struct ReadOnlyProcess {
+        gitAction action;
+        wxString output;
+    };
+
+    /// The maximum number of read-only git actions running at the same time
+    static constexpr size_t MAX_CONCURRENT_GIT_ACTIONS = 4;
+
     wxArrayString m_localBranchList;
     wxArrayString m_remoteBranchList;
     wxStringSet_t m_trackedFiles;
@@ -161,6 +183,7 @@ class GitPlugin : public IPlugin
     wxString m_commandOutput;
     bool m_bActionRequiresTreUpdate;
     IProcess* m_process;
+    std::unordered_map<IProcess*, ReadOnlyProcess> m_readOnlyProcesses;
     wxEvtHandler* m_eventHandler;
     clToolBar* m_pluginToolbar;
     wxMenu* m_pluginMenu;
@@ -186,6 +209,11 @@ class GitPlugin : public IPlugin
 #if USE_SFTP
     clSSH::Ptr_t m_ssh;
 #endif
+    std::shared_ptr<GitIndex> m_gitIndex;
+    std::thread* m_gitIndexThread = nullptr;
+    bool m_gitIndexScanPending = false;
+    bool m_gitIndexUnsupported = false;
+    bool m_gitIndexCanDetectModified = true;
 
 private:
     void StartCodeLiteRemote();
@@ -209,10 +237,10 @@ private:
     bool IsWorkspaceOpened() const;
     wxString GetCommitMessageFile() const;
     wxString FindRepositoryRoot(const wxString& starting_dir) const;
-    void FinishGitListAction(const gitAction& ga);
-    void ListBranchAction(const gitAction& ga);
-    void GetCurrentBranchAction(const gitAction& ga);
-    void UpdateFileTree();
+    void FinishGitListAction(const gitAction& ga, const wxString& output);
+    void ListBranchAction(const gitAction& ga, const wxString& output);
+    void GetCurrentBranchAction(const gitAction& ga, const wxString& output);
+    void UpdateFileTree(const wxString& output);
 
     void ShowProgress(const wxString& message, bool pulse = true);
     void HideProgress();
@@ -225,6 +253,27 @@ private:
     void DoLoadBlameInfo(bool clearCache);
     void DoUpdateBlameInfo(const wxString& info, const wxString& fullpath);
     void DoAnyFileModified();
+
+    /// Read the tracked / modified files from .git/index instead of running "git ls-files"
+    /// Returns false if the index can not be used and the caller should fallback to running git
+    bool DoScanGitIndex();
+    void OnGitIndexScanned(std::shared_ptr<GitIndexScanResult> result);
+    void DoJoinGitIndexThread();
+
+    /// Action scheduling: read-only actions (blame, diff, ls-files, show...) run concurrently, mutating actions run
+    /// one at a time, in the order they were queued. Interactive read-only actions are started before the background
+    /// refreshes
+    static bool IsReadOnlyAction(int action);
+    static bool IsInteractiveAction(int action);
+    static bool IsWorkingTreeAction(int action);
+    std::list<gitAction>::iterator DoFindNextGitAction();
+    bool DoRunGitAction(const gitAction& ga, bool concurrent);
+    bool DoHandleGitActionOutput(const gitAction& ga, const wxString& output);
+    void OnReadOnlyProcessTerminated(std::unordered_map<IProcess*, ReadOnlyProcess>::iterator iter);
+    void DoKillReadOnlyProcesses();
+    bool DoUpdateFileStatusFromIndex(const wxString& fullpath);
+    void DoUpdateTrackedFiles(wxStringSet_t& files);
+    void DoUpdateModifiedFiles(wxStringSet_t& files);
     DECLARE_EVENT_TABLE()
 
     // Event handlers
@@ -327,13 +376,6 @@ public:
      */
     IEditor* OpenFile(const wxString& relativePathFile);
 
-    /**
-     * @brief fetch the next 100 commits (skip 'skip' first commits)
-     * and show them in the commit list dialog
-     * @param skip number of first commits to skip
-     */
-    void FetchNextCommits(int skip, const wxString& args);
-
     GitConsole* GetConsole() { return m_console; }
     IProcess* GetProcess() { return m_process; }
     clCommandProcessor* GetFolderProcess() { return m_commandProcessor; }
@@ -37,16 +37,22 @@
 #include "lexer_configuration.h"
 #include "windowattrmanager.h"
 
+#include <algorithm>
 #include <wx/tokenzr.h>
 
 static int ID_COPY_COMMIT_HASH = wxNewId();
 static int ID_REVERT_COMMIT = wxNewId();
 
+// the number of commits loaded at a time
+static const size_t COMMITS_PAGE_SIZE = 500;
+// the number of commits a search loads on its own (without the user scrolling) looking for matches
+static const size_t SEARCH_LOAD_LIMIT = 20000;
+
 GitCommitListDlg::GitCommitListDlg(wxWindow* parent, const wxString& workingDir, GitPlugin* git)
     : GitCommitListDlgBase(parent)
     , m_git(git)
     , m_workingDir(workingDir)
-    , m_skip(0)
+    , m_process(NULL)
 {
     Bind(wxEVT_ASYNC_PROCESS_OUTPUT, &GitCommitListDlg::OnProcessOutput, this);
     Bind(wxEVT_ASYNC_PROCESS_TERMINATED, &GitCommitListDlg::OnProcessTerminated, this);
@@ -56,25 +62,34 @@ GitCommitListDlg::GitCommitListDlg(wxWindow* parent, const wxString& workingDir,
         lex->Apply(m_stcDiff, true);
     }
 
-    m_dvListCtrlCommitList->Connect(ID_COPY_COMMIT_HASH, wxEVT_COMMAND_MENU_SELECTED,
-                                    wxCommandEventHandler(GitCommitListDlg::OnCopyCommitHashToClipboard), NULL, this);
-    m_dvListCtrlCommitList->Connect(ID_REVERT_COMMIT, wxEVT_COMMAND_MENU_SELECTED,
-                                    wxCommandEventHandler(GitCommitListDlg::OnRevertCommit), NULL, this);
+    m_listCtrlCommitList->Connect(ID_COPY_COMMIT_HASH, wxEVT_COMMAND_MENU_SELECTED,
+                                  wxCommandEventHandler(GitCommitListDlg::OnCopyCommitHashToClipboard), NULL, this);
+    m_listCtrlCommitList->Connect(ID_REVERT_COMMIT, wxEVT_COMMAND_MENU_SELECTED,
+                                  wxCommandEventHandler(GitCommitListDlg::OnRevertCommit), NULL, this);
+    m_listCtrlCommitList->SetData(&m_commits);
+    m_listCtrlCommitList->SetFetchMoreCallback([this]() { OnFetchMore(); });
 
     ::clSetDialogBestSizeAndPosition(this);
     CenterOnParent();
 }
 
 /*******************************************************************************/
-GitCommitListDlg::~GitCommitListDlg() { m_git->m_commitListDlg = NULL; }
+GitCommitListDlg::~GitCommitListDlg()
+{
+    if(m_searchThread) {
+        m_searchThread->join();
+        wxDELETE(m_searchThread);
+    }
+    DoStopLog();
+    m_git->m_commitListDlg = NULL;
+}
 
 /*******************************************************************************/
-void GitCommitListDlg::SetCommitList(const wxString& commits)
+void GitCommitListDlg::LoadCommits(const wxString& extra_args)
 {
-    m_commitList = commits;
-    m_history.insert(std::make_pair(m_skip, m_commitList));
-    // Load all commits, un-filtered
-    DoLoadCommits("");
+    m_comboExtraArgs->SetValue(extra_args);
+    m_logArgs = extra_args;
+    DoReloadCommits();
 }
 
 void GitCommitListDlg::Display()
@@ -85,6 +100,151 @@ void GitCommitListDlg::Display()
     CallAfter(&GitCommitListDlg::DoShow);
 }
 
+/*******************************************************************************/
+void GitCommitListDlg::DoReloadCommits()
+{
+    DoStopLog();
+    ClearAll();
+    m_commits.Clear();
+    m_loadTarget = 0;
+    m_logComplete = false;
+    DoResetSearch();
+    DoLoadCommits(COMMITS_PAGE_SIZE);
+}
+
+void GitCommitListDlg::DoStopLog()
+{
+    if(m_logProcess) {
+        m_logProcess->Detach();
+        wxDELETE(m_logProcess);
+    }
+    m_logPaused = false;
+}
+
+void GitCommitListDlg::DoFetchCommits()
+{
+    m_fetchScheduled = false;
+    DoLoadCommits(m_commits.GetCount() + COMMITS_PAGE_SIZE);
+    if(!m_Filter.empty()) {
+        // the user scrolled to the end of the matches, let the search go further
+        m_searchLoadLimit = std::max(m_searchLoadLimit, m_commits.GetCount() + SEARCH_LOAD_LIMIT);
+    }
+}
+
+void GitCommitListDlg::DoLoadCommits(size_t target)
+{
+    m_loadTarget = std::max(m_loadTarget, target);
+    if(m_logComplete || m_commits.GetCount() >= m_loadTarget) {
+        return;
+    }
+
+    if(m_logProcess) {
+        if(m_logPaused) {
+            m_logPaused = false;
+            m_logProcess->ResumeAsyncReads();
+        }
+        return;
+    }
+
+    // a single process for the whole history: paging with --skip would make git walk the loaded commits again
+    wxString command_args;
+    command_args << "--no-pager log " << GitCommitTable::GetLogFormat() << " " << m_logArgs;
+    m_logProcess = m_git->AsyncRunGit(this, command_args, IProcessCreateDefault | IProcessWrapInShell, m_workingDir);
+    if(!m_logProcess) {
+        m_logComplete = true;
+    }
+}
+
+void GitCommitListDlg::OnFetchMore()
+{
+    // called while the list is painting its rows, so only schedule the fetch
+    if(m_fetchScheduled || m_logComplete) {
+        return;
+    }
+    m_fetchScheduled = true;
+    CallAfter(&GitCommitListDlg::DoFetchCommits);
+}
+
+void GitCommitListDlg::DoCommitsAdded(size_t count)
+{
+    if(m_logProcess && !m_logPaused && m_commits.GetCount() >= m_loadTarget) {
+        // enough commits for now, git blocks once the pipe is full
+        m_logPaused = true;
+        m_logProcess->SuspendAsyncReads();
+    }
+    if(count == 0) {
+        return;
+    }
+
+    if(m_Filter.empty()) {
+        m_listCtrlCommitList->UpdateItemCount();
+    } else {
+        DoSearch();
+    }
+}
+
+/*******************************************************************************/
+void GitCommitListDlg::DoResetSearch()
+{
+    // results of a search that is still running are discarded
+    ++m_searchGeneration;
+    m_filteredRows.clear();
+    m_searchedRows = 0;
+    m_searchLoadLimit = m_commits.GetCount() + SEARCH_LOAD_LIMIT;
+    m_listCtrlCommitList->SetData(&m_commits, m_Filter.empty() ? nullptr : &m_filteredRows);
+    DoSearch();
+}
+
+void GitCommitListDlg::DoSearch()
+{
+    if(m_Filter.empty() || m_searchThread) {
+        return;
+    }
+
+    if(m_searchedRows >= m_commits.GetCount()) {
+        // all the loaded commits were searched, load more if the matches do not fill a page. A rare search term
+        // stops at the limit, scrolling to the end of the matches loads more
+        if(m_filteredRows.size() < COMMITS_PAGE_SIZE && m_commits.GetCount() < m_searchLoadLimit) {
+            DoLoadCommits(std::min(m_commits.GetCount() + COMMITS_PAGE_SIZE, m_searchLoadLimit));
+        }
+        return;
+    }
+
+    std::vector<wxString> words;
+    wxArrayString searchStrings = ::wxStringTokenize(m_Filter, " ", wxTOKEN_STRTOK);
+    words.insert(words.end(), searchStrings.begin(), searchStrings.end());
+
+    auto result = std::make_shared<SearchResult>();
+    result->generation = m_searchGeneration;
+    result->first_row = m_searchedRows;
+    auto slice = std::make_shared<GitCommitTable>(m_commits.Slice(m_searchedRows, m_commits.GetCount()));
+    bool ignore_case = m_filterIgnoreCase;
+    m_searchThread = new std::thread([this, result, slice, words, ignore_case]() {
+        result->row_count = slice->GetCount();
+        result->matches = slice->FindSubjects(words, ignore_case);
+        CallAfter(&GitCommitListDlg::OnSearchDone, result);
+    });
+}
+
+void GitCommitListDlg::OnSearchDone(std::shared_ptr<SearchResult> result)
+{
+    if(m_searchThread) {
+        m_searchThread->join();
+        wxDELETE(m_searchThread);
+    }
+
+    if(result->generation == m_searchGeneration) {
+        for(size_t row : result->matches) {
+            m_filteredRows.push_back(result->first_row + row);
+        }
+        m_searchedRows = result->first_row + result->row_count;
+        m_listCtrlCommitList->UpdateItemCount();
+    }
+
+    // search the commits that arrived in the meantime (or restart with the new filter)
+    DoSearch();
+}
+
 /*******************************************************************************/
 void GitCommitListDlg::OnChangeFile(wxCommandEvent& e)
 {
@@ -98,7 +258,15 @@ void GitCommitListDlg::OnChangeFile(wxCommandEvent& e)
 /*******************************************************************************/
 void GitCommitListDlg::OnProcessTerminated(clProcessEvent& event)
 {
-    wxUnusedVar(event);
+    if(m_logProcess && event.GetProcess() == m_logProcess) {
+        // this is the end of the history
+        wxDELETE(m_logProcess);
+        m_logPaused = false;
+        m_logComplete = true;
+        DoCommitsAdded(m_commits.Flush());
+        return;
+    }
+
     wxDELETE(m_process);
 
     ClearAll(false);
@@ -129,44 +297,61 @@ void GitCommitListDlg::OnProcessTerminated(clProcessEvent& event)
     m_stcCommitMessage->SetEditable(false);
 }
 /*******************************************************************************/
-void GitCommitListDlg::OnProcessOutput(clProcessEvent& event) { m_commandOutput.Append(event.GetOutput()); }
+void GitCommitListDlg::OnProcessOutput(clProcessEvent& event)
+{
+    if(m_logProcess && event.GetProcess() == m_logProcess) {
+        // parse the log as it arrives
+        DoCommitsAdded(m_commits.Append(event.GetOutput()));
+        return;
+    }
+    m_commandOutput.Append(event.GetOutput());
+}
+
+wxString GitCommitListDlg::GetSelectedCommitID() const
+{
+    size_t row = m_listCtrlCommitList->GetSelectedCommitRow();
+    if(row == wxString::npos) {
+        return wxEmptyString;
+    }
+    return m_commits.GetField(row, GitCommitTable::kHash);
+}
 
-void GitCommitListDlg::OnSelectionChanged(wxDataViewEvent& event)
+void GitCommitListDlg::OnSelectionChanged(wxListEvent& event)
 {
-    wxVariant v;
-    if(!event.GetItem().IsOk()) {
+    size_t row = m_listCtrlCommitList->GetCommitRow(event.GetIndex());
+    if(row == wxString::npos) {
         return;
     }
 
-    wxString commitID = m_dvListCtrlCommitList->GetItemText(event.GetItem());
+    wxString commitID = m_commits.GetField(row, GitCommitTable::kHash);
     wxString command_args;
     command_args << "--no-pager show --first-parent " << commitID;
     m_process = m_git->AsyncRunGit(this, command_args, IProcessCreateDefault | IProcessWrapInShell, m_workingDir);
 }
 
-void GitCommitListDlg::OnContextMenu(wxDataViewEvent& event)
+void GitCommitListDlg::OnContextMenu(wxListEvent& event)
 {
     wxMenu menu;
     menu.Append(ID_COPY_COMMIT_HASH, _("Copy commit hash to clipboard"));
     menu.Append(ID_REVERT_COMMIT, _("Revert this commit"));
-    m_dvListCtrlCommitList->PopupMenu(&menu);
+    m_listCtrlCommitList->PopupMenu(&menu);
 }
 
 void GitCommitListDlg::OnCopyCommitHashToClipboard(wxCommandEvent& e)
 {
-    wxDataViewItem sel = m_dvListCtrlCommitList->GetSelection();
-    CHECK_ITEM_RET(sel);
-
-    wxString commitID = m_dvListCtrlCommitList->GetItemText(sel);
+    wxString commitID = GetSelectedCommitID();
+    if(commitID.empty()) {
+        return;
+    }
     ::CopyToClipboard(commitID);
 }
 
 void GitCommitListDlg::OnRevertCommit(wxCommandEvent& e)
 {
-    wxDataViewItem sel = m_dvListCtrlCommitList->GetSelection();
-    CHECK_ITEM_RET(sel);
-
-    wxString commitID = m_dvListCtrlCommitList->GetItemText(sel);
+    wxString commitID = GetSelectedCommitID();
+    if(commitID.empty()) {
+        return;
+    }
 
     if(::wxMessageBox(_("Are you sure you want to revert commit #") + commitID, "CodeLite",
                       wxYES_NO | wxCANCEL | wxICON_QUESTION, this) != wxYES) {
@@ -181,29 +366,6 @@ void GitCommitListDlg::OnClose(wxCloseEvent& event)
     Destroy();
 }
 
-void GitCommitListDlg::DoLoadCommits(const wxString& filter)
-{
-    ClearAll();
-
-    // hash @ subject @ author-name @ date
-    wxArrayString gitList = wxStringTokenize(m_commitList, wxT("\n"), wxTOKEN_STRTOK);
-    wxArrayString filters = wxStringTokenize(filter, " ");
-    wxVector<wxVariant> cols;
-    for(unsigned i = 0; i < gitList.GetCount(); ++i) {
-        wxArrayString gitCommit = ::wxStringTokenize(gitList[i], "@");
-        if(gitCommit.GetCount() >= 4) {
-            cols.clear();
-            cols.reserve(4);
-
-            cols.push_back(gitCommit.Item(0));
-            cols.push_back(gitCommit.Item(1));
-            cols.push_back(gitCommit.Item(2));
-            cols.push_back(gitCommit.Item(3));
-            m_dvListCtrlCommitList->AppendItem(cols);
-        }
-    }
-}
-
 void GitCommitListDlg::ClearAll(bool includingCommitlist /*=true*/)
 {
     m_stcCommitMessage->SetEditable(true);
@@ -211,7 +373,7 @@ void GitCommitListDlg::ClearAll(bool includingCommitlist /*=true*/)
     m_stcCommitMessage->ClearAll();
     m_fileListBox->Clear();
     if(includingCommitlist) {
-        m_dvListCtrlCommitList->DeleteAllItems();
+        m_listCtrlCommitList->SetItemCount(0);
     }
     m_diffMap.clear();
     m_stcDiff->ClearAll();
@@ -221,87 +383,27 @@ void GitCommitListDlg::ClearAll(bool includingCommitlist /*=true*/)
 
 void GitCommitListDlg::OnSearchCommitList(wxCommandEvent& event)
 {
-    wxString filter = GetFilterString();
-    if(filter == m_Filter) {
-        return; // No change
-    }
-
-    m_Filter = filter;
-
-    if(m_Filter.empty()) {
-        wxCommandEvent e; // A search-filter has been removed, so reload
-        m_git->OnCommitList(e);
+    // the extra arguments are passed to "git log", changing them reloads the list
+    wxString args = m_comboExtraArgs->GetValue();
+    if(args != m_logArgs) {
+        m_logArgs = args;
+        m_Filter = m_searchCtrlFilter->GetValue();
+        m_filterIgnoreCase = m_checkBoxIgnoreCase->IsChecked();
+        DoReloadCommits();
         return;
     }
 
-    ClearAll();
-
-    m_skip = 0;
-    m_history.clear();
-    m_commitList.clear();
-
-    m_git->FetchNextCommits(m_skip, m_Filter);
-}
-
-wxString GitCommitListDlg::GetFilterString() const
-{
-    wxString args;
+    // the search text filters the loaded commits
     wxString filter = m_searchCtrlFilter->GetValue();
-
-    if(filter.empty() && m_comboExtraArgs->GetValue().empty()) {
-        return args;
-    }
-
-    wxArrayString searchStrings = ::wxStringTokenize(filter, " ", wxTOKEN_STRTOK);
-    for(size_t i = 0; i < searchStrings.size(); ++i) {
-        // Pass each search string using its own --grep field
-        args << " --grep=" << searchStrings.Item(i);
-    }
-
-    if(!searchStrings.IsEmpty()) {
-        //  Limit the commits output to ones that match all given --grep
-        args << " --all-match";
-    }
-
-    if(m_checkBoxIgnoreCase->IsChecked()) {
-        args << " -i";
-    }
-
-    if(!m_comboExtraArgs->GetValue().empty()) {
-        args << ' ' << m_comboExtraArgs->GetValue();
-    }
-
-    return args;
-}
-
-void GitCommitListDlg::OnNext(wxCommandEvent& event)
-{
-    wxUnusedVar(event);
-    m_skip += 100;
-    // Check the cache first
-    if(m_history.count(m_skip)) {
-        SetCommitList(m_history.find(m_skip)->second);
-    } else {
-        m_git->FetchNextCommits(m_skip, m_Filter);
-    }
-}
-
-void GitCommitListDlg::OnPrevious(wxCommandEvent& event)
-{
-    wxUnusedVar(event);
-    int skip = m_skip - 100;
-    if(m_history.count(skip)) {
-        m_skip -= 100;
-        SetCommitList(m_history.find(m_skip)->second);
+    bool ignore_case = m_checkBoxIgnoreCase->IsChecked();
+    if(filter == m_Filter && ignore_case == m_filterIgnoreCase) {
+        return; // No change
     }
-}
-
-void GitCommitListDlg::OnPreviousUI(wxUpdateUIEvent& event) { event.Enable(m_skip >= 100); }
 
-void GitCommitListDlg::OnNextUpdateUI(wxUpdateUIEvent& event)
-{
-    event.Enable(m_dvListCtrlCommitList->GetItemCount() >= 100);
+    m_Filter = filter;
+    m_filterIgnoreCase = ignore_case;
+    ClearAll(false);
+    DoResetSearch();
 }
 
 void GitCommitListDlg::OnBtnClose(wxCommandEvent& event) { Destroy(); }
-
@@ -30,47 +30,85 @@
 //
 //////////////////////////////////////////////////////////////////////////////
 
+
 #ifndef __gitCommitListDlg__
 #define __gitCommitListDlg__
 
+#include "GitCommitTable.hpp"
 #include "cl_command_event.h"
 #include "gitui.h"
 #include "macros.h"
 
-#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
 
 class IProcess;
 class GitPlugin;
 class GitCommitListDlg : public GitCommitListDlgBase
 {
+    /// The result of searching a range of the commit table
+    struct SearchResult {
+        size_t generation = 0;
+        size_t first_row = 0;
+        size_t row_count = 0;
+        std::vector<size_t> matches; // relative to first_row
+    };
+
     GitPlugin* m_git;
     wxStringMap_t m_diffMap;
     wxString m_workingDir;
     wxString m_commandOutput;
     IProcess* m_process;
-    wxString m_commitList;
     wxString m_Filter;
-    int m_skip;
-    std::map<int, wxString> m_history;
+    bool m_filterIgnoreCase = false;
+
+    // the commits are streamed from a single "git log" process. Reading its output is paused once `m_loadTarget`
+    // commits are loaded (git then blocks on the full pipe) and resumed as the user scrolls
+    GitCommitTable m_commits;
+    wxString m_logArgs;
+    IProcess* m_logProcess = nullptr;
+    size_t m_loadTarget = 0;
+    bool m_logPaused = false;
+    bool m_logComplete = false;
+    bool m_fetchScheduled = false;
+
+    // searching the subjects runs in the background over the loaded commits
+    std::vector<size_t> m_filteredRows;
+    size_t m_searchedRows = 0;
+    size_t m_searchGeneration = 0;
+    size_t m_searchLoadLimit = 0; ///< a search loads more commits on its own up to this count
+    std::thread* m_searchThread = nullptr;
 
 protected:
     virtual void OnBtnClose(wxCommandEvent& event);
-    virtual void OnNextUpdateUI(wxUpdateUIEvent& event);
-    virtual void OnNext(wxCommandEvent& event);
-    virtual void OnPrevious(wxCommandEvent& event);
-    virtual void OnPreviousUI(wxUpdateUIEvent& event);
     virtual void OnSearchCommitList(wxCommandEvent& event);
-    void DoLoadCommits(const wxString& filter);
     void ClearAll(bool includingCommitlist = true);
-    wxString GetFilterString() const;
     virtual bool Show(bool show = true) { return wxDialog::Show(show); }
     void DoShow() { wxDialog::Show(); }
 
+    void DoReloadCommits();
+    void DoFetchCommits();
+    /**
+     * @brief load commits until `target` commits are loaded (or the history ends)
+     */
+    void DoLoadCommits(size_t target);
+    void DoStopLog();
+    void DoCommitsAdded(size_t count);
+    void DoResetSearch();
+    void DoSearch();
+    void OnSearchDone(std::shared_ptr<SearchResult> result);
+    void OnFetchMore();
+    wxString GetSelectedCommitID() const;
+
 public:
     GitCommitListDlg(wxWindow* parent, const wxString& workingDir, GitPlugin* git);
     virtual ~GitCommitListDlg();
 
-    void SetCommitList(const wxString& commits);
+    /**
+     * @brief (re)load the commit list, passing `extra_args` to "git log"
+     */
+    void LoadCommits(const wxString& extra_args);
     void Display();
 
 private:
@@ -82,8 +120,8 @@ private:
 
 protected:
     virtual void OnClose(wxCloseEvent& event);
-    virtual void OnContextMenu(wxDataViewEvent& event);
-    virtual void OnSelectionChanged(wxDataViewEvent& event);
+    virtual void OnContextMenu(wxListEvent& event);
+    virtual void OnSelectionChanged(wxListEvent& event);
     void OnRevertCommit(wxCommandEvent& e);
     void OnCopyCommitHashToClipboard(wxCommandEvent& e);
 };
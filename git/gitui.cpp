@@ -585,34 +585,14 @@ GitCommitListDlgBase::GitCommitListDlgBase(
                                           wxDLG_UNIT(m_splitterPage781, wxSize(-1, -1)),
                                           wxTE_PROCESS_ENTER);
     m_searchCtrlFilter->SetToolTip(
-        _("Search for specific text in commits.\nThis uses --grep, and so searches only the text of the commit "
-          "message. To search by author etc, use the 'Extra arguments' box."));
+        _("Search for specific text in the subject of the loaded commits.\nTo search by author etc, use the 'Extra "
+          "arguments' box."));
     m_searchCtrlFilter->SetFocus();
     m_searchCtrlFilter->ShowSearchButton(true);
     m_searchCtrlFilter->ShowCancelButton(false);
 
     flexGridSizer800->Add(m_searchCtrlFilter, 1, wxALL | wxEXPAND | wxALIGN_CENTER_VERTICAL, WXC_FROM_DIP(5));
 
-    m_buttonPrevious = new wxButton(m_splitterPage781,
-                                    wxID_BACKWARD,
-                                    _("Previous"),
-                                    wxDefaultPosition,
-                                    wxDLG_UNIT(m_splitterPage781, wxSize(-1, -1)),
-                                    0);
-    m_buttonPrevious->SetToolTip(_("Show previous 100 commits"));
-
-    flexGridSizer800->Add(m_buttonPrevious, 0, wxALL | wxEXPAND, WXC_FROM_DIP(5));
-
-    m_buttonNext = new wxButton(m_splitterPage781,
-                                wxID_FORWARD,
-                                _("Next"),
-                                wxDefaultPosition,
-                                wxDLG_UNIT(m_splitterPage781, wxSize(-1, -1)),
-                                0);
-    m_buttonNext->SetToolTip(_("Fetch the next 100 commits"));
-
-    flexGridSizer800->Add(m_buttonNext, 0, wxALL | wxEXPAND | wxALIGN_CENTER_VERTICAL, WXC_FROM_DIP(5));
-
     wxArrayString m_comboExtraArgsArr;
     m_comboExtraArgsArr.Add(_("--since="));
     m_comboExtraArgsArr.Add(_("--before="));
@@ -647,22 +627,22 @@ GitCommitListDlgBase::GitCommitListDlgBase(
 
     flexGridSizer800->Add(m_checkBoxIgnoreCase, 0, wxALL | wxALIGN_CENTER_VERTICAL, WXC_FROM_DIP(5));
 
-    m_dvListCtrlCommitList = new clThemedListCtrl(m_splitterPage781,
-                                                  wxID_ANY,
-                                                  wxDefaultPosition,
-                                                  wxDLG_UNIT(m_splitterPage781, wxSize(-1, -1)),
-                                                  wxDV_ROW_LINES | wxDV_SINGLE | get_border_simple_theme_aware_bit());
-
-    boxSizer787->Add(m_dvListCtrlCommitList, 1, wxALL | wxEXPAND, WXC_FROM_DIP(5));
-
-    m_dvListCtrlCommitList->AppendTextColumn(
-        _("Commit"), wxDATAVIEW_CELL_INERT, WXC_FROM_DIP(-2), wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
-    m_dvListCtrlCommitList->AppendTextColumn(
-        _("Author"), wxDATAVIEW_CELL_INERT, WXC_FROM_DIP(-2), wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
-    m_dvListCtrlCommitList->AppendTextColumn(
-        _("Date"), wxDATAVIEW_CELL_INERT, WXC_FROM_DIP(-2), wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
-    m_dvListCtrlCommitList->AppendTextColumn(
-        _("Subject"), wxDATAVIEW_CELL_INERT, WXC_FROM_DIP(-2), wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_listCtrlCommitList = new GitCommitListCtrl(m_splitterPage781,
+                                                 wxID_ANY,
+                                                 wxDefaultPosition,
+                                                 wxDLG_UNIT(m_splitterPage781, wxSize(-1, -1)),
+                                                 wxLC_VIRTUAL | wxLC_REPORT | wxLC_SINGLE_SEL);
+
+    boxSizer787->Add(m_listCtrlCommitList, 1, wxALL | wxEXPAND, WXC_FROM_DIP(5));
+
+    m_listCtrlCommitList->InsertColumn(
+        m_listCtrlCommitList->GetColumnCount(), _("Commit"), wxLIST_FORMAT_LEFT, WXC_FROM_DIP(100));
+    m_listCtrlCommitList->InsertColumn(
+        m_listCtrlCommitList->GetColumnCount(), _("Author"), wxLIST_FORMAT_LEFT, WXC_FROM_DIP(150));
+    m_listCtrlCommitList->InsertColumn(
+        m_listCtrlCommitList->GetColumnCount(), _("Date"), wxLIST_FORMAT_LEFT, WXC_FROM_DIP(150));
+    m_listCtrlCommitList->InsertColumn(
+        m_listCtrlCommitList->GetColumnCount(), _("Subject"), wxLIST_FORMAT_LEFT, WXC_FROM_DIP(500));
     m_splitterPage785 = new wxPanel(
         m_splitter777, wxID_ANY, wxDefaultPosition, wxDLG_UNIT(m_splitter777, wxSize(-1, -1)), wxTAB_TRAVERSAL);
     m_splitter777->SplitHorizontally(m_splitterPage781, m_splitterPage785, 0);
@@ -845,13 +825,8 @@ GitCommitListDlgBase::GitCommitListDlgBase(
     this->Bind(wxEVT_CLOSE_WINDOW, &GitCommitListDlgBase::OnClose, this);
     m_searchCtrlFilter->Bind(wxEVT_COMMAND_TEXT_ENTER, &GitCommitListDlgBase::OnSearchCommitList, this);
     m_searchCtrlFilter->Bind(wxEVT_COMMAND_SEARCHCTRL_SEARCH_BTN, &GitCommitListDlgBase::OnSearchCommitList, this);
-    m_buttonPrevious->Bind(wxEVT_COMMAND_BUTTON_CLICKED, &GitCommitListDlgBase::OnPrevious, this);
-    m_buttonPrevious->Bind(wxEVT_UPDATE_UI, &GitCommitListDlgBase::OnPreviousUI, this);
-    m_buttonNext->Bind(wxEVT_COMMAND_BUTTON_CLICKED, &GitCommitListDlgBase::OnNext, this);
-    m_buttonNext->Bind(wxEVT_UPDATE_UI, &GitCommitListDlgBase::OnNextUpdateUI, this);
-    m_dvListCtrlCommitList->Bind(
-        wxEVT_COMMAND_DATAVIEW_SELECTION_CHANGED, &GitCommitListDlgBase::OnSelectionChanged, this);
-    m_dvListCtrlCommitList->Bind(wxEVT_COMMAND_DATAVIEW_ITEM_CONTEXT_MENU, &GitCommitListDlgBase::OnContextMenu, this);
+    m_listCtrlCommitList->Bind(wxEVT_COMMAND_LIST_ITEM_SELECTED, &GitCommitListDlgBase::OnSelectionChanged, this);
+    m_listCtrlCommitList->Bind(wxEVT_COMMAND_LIST_ITEM_RIGHT_CLICK, &GitCommitListDlgBase::OnContextMenu, this);
     m_fileListBox->Bind(wxEVT_COMMAND_LISTBOX_SELECTED, &GitCommitListDlgBase::OnChangeFile, this);
     m_buttonClose->Bind(wxEVT_COMMAND_BUTTON_CLICKED, &GitCommitListDlgBase::OnBtnClose, this);
 }
@@ -861,14 +836,8 @@ GitCommitListDlgBase::~GitCommitListDlgBase()
     this->Unbind(wxEVT_CLOSE_WINDOW, &GitCommitListDlgBase::OnClose, this);
     m_searchCtrlFilter->Unbind(wxEVT_COMMAND_TEXT_ENTER, &GitCommitListDlgBase::OnSearchCommitList, this);
     m_searchCtrlFilter->Unbind(wxEVT_COMMAND_SEARCHCTRL_SEARCH_BTN, &GitCommitListDlgBase::OnSearchCommitList, this);
-    m_buttonPrevious->Unbind(wxEVT_COMMAND_BUTTON_CLICKED, &GitCommitListDlgBase::OnPrevious, this);
-    m_buttonPrevious->Unbind(wxEVT_UPDATE_UI, &GitCommitListDlgBase::OnPreviousUI, this);
-    m_buttonNext->Unbind(wxEVT_COMMAND_BUTTON_CLICKED, &GitCommitListDlgBase::OnNext, this);
-    m_buttonNext->Unbind(wxEVT_UPDATE_UI, &GitCommitListDlgBase::OnNextUpdateUI, this);
-    m_dvListCtrlCommitList->Unbind(
-        wxEVT_COMMAND_DATAVIEW_SELECTION_CHANGED, &GitCommitListDlgBase::OnSelectionChanged, this);
-    m_dvListCtrlCommitList->Unbind(
-        wxEVT_COMMAND_DATAVIEW_ITEM_CONTEXT_MENU, &GitCommitListDlgBase::OnContextMenu, this);
+    m_listCtrlCommitList->Unbind(wxEVT_COMMAND_LIST_ITEM_SELECTED, &GitCommitListDlgBase::OnSelectionChanged, this);
+    m_listCtrlCommitList->Unbind(wxEVT_COMMAND_LIST_ITEM_RIGHT_CLICK, &GitCommitListDlgBase::OnContextMenu, this);
     m_fileListBox->Unbind(wxEVT_COMMAND_LISTBOX_SELECTED, &GitCommitListDlgBase::OnChangeFile, this);
     m_buttonClose->Unbind(wxEVT_COMMAND_BUTTON_CLICKED, &GitCommitListDlgBase::OnBtnClose, this);
 }
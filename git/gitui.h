@@ -31,6 +31,8 @@
 #include "clToolBar.h"
 #include <wx/dataview.h>
 #include "clThemedListCtrl.h"
+#include <wx/listctrl.h>
+#include "GitCommitListCtrl.h"
 #include <wx/stc/stc.h>
 #include "clThemedSTC.hpp"
 #include <wx/statbox.h>
@@ -190,11 +192,9 @@ protected:
     clThemedSplitterWindow* m_splitter777;
     wxPanel* m_splitterPage781;
     wxSearchCtrl* m_searchCtrlFilter;
-    wxButton* m_buttonPrevious;
-    wxButton* m_buttonNext;
     wxComboBox* m_comboExtraArgs;
     wxCheckBox* m_checkBoxIgnoreCase;
-    clThemedListCtrl* m_dvListCtrlCommitList;
+    GitCommitListCtrl* m_listCtrlCommitList;
     wxPanel* m_splitterPage785;
     clThemedSplitterWindow* m_splitter791;
     wxPanel* m_splitterPage795;
@@ -211,22 +211,16 @@ protected:
 protected:
     virtual void OnClose(wxCloseEvent& event) { event.Skip(); }
     virtual void OnSearchCommitList(wxCommandEvent& event) { event.Skip(); }
-    virtual void OnPrevious(wxCommandEvent& event) { event.Skip(); }
-    virtual void OnPreviousUI(wxUpdateUIEvent& event) { event.Skip(); }
-    virtual void OnNext(wxCommandEvent& event) { event.Skip(); }
-    virtual void OnNextUpdateUI(wxUpdateUIEvent& event) { event.Skip(); }
-    virtual void OnSelectionChanged(wxDataViewEvent& event) { event.Skip(); }
-    virtual void OnContextMenu(wxDataViewEvent& event) { event.Skip(); }
+    virtual void OnSelectionChanged(wxListEvent& event) { event.Skip(); }
+    virtual void OnContextMenu(wxListEvent& event) { event.Skip(); }
     virtual void OnChangeFile(wxCommandEvent& event) { event.Skip(); }
     virtual void OnBtnClose(wxCommandEvent& event) { event.Skip(); }
 
 public:
     wxSearchCtrl* GetSearchCtrlFilter() { return m_searchCtrlFilter; }
-    wxButton* GetButtonPrevious() { return m_buttonPrevious; }
-    wxButton* GetButtonNext() { return m_buttonNext; }
     wxComboBox* GetComboExtraArgs() { return m_comboExtraArgs; }
     wxCheckBox* GetCheckBoxIgnoreCase() { return m_checkBoxIgnoreCase; }
-    clThemedListCtrl* GetDvListCtrlCommitList() { return m_dvListCtrlCommitList; }
+    GitCommitListCtrl* GetListCtrlCommitList() { return m_listCtrlCommitList; }
     wxPanel* GetSplitterPage781() { return m_splitterPage781; }
     wxStaticText* GetStaticText210() { return m_staticText210; }
     wxListBox* GetFileListBox() { return m_fileListBox; }